@@ -247,6 +247,7 @@ struct ParsedTocoFlags {
   Arg<bool> allow_nudging_weights_to_use_fast_gemm_kernel = Arg<bool>(false);
   Arg<int64> dedupe_array_min_size_bytes = Arg<int64>(64);
   Arg<bool> split_tflite_lstm_inputs = Arg<bool>(true);
+  Arg<float> posit_weights_max_relative_error = Arg<float>(0.);
 };
 
 }  // namespace toco
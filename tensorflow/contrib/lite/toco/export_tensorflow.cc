@@ -33,6 +33,8 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/posit16/posit16.h"
+#include "tensorflow/core/lib/posit8/posit8.h"
 #include "tensorflow/core/platform/logging.h"
 
 using tensorflow::DT_BOOL;
@@ -40,6 +42,8 @@ using tensorflow::DT_FLOAT;
 using tensorflow::DT_INT16;
 using tensorflow::DT_INT32;
 using tensorflow::DT_INT64;
+using tensorflow::DT_POSIT16;
+using tensorflow::DT_POSIT8;
 using tensorflow::DT_UINT8;
 using tensorflow::GraphDef;
 using tensorflow::TensorProto;
@@ -2288,6 +2292,61 @@ void AddPlaceholderForRNNState(const Model& model, const string& name, int size,
   }
 }
 
+template <typename Posit>
+string EncodePositTensorContent(const std::vector<float>& values) {
+  std::vector<Posit> posits;
+  posits.reserve(values.size());
+  for (float value : values) {
+    posits.emplace_back(value);
+  }
+  return string(reinterpret_cast<const char*>(posits.data()),
+                sizeof(Posit) * posits.size());
+}
+
+// Rewrites the float Const nodes of arrays that have a posit storage format
+// into a posit Const followed by a Cast to float. The Cast takes the original
+// node name, so consumers are left untouched.
+void StoreConstantArraysInPositFormats(const Model& model,
+                                       GraphDef* tensorflow_graph) {
+  const int num_nodes = tensorflow_graph->node_size();
+  for (int i = 0; i < num_nodes; i++) {
+    tensorflow::NodeDef* const_op = tensorflow_graph->mutable_node(i);
+    if (const_op->op() != "Const" || !model.HasArray(const_op->name())) {
+      continue;
+    }
+    const PositStorageFormat format =
+        model.GetArray(const_op->name()).posit_storage_format;
+    if (format == PositStorageFormat::kNone) {
+      continue;
+    }
+    auto* tensor = (*const_op->mutable_attr())["value"].mutable_tensor();
+    CHECK_EQ(tensor->dtype(), DT_FLOAT);
+    const string& content = tensor->tensor_content();
+    std::vector<float> values(content.size() / sizeof(float));
+    std::copy(content.begin(), content.end(),
+              reinterpret_cast<char*>(values.data()));
+
+    const tensorflow::DataType posit_type =
+        format == PositStorageFormat::kPosit8 ? DT_POSIT8 : DT_POSIT16;
+    tensor->set_dtype(posit_type);
+    tensor->set_tensor_content(
+        format == PositStorageFormat::kPosit8
+            ? EncodePositTensorContent<tensorflow::posit8>(values)
+            : EncodePositTensorContent<tensorflow::posit16>(values));
+    (*const_op->mutable_attr())["dtype"].set_type(posit_type);
+    const string array_name = const_op->name();
+    const string posit_name = AvailableArrayName(model, array_name + "/posit");
+    const_op->set_name(posit_name);
+
+    tensorflow::NodeDef* cast_op = tensorflow_graph->add_node();
+    cast_op->set_op("Cast");
+    cast_op->set_name(array_name);
+    *cast_op->add_input() = posit_name;
+    (*cast_op->mutable_attr())["SrcT"].set_type(posit_type);
+    (*cast_op->mutable_attr())["DstT"].set_type(DT_FLOAT);
+  }
+}
+
 void ExportTensorFlowGraphDefImplementation(const Model& model,
                                             GraphDef* tensorflow_graph) {
   for (const auto& input_array : model.flags.input_arrays()) {
@@ -2325,6 +2384,7 @@ void ExportTensorFlowGraphDefImplementation(const Model& model,
       }
     }
   }
+  StoreConstantArraysInPositFormats(model, tensorflow_graph);
 }
 }  // namespace
 
@@ -271,6 +271,20 @@ class EnsureUint8WeightsSafeForFastInt8Kernels : public GraphTransformation {
   bool has_default_ranges_flag_ = false;
 };
 
+// Picks, for each large constant float array, the narrowest posit format whose
+// rounding keeps the relative error of every element within
+// max_relative_error, and records it in Array::posit_storage_format.
+class SelectPositStorageFormats : public GraphTransformation {
+ public:
+  bool Run(Model* model, std::size_t op_index) override;
+  const char* Name() const override { return "SelectPositStorageFormats"; }
+  float max_relative_error() const { return max_relative_error_; }
+  void set_max_relative_error(float val) { max_relative_error_ = val; }
+
+ private:
+  float max_relative_error_ = 0.f;
+};
+
 #undef DECLARE_GRAPH_TRANSFORMATION
 
 }  // end namespace toco
@@ -0,0 +1,110 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "tensorflow/contrib/lite/toco/graph_transformations/graph_transformations.h"
+#include "tensorflow/contrib/lite/toco/model.h"
+#include "tensorflow/contrib/lite/toco/tooling_util.h"
+#include "tensorflow/core/lib/posit16/posit16.h"
+#include "tensorflow/core/lib/posit8/posit8.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace toco {
+
+namespace {
+
+// Smaller arrays are left in float: the Cast added on export would cost more
+// than the bytes it saves.
+constexpr int kMinElementsForPositStorage = 64;
+
+template <typename Posit>
+float RoundToPosit(float value) {
+  return static_cast<float>(Posit(value));
+}
+
+// Rounds "values" to the posit format "Posit" into "rounded", and returns the
+// largest relative error over the nonzero elements.
+template <typename Posit>
+float RoundAndMeasure(const std::vector<float>& values,
+                      std::vector<float>* rounded) {
+  rounded->resize(values.size());
+  float max_relative_error = 0.f;
+  for (int i = 0; i < values.size(); i++) {
+    const float value = values[i];
+    (*rounded)[i] = RoundToPosit<Posit>(value);
+    if (value != 0.f) {
+      const float relative_error =
+          std::abs((*rounded)[i] - value) / std::abs(value);
+      max_relative_error = std::max(max_relative_error, relative_error);
+    }
+  }
+  return max_relative_error;
+}
+
+const char* PositStorageFormatName(PositStorageFormat format) {
+  return format == PositStorageFormat::kPosit8 ? "posit8" : "posit16";
+}
+
+}  // namespace
+
+bool SelectPositStorageFormats::Run(Model* model, std::size_t op_index) {
+  const auto& op = *model->operators[op_index];
+  bool changed = false;
+  for (const string& input : op.inputs) {
+    if (!IsConstantParameterArray(*model, input)) {
+      continue;
+    }
+    auto& array = model->GetArray(input);
+    if (array.data_type != ArrayDataType::kFloat ||
+        array.buffer->type != ArrayDataType::kFloat ||
+        array.posit_storage_format != PositStorageFormat::kNone ||
+        array.buffer->Length() < kMinElementsForPositStorage) {
+      continue;
+    }
+    auto& values = array.GetMutableBuffer<ArrayDataType::kFloat>().data;
+    bool all_finite = true;
+    for (float value : values) {
+      all_finite &= std::isfinite(value);
+    }
+    if (!all_finite) {
+      // Posits have no infinities; keep the array as float.
+      continue;
+    }
+
+    // Try the formats from narrowest to widest.
+    std::vector<float> rounded;
+    float error = RoundAndMeasure<tensorflow::posit8>(values, &rounded);
+    PositStorageFormat format = PositStorageFormat::kPosit8;
+    if (error > max_relative_error()) {
+      error = RoundAndMeasure<tensorflow::posit16>(values, &rounded);
+      format = PositStorageFormat::kPosit16;
+    }
+    if (error > max_relative_error()) {
+      continue;
+    }
+    values.swap(rounded);
+    array.posit_storage_format = format;
+    AddMessageF(
+        "Storing constant array %s as %s (max relative error %g) for %s",
+        input, PositStorageFormatName(format), error, LogName(op));
+    changed = true;
+  }
+  return changed;
+}
+
+}  // namespace toco
@@ -0,0 +1,111 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/contrib/lite/toco/graph_transformations/graph_transformations.h"
+#include "tensorflow/contrib/lite/toco/model.h"
+#include "tensorflow/contrib/lite/toco/tooling_util.h"
+
+namespace toco {
+
+namespace {
+
+class SelectPositStorageFormatsTest : public ::testing::Test {
+ protected:
+  // Builds a model with one Add operator whose second input is the constant
+  // array "weights" holding "values".
+  void PrepareModel(const std::vector<float>& values) {
+    Array& input = model_.GetOrCreateArray("input");
+    input.data_type = ArrayDataType::kFloat;
+    *input.mutable_shape()->mutable_dims() = {static_cast<int>(values.size())};
+
+    Array& weights = model_.GetOrCreateArray("weights");
+    weights.data_type = ArrayDataType::kFloat;
+    *weights.mutable_shape()->mutable_dims() = {
+        static_cast<int>(values.size())};
+    weights.GetMutableBuffer<ArrayDataType::kFloat>().data = values;
+
+    auto* add_op = new AddOperator;
+    add_op->inputs = {"input", "weights"};
+    add_op->outputs = {"output"};
+    model_.GetOrCreateArray("output").data_type = ArrayDataType::kFloat;
+    model_.operators.push_back(std::unique_ptr<Operator>(add_op));
+  }
+
+  bool Run(float max_relative_error) {
+    SelectPositStorageFormats transformation;
+    transformation.set_max_relative_error(max_relative_error);
+    return transformation.Run(&model_, /*op_index=*/0);
+  }
+
+  const Array& weights() const { return model_.GetArray("weights"); }
+  const std::vector<float>& weights_data() const {
+    return weights().GetBuffer<ArrayDataType::kFloat>().data;
+  }
+
+  Model model_;
+};
+
+// Powers of two within posit8's range are exact in every format.
+TEST_F(SelectPositStorageFormatsTest, ExactValuesUsePosit8) {
+  std::vector<float> values;
+  for (int i = 0; i < 64; i++) {
+    values.push_back((i % 2 ? -1.f : 1.f) * (1 << (i % 6)) / 4.f);
+  }
+  PrepareModel(values);
+  EXPECT_TRUE(Run(0.f));
+  EXPECT_EQ(PositStorageFormat::kPosit8, weights().posit_storage_format);
+  EXPECT_EQ(values, weights_data());
+  // Arrays that already have a format are not revisited.
+  EXPECT_FALSE(Run(0.f));
+}
+
+// posit8 keeps 5 fraction bits around 1 and posit16 keeps 12, so a 1e-3
+// budget rules out posit8 for these values but not posit16.
+TEST_F(SelectPositStorageFormatsTest, FallsBackToPosit16) {
+  std::vector<float> values;
+  for (int i = 0; i < 64; i++) {
+    values.push_back(1.f + 0.0123f * i);
+  }
+  PrepareModel(values);
+  EXPECT_TRUE(Run(1e-3f));
+  EXPECT_EQ(PositStorageFormat::kPosit16, weights().posit_storage_format);
+  for (int i = 0; i < values.size(); i++) {
+    EXPECT_NEAR(values[i], weights_data()[i], 1e-3f * values[i]);
+  }
+}
+
+TEST_F(SelectPositStorageFormatsTest, KeepsFloatWhenNoFormatFits) {
+  std::vector<float> values;
+  for (int i = 0; i < 64; i++) {
+    values.push_back(1.f + 0.0123f * i);
+  }
+  PrepareModel(values);
+  EXPECT_FALSE(Run(1e-6f));
+  EXPECT_EQ(PositStorageFormat::kNone, weights().posit_storage_format);
+  EXPECT_EQ(values, weights_data());
+}
+
+TEST_F(SelectPositStorageFormatsTest, IgnoresSmallArrays) {
+  PrepareModel(std::vector<float>(8, 1.f));
+  EXPECT_FALSE(Run(1.f));
+  EXPECT_EQ(PositStorageFormat::kNone, weights().posit_storage_format);
+}
+
+}  // namespace
+}  // namespace toco
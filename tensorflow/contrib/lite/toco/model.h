@@ -203,6 +203,10 @@ enum class ArrayDataType : uint8 {
   kComplex64,
 };
 
+// Posit formats in which a constant float array may be stored on export.
+// posit8 has no exponent bits and posit16 has one, as in TensorFlow.
+enum class PositStorageFormat : uint8 { kNone, kPosit8, kPosit16 };
+
 // Compile-time logic to map ArrayDataType to the corresponding C++ scalar type
 template <ArrayDataType A>
 struct DataTypeImpl {};
@@ -2022,6 +2026,12 @@ struct Array {
   //   a min and a max. Unlike MinMax which is agnostic as to the quantized
   //   data type, narrow_range refers to values in the quantized data type.
   bool narrow_range = false;
+  // Only for constant float arrays. When not kNone, the TensorFlow GraphDef
+  // exporter stores the buffer in this posit format followed by a Cast back
+  // to float. The float buffer already holds the values rounded to that
+  // format, so the rest of toco sees exactly what the exported graph computes.
+  // Set by SelectPositStorageFormats.
+  PositStorageFormat posit_storage_format = PositStorageFormat::kNone;
 
  private:
   std::unique_ptr<Shape> array_shape;
@@ -362,6 +362,19 @@ void Transform(const TocoFlags& toco_flags, Model* model) {
     EncodeConstantArraysMinMaxByWrappingThemInFakeQuantNodes(model);
   }
 
+  if (toco_flags.has_posit_weights_max_relative_error()) {
+    QCHECK_EQ(output_format, TENSORFLOW_GRAPHDEF)
+        << "--posit_weights_max_relative_error is only supported when "
+           "exporting to a TensorFlow GraphDef.";
+    QCHECK(!quantize_output)
+        << "--posit_weights_max_relative_error applies to float models only.";
+    auto* select_posit_storage_formats = new SelectPositStorageFormats;
+    select_posit_storage_formats->set_max_relative_error(
+        toco_flags.posit_weights_max_relative_error());
+    RunGraphTransformations(model, "posit storage format selection",
+                            {select_posit_storage_formats});
+  }
+
   // Deduplicate large constant arrays.
   if (toco_flags.has_dedupe_array_min_size_bytes()) {
     DedupeConstantArrays(model, toco_flags.dedupe_array_min_size_bytes());
@@ -21,6 +21,7 @@ from __future__ import print_function
 # pylint: disable=unused-import,wildcard-import
 from tensorflow.contrib.mixed_precision.python.loss_scale_manager import *
 from tensorflow.contrib.mixed_precision.python.loss_scale_optimizer import *
+from tensorflow.contrib.mixed_precision.python.posit_optimizers import *
 
 from tensorflow.python.util.all_util import remove_undocumented
 
@@ -28,7 +29,10 @@ _allowed_symbols = [
     "LossScaleManager",
     "FixedLossScaleManager",
     "ExponentialUpdateLossScaleManager",
+    "PositLossScaleManager",
     "LossScaleOptimizer",
+    "PositAdamOptimizer",
+    "PositMomentumOptimizer",
 ]
 
 remove_undocumented(__name__, _allowed_symbols)
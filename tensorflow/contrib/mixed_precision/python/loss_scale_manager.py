@@ -18,13 +18,16 @@ from __future__ import division
 from __future__ import print_function
 
 import abc
+import math
 import six
 
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
+from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import control_flow_ops
 from tensorflow.python.ops import gen_control_flow_ops
 from tensorflow.python.ops import gen_math_ops
+from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import state_ops
 from tensorflow.python.ops import variable_scope
 
@@ -69,6 +72,25 @@ class LossScaleManager(object):
     del finite_grads
     return
 
+  def update_loss_scale_from_grads(self, finite_grads, grads):
+    """Updates loss scale given the gradients of the current step.
+
+    `LossScaleOptimizer` calls this method. The default implementation only
+    looks at whether the gradients are finite; managers that need the
+    gradient values themselves override it.
+
+    Args:
+      finite_grads: bool scalar tensor indicating if all gradients are
+        finite (i.e., not inf or nan).
+      grads: The list of down-scaled gradients of the current step. Entries
+        may be `None` or `IndexedSlices`.
+
+    Returns:
+      An op, when executed updates the loss scale.
+    """
+    del grads
+    return self.update_loss_scale(finite_grads)
+
 
 class FixedLossScaleManager(LossScaleManager):
   """Loss scale manager with a fixed loss scale.
@@ -198,3 +220,132 @@ class ExponentialUpdateLossScaleManager(LossScaleManager):
 
     return control_flow_ops.cond(finite_grads, update_if_finite_grads,
                                  update_if_not_finite_grads)
+
+
+class PositLossScaleManager(LossScaleManager):
+  """Loss scale manager for training with posit gradients.
+
+  Posits do not overflow: values beyond the largest posit saturate, and
+  precision tapers off gradually on both sides of 1. The scale is therefore
+  not found by probing for overflow as in
+  `ExponentialUpdateLossScaleManager`. Instead, this manager measures where
+  the scaled gradients fall in the posit regimes, as the mean base-2 exponent
+  of their non-zero elements, and every `update_every_n_steps` steps moves
+  the scale by a power of two so that this mean sits at `target_exponent`.
+  The default of 0 centers the gradients on the regime around 1, where posits
+  have the most fraction bits.
+
+  Non-finite gradients (NaR) halve the scale immediately.
+  """
+
+  def __init__(self,
+               init_loss_scale=1.,
+               update_every_n_steps=100,
+               target_exponent=0.,
+               max_exponent_change=4,
+               min_loss_scale=2.**-32,
+               max_loss_scale=2.**32):
+    """Constructor of the posit loss scale manager.
+
+    Args:
+      init_loss_scale: A Python float. The loss scale to use at the beginning.
+      update_every_n_steps: The number of steps whose gradient statistics are
+        averaged before the loss scale is updated.
+      target_exponent: The base-2 exponent at which to center the scaled
+        gradients.
+      max_exponent_change: The largest change of the loss scale, as a power of
+        two, in a single update.
+      min_loss_scale: The smallest loss scale to use.
+      max_loss_scale: The largest loss scale to use.
+
+    Raises:
+      ValueError: If update_every_n_steps is less than 1, or the loss scale
+        bounds are invalid.
+    """
+    if update_every_n_steps < 1:
+      raise ValueError("update_every_n_steps must be at least 1.")
+    if not 0 < min_loss_scale <= init_loss_scale <= max_loss_scale:
+      raise ValueError(
+          "Must have 0 < min_loss_scale <= init_loss_scale <= max_loss_scale.")
+    self._update_every_n_steps = update_every_n_steps
+    self._target_exponent = float(target_exponent)
+    self._max_exponent_change = float(max_exponent_change)
+    self._min_loss_scale = float(min_loss_scale)
+    self._max_loss_scale = float(max_loss_scale)
+    self._loss_scale = variable_scope.variable(
+        name="loss_scale",
+        initial_value=ops.convert_to_tensor(init_loss_scale, dtypes.float32),
+        dtype=dtypes.float32,
+        trainable=False)
+    self._num_steps = variable_scope.variable(
+        name="num_steps", initial_value=0, dtype=dtypes.int32,
+        trainable=False)
+    self._exponent_sum = variable_scope.variable(
+        name="exponent_sum", initial_value=0., dtype=dtypes.float32,
+        trainable=False)
+
+  def get_loss_scale(self):
+    """Returns the loss scale."""
+    return self._loss_scale
+
+  def update_loss_scale(self, finite_grads):
+    """Halves the loss scale if gradients are not finite."""
+    return control_flow_ops.cond(
+        finite_grads, gen_control_flow_ops.no_op, self._decrease_loss_scale)
+
+  def update_loss_scale_from_grads(self, finite_grads, grads):
+    """Updates the loss scale from the exponents of the scaled gradients."""
+    exponent_sum = ops.convert_to_tensor(0., dtypes.float32)
+    count = ops.convert_to_tensor(0., dtypes.float32)
+    for g in grads:
+      if g is None:
+        continue
+      if isinstance(g, ops.IndexedSlices):
+        g = g.values
+      magnitude = math_ops.abs(math_ops.cast(g, dtypes.float32))
+      nonzero = math_ops.greater(magnitude, 0.)
+      log_magnitude = math_ops.log(
+          array_ops.where(nonzero, magnitude, array_ops.ones_like(magnitude)))
+      exponent_sum += math_ops.reduce_sum(log_magnitude) / math.log(2.)
+      count += math_ops.reduce_sum(math_ops.cast(nonzero, dtypes.float32))
+    # The gradients were already down-scaled; add the scale back in.
+    mean_exponent = (exponent_sum / math_ops.maximum(count, 1.) +
+                     math_ops.log(self._loss_scale) / math.log(2.))
+
+    def record_step():
+      def update_scale():
+        average = (self._exponent_sum + mean_exponent) / math_ops.cast(
+            self._update_every_n_steps, dtypes.float32)
+        change = math_ops.round(self._target_exponent - average)
+        change = math_ops.minimum(
+            math_ops.maximum(change, -self._max_exponent_change),
+            self._max_exponent_change)
+        new_loss_scale = math_ops.minimum(
+            math_ops.maximum(self._loss_scale * math_ops.pow(2., change),
+                             self._min_loss_scale), self._max_loss_scale)
+        return control_flow_ops.group(
+            state_ops.assign(self._loss_scale, new_loss_scale),
+            self._reset_stats())
+
+      def accumulate():
+        return control_flow_ops.group(
+            state_ops.assign_add(self._num_steps, 1),
+            state_ops.assign_add(self._exponent_sum, mean_exponent))
+
+      return control_flow_ops.cond(
+          self._num_steps + 1 >= self._update_every_n_steps, update_scale,
+          accumulate)
+
+    return control_flow_ops.cond(finite_grads, record_step,
+                                 self._decrease_loss_scale)
+
+  def _reset_stats(self):
+    return control_flow_ops.group(
+        state_ops.assign(self._num_steps, 0),
+        state_ops.assign(self._exponent_sum, 0.))
+
+  def _decrease_loss_scale(self):
+    update_op = state_ops.assign(
+        self._loss_scale,
+        math_ops.maximum(self._min_loss_scale, self._loss_scale * 0.5))
+    return control_flow_ops.group(update_op, self._reset_stats())
@@ -22,6 +22,8 @@ import numpy as np
 from tensorflow.contrib.mixed_precision.python import loss_scale_manager as lsm_lib
 from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.eager import context
+from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import test_util
 from tensorflow.python.ops import variables
 from tensorflow.python.platform import test
@@ -178,5 +180,41 @@ class ExponentialUpdateLossScaleManagerTest(test.TestCase):
     self._test_helper(inputs, expected_outputs, init_loss_scale)
 
 
+class PositLossScaleManagerTest(test.TestCase):
+
+  def _run_updates(self, lsm, finite, grads, num_steps):
+    self.evaluate(variables.global_variables_initializer())
+    update_fn = lambda: lsm.update_loss_scale_from_grads(finite, grads)
+    if not context.executing_eagerly():
+      update_op = update_fn()
+    outputs = []
+    for _ in range(num_steps):
+      if context.executing_eagerly():
+        update_fn()
+      else:
+        self.evaluate(update_op)
+      outputs.append(self.evaluate(lsm.get_loss_scale()))
+    return outputs
+
+  @test_util.run_in_graph_and_eager_modes
+  def test_centers_gradient_exponent(self):
+    lsm = lsm_lib.PositLossScaleManager(
+        init_loss_scale=1, update_every_n_steps=2, max_exponent_change=4)
+    grads = [
+        constant_op.constant([2.**-10, -2.**-10, 0.], dtype=dtypes.float32),
+        None
+    ]
+    outputs = self._run_updates(lsm, constant_op.constant(True), grads, 8)
+    self.assertAllEqual([1, 16, 16, 256, 256, 1024, 1024, 1024], outputs)
+
+  @test_util.run_in_graph_and_eager_modes
+  def test_non_finite_gradients_halve_scale(self):
+    lsm = lsm_lib.PositLossScaleManager(
+        init_loss_scale=8, update_every_n_steps=2, min_loss_scale=2)
+    grads = [constant_op.constant([1.], dtype=dtypes.float32)]
+    outputs = self._run_updates(lsm, constant_op.constant(False), grads, 3)
+    self.assertAllEqual([4, 2, 2], outputs)
+
+
 if __name__ == "__main__":
   test.main()
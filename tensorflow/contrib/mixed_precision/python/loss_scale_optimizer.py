@@ -158,7 +158,8 @@ class LossScaleOptimizer(optimizer.Optimizer):
     # Potentially adjust gradient scale in case of finite gradients.
     return control_flow_ops.group(
         update_vars,
-        self._loss_scale_manager.update_loss_scale(is_overall_finite))
+        self._loss_scale_manager.update_loss_scale_from_grads(
+            is_overall_finite, grads))
 
   def _down_scale(self, grads_vars, loss_scale):
     # Down scale grads by the loss_scale.
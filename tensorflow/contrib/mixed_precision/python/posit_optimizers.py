@@ -0,0 +1,168 @@
+# Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Optimizers for posit variables that keep higher precision master weights."""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import ops
+from tensorflow.python.ops import math_ops
+from tensorflow.python.training import adam
+from tensorflow.python.training import momentum
+from tensorflow.python.training import training_ops
+
+_POSIT_DTYPES = frozenset([dtypes.posit8, dtypes.posit16, dtypes.posit32])
+
+
+class _MasterWeights(object):
+  """Creates and looks up the "master" slot of posit variables."""
+
+  def __init__(self, master_dtype, use_master):
+    master_dtype = dtypes.as_dtype(master_dtype)
+    if master_dtype not in (dtypes.float32, dtypes.float64):
+      raise ValueError("master_dtype must be float32 or float64, got %s" %
+                       master_dtype)
+    self.dtype = master_dtype
+    self._use_master = use_master
+
+  def wants(self, var):
+    """Returns whether `var` gets a master copy."""
+    if var.dtype.base_dtype not in _POSIT_DTYPES:
+      return False
+    return self._use_master is None or self._use_master(var)
+
+  def initial_value(self, var):
+    with ops.colocate_with(var):
+      return math_ops.cast(var.initialized_value(), self.dtype)
+
+
+class PositMomentumOptimizer(momentum.MomentumOptimizer):
+  """Momentum optimizer for posit variables with float master weights.
+
+  The accumulator slot has the dtype of the variable, so a posit16 model keeps
+  16 bit optimizer state. Each posit resource variable selected by
+  `use_master` additionally gets a "master" slot of `master_dtype`. The update
+  is applied to the master copy and the variable is rounded from it, so that
+  updates smaller than the posit spacing of the weights still accumulate.
+
+  Variables that are not posits, reference variables and sparse updates use
+  the regular `MomentumOptimizer` update.
+  """
+
+  def __init__(self, learning_rate, momentum,  # pylint: disable=redefined-outer-name
+               use_locking=False, name="PositMomentum", use_nesterov=False,
+               master_dtype=dtypes.float32, use_master=None):
+    """Construct a new posit Momentum optimizer.
+
+    Args:
+      learning_rate: A `Tensor` or a floating point value.  The learning rate.
+      momentum: A `Tensor` or a floating point value.  The momentum.
+      use_locking: If `True` use locks for update operations.
+      name: Optional name prefix for the operations created when applying
+        gradients.  Defaults to "PositMomentum".
+      use_nesterov: If `True` use Nesterov Momentum.
+      master_dtype: `float32` or `float64`. The type of the master weights.
+      use_master: Optional callable taking a variable and returning whether it
+        needs a master copy. By default every posit variable gets one.
+    """
+    super(PositMomentumOptimizer, self).__init__(
+        learning_rate, momentum, use_locking=use_locking, name=name,
+        use_nesterov=use_nesterov)
+    self._master = _MasterWeights(master_dtype, use_master)
+
+  def _create_slots(self, var_list):
+    super(PositMomentumOptimizer, self)._create_slots(var_list)
+    for v in var_list:
+      if self._master.wants(v):
+        self._get_or_make_slot(v, self._master.initial_value(v), "master",
+                               self._name)
+
+  def _resource_apply_dense(self, grad, var):
+    master = self.get_slot(var, "master")
+    if master is None:
+      return super(PositMomentumOptimizer, self)._resource_apply_dense(
+          grad, var)
+    mom = self.get_slot(var, "momentum")
+    return training_ops.resource_apply_momentum_with_master(
+        var.handle, master.handle, mom.handle,
+        math_ops.cast(self._learning_rate_tensor, self._master.dtype),
+        grad,
+        math_ops.cast(self._momentum_tensor, self._master.dtype),
+        use_locking=self._use_locking,
+        use_nesterov=self._use_nesterov)
+
+
+class PositAdamOptimizer(adam.AdamOptimizer):
+  """Adam optimizer for posit variables with float master weights.
+
+  The "m" and "v" slots have the dtype of the variable, so a posit16 model
+  keeps 16 bit optimizer state. Each posit resource variable selected by
+  `use_master` additionally gets a "master" slot of `master_dtype`. The update
+  is computed in `master_dtype`, applied to the master copy, and the variable
+  is rounded from it.
+
+  Variables that are not posits, reference variables and sparse updates use
+  the regular `AdamOptimizer` update.
+  """
+
+  def __init__(self, learning_rate=0.001, beta1=0.9, beta2=0.999,
+               epsilon=1e-8, use_locking=False, name="PositAdam",
+               master_dtype=dtypes.float32, use_master=None):
+    """Construct a new posit Adam optimizer.
+
+    Args:
+      learning_rate: A Tensor or a floating point value.  The learning rate.
+      beta1: A float value or a constant float tensor.
+        The exponential decay rate for the 1st moment estimates.
+      beta2: A float value or a constant float tensor.
+        The exponential decay rate for the 2nd moment estimates.
+      epsilon: A small constant for numerical stability.
+      use_locking: If True use locks for update operations.
+      name: Optional name for the operations created when applying gradients.
+        Defaults to "PositAdam".
+      master_dtype: `float32` or `float64`. The type of the master weights.
+      use_master: Optional callable taking a variable and returning whether it
+        needs a master copy. By default every posit variable gets one.
+    """
+    super(PositAdamOptimizer, self).__init__(
+        learning_rate=learning_rate, beta1=beta1, beta2=beta2,
+        epsilon=epsilon, use_locking=use_locking, name=name)
+    self._master = _MasterWeights(master_dtype, use_master)
+
+  def _create_slots(self, var_list):
+    super(PositAdamOptimizer, self)._create_slots(var_list)
+    for v in var_list:
+      if self._master.wants(v):
+        self._get_or_make_slot(v, self._master.initial_value(v), "master",
+                               self._name)
+
+  def _resource_apply_dense(self, grad, var):
+    master = self.get_slot(var, "master")
+    if master is None:
+      return super(PositAdamOptimizer, self)._resource_apply_dense(grad, var)
+    m = self.get_slot(var, "m")
+    v = self.get_slot(var, "v")
+    beta1_power, beta2_power = self._get_beta_accumulators()
+    dtype = self._master.dtype
+    return training_ops.resource_apply_adam_with_master(
+        var.handle, master.handle, m.handle, v.handle,
+        math_ops.cast(beta1_power, dtype),
+        math_ops.cast(beta2_power, dtype),
+        math_ops.cast(self._lr_t, dtype),
+        math_ops.cast(self._beta1_t, dtype),
+        math_ops.cast(self._beta2_t, dtype),
+        math_ops.cast(self._epsilon_t, dtype),
+        grad, use_locking=self._use_locking)
@@ -0,0 +1,104 @@
+# Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Tests for the posit master-weight optimizers."""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import numpy as np
+
+from tensorflow.contrib.mixed_precision.python import posit_optimizers
+from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import dtypes
+from tensorflow.python.ops import math_ops
+from tensorflow.python.ops import resource_variable_ops
+from tensorflow.python.ops import variables
+from tensorflow.python.platform import test
+
+
+class PositOptimizersTest(test.TestCase):
+
+  def _run_steps(self, opt, num_steps, grad_value):
+    var = resource_variable_ops.ResourceVariable(
+        [1.0, 2.0], dtype=dtypes.posit16, name="var")
+    grad = math_ops.cast(
+        constant_op.constant([grad_value, grad_value]), dtypes.posit16)
+    update = opt.apply_gradients([(grad, var)])
+    master = opt.get_slot(var, "master")
+    self.assertEqual(dtypes.float32, master.dtype.base_dtype)
+    self.evaluate(variables.global_variables_initializer())
+    for _ in range(num_steps):
+      self.evaluate(update)
+    return (self.evaluate(math_ops.cast(var, dtypes.float32)),
+            self.evaluate(master))
+
+  def testMomentumAccumulatesSmallUpdates(self):
+    with self.test_session():
+      # Each step moves the weights by 2^-14, at most half the posit16
+      # spacing just below 1 and 2, so without a master copy they would never
+      # move.
+      opt = posit_optimizers.PositMomentumOptimizer(
+          learning_rate=1.0, momentum=0.0)
+      var, master = self._run_steps(opt, 64, 2.**-14)
+      self.assertAllClose([1.0 - 2.**-8, 2.0 - 2.**-8], master)
+      self.assertAllClose(master, var, atol=2.**-11)
+      slot = opt.get_slot_names()
+      self.assertEqual(["master", "momentum"], sorted(slot))
+
+  def testAdamMatchesFloatUpdate(self):
+    with self.test_session():
+      opt = posit_optimizers.PositAdamOptimizer(learning_rate=0.01)
+      var, master = self._run_steps(opt, 3, 0.1)
+      # Adam moves each weight by about lr per step regardless of the
+      # gradient's magnitude.
+      self.assertAllClose(np.array([1.0, 2.0]) - 0.03, master, atol=1e-4)
+      self.assertAllClose(master, var, atol=2.**-9)
+
+  def testDoubleMasterDecodesPosit32Exactly(self):
+    with self.test_session():
+      # 1 + 2^-26 is a posit32 but not a float32, so the gradient only reaches
+      # a float64 master intact if it is decoded straight to double.
+      opt = posit_optimizers.PositMomentumOptimizer(
+          learning_rate=1.0, momentum=0.0, master_dtype=dtypes.float64)
+      var = resource_variable_ops.ResourceVariable(
+          [1.0, 2.0], dtype=dtypes.posit32)
+      grad = math_ops.cast(
+          constant_op.constant([1.0 + 2.**-26] * 2, dtype=dtypes.float64),
+          dtypes.posit32)
+      update = opt.apply_gradients([(grad, var)])
+      self.evaluate(variables.global_variables_initializer())
+      self.evaluate(update)
+      master = self.evaluate(opt.get_slot(var, "master"))
+      self.assertAllEqual([-2.**-26, 1.0 - 2.**-26], master)
+      self.assertAllEqual(
+          master, self.evaluate(math_ops.cast(var, dtypes.float64)))
+
+  def testUseMaster(self):
+    with self.test_session():
+      opt = posit_optimizers.PositMomentumOptimizer(
+          learning_rate=1.0, momentum=0.0, use_master=lambda v: False)
+      var = resource_variable_ops.ResourceVariable(
+          [1.0, 2.0], dtype=dtypes.posit16)
+      grad = math_ops.cast(constant_op.constant([0.5, 0.5]), dtypes.posit16)
+      opt.apply_gradients([(grad, var)])
+      self.assertIsNone(opt.get_slot(var, "master"))
+
+  def testInvalidMasterDtype(self):
+    with self.assertRaises(ValueError):
+      posit_optimizers.PositAdamOptimizer(master_dtype=dtypes.float16)
+
+
+if __name__ == "__main__":
+  test.main()
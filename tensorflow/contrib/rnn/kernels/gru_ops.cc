@@ -18,12 +18,101 @@ limitations under the License.
 #include "tensorflow/contrib/rnn/kernels/gru_ops.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
 
+namespace functor {
+
+// Posit GRU cells decode their inputs, run the float cell above on the
+// decoded values, and round r, u, c and h once each. 'r_u_bar', 'x_h_prev'
+// and 'x_h_prevr' are scratch and stay in float.
+template <typename T>
+struct GRUBlockCellFpropPosit : public GRUCell {
+  GRUBlockCellFpropPosit(const int batch_size, const int input_size,
+                         const int cell_size)
+      : GRUCell(batch_size, input_size, cell_size) {}
+
+  void operator()(
+      OpKernelContext* ctx, const CPUDevice& d,
+      typename TTypes<T>::ConstMatrix x, typename TTypes<T>::ConstMatrix h_prev,
+      typename TTypes<T>::ConstMatrix w_ru, typename TTypes<T>::ConstMatrix w_c,
+      typename TTypes<T>::ConstVec b_ru, typename TTypes<T>::ConstVec b_c,
+      typename TTypes<T>::Matrix r_u_bar, typename TTypes<T>::Matrix r,
+      typename TTypes<T>::Matrix u, typename TTypes<T>::Matrix c,
+      typename TTypes<T>::Matrix h, typename TTypes<T>::Matrix x_h_prev,
+      typename TTypes<T>::Matrix x_h_prevr) {
+    const int64 batch_cell = static_cast<int64>(batch_size_) * cell_size_;
+    const int64 xh_size =
+        static_cast<int64>(batch_size_) * (input_size_ + cell_size_);
+
+    // Layout: w_ru | w_c | b_ru | b_c | x | h_prev | r_u_bar | r | u | c | h |
+    // x_h_prev | x_h_prevr.
+    const int64 total = w_ru.size() + w_c.size() + b_ru.size() + b_c.size() +
+                        x.size() + 7 * batch_cell + 2 * xh_size;
+    Tensor scratch;
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_temp(DT_FLOAT, TensorShape({total}), &scratch));
+    float* w_ru_f = scratch.flat<float>().data();
+    float* w_c_f = w_ru_f + w_ru.size();
+    float* b_ru_f = w_c_f + w_c.size();
+    float* b_c_f = b_ru_f + b_ru.size();
+    float* x_f = b_c_f + b_c.size();
+    float* h_prev_f = x_f + x.size();
+    float* r_u_bar_f = h_prev_f + batch_cell;
+    float* r_f = r_u_bar_f + 2 * batch_cell;
+    float* u_f = r_f + batch_cell;
+    float* c_f = u_f + batch_cell;
+    float* h_f = c_f + batch_cell;
+    float* x_h_prev_f = h_f + batch_cell;
+    float* x_h_prevr_f = x_h_prev_f + xh_size;
+
+    // 'h' may alias 'h_prev', so it is decoded before anything is written.
+    ParallelDecodePosits(ctx, w_ru.data(), w_ru_f, w_ru.size());
+    ParallelDecodePosits(ctx, w_c.data(), w_c_f, w_c.size());
+    PositToFloat(b_ru.data(), b_ru_f, b_ru.size());
+    PositToFloat(b_c.data(), b_c_f, b_c.size());
+    ParallelDecodePosits(ctx, x.data(), x_f, x.size());
+    ParallelDecodePosits(ctx, h_prev.data(), h_prev_f, batch_cell);
+
+    typedef TTypes<float>::ConstMatrix ConstMatrix;
+    typedef TTypes<float>::ConstVec ConstVec;
+    typedef TTypes<float>::Matrix Matrix;
+    GRUBlockCellFprop<CPUDevice, float, false /* USE_CUBLAS */>(
+        batch_size_, input_size_, cell_size_)(
+        ctx, d, ConstMatrix(x_f, batch_size_, input_size_),
+        ConstMatrix(h_prev_f, batch_size_, cell_size_),
+        ConstMatrix(w_ru_f, w_ru.dimension(0), w_ru.dimension(1)),
+        ConstMatrix(w_c_f, w_c.dimension(0), w_c.dimension(1)),
+        ConstVec(b_ru_f, b_ru.size()), ConstVec(b_c_f, b_c.size()),
+        Matrix(r_u_bar_f, batch_size_, 2 * cell_size_),
+        Matrix(r_f, batch_size_, cell_size_),
+        Matrix(u_f, batch_size_, cell_size_),
+        Matrix(c_f, batch_size_, cell_size_),
+        Matrix(h_f, batch_size_, cell_size_),
+        Matrix(x_h_prev_f, batch_size_, input_size_ + cell_size_),
+        Matrix(x_h_prevr_f, batch_size_, input_size_ + cell_size_));
+
+    ParallelEncodePosits(ctx, r_f, r.data(), batch_cell);
+    ParallelEncodePosits(ctx, u_f, u.data(), batch_cell);
+    ParallelEncodePosits(ctx, c_f, c.data(), batch_cell);
+    ParallelEncodePosits(ctx, h_f, h.data(), batch_cell);
+  }
+};
+
+template <>
+struct GRUBlockCellFprop<CPUDevice, posit16, false /* USE_CUBLAS */>
+    : public GRUBlockCellFpropPosit<posit16> {
+  GRUBlockCellFprop(const int batch_size, const int input_size,
+                    const int cell_size)
+      : GRUBlockCellFpropPosit<posit16>(batch_size, input_size, cell_size) {}
+};
+
+}  // namespace functor
+
 template <typename Device, typename T, bool USE_CUBLAS>
 class GRUCellBlockOp : public OpKernel {
  public:
@@ -165,6 +254,7 @@ class GRUCellBlockOp : public OpKernel {
       GRUCellBlockOp<CPUDevice, T, false>);
 
 REGISTER_KERNEL(float);
+REGISTER_KERNEL(posit16);
 #undef REGISTER_KERNEL
 
 template <typename Device, typename T, bool USE_CUBLAS>
@@ -31,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 
@@ -226,6 +227,128 @@ void LSTMBlockCellBpropWithEigen(
 DEFINE_CPU_SPECS(float);
 #undef DEFINE_CPU_SPECS
 
+// Posit cells decode their inputs, run the float cell math above on the
+// decoded values (gate matmul, bias, sigmoid/tanh, cell update), and round
+// each output once. 'xh' and 'icfo' are scratch and never leave the float
+// domain. Decoded weights are cached on the functor, so BlockLSTM, which
+// reuses one functor for the whole sequence, decodes them once rather than
+// once per timestep.
+template <typename T>
+struct LSTMBlockCellFpropPosit : public LSTMBlockCell {
+  LSTMBlockCellFpropPosit(const int batch_size, const int input_size,
+                          const int cell_size)
+      : LSTMBlockCell(batch_size, input_size, cell_size) {}
+
+  void operator()(
+      OpKernelContext* ctx, const CPUDevice& d, const T forget_bias,
+      const T cell_clip, bool use_peephole, typename TTypes<T>::ConstMatrix x,
+      typename TTypes<T>::ConstMatrix cs_prev,
+      typename TTypes<T>::ConstMatrix h_prev, typename TTypes<T>::ConstMatrix w,
+      typename TTypes<T>::ConstVec wci, typename TTypes<T>::ConstVec wcf,
+      typename TTypes<T>::ConstVec wco, typename TTypes<T>::ConstVec b,
+      typename TTypes<T>::Matrix xh, typename TTypes<T>::Matrix i,
+      typename TTypes<T>::Matrix cs, typename TTypes<T>::Matrix f,
+      typename TTypes<T>::Matrix o, typename TTypes<T>::Matrix ci,
+      typename TTypes<T>::Matrix co, typename TTypes<T>::Matrix icfo,
+      typename TTypes<T>::Matrix h) {
+    const int64 batch_cell = static_cast<int64>(batch_size_) * cell_size_;
+    const int64 xh_cols = input_size_ + cell_size_;
+
+    if (w.data() != weights_src_) {
+      // Layout: w | b | wci | wcf | wco.
+      const int64 total =
+          w.size() + b.size() + wci.size() + wcf.size() + wco.size();
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, TensorShape({total}),
+                                             &weights_));
+      float* dst = weights_.flat<float>().data();
+      ParallelDecodePosits(ctx, w.data(), dst, w.size());
+      dst += w.size();
+      PositToFloat(b.data(), dst, b.size());
+      dst += b.size();
+      PositToFloat(wci.data(), dst, wci.size());
+      dst += wci.size();
+      PositToFloat(wcf.data(), dst, wcf.size());
+      dst += wcf.size();
+      PositToFloat(wco.data(), dst, wco.size());
+      weights_src_ = w.data();
+    }
+    const float* w_f = weights_.flat<float>().data();
+    const float* b_f = w_f + w.size();
+    const float* wci_f = b_f + b.size();
+    const float* wcf_f = wci_f + wci.size();
+    const float* wco_f = wcf_f + wcf.size();
+
+    if (!scratch_.IsInitialized()) {
+      // Layout: x | cs_prev | h_prev | xh | i | cs | f | o | ci | co | h |
+      // icfo.
+      const int64 total = x.size() + batch_size_ * xh_cols + 13 * batch_cell;
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, TensorShape({total}),
+                                             &scratch_));
+    }
+    float* x_f = scratch_.flat<float>().data();
+    float* cs_prev_f = x_f + x.size();
+    float* h_prev_f = cs_prev_f + batch_cell;
+    float* xh_f = h_prev_f + batch_cell;
+    float* i_f = xh_f + batch_size_ * xh_cols;
+    float* cs_f = i_f + batch_cell;
+    float* f_f = cs_f + batch_cell;
+    float* o_f = f_f + batch_cell;
+    float* ci_f = o_f + batch_cell;
+    float* co_f = ci_f + batch_cell;
+    float* h_f = co_f + batch_cell;
+    float* icfo_f = h_f + batch_cell;
+
+    // 'i' and 'o' may alias 'h_prev' and 'cs_prev', so every input is decoded
+    // before any output is written.
+    ParallelDecodePosits(ctx, x.data(), x_f, x.size());
+    ParallelDecodePosits(ctx, cs_prev.data(), cs_prev_f, batch_cell);
+    ParallelDecodePosits(ctx, h_prev.data(), h_prev_f, batch_cell);
+
+    typedef TTypes<float>::ConstMatrix ConstMatrix;
+    typedef TTypes<float>::ConstVec ConstVec;
+    typedef TTypes<float>::Matrix Matrix;
+    LSTMBlockCellFpropWithEigen<float>(
+        *this, ctx, d, static_cast<float>(forget_bias),
+        static_cast<float>(cell_clip), use_peephole,
+        ConstMatrix(x_f, batch_size_, input_size_),
+        ConstMatrix(cs_prev_f, batch_size_, cell_size_),
+        ConstMatrix(h_prev_f, batch_size_, cell_size_),
+        ConstMatrix(w_f, w.dimension(0), w.dimension(1)),
+        ConstVec(wci_f, wci.size()), ConstVec(wcf_f, wcf.size()),
+        ConstVec(wco_f, wco.size()), ConstVec(b_f, b.size()),
+        Matrix(xh_f, batch_size_, xh_cols),
+        Matrix(i_f, batch_size_, cell_size_),
+        Matrix(cs_f, batch_size_, cell_size_),
+        Matrix(f_f, batch_size_, cell_size_),
+        Matrix(o_f, batch_size_, cell_size_),
+        Matrix(ci_f, batch_size_, cell_size_),
+        Matrix(co_f, batch_size_, cell_size_),
+        Matrix(icfo_f, batch_size_, cell_size_ * 4),
+        Matrix(h_f, batch_size_, cell_size_));
+
+    ParallelEncodePosits(ctx, i_f, i.data(), batch_cell);
+    ParallelEncodePosits(ctx, cs_f, cs.data(), batch_cell);
+    ParallelEncodePosits(ctx, f_f, f.data(), batch_cell);
+    ParallelEncodePosits(ctx, o_f, o.data(), batch_cell);
+    ParallelEncodePosits(ctx, ci_f, ci.data(), batch_cell);
+    ParallelEncodePosits(ctx, co_f, co.data(), batch_cell);
+    ParallelEncodePosits(ctx, h_f, h.data(), batch_cell);
+  }
+
+ private:
+  const T* weights_src_ = nullptr;
+  Tensor weights_;
+  Tensor scratch_;
+};
+
+template <>
+struct LSTMBlockCellFprop<CPUDevice, posit16, false /* USE_CUBLAS */>
+    : public LSTMBlockCellFpropPosit<posit16> {
+  LSTMBlockCellFprop(const int batch_size, const int input_size,
+                     const int cell_size)
+      : LSTMBlockCellFpropPosit<posit16>(batch_size, input_size, cell_size) {}
+};
+
 }  // namespace functor
 
 template <typename Device, typename T, bool USE_CUBLAS>
@@ -352,7 +475,7 @@ class LSTMBlockCellOp : public OpKernel {
 
     functor::LSTMBlockCellFprop<Device, T, USE_CUBLAS>(batch_size, input_size,
                                                        cell_size)(
-        ctx, device, forget_bias_, cell_clip_, use_peephole_,
+        ctx, device, T(forget_bias_), T(cell_clip_), use_peephole_,
         x_tensor->matrix<T>(), cs_prev_tensor->matrix<T>(),
         h_prev_tensor->matrix<T>(), w_tensor->matrix<T>(), wci_tensor->vec<T>(),
         wcf_tensor->vec<T>(), wco_tensor->vec<T>(), b_tensor->vec<T>(),
@@ -372,6 +495,7 @@ class LSTMBlockCellOp : public OpKernel {
       Name("LSTMBlockCell").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
       LSTMBlockCellOp<CPUDevice, T, false>);
 REGISTER_KERNEL(float);
+REGISTER_KERNEL(posit16);
 // REGISTER_KERNEL(double);
 #undef REGISTER_KERNEL
 
@@ -951,6 +1075,8 @@ class BlockLSTMOp : public OpKernel {
 
     const int64 seq_len_max = seq_len_max_tensor->scalar<int64>()();
     SliceHelper<Device, T> slicer(ctx);
+    functor::LSTMBlockCellFprop<Device, T, USE_CUBLAS> fprop(
+        batch_size, input_size, cell_size);
     for (int64 t = 0; t < seq_len_max; ++t) {
       const Tensor x_tensor = slicer.InputSlice(*x, t, "x");
       const Tensor& cs_prev_tensor2 =
@@ -967,9 +1093,7 @@ class BlockLSTMOp : public OpKernel {
       Tensor co_tensor = slicer.OutputSlice(co_out, t, "co_out");
       Tensor h_tensor = slicer.OutputSlice(h_out, t, "h_out");
 
-      functor::LSTMBlockCellFprop<Device, T, USE_CUBLAS>(batch_size, input_size,
-                                                         cell_size)(
-          ctx, device, forget_bias_, cell_clip_, use_peephole_,
+      fprop(ctx, device, T(forget_bias_), T(cell_clip_), use_peephole_,
           x_tensor.matrix<T>(), cs_prev_tensor2.matrix<T>(),
           h_prev_tensor2.matrix<T>(), w_tensor->matrix<T>(),
           wci_tensor->vec<T>(), wcf_tensor->vec<T>(), wco_tensor->vec<T>(),
@@ -984,10 +1108,10 @@ class BlockLSTMOp : public OpKernel {
       Tensor cs_tensor = cs_out->Slice(seq_len_max, timelen);
       Tensor h_tensor = h_out->Slice(seq_len_max, timelen);
 
-      functor::TensorUnalignedZero<Device, T>()(
-          device, cs_tensor.unaligned_flat<float>());
-      functor::TensorUnalignedZero<Device, T>()(
-          device, h_tensor.unaligned_flat<float>());
+      functor::TensorUnalignedZero<Device, T>()(device,
+                                                cs_tensor.unaligned_flat<T>());
+      functor::TensorUnalignedZero<Device, T>()(device,
+                                                h_tensor.unaligned_flat<T>());
     }
   }
 
@@ -1002,6 +1126,7 @@ class BlockLSTMOp : public OpKernel {
       Name("BlockLSTM").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
       BlockLSTMOp<CPUDevice, T, false>);
 REGISTER_KERNEL(float);
+REGISTER_KERNEL(posit16);
 // REGISTER_KERNEL(double);
 #undef REGISTER_KERNEL
 
@@ -21,7 +21,7 @@ using tensorflow::shape_inference::InferenceContext;
 using tensorflow::shape_inference::ShapeHandle;
 
 REGISTER_OP("GRUBlockCell")
-    .Attr("T: {float}")
+    .Attr("T: {float, posit16}")
     .Input("x: T")
     .Input("h_prev: T")
     .Input("w_ru: T")
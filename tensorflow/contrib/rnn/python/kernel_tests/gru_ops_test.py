@@ -20,9 +20,11 @@ from __future__ import print_function
 
 import numpy as np
 
+from tensorflow.contrib.rnn.ops import gen_gru_ops
 from tensorflow.contrib.rnn.python.kernel_tests import benchmarking
 from tensorflow.contrib.rnn.python.ops import gru_ops
 from tensorflow.python.client import session
+from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
 from tensorflow.python.ops import array_ops
@@ -328,6 +330,58 @@ class GRUBlockCellTest(test.TestCase):
     self.assertLess(error_b_ru, eps)
     self.assertLess(error_b_c, eps)
 
+  def testPosit16MatchesFloat(self):
+    """The posit16 GRUBlockCell tracks the float kernel."""
+    np.random.seed(1994)
+    batch_size = 2
+    input_size = 3
+    cell_size = 4
+    x_value = np.random.randn(batch_size, input_size).astype(np.float32)
+    h_value = 0.1 * np.random.randn(batch_size, cell_size).astype(np.float32)
+    w_ru_value = 0.2 * np.random.randn(input_size + cell_size,
+                                       2 * cell_size).astype(np.float32)
+    w_c_value = 0.2 * np.random.randn(input_size + cell_size,
+                                      cell_size).astype(np.float32)
+    b_ru_value = np.ones([2 * cell_size], dtype=np.float32)
+    b_c_value = np.zeros([cell_size], dtype=np.float32)
+
+    def outputs(dtype):
+      args = [
+          math_ops.cast(constant_op.constant(v), dtype)
+          for v in (x_value, h_value, w_ru_value, w_c_value, b_ru_value,
+                    b_c_value)
+      ]
+      return [
+          math_ops.cast(t, dtypes.float32)
+          for t in gen_gru_ops.gru_block_cell(*args)
+      ]
+
+    with self.test_session(use_gpu=False) as sess:
+      float_res, posit_res = sess.run(
+          [outputs(dtypes.float32), outputs(dtypes.posit16)])
+    for expected, actual in zip(float_res, posit_res):
+      self.assertAllClose(expected, actual, rtol=1e-2, atol=1e-3)
+
+  def testPosit16HasNoGradient(self):
+    """Differentiating a posit16 cell fails when the graph is built."""
+    batch_size = 2
+    input_size = 3
+    cell_size = 4
+
+    def zeros(*shape):
+      return math_ops.cast(array_ops.zeros(shape), dtypes.posit16)
+
+    x = zeros(batch_size, input_size)
+    h_prev = zeros(batch_size, cell_size)
+    w_ru = zeros(input_size + cell_size, 2 * cell_size)
+    w_c = zeros(input_size + cell_size, cell_size)
+    b_ru = zeros(2 * cell_size)
+    b_c = zeros(cell_size)
+    _, _, _, h = gen_gru_ops.gru_block_cell(x, h_prev, w_ru, w_c, b_ru, b_c)
+    with self.assertRaisesRegexp(TypeError,
+                                 "GRUBlockCell has no gradient for posit16"):
+      gradients_impl.gradients(h, [x])
+
 
 #### Benchmarking GRUBlockCell vs GRUCell.
 
@@ -29,6 +29,7 @@ from tensorflow.python.framework import ops
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import gradients_impl
 from tensorflow.python.ops import init_ops
+from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import rnn
 from tensorflow.python.ops import rnn_cell
 from tensorflow.python.ops import variable_scope
@@ -429,6 +430,66 @@ class LSTMBlockCellTest(test.TestCase):
       for fused, unfused in zip(fused_wgrads, unfused_wgrads):
         self.assertAllClose(fused, unfused, rtol=1e-6, atol=1e-6)
 
+  def testPosit16MatchesFloat(self):
+    """Posit16 LSTMBlockCell and BlockLSTM track the float kernels."""
+    np.random.seed(1994)
+    batch_size = 2
+    input_size = 3
+    cell_size = 4
+    time_len = 5
+    x_value = np.random.randn(time_len, batch_size,
+                              input_size).astype(np.float32)
+    cs_value = 0.1 * np.random.randn(batch_size, cell_size).astype(np.float32)
+    h_value = 0.1 * np.random.randn(batch_size, cell_size).astype(np.float32)
+    w_value = 0.2 * np.random.randn(input_size + cell_size,
+                                    4 * cell_size).astype(np.float32)
+    b_value = 0.1 * np.random.randn(4 * cell_size).astype(np.float32)
+
+    def outputs(dtype):
+      x, cs_prev, h_prev, w, b = [
+          math_ops.cast(constant_op.constant(v), dtype)
+          for v in (x_value, cs_value, h_value, w_value, b_value)
+      ]
+      cell = lstm_ops._lstm_block_cell(  # pylint: disable=protected-access
+          x[0], cs_prev, h_prev, w, b, forget_bias=1.0, use_peephole=False)
+      _, cs, _, _, _, _, h = lstm_ops._block_lstm(  # pylint: disable=protected-access
+          constant_op.constant(time_len, dtype=dtypes.int64),
+          array_ops.unstack(x), w, b, cs_prev=cs_prev, h_prev=h_prev,
+          forget_bias=1.0, use_peephole=False)
+      return [math_ops.cast(t, dtypes.float32) for t in list(cell) + [cs, h]]
+
+    with self.test_session(use_gpu=False) as sess:
+      float_res, posit_res = sess.run(
+          [outputs(dtypes.float32), outputs(dtypes.posit16)])
+    for expected, actual in zip(float_res, posit_res):
+      self.assertAllClose(expected, actual, rtol=1e-2, atol=1e-3)
+
+  def testPosit16HasNoGradient(self):
+    """Differentiating a posit16 cell fails when the graph is built."""
+    batch_size = 2
+    input_size = 3
+    cell_size = 4
+
+    def zeros(*shape):
+      return math_ops.cast(array_ops.zeros(shape), dtypes.posit16)
+
+    x, cs_prev, h_prev = [
+        zeros(batch_size, size) for size in (input_size, cell_size, cell_size)
+    ]
+    w = zeros(input_size + cell_size, 4 * cell_size)
+    b = zeros(4 * cell_size)
+    cell = lstm_ops._lstm_block_cell(  # pylint: disable=protected-access
+        x, cs_prev, h_prev, w, b, use_peephole=False)
+    with self.assertRaisesRegexp(TypeError,
+                                 "LSTMBlockCell has no gradient for posit16"):
+      gradients_impl.gradients(cell[-1], [x])
+    _, _, _, _, _, _, h = lstm_ops._block_lstm(  # pylint: disable=protected-access
+        constant_op.constant(1, dtype=dtypes.int64), [x], w, b,
+        cs_prev=cs_prev, h_prev=h_prev, use_peephole=False)
+    with self.assertRaisesRegexp(TypeError,
+                                 "BlockLSTM has no gradient for posit16"):
+      gradients_impl.gradients(h, [x])
+
 #### Benchmarking.
 
 
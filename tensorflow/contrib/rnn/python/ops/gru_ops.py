@@ -19,6 +19,7 @@ from __future__ import print_function
 
 from tensorflow.contrib.rnn.ops import gen_gru_ops
 from tensorflow.contrib.util import loader
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
 from tensorflow.python.layers import base as base_layer
 from tensorflow.python.ops import array_ops
@@ -78,7 +79,15 @@ def _GRUBlockCellGrad(op, *grad):
 
   d_b_c = sum of d_c_bar along axis = 0
   ```
+
+  Raises:
+    TypeError: If the op runs on `posit16`, which has no gradient kernel.
   """
+  dtype = op.get_attr("T")
+  if dtype != dtypes.float32:
+    raise TypeError(
+        "%s has no gradient for %s inputs: the posit kernels are forward "
+        "only. Run the cell in float32 to train it." % (op.type, dtype.name))
   x, h_prev, w_ru, w_c, b_ru, b_c = op.inputs
   r, u, c, _ = op.outputs
   _, _, _, d_h = grad
@@ -130,6 +139,8 @@ class GRUBlockCell(LayerRNNCell):
   h = (1-u) \circ c + u \circ h_prev
   ```
 
+  The op also runs on `posit16` inputs on CPU, but only forward: taking the
+  gradient of a `posit16` cell raises a `TypeError`.
   """
 
   @deprecated_args(None, "cell_size is deprecated, use num_units instead",
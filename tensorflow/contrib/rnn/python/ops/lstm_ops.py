@@ -78,8 +78,9 @@ def _lstm_block_cell(x,
   ```
 
   Args:
-    x: A `Tensor`. Must be one of the following types: `float32`.
-      The input to the LSTM cell, shape (batch_size, num_inputs).
+    x: A `Tensor`. Must be one of the following types: `float32`, `posit16`.
+      The input to the LSTM cell, shape (batch_size, num_inputs). `posit16`
+      cells run forward only and have no gradient.
     cs_prev: A `Tensor`. Must have the same type as `x`.
       Value of the cell state at previous time step.
     h_prev: A `Tensor`. Must have the same type as `x`.
@@ -116,7 +117,7 @@ def _lstm_block_cell(x,
     cell_size = cs_prev.get_shape().with_rank(2)[1].value
     if cell_size is None:
       raise ValueError("cell_size from `cs_prev` should not be None.")
-    wci = array_ops.constant(0, dtype=dtypes.float32, shape=[cell_size])
+    wci = array_ops.constant(0, dtype=b.dtype, shape=[cell_size])
     wcf = wci
     wco = wci
 
@@ -154,7 +155,8 @@ def _block_lstm(seq_len_max,
 
   Args:
     seq_len_max: A `Tensor` of type `int64`.
-    x: A list of at least 1 `Tensor` objects of the same type in: `float32`.
+    x: A list of at least 1 `Tensor` objects of the same type in: `float32`,
+      `posit16`. `posit16` runs forward only and has no gradient.
     w: A `Tensor`. Must have the same type as `x`.
     b: A `Tensor`. Must have the same type as `x`.
     cs_prev: A `Tensor`. Must have the same type as `x`.
@@ -195,13 +197,13 @@ def _block_lstm(seq_len_max,
   zero_state = None
   if cs_prev is None or h_prev is None:
     zero_state = array_ops.constant(
-        0, dtype=dtypes.float32, shape=[batch_size, cell_size])
+        0, dtype=b.dtype, shape=[batch_size, cell_size])
   if cs_prev is None:
     cs_prev = zero_state
   if h_prev is None:
     h_prev = zero_state
   if wci is None:
-    wci = array_ops.constant(0, dtype=dtypes.float32, shape=[cell_size])
+    wci = array_ops.constant(0, dtype=b.dtype, shape=[cell_size])
     wcf = wci
     wco = wci
 
@@ -231,9 +233,19 @@ def _block_lstm(seq_len_max,
 _lstm_block_cell_grad_outputs = ["cs_prev_grad", "dicfo"]
 
 
+def _check_gradient_dtype(op):
+  """Raises a TypeError if the gradient kernels don't support `op`'s type."""
+  dtype = op.get_attr("T")
+  if dtype != dtypes.float32:
+    raise TypeError(
+        "%s has no gradient for %s inputs: the posit kernels are forward "
+        "only. Run the cell in float32 to train it." % (op.type, dtype.name))
+
+
 @ops.RegisterGradient("LSTMBlockCell")
 def _LSTMBlockCellGrad(op, *grad):
   """Gradient for LSTMBlockCell."""
+  _check_gradient_dtype(op)
   (x, cs_prev, h_prev, w, wci, wcf, wco, b) = op.inputs
   (i, cs, f, o, ci, co, _) = op.outputs
   (_, cs_grad, _, _, _, _, h_grad) = grad
@@ -294,6 +306,7 @@ def _LSTMBlockCellGrad(op, *grad):
 @ops.RegisterGradient("BlockLSTM")
 def _BlockLSTMGrad(op, *grad):
   """Gradient for BlockLSTM."""
+  _check_gradient_dtype(op)
   seq_len_max, x, cs_prev, h_prev, w, wci, wcf, wco, b = op.inputs
   i, cs, f, o, ci, co, h = op.outputs
 
@@ -339,6 +352,9 @@ class LSTMBlockCell(LayerRNNCell):
   Unlike `rnn_cell_impl.LSTMCell`, this is a monolithic op and should be much
   faster.  The weight and bias matrices should be compatible as long as the
   variable scope matches.
+
+  The op also runs on `posit16` inputs on CPU, but only forward: taking the
+  gradient of a `posit16` cell raises a `TypeError`.
   """
 
   def __init__(self,
@@ -588,6 +604,8 @@ class LSTMBlockFusedCell(LSTMBlockWrapper):
   reduce the scale of forgetting in the beginning of the training.
 
   The variable naming is consistent with `rnn_cell_impl.LSTMCell`.
+
+  As for `LSTMBlockCell`, `posit16` inputs are supported forward only.
   """
 
   def __init__(self,
@@ -105,6 +105,11 @@ class AccumulateNV2RemovePass : public GraphOptimizationPass {
       }
     }
 
+    if (dtype == DT_POSIT8 || dtype == DT_POSIT16 || dtype == DT_POSIT32) {
+      return rewriteAsAddN(n, g, dtype, data_edges, control_edges,
+                           base_make_node);
+    }
+
     // Create the following ops to replace the AccumulateNV2 placeholder:
     Node* create_accumulator = nullptr;            // TemporaryVariable op
     Node* initial_val = nullptr;                   // Const op
@@ -204,6 +209,43 @@ class AccumulateNV2RemovePass : public GraphOptimizationPass {
 
     return Status::OK();
   }
+
+  // Every AssignAdd into the accumulator would round. For posits, AddN sums
+  // all inputs exactly and rounds once, so it replaces the placeholder
+  // directly, at the cost of keeping all inputs alive until the last one is
+  // ready.
+  template <typename MakeNode>
+  Status rewriteAsAddN(Node* n, Graph* g, DataType dtype,
+                       const std::vector<const Edge*>& data_edges,
+                       const std::vector<const Edge*>& control_edges,
+                       const MakeNode& base_make_node) {
+    std::vector<NodeBuilder::NodeOut> inputs(data_edges.size());
+    for (const Edge* data_edge : data_edges) {
+      inputs[data_edge->dst_input()] =
+          NodeBuilder::NodeOut(data_edge->src(), data_edge->src_output());
+    }
+    std::vector<Node*> control_inputs;
+    for (const Edge* control_edge : control_edges) {
+      control_inputs.push_back(control_edge->src());
+    }
+
+    // Note that we use the original placeholder op's name here
+    Node* add_n = nullptr;
+    TF_RETURN_IF_ERROR(base_make_node("AddN", n->name())
+                           .Attr("T", dtype)
+                           .Input(inputs)
+                           .ControlInputs(control_inputs)
+                           .Finalize(g, &add_n));
+    for (const Edge* out_edge : n->out_edges()) {
+      if (out_edge->IsControlEdge()) {
+        g->AddControlEdge(add_n, out_edge->dst());
+      } else {
+        g->AddEdge(add_n, 0, out_edge->dst(), out_edge->dst_input());
+      }
+    }
+    g->RemoveNode(n);
+    return Status::OK();
+  }
 };
 REGISTER_OPTIMIZATION(OptimizationPassRegistry::PRE_PLACEMENT, 0,
                       AccumulateNV2RemovePass);
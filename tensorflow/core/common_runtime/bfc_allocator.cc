@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <atomic>
 
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
@@ -29,12 +30,97 @@ limitations under the License.
 
 namespace tensorflow {
 
+namespace {
+
+// Guards BFCAllocator::ThreadCache::allocator and the thread_caches_ of all
+// allocators.
+mutex* ThreadCacheRegistryMu() {
+  static mutex* mu = new mutex;
+  return mu;
+}
+
+std::atomic<int64> next_bfc_allocator_uid{0};
+
+// Number of allocation ids a thread cache reserves at a time.
+constexpr int64 kCacheIdBatch = 1024;
+
+}  // namespace
+
+// The free chunks one thread holds for one allocator. Only that thread
+// touches the free lists.
+struct BFCAllocator::ThreadCache {
+  // Null once the allocator has been destroyed.
+  BFCAllocator* allocator;
+  int64 allocator_uid;
+  // Pointers as handed to callers, i.e. past the CacheHeader.
+  std::vector<void*> chunks[kNumCacheClasses];
+  // Allocation ids reserved by this cache: [next_id, id_limit).
+  int64 next_id = 0;
+  int64 id_limit = 0;
+};
+
+// The caches of the current thread, returned to their allocators when the
+// thread exits.
+class BFCAllocator::ThreadCacheSet {
+ public:
+  ThreadCacheSet() {}
+
+  ~ThreadCacheSet() {
+    mutex_lock l(*ThreadCacheRegistryMu());
+    for (ThreadCache* cache : caches_) {
+      BFCAllocator* allocator = cache->allocator;
+      if (allocator != nullptr) {
+        for (int c = 0; c < kNumCacheClasses; ++c) {
+          allocator->FlushCache(cache, c, 0);
+        }
+        allocator->retry_helper_.NotifyDealloc();
+        auto& all = allocator->thread_caches_;
+        all.erase(std::find(all.begin(), all.end(), cache));
+      }
+      delete cache;
+    }
+  }
+
+  ThreadCache* Find(int64 allocator_uid) const {
+    for (ThreadCache* cache : caches_) {
+      if (cache->allocator_uid == allocator_uid) return cache;
+    }
+    return nullptr;
+  }
+
+  ThreadCache* Create(BFCAllocator* allocator) {
+    mutex_lock l(*ThreadCacheRegistryMu());
+    // Drop the caches of allocators that no longer exist.
+    auto dead = std::remove_if(caches_.begin(), caches_.end(),
+                               [](ThreadCache* cache) {
+                                 if (cache->allocator != nullptr) return false;
+                                 delete cache;
+                                 return true;
+                               });
+    caches_.erase(dead, caches_.end());
+    ThreadCache* cache = new ThreadCache;
+    cache->allocator = allocator;
+    cache->allocator_uid = allocator->uid_;
+    caches_.push_back(cache);
+    allocator->thread_caches_.push_back(cache);
+    return cache;
+  }
+
+ private:
+  std::vector<ThreadCache*> caches_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ThreadCacheSet);
+};
+
 BFCAllocator::BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
-                           bool allow_growth, const string& name)
+                           bool allow_growth, const string& name,
+                           bool thread_caching)
     : suballocator_(sub_allocator),
       name_(name),
       free_chunks_list_(kInvalidChunkHandle),
-      next_allocation_id_(1) {
+      next_allocation_id_(1),
+      thread_caching_(thread_caching),
+      uid_(next_bfc_allocator_uid.fetch_add(1)) {
   if (allow_growth) {
     // 1MiB smallest initial allocation, unless total memory available
     // is less.
@@ -68,6 +154,14 @@ BFCAllocator::BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
 }
 
 BFCAllocator::~BFCAllocator() {
+  {
+    // Chunks still held by thread caches go away with the regions.
+    mutex_lock l(*ThreadCacheRegistryMu());
+    for (ThreadCache* cache : thread_caches_) {
+      cache->allocator = nullptr;
+    }
+  }
+
   // Return memory back.
   VLOG(2) << "Number of regions allocated: "
           << region_manager_.regions().size();
@@ -106,6 +200,11 @@ bool BFCAllocator::Extend(size_t alignment, size_t rounded_bytes) {
     increased_allocation = true;
   }
 
+  // Cached chunks are told apart by their offset from region starts.
+  if (thread_caching_) {
+    alignment = std::max(alignment, size_t{kMinAllocationSize});
+  }
+
   // Try allocating.
   size_t bytes = std::min(curr_region_allocation_bytes_, available_bytes);
   void* mem_addr = suballocator_->Alloc(alignment, bytes);
@@ -126,6 +225,10 @@ bool BFCAllocator::Extend(size_t alignment, size_t rounded_bytes) {
   if (mem_addr == nullptr) {
     return false;
   }
+  if (thread_caching_) {
+    CHECK_EQ(0, reinterpret_cast<uintptr_t>(mem_addr) % kMinAllocationSize)
+        << "Sub-allocator of " << Name() << " ignored the region alignment";
+  }
 
   if (!increased_allocation) {
     // Increase the region size of the next required allocation.
@@ -242,6 +345,12 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     LOG(ERROR) << "tried to allocate 0 bytes";
     return nullptr;
   }
+  if (thread_caching_) {
+    const int cache_class = CacheClassFor(unused_alignment, num_bytes);
+    if (cache_class >= 0) {
+      return AllocateCached(cache_class, num_bytes);
+    }
+  }
   // First, always allocate memory of at least kMinAllocationSize
   // bytes, and always allocate multiples of kMinAllocationSize bytes
   // so all memory addresses are nicely byte aligned.
@@ -252,16 +361,15 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
 
   mutex_lock l(lock_);
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-  if (ptr != nullptr) {
-    return ptr;
-  }
-
-  // Try to extend
-  if (Extend(unused_alignment, rounded_bytes)) {
+  if (ptr == nullptr && Extend(unused_alignment, rounded_bytes)) {
+    // Try again in the extended arena.
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-    if (ptr != nullptr) {
-      return ptr;
+  }
+  if (ptr != nullptr) {
+    if (thread_caching_) {
+      RecordAlloc(ChunkFromHandle(region_manager_.get_handle(ptr))->size);
     }
+    return ptr;
   }
 
   // We searched all bins for an existing free chunk to use and
@@ -368,6 +476,11 @@ void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
 }
 
 void BFCAllocator::DeallocateRaw(void* ptr) {
+  if (IsCachedPtr(ptr)) {
+    // Notifies the retry helper itself if memory goes back to the arena.
+    DeallocateCached(ptr);
+    return;
+  }
   DeallocateRawInternal(ptr);
   retry_helper_.NotifyDealloc();
 }
@@ -382,6 +495,9 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   // Find the chunk from the ptr.
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle);
+  if (thread_caching_) {
+    RecordFree(ChunkFromHandle(h)->size);
+  }
 
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
@@ -502,6 +618,9 @@ void BFCAllocator::AddAllocVisitor(Visitor visitor) {
 bool BFCAllocator::TracksAllocationSizes() { return true; }
 
 size_t BFCAllocator::RequestedSize(const void* ptr) {
+  if (IsCachedPtr(ptr)) {
+    return HeaderFor(ptr)->requested_size;
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -511,6 +630,10 @@ size_t BFCAllocator::RequestedSize(const void* ptr) {
 }
 
 size_t BFCAllocator::AllocatedSize(const void* ptr) {
+  if (IsCachedPtr(ptr)) {
+    return (kMinAllocationSize << HeaderFor(ptr)->cache_class) -
+           kCacheHeaderSize;
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -520,6 +643,9 @@ size_t BFCAllocator::AllocatedSize(const void* ptr) {
 }
 
 int64 BFCAllocator::AllocationId(const void* ptr) {
+  if (IsCachedPtr(ptr)) {
+    return HeaderFor(ptr)->allocation_id;
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -663,6 +789,11 @@ void BFCAllocator::DumpMemoryLog(size_t num_bytes) {
 void BFCAllocator::GetStats(AllocatorStats* stats) {
   mutex_lock l(lock_);
   *stats = stats_;
+  if (thread_caching_) {
+    stats->num_allocs = num_allocs_.load(std::memory_order_relaxed);
+    stats->bytes_in_use = live_bytes_.load(std::memory_order_relaxed);
+    stats->max_bytes_in_use = peak_bytes_.load(std::memory_order_relaxed);
+  }
 }
 
 void BFCAllocator::ClearStats() {
@@ -670,6 +801,105 @@ void BFCAllocator::ClearStats() {
   stats_.num_allocs = 0;
   stats_.max_bytes_in_use = stats_.bytes_in_use;
   stats_.max_alloc_size = 0;
+  num_allocs_.store(0, std::memory_order_relaxed);
+  peak_bytes_.store(live_bytes_.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+}
+
+int BFCAllocator::CacheClassFor(size_t alignment, size_t num_bytes) {
+  if (alignment > kCacheHeaderSize) return -1;
+  const size_t chunk_bytes = RoundedBytes(num_bytes + kCacheHeaderSize);
+  int cache_class = 0;
+  while ((kMinAllocationSize << cache_class) < chunk_bytes) {
+    if (++cache_class == kNumCacheClasses) return -1;
+  }
+  return cache_class;
+}
+
+// static
+size_t BFCAllocator::CacheClassCapacity(int cache_class) {
+  return std::max<size_t>(
+      2, kMaxCachedBytesPerClass / (kMinAllocationSize << cache_class));
+}
+
+BFCAllocator::ThreadCache* BFCAllocator::GetThreadCache() {
+  static thread_local ThreadCacheSet thread_caches;
+  ThreadCache* cache = thread_caches.Find(uid_);
+  return cache != nullptr ? cache : thread_caches.Create(this);
+}
+
+void BFCAllocator::RecordAlloc(int64 bytes) {
+  num_allocs_.fetch_add(1, std::memory_order_relaxed);
+  const int64 live =
+      live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64 peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (live > peak && !peak_bytes_.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void* BFCAllocator::AllocateCached(int cache_class, size_t num_bytes) {
+  ThreadCache* cache = GetThreadCache();
+  std::vector<void*>& chunks = cache->chunks[cache_class];
+  if (chunks.empty() && !RefillCache(cache, cache_class)) {
+    return nullptr;
+  }
+  void* ptr = chunks.back();
+  chunks.pop_back();
+  if (cache->next_id == cache->id_limit) {
+    cache->next_id = next_allocation_id_.fetch_add(kCacheIdBatch);
+    cache->id_limit = cache->next_id + kCacheIdBatch;
+  }
+  CacheHeader* header = HeaderFor(ptr);
+  header->requested_size = num_bytes;
+  header->allocation_id = cache->next_id++;
+  RecordAlloc(kMinAllocationSize << cache_class);
+  return ptr;
+}
+
+void BFCAllocator::DeallocateCached(void* ptr) {
+  const int cache_class = HeaderFor(ptr)->cache_class;
+  RecordFree(kMinAllocationSize << cache_class);
+  ThreadCache* cache = GetThreadCache();
+  std::vector<void*>& chunks = cache->chunks[cache_class];
+  chunks.push_back(ptr);
+  const size_t capacity = CacheClassCapacity(cache_class);
+  if (chunks.size() > capacity) {
+    FlushCache(cache, cache_class, capacity / 2);
+    retry_helper_.NotifyDealloc();
+  }
+}
+
+bool BFCAllocator::RefillCache(ThreadCache* cache, int cache_class) {
+  const size_t chunk_bytes = kMinAllocationSize << cache_class;
+  const BinNum bin_num = BinNumForSize(chunk_bytes);
+  const size_t batch = CacheClassCapacity(cache_class) / 2;
+  std::vector<void*>& chunks = cache->chunks[cache_class];
+  mutex_lock l(lock_);
+  while (chunks.size() < batch) {
+    void* chunk = FindChunkPtr(bin_num, chunk_bytes, chunk_bytes);
+    if (chunk == nullptr && Extend(kMinAllocationSize, chunk_bytes)) {
+      chunk = FindChunkPtr(bin_num, chunk_bytes, chunk_bytes);
+    }
+    if (chunk == nullptr) break;
+    CacheHeader* header = reinterpret_cast<CacheHeader*>(chunk);
+    header->cache_class = cache_class;
+    chunks.push_back(static_cast<char*>(chunk) + kCacheHeaderSize);
+  }
+  return !chunks.empty();
+}
+
+void BFCAllocator::FlushCache(ThreadCache* cache, int cache_class,
+                              size_t keep) {
+  std::vector<void*>& chunks = cache->chunks[cache_class];
+  if (chunks.size() <= keep) return;
+  mutex_lock l(lock_);
+  while (chunks.size() > keep) {
+    const ChunkHandle h = region_manager_.get_handle(HeaderFor(chunks.back()));
+    CHECK(h != kInvalidChunkHandle);
+    FreeAndMaybeCoalesce(h);
+    chunks.pop_back();
+  }
 }
 
 std::array<BFCAllocator::BinDebugInfo, BFCAllocator::kNumBins>
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_BFC_ALLOCATOR_H_
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -42,11 +43,20 @@ namespace tensorflow {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// With "thread_caching", requests of up to a few tens of KB are served from
+// per-thread caches of free chunks in a handful of power-of-two size classes,
+// without taking the allocator lock. A cache refills from and returns to the
+// shared arena in batches, and is returned in full when its thread exits.
+// Each cached chunk starts with a small header recording the current
+// allocation, so RequestedSize(), AllocatedSize(), AllocationId() and the
+// stats stay exact. Meant for host memory shared by many threads.
 class BFCAllocator : public VisitableAllocator {
  public:
   // Takes ownership of sub_allocator.
   BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
-               bool allow_growth, const string& name);
+               bool allow_growth, const string& name,
+               bool thread_caching = false);
   ~BFCAllocator() override;
 
   string Name() override { return name_; }
@@ -79,6 +89,49 @@ class BFCAllocator : public VisitableAllocator {
                             bool dump_log_on_failure);
   void DeallocateRawInternal(void* ptr);
 
+  // Thread caching. A cached chunk of class c is kMinAllocationSize << c
+  // bytes and starts with a CacheHeader; the caller gets the memory after
+  // it. Arena chunks start on kMinAllocationSize boundaries, so the offset
+  // of a pointer tells which kind it is.
+  struct CacheHeader {
+    size_t requested_size;
+    int64 allocation_id;
+    int cache_class;
+  };
+  struct ThreadCache;
+  class ThreadCacheSet;
+  static constexpr size_t kCacheHeaderSize = 64;
+  static constexpr int kNumCacheClasses = 9;  // 256B to 64KB chunks.
+  // Free bytes a thread may hold per class before returning some.
+  static constexpr size_t kMaxCachedBytesPerClass = 64 << 10;
+
+  // Returns the class serving "num_bytes" with "alignment", or -1.
+  int CacheClassFor(size_t alignment, size_t num_bytes);
+  static size_t CacheClassCapacity(int cache_class);
+  bool IsCachedPtr(const void* ptr) const {
+    return thread_caching_ &&
+           reinterpret_cast<uintptr_t>(ptr) % kMinAllocationSize ==
+               kCacheHeaderSize;
+  }
+  static CacheHeader* HeaderFor(const void* ptr) {
+    return reinterpret_cast<CacheHeader*>(
+        const_cast<char*>(static_cast<const char*>(ptr)) - kCacheHeaderSize);
+  }
+  ThreadCache* GetThreadCache();
+  void* AllocateCached(int cache_class, size_t num_bytes);
+  void DeallocateCached(void* ptr);
+  // Moves a batch of chunks of "cache_class" from the arena to "cache".
+  // Returns false if the arena is out of memory.
+  bool RefillCache(ThreadCache* cache, int cache_class);
+  // Returns the chunks of "cache_class" beyond "keep" to the arena.
+  void FlushCache(ThreadCache* cache, int cache_class, size_t keep);
+  // Counts an allocation or deallocation of "bytes" in the thread caching
+  // stats.
+  void RecordAlloc(int64 bytes);
+  void RecordFree(int64 bytes) {
+    live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   typedef size_t ChunkHandle;
@@ -439,12 +492,23 @@ class BFCAllocator : public VisitableAllocator {
   std::vector<Visitor> region_visitors_ GUARDED_BY(lock_);
 
   // Counter containing the next unique identifier to assign to a
-  // newly-created chunk.
-  int64 next_allocation_id_ GUARDED_BY(lock_);
+  // newly-created chunk. Thread caches reserve ranges of it without the lock.
+  std::atomic<int64> next_allocation_id_;
 
   // Stats.
   AllocatorStats stats_ GUARDED_BY(lock_);
 
+  // Thread caching state. Chunks held by caches count as in use in stats_,
+  // so with thread caching GetStats() reports these counters instead.
+  const bool thread_caching_;
+  // Identifies this allocator to the thread caches; never reused.
+  const int64 uid_;
+  std::atomic<int64> num_allocs_{0};
+  std::atomic<int64> live_bytes_{0};
+  std::atomic<int64> peak_bytes_{0};
+  // The caches of all threads, guarded by the registry mutex in the .cc file.
+  std::vector<ThreadCache*> thread_caches_;
+
   friend class GPUBFCAllocatorPrivateMethodsTest;
   TF_DISALLOW_COPY_AND_ASSIGN(BFCAllocator);
 };
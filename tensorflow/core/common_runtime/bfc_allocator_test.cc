@@ -0,0 +1,136 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/bfc_allocator.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/pool_allocator.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace {
+
+BFCAllocator* NewCachingAllocator() {
+  return new BFCAllocator(new BasicCPUAllocator(port::kNUMANoAffinity),
+                          1 << 30, true /*allow_growth*/, "cpu_bfc",
+                          true /*thread_caching*/);
+}
+
+TEST(BFCAllocatorThreadCachingTest, TracksSizesAndIds) {
+  std::unique_ptr<BFCAllocator> a(NewCachingAllocator());
+  ASSERT_TRUE(a->TracksAllocationSizes());
+
+  std::vector<void*> ptrs;
+  std::set<int64> ids;
+  // Small sizes are served from the thread cache, the largest from the arena.
+  for (size_t s : {1, 100, 1000, 10000, 60000, 1 << 20}) {
+    void* raw = a->AllocateRaw(32, s);
+    ASSERT_NE(nullptr, raw);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(raw) % 32);
+    EXPECT_EQ(s, a->RequestedSize(raw));
+    EXPECT_GE(a->AllocatedSize(raw), s);
+    EXPECT_TRUE(ids.insert(a->AllocationId(raw)).second);
+    ptrs.push_back(raw);
+  }
+
+  // Make sure none of them overlap.
+  std::sort(ptrs.begin(), ptrs.end());
+  for (size_t i = 1; i < ptrs.size(); i++) {
+    ASSERT_GE(static_cast<char*>(ptrs[i]) - static_cast<char*>(ptrs[i - 1]),
+              a->RequestedSize(ptrs[i - 1]));
+  }
+  for (void* p : ptrs) a->DeallocateRaw(p);
+
+  // A chunk reused from the cache gets a new id.
+  void* raw = a->AllocateRaw(32, 100);
+  EXPECT_EQ(100, a->RequestedSize(raw));
+  EXPECT_TRUE(ids.insert(a->AllocationId(raw)).second);
+  a->DeallocateRaw(raw);
+}
+
+TEST(BFCAllocatorThreadCachingTest, Stats) {
+  std::unique_ptr<BFCAllocator> a(NewCachingAllocator());
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 100; ++i) {
+    ptrs.push_back(a->AllocateRaw(32, 100 + i));
+  }
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_EQ(100, stats.num_allocs);
+  EXPECT_GT(stats.bytes_in_use, 100 * 100);
+  const int64 peak = stats.bytes_in_use;
+  EXPECT_EQ(peak, stats.max_bytes_in_use);
+
+  for (void* p : ptrs) a->DeallocateRaw(p);
+  a->GetStats(&stats);
+  EXPECT_EQ(100, stats.num_allocs);
+  EXPECT_EQ(0, stats.bytes_in_use);
+  EXPECT_EQ(peak, stats.max_bytes_in_use);
+
+  a->ClearStats();
+  a->GetStats(&stats);
+  EXPECT_EQ(0, stats.num_allocs);
+  EXPECT_EQ(0, stats.max_bytes_in_use);
+}
+
+TEST(BFCAllocatorThreadCachingTest, ManyThreads) {
+  std::unique_ptr<BFCAllocator> a(NewCachingAllocator());
+  const int kThreads = 8;
+  const int kAllocsPerThread = 2000;
+  // Each thread frees half of what it allocates and hands the rest to the
+  // main thread, so chunks move between caches.
+  std::vector<std::vector<void*>> leftovers(kThreads);
+  {
+    thread::ThreadPool pool(Env::Default(), "bfc_test", kThreads);
+    for (int t = 0; t < kThreads; ++t) {
+      pool.Schedule([&a, &leftovers, t]() {
+        std::vector<void*> live;
+        for (int i = 0; i < kAllocsPerThread; ++i) {
+          const size_t size = 1 + (i * 37 + t * 101) % 30000;
+          void* raw = a->AllocateRaw(16, size);
+          CHECK(raw != nullptr);
+          memset(raw, t, size);
+          live.push_back(raw);
+          if (i % 2 == 1) {
+            void* victim = live[live.size() - 2];
+            a->DeallocateRaw(victim);
+            live.erase(live.end() - 2);
+          }
+        }
+        leftovers[t] = live;
+      });
+    }
+  }
+
+  std::set<void*> unique;
+  for (const auto& live : leftovers) unique.insert(live.begin(), live.end());
+  EXPECT_EQ(kThreads * kAllocsPerThread / 2, unique.size());
+  for (void* p : unique) a->DeallocateRaw(p);
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_EQ(kThreads * kAllocsPerThread, stats.num_allocs);
+  EXPECT_EQ(0, stats.bytes_in_use);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,234 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/callable_batcher.h"
+
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Returns OK if every fetch can be split back into calls that together fed
+// "batch_size" rows.
+Status CheckFetchShapes(const std::vector<Tensor>& fetches,
+                        int64 batch_size) {
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    const Tensor& fetch = fetches[i];
+    if (fetch.dims() == 0 || fetch.dim_size(0) != batch_size) {
+      return errors::FailedPrecondition(
+          "Fetch ", i, " of a batched callable has shape ",
+          fetch.shape().DebugString(),
+          ", whose 0th dimension does not equal the batch size ", batch_size);
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+// One call of Run(). The pointers are owned by the caller, which waits for
+// "done".
+struct CallableBatcher::Task : public serving::BatchTask {
+  const std::vector<Tensor>* feeds;
+  std::vector<Tensor>* fetches;
+  RunMetadata* run_metadata;
+  int64 batch_size;
+  Status* status;
+  Notification* done;
+
+  size_t size() const override { return batch_size; }
+};
+
+constexpr int CallableBatcher::kMaxQueues;
+
+Status CallableBatcher::Create(const CallableOptions::BatchingOptions& options,
+                               RunFn run_fn,
+                               std::unique_ptr<CallableBatcher>* batcher) {
+  if (options.max_batch_size() <= 1) {
+    return errors::InvalidArgument("max_batch_size must be above 1, got ",
+                                   options.max_batch_size());
+  }
+  Scheduler::QueueOptions queue_options;
+  queue_options.max_batch_size = options.max_batch_size();
+  queue_options.batch_timeout_micros = options.batch_timeout_micros();
+  if (options.max_enqueued_batches() > 0) {
+    queue_options.max_enqueued_batches = options.max_enqueued_batches();
+  }
+  std::unique_ptr<CallableBatcher> new_batcher(
+      new CallableBatcher(std::move(run_fn), queue_options));
+
+  Scheduler::Options scheduler_options;
+  scheduler_options.thread_pool_name = "callable_batch_threads";
+  if (options.num_batch_threads() > 0) {
+    scheduler_options.num_batch_threads = options.num_batch_threads();
+  }
+  TF_RETURN_IF_ERROR(
+      Scheduler::Create(scheduler_options, &new_batcher->scheduler_));
+  *batcher = std::move(new_batcher);
+  return Status::OK();
+}
+
+CallableBatcher::~CallableBatcher() {
+  mutex_lock l(mu_);
+  queues_.clear();
+}
+
+int64 CallableBatcher::BatchSize(const std::vector<Tensor>& feeds) const {
+  if (feeds.empty()) return -1;
+  const int64 batch_size =
+      feeds[0].dims() > 0 ? feeds[0].dim_size(0) : static_cast<int64>(-1);
+  if (batch_size <= 0 || batch_size > queue_options_.max_batch_size) {
+    return -1;
+  }
+  for (const Tensor& feed : feeds) {
+    if (feed.dims() == 0 || feed.dim_size(0) != batch_size ||
+        feed.dtype() == DT_RESOURCE || feed.dtype() == DT_VARIANT) {
+      return -1;
+    }
+  }
+  return batch_size;
+}
+
+Status CallableBatcher::GetQueue(const std::vector<Tensor>& feeds,
+                                 Queue** queue) {
+  string signature;
+  for (const Tensor& feed : feeds) {
+    TensorShape shape = feed.shape();
+    shape.RemoveDim(0);
+    strings::StrAppend(&signature, DataTypeString(feed.dtype()),
+                       shape.DebugString(), ";");
+  }
+  mutex_lock l(mu_);
+  auto it = queues_.find(signature);
+  if (it != queues_.end()) {
+    *queue = it->second.get();
+    return Status::OK();
+  }
+  if (queues_.size() >= kMaxQueues) {
+    *queue = nullptr;
+    return Status::OK();
+  }
+  std::unique_ptr<Queue> new_queue;
+  TF_RETURN_IF_ERROR(scheduler_->AddQueue(
+      queue_options_,
+      [this](std::unique_ptr<Batch> batch) { ProcessBatch(std::move(batch)); },
+      &new_queue));
+  *queue = new_queue.get();
+  queues_[signature] = std::move(new_queue);
+  return Status::OK();
+}
+
+Status CallableBatcher::Run(const std::vector<Tensor>& feeds,
+                            std::vector<Tensor>* fetches,
+                            RunMetadata* run_metadata) {
+  const int64 batch_size = BatchSize(feeds);
+  Queue* queue = nullptr;
+  if (batch_size > 0) {
+    TF_RETURN_IF_ERROR(GetQueue(feeds, &queue));
+  }
+  if (queue == nullptr) {
+    return run_fn_(feeds, fetches, run_metadata);
+  }
+
+  Status status;
+  Notification done;
+  std::unique_ptr<Task> task(new Task);
+  task->feeds = &feeds;
+  task->fetches = fetches;
+  task->run_metadata = run_metadata;
+  task->batch_size = batch_size;
+  task->status = &status;
+  task->done = &done;
+  TF_RETURN_IF_ERROR(queue->Schedule(&task));
+  done.WaitForNotification();
+  return status;
+}
+
+void CallableBatcher::ProcessBatch(std::unique_ptr<Batch> batch) {
+  if (batch->empty()) return;
+  const Status status = RunBatch(batch.get());
+  for (int i = 0; i < batch->num_tasks(); ++i) {
+    Task* task = batch->mutable_task(i);
+    *task->status = status;
+    task->done->Notify();
+  }
+}
+
+Status CallableBatcher::RunBatch(Batch* batch) {
+  const int num_tasks = batch->num_tasks();
+  if (num_tasks == 1) {
+    // Checked like a larger batch, so that whether a call succeeds does not
+    // depend on how many others it was batched with.
+    Task* task = batch->mutable_task(0);
+    TF_RETURN_IF_ERROR(
+        run_fn_(*task->feeds, task->fetches, task->run_metadata));
+    return task->fetches == nullptr
+               ? Status::OK()
+               : CheckFetchShapes(*task->fetches, task->size());
+  }
+
+  const Task& first = batch->task(0);
+  std::vector<Tensor> feeds(first.feeds->size());
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    std::vector<Tensor> to_concat;
+    to_concat.reserve(num_tasks);
+    for (int j = 0; j < num_tasks; ++j) {
+      to_concat.push_back((*batch->task(j).feeds)[i]);
+    }
+    TF_RETURN_IF_ERROR(tensor::Concat(to_concat, &feeds[i]));
+  }
+
+  bool want_metadata = false;
+  for (int j = 0; j < num_tasks; ++j) {
+    want_metadata |= batch->task(j).run_metadata != nullptr;
+  }
+  std::vector<Tensor> fetches;
+  RunMetadata run_metadata;
+  TF_RETURN_IF_ERROR(
+      run_fn_(feeds, first.fetches == nullptr ? nullptr : &fetches,
+              want_metadata ? &run_metadata : nullptr));
+
+  if (first.fetches != nullptr) {
+    std::vector<int64> sizes;
+    sizes.reserve(num_tasks);
+    for (int j = 0; j < num_tasks; ++j) {
+      sizes.push_back(batch->task(j).size());
+    }
+    TF_RETURN_IF_ERROR(CheckFetchShapes(fetches, batch->size()));
+    for (int j = 0; j < num_tasks; ++j) {
+      batch->mutable_task(j)->fetches->resize(fetches.size());
+    }
+    for (size_t i = 0; i < fetches.size(); ++i) {
+      std::vector<Tensor> split;
+      TF_RETURN_IF_ERROR(tensor::Split(fetches[i], sizes, &split));
+      for (int j = 0; j < num_tasks; ++j) {
+        (*batch->mutable_task(j)->fetches)[i] = std::move(split[j]);
+      }
+    }
+  }
+  if (want_metadata) {
+    for (int j = 0; j < num_tasks; ++j) {
+      RunMetadata* task_metadata = batch->task(j).run_metadata;
+      if (task_metadata != nullptr) *task_metadata = run_metadata;
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace tensorflow
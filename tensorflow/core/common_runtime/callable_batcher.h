@@ -0,0 +1,102 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_CALLABLE_BATCHER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_CALLABLE_BATCHER_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+namespace tensorflow {
+
+// Coalesces concurrent runs of a callable into one step. The feeds of the
+// runs are concatenated along their 0th dimension, the callable is run once
+// on the result, and each fetch is split back along its 0th dimension.
+//
+// Only runs whose feeds have the same types and the same shapes apart from
+// the 0th dimension are batched together; each such signature gets its own
+// queue on a shared batch scheduler.
+class CallableBatcher {
+ public:
+  // Runs one step of the callable. "fetches" is null if the callable has
+  // no fetches.
+  typedef std::function<Status(const std::vector<Tensor>& feeds,
+                               std::vector<Tensor>* fetches,
+                               RunMetadata* run_metadata)>
+      RunFn;
+
+  // "options.max_batch_size" must be above 1.
+  static Status Create(const CallableOptions::BatchingOptions& options,
+                       RunFn run_fn, std::unique_ptr<CallableBatcher>* batcher);
+
+  // Blocks until all the runs that were scheduled have completed.
+  ~CallableBatcher();
+
+  // Runs the callable on "feeds", batched with concurrent calls where
+  // possible, and returns the slices of the fetches that belong to this
+  // call. Runs that cannot be batched, e.g. because a feed is a scalar or
+  // a resource, are run on their own in the calling thread.
+  Status Run(const std::vector<Tensor>& feeds, std::vector<Tensor>* fetches,
+             RunMetadata* run_metadata);
+
+ private:
+  struct Task;
+  typedef serving::SharedBatchScheduler<Task> Scheduler;
+  typedef serving::BatchScheduler<Task> Queue;
+  typedef serving::Batch<Task> Batch;
+
+  // The most distinct feed signatures that get a queue. Runs with other
+  // signatures are not batched.
+  static constexpr int kMaxQueues = 64;
+
+  CallableBatcher(RunFn run_fn, const Scheduler::QueueOptions& queue_options)
+      : run_fn_(std::move(run_fn)), queue_options_(queue_options) {}
+
+  // Returns the size of the batch dimension of "feeds", or -1 if they
+  // cannot be batched.
+  int64 BatchSize(const std::vector<Tensor>& feeds) const;
+
+  // Returns the queue for runs with the same signature as "feeds", or null
+  // if there are too many signatures.
+  Status GetQueue(const std::vector<Tensor>& feeds, Queue** queue);
+
+  void ProcessBatch(std::unique_ptr<Batch> batch);
+  Status RunBatch(Batch* batch);
+
+  const RunFn run_fn_;
+  const Scheduler::QueueOptions queue_options_;
+  std::shared_ptr<Scheduler> scheduler_;
+
+  mutex mu_;
+  // Keyed by the feed signature. Destroyed before scheduler_, which waits
+  // for their tasks to complete.
+  std::map<string, std::unique_ptr<Queue>> queues_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CallableBatcher);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_CALLABLE_BATCHER_H_
@@ -0,0 +1,174 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/callable_batcher.h"
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Doubles its only feed, and records the batch sizes it ran.
+class DoublingCallable {
+ public:
+  CallableBatcher::RunFn run_fn() {
+    return [this](const std::vector<Tensor>& feeds,
+                  std::vector<Tensor>* fetches, RunMetadata* run_metadata) {
+      {
+        mutex_lock l(mu_);
+        batch_sizes_.push_back(feeds[0].dim_size(0));
+      }
+      Tensor out(DT_FLOAT, feeds[0].shape());
+      auto in_flat = feeds[0].flat<float>();
+      auto out_flat = out.flat<float>();
+      for (int64 i = 0; i < in_flat.size(); ++i) {
+        out_flat(i) = 2 * in_flat(i);
+      }
+      fetches->assign({out});
+      return Status::OK();
+    };
+  }
+
+  std::vector<int64> batch_sizes() {
+    mutex_lock l(mu_);
+    return batch_sizes_;
+  }
+
+ private:
+  mutex mu_;
+  std::vector<int64> batch_sizes_ GUARDED_BY(mu_);
+};
+
+// Runs "batcher" on num_calls threads at once; call i feeds a [1, 2] tensor
+// of "i"s, plus "extra_columns" columns.
+void RunConcurrently(CallableBatcher* batcher, int num_calls,
+                     const std::function<int(int)>& extra_columns) {
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int i = 0; i < num_calls; ++i) {
+    threads.emplace_back(
+        Env::Default()->StartThread(ThreadOptions(), "caller", [=]() {
+          const int columns = 2 + extra_columns(i);
+          Tensor feed(DT_FLOAT, TensorShape({1, columns}));
+          feed.flat<float>().setConstant(i);
+          std::vector<Tensor> fetches;
+          TF_EXPECT_OK(batcher->Run({feed}, &fetches, nullptr));
+          ASSERT_EQ(1, fetches.size());
+          Tensor expected(DT_FLOAT, TensorShape({1, columns}));
+          expected.flat<float>().setConstant(2 * i);
+          test::ExpectTensorEqual<float>(expected, fetches[0]);
+        }));
+  }
+}
+
+TEST(CallableBatcherTest, CoalescesConcurrentCalls) {
+  DoublingCallable callable;
+  CallableOptions::BatchingOptions options;
+  options.set_max_batch_size(8);
+  options.set_batch_timeout_micros(10 * 1000 * 1000);
+  options.set_num_batch_threads(1);
+  std::unique_ptr<CallableBatcher> batcher;
+  TF_ASSERT_OK(CallableBatcher::Create(options, callable.run_fn(), &batcher));
+
+  // The batch fills up long before it times out.
+  RunConcurrently(batcher.get(), 8, [](int i) { return 0; });
+  EXPECT_EQ(std::vector<int64>({8}), callable.batch_sizes());
+}
+
+TEST(CallableBatcherTest, BatchesCompatibleShapesOnly) {
+  DoublingCallable callable;
+  CallableOptions::BatchingOptions options;
+  options.set_max_batch_size(4);
+  options.set_batch_timeout_micros(10 * 1000 * 1000);
+  options.set_num_batch_threads(2);
+  std::unique_ptr<CallableBatcher> batcher;
+  TF_ASSERT_OK(CallableBatcher::Create(options, callable.run_fn(), &batcher));
+
+  RunConcurrently(batcher.get(), 8, [](int i) { return i % 2; });
+  EXPECT_EQ(std::vector<int64>({4, 4}), callable.batch_sizes());
+}
+
+TEST(CallableBatcherTest, RunsScalarFeedsAlone) {
+  DoublingCallable callable;
+  CallableOptions::BatchingOptions options;
+  options.set_max_batch_size(4);
+  options.set_batch_timeout_micros(10 * 1000 * 1000);
+  std::unique_ptr<CallableBatcher> batcher;
+  TF_ASSERT_OK(CallableBatcher::Create(options, callable.run_fn(), &batcher));
+
+  std::vector<Tensor> fetches;
+  TF_ASSERT_OK(batcher->Run({test::AsScalar<float>(3)}, &fetches, nullptr));
+  test::ExpectTensorEqual<float>(test::AsScalar<float>(6), fetches[0]);
+}
+
+TEST(CallableBatcherTest, ReportsUnsplittableFetches) {
+  CallableOptions::BatchingOptions options;
+  options.set_max_batch_size(2);
+  options.set_batch_timeout_micros(10 * 1000 * 1000);
+  std::unique_ptr<CallableBatcher> batcher;
+  TF_ASSERT_OK(CallableBatcher::Create(
+      options,
+      [](const std::vector<Tensor>& feeds, std::vector<Tensor>* fetches,
+         RunMetadata* run_metadata) {
+        fetches->assign({test::AsScalar<float>(0)});
+        return Status::OK();
+      },
+      &batcher));
+
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back(
+        Env::Default()->StartThread(ThreadOptions(), "caller", [&batcher]() {
+          std::vector<Tensor> fetches;
+          Status s = batcher->Run({test::AsTensor<float>({1})}, &fetches,
+                                  nullptr);
+          EXPECT_TRUE(errors::IsFailedPrecondition(s)) << s;
+        }));
+  }
+}
+
+TEST(CallableBatcherTest, ChecksFetchesOfCallsBatchedAlone) {
+  CallableOptions::BatchingOptions options;
+  options.set_max_batch_size(2);
+  options.set_batch_timeout_micros(0);
+  std::unique_ptr<CallableBatcher> batcher;
+  TF_ASSERT_OK(CallableBatcher::Create(
+      options,
+      [](const std::vector<Tensor>& feeds, std::vector<Tensor>* fetches,
+         RunMetadata* run_metadata) {
+        fetches->assign({test::AsScalar<float>(0)});
+        return Status::OK();
+      },
+      &batcher));
+
+  // A batch of one fails like a larger one would.
+  std::vector<Tensor> fetches;
+  Status s = batcher->Run({test::AsTensor<float>({1})}, &fetches, nullptr);
+  EXPECT_TRUE(errors::IsFailedPrecondition(s)) << s;
+}
+
+TEST(CallableBatcherTest, RejectsSmallMaxBatchSize) {
+  CallableOptions::BatchingOptions options;
+  options.set_max_batch_size(1);
+  std::unique_ptr<CallableBatcher> batcher;
+  EXPECT_TRUE(errors::IsInvalidArgument(
+      CallableBatcher::Create(options, nullptr, &batcher)));
+}
+
+}  // namespace
+}  // namespace tensorflow
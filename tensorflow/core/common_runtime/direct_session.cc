@@ -15,10 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/direct_session.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <string>
 #include <vector>
 
+#include "tensorflow/core/common_runtime/callable_batcher.h"
 #include "tensorflow/core/common_runtime/collective_executor_mgr.h"
 #include "tensorflow/core/common_runtime/collective_param_resolver_local.h"
 #include "tensorflow/core/common_runtime/constant_folding.h"
@@ -33,12 +36,16 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/optimization_registry.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
+#include "tensorflow/core/common_runtime/shape_refiner.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/common_runtime/step_tracer.h"
+#include "tensorflow/core/common_runtime/unified_thread_pool.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb_text.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/graph_def_util.h"
 #include "tensorflow/core/framework/log_memory.h"
+#include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/versions.pb.h"
@@ -56,6 +63,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
@@ -75,6 +83,13 @@ auto* direct_session_runs = monitoring::Counter<0>::New(
     "/tensorflow/core/direct_session_runs",
     "The number of times DirectSession::Run() has been called.");
 
+auto* direct_session_core_utilization = monitoring::Sampler<0>::New(
+    {"/tensorflow/core/direct_session_core_utilization",
+     "The fraction of the unified thread pool's worker time spent busy "
+     "during a DirectSession step."},
+    monitoring::Buckets::Explicit({0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8,
+                                   0.9, 1.0}));
+
 Status NewThreadPoolFromThreadPoolOptions(
     const SessionOptions& options,
     const ThreadPoolOptionProto& thread_pool_options, int pool_number,
@@ -137,6 +152,40 @@ string GetRendezvousKey(const string& tensor_name,
                          frame_iter.frame_id, ":", frame_iter.iter_id);
 }
 
+// Returns an error if a fetch of a batched callable is known not to have
+// the batch as its 0th dimension: a scalar, or a tensor whose 0th dimension
+// is fixed regardless of the feeds. Shapes come from shape inference on the
+// partition graphs, whose feeds have unknown shapes. Fetches whose shapes
+// are not known are checked on every batch instead.
+Status CheckBatchableFetches(const CallableOptions& callable_options,
+                             const std::vector<Graph*>& graphs) {
+  for (const Graph* graph : graphs) {
+    ShapeRefiner refiner(graph->versions(), graph->op_registry());
+    refiner.set_require_shape_inference_fns(false);
+    std::vector<Node*> order;
+    GetReversePostOrder(*graph, &order);
+    for (const Node* n : order) {
+      if (!n->IsOp()) continue;
+      // Shapes are only a hint here, so stop at the first node that cannot
+      // be inferred.
+      if (!refiner.AddNode(n).ok()) break;
+      if (n->type_string() != FunctionLibraryDefinition::kRetOp) continue;
+      int index;
+      TF_RETURN_IF_ERROR(GetNodeAttr(n->attrs(), "index", &index));
+      shape_inference::InferenceContext* c = refiner.GetContext(n);
+      const shape_inference::ShapeHandle shape = c->input(0);
+      if (!c->RankKnown(shape)) continue;
+      if (c->Rank(shape) == 0 || c->ValueKnown(c->Dim(shape, 0))) {
+        return errors::InvalidArgument(
+            "Fetch ", callable_options.fetch(index), " has shape ",
+            c->DebugString(shape),
+            ", which cannot be split along the batch of a batched callable.");
+      }
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace
 
 class DirectSessionFactory : public SessionFactory {
@@ -236,7 +285,9 @@ void DirectSession::SchedClosure(thread::ThreadPool* pool,
   // safe given the reasoning above.
   c();
 #else
-  if (pool != nullptr) {
+  if (unified_pool_ != nullptr && pool == unified_pool_->workers()) {
+    unified_pool_->Schedule(std::move(c));
+  } else if (pool != nullptr) {
     pool->Schedule(std::move(c));
   } else {
     c();
@@ -263,6 +314,13 @@ DirectSession::DirectSession(const SessionOptions& options,
           &owned));
       thread_pools_.emplace_back(pool, owned);
     }
+    if (options_.config.experimental().use_unified_thread_pool()) {
+      LOG(WARNING) << "use_unified_thread_pool is ignored for inter-op work "
+                      "when session_inter_op_thread_pool is set.";
+    }
+  } else if (options_.config.experimental().use_unified_thread_pool()) {
+    unified_pool_ = UnifiedComputePool(options_);
+    thread_pools_.emplace_back(unified_pool_->workers(), false /* owned */);
   } else if (options_.config.use_per_session_threads()) {
     thread_pools_.emplace_back(NewThreadPoolFromSessionOptions(options_),
                                true /* owned */);
@@ -276,6 +334,12 @@ DirectSession::DirectSession(const SessionOptions& options,
   if (!status.ok()) {
     LOG(ERROR) << status.error_message();
   }
+  const float step_trace_sampling_rate =
+      options_.config.experimental().step_trace_sampling_rate();
+  if (step_trace_sampling_rate > 0) {
+    step_trace_sampling_period_ = std::max<int64>(
+        1, std::llround(1.0 / std::min(1.0f, step_trace_sampling_rate)));
+  }
   // NOTE(mrry): We do not need to use a unique string for the session
   // handle, because DirectSession owns its devices. This may change
   // in future versions.
@@ -520,11 +584,26 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
           ((measure_step_count + 1) % build_cost_model_every == 0);
     }
   }
+  // The binary trace cannot replace NodeExecStats that feed a cost model
+  // or an OOM report.
+  const bool binary_trace =
+      do_trace && run_options.experimental().use_binary_step_trace() &&
+      !update_cost_model && !run_options.report_tensor_allocations_upon_oom();
   if (do_trace || update_cost_model ||
       run_options.report_tensor_allocations_upon_oom()) {
+    // The collector also receives the device tracer's stats.
     run_state.collector.reset(
         new StepStatsCollector(run_metadata->mutable_step_stats()));
-    args.stats_collector = run_state.collector.get();
+    if (!binary_trace) args.stats_collector = run_state.collector.get();
+  }
+  // A sampled step that is not otherwise traced returns its binary trace in
+  // run_metadata too.
+  const bool sampled_trace =
+      args.stats_collector == nullptr && !binary_trace &&
+      run_metadata != nullptr && step_trace_sampling_period_ > 0 &&
+      step_id % step_trace_sampling_period_ == 0;
+  if (binary_trace || sampled_trace) {
+    args.step_tracer = StepTracer::Global();
   }
 
   std::unique_ptr<DeviceTracer> tracer;
@@ -582,6 +661,10 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
     }
   }
 
+  const uint64 start_nanos = options_.env->NowNanos();
+  const int64 start_busy_nanos =
+      unified_pool_ != nullptr ? unified_pool_->busy_nanos() : 0;
+
   Executor::Args::Runner default_runner = [this,
                                            pool](Executor::Args::Closure c) {
     SchedClosure(pool, std::move(c));
@@ -607,6 +690,22 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
                           ? run_options.timeout_in_ms()
                           : operation_timeout_in_ms_);
 
+  if (unified_pool_ != nullptr) {
+    // Concurrent steps share the workers, so this is the utilization of the
+    // whole pool while the step ran.
+    const uint64 elapsed_nanos = options_.env->NowNanos() - start_nanos;
+    if (elapsed_nanos > 0) {
+      const double utilization = std::min(
+          1.0, static_cast<double>(unified_pool_->busy_nanos() -
+                                   start_busy_nanos) /
+                   (static_cast<double>(elapsed_nanos) *
+                    unified_pool_->NumThreads()));
+      direct_session_core_utilization->GetCell()->Add(utilization);
+      VLOG(1) << "Core utilization of step " << step_id << ": "
+              << utilization;
+    }
+  }
+
   if (!cancellation_manager_->DeregisterCallback(cancellation_token)) {
     // The step has been cancelled: make sure we don't attempt to receive the
     // outputs as this would make it block forever.
@@ -635,6 +734,10 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   if (run_state.collector) {
     run_state.collector->Finalize();
   }
+  if (binary_trace || sampled_trace) {
+    StepTracer::Global()->ExportStepStats(step_id,
+                                          run_metadata->mutable_step_stats());
+  }
 
   // Build and return the cost model as instructed.
   if (update_cost_model) {
@@ -1199,6 +1302,8 @@ Status DirectSession::CreateExecutors(
     LocalExecutorParams params;
     params.device = device;
     params.function_library = lib;
+    params.use_static_memory_plan =
+        options_.config.experimental().use_static_memory_plan();
     auto opseg = device->op_segment();
     params.create_kernel = [this, lib, opseg](const NodeDef& ndef,
                                               OpKernel** kernel) {
@@ -1667,15 +1772,57 @@ Status DirectSession::MakeCallable(const CallableOptions& callable_options,
   TF_RETURN_IF_ERROR(CheckNotClosed());
   TF_RETURN_IF_ERROR(CheckGraphCreated("MakeCallable()"));
 
+  const CallableOptions::BatchingOptions& batching_options =
+      callable_options.batching_options();
+  const bool use_batching = batching_options.max_batch_size() > 1;
+  if (use_batching) {
+    // The batcher concatenates and splits tensors on the host, so tensors
+    // may only be fed or fetched through CPU devices.
+    for (const auto* devices : {&callable_options.feed_devices(),
+                                &callable_options.fetch_devices()}) {
+      for (const auto& tensor_and_device : *devices) {
+        Device* device;
+        TF_RETURN_IF_ERROR(
+            device_mgr_->LookupDevice(tensor_and_device.second, &device));
+        if (device->device_type() != DEVICE_CPU) {
+          return errors::InvalidArgument(
+              "Batched callables must feed and fetch tensors in host memory, "
+              "but ", tensor_and_device.first, " is on ",
+              tensor_and_device.second);
+        }
+      }
+    }
+  }
+
   std::unique_ptr<ExecutorsAndKeys> ek;
   std::unique_ptr<FunctionInfo> func_info;
   RunStateArgs run_state_args(callable_options.run_options().debug_options());
   TF_RETURN_IF_ERROR(
       CreateExecutors(callable_options, &ek, &func_info, &run_state_args));
+  std::unique_ptr<CallableBatcher> batcher;
+  if (use_batching) {
+    std::vector<Graph*> graphs;
+    for (const PerPartitionExecutorsAndLib& item : ek->items) {
+      graphs.push_back(item.graph);
+    }
+    TF_RETURN_IF_ERROR(CheckBatchableFetches(callable_options, graphs));
+    // Every caller holds on to the executors while its run is batched.
+    ExecutorsAndKeys* executors_and_keys = ek.get();
+    TF_RETURN_IF_ERROR(CallableBatcher::Create(
+        batching_options,
+        [this, executors_and_keys](const std::vector<Tensor>& feed_tensors,
+                                   std::vector<Tensor>* fetch_tensors,
+                                   RunMetadata* run_metadata) {
+          return RunCallableStep(executors_and_keys, feed_tensors,
+                                 fetch_tensors, run_metadata);
+        },
+        &batcher));
+  }
   {
     mutex_lock l(callables_lock_);
     *out_handle = next_callable_handle_++;
-    callables_[*out_handle] = {std::move(ek), std::move(func_info)};
+    callables_[*out_handle] = {std::move(ek), std::move(func_info),
+                               std::move(batcher)};
   }
   return Status::OK();
 }
@@ -1734,7 +1881,7 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
 
   // Check if we already have an executor for these arguments.
   std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
-  const int64 step_id = step_id_counter_.fetch_add(1);
+  std::shared_ptr<CallableBatcher> batcher;
 
   {
     tf_shared_lock l(callables_lock_);
@@ -1742,6 +1889,7 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
       return errors::InvalidArgument("No such callable handle: ", handle);
     }
     executors_and_keys = callables_[handle].executors_and_keys;
+    batcher = callables_[handle].batcher;
   }
 
   if (!executors_and_keys) {
@@ -1749,6 +1897,30 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
         "Attempted to run callable after handle was released: ", handle);
   }
 
+  if (feed_tensors.size() != executors_and_keys->input_types.size()) {
+    return errors::InvalidArgument(
+        "Expected ", executors_and_keys->input_types.size(),
+        " feed tensors, but got ", feed_tensors.size());
+  }
+  if (fetch_tensors == nullptr && !executors_and_keys->output_types.empty()) {
+    return errors::InvalidArgument(
+        "`fetch_tensors` must be provided when the callable has one or more "
+        "outputs.");
+  }
+
+  if (batcher != nullptr) {
+    return batcher->Run(feed_tensors, fetch_tensors, run_metadata);
+  }
+  return RunCallableStep(executors_and_keys.get(), feed_tensors, fetch_tensors,
+                         run_metadata);
+}
+
+::tensorflow::Status DirectSession::RunCallableStep(
+    ExecutorsAndKeys* executors_and_keys,
+    const std::vector<Tensor>& feed_tensors, std::vector<Tensor>* fetch_tensors,
+    RunMetadata* run_metadata) {
+  const int64 step_id = step_id_counter_.fetch_add(1);
+
   // NOTE(mrry): Debug options are not currently supported in the
   // callable interface.
   DebugOptions debug_options;
@@ -1756,23 +1928,14 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
 
   // Configure a call frame for the step, which we use to feed and
   // fetch values to and from the executors.
-  if (feed_tensors.size() != executors_and_keys->input_types.size()) {
-    return errors::InvalidArgument(
-        "Expected ", executors_and_keys->input_types.size(),
-        " feed tensors, but got ", feed_tensors.size());
-  }
   if (fetch_tensors != nullptr) {
     fetch_tensors->resize(executors_and_keys->output_types.size());
-  } else if (!executors_and_keys->output_types.empty()) {
-    return errors::InvalidArgument(
-        "`fetch_tensors` must be provided when the callable has one or more "
-        "outputs.");
   }
 
   // A specialized CallFrame implementation that takes advantage of the
   // optimized RunCallable interface.
 
-  RunCallableCallFrame call_frame(this, executors_and_keys.get(), &feed_tensors,
+  RunCallableCallFrame call_frame(this, executors_and_keys, &feed_tensors,
                                   fetch_tensors);
 
   if (LogMemory::IsEnabled()) {
@@ -1781,7 +1944,7 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
 
   TF_RETURN_IF_ERROR(
       RunInternal(step_id, executors_and_keys->callable_options.run_options(),
-                  &call_frame, executors_and_keys.get(), run_metadata));
+                  &call_frame, executors_and_keys, run_metadata));
 
   return Status::OK();
 }
@@ -1800,7 +1963,8 @@ DirectSession::Callable::~Callable() {
   // of `executors_and_keys` will call into an object owned by
   // `function_info` (in particular, when deleting a kernel, it relies
   // on the `FunctionLibraryRuntime` to know if the kernel is stateful
-  // or not).
+  // or not). `batcher` runs steps with `executors_and_keys`.
+  batcher.reset();
   executors_and_keys.reset();
   function_info.reset();
 }
@@ -47,10 +47,12 @@ limitations under the License.
 
 namespace tensorflow {
 
+class CallableBatcher;
 class CostModel;
 class DebugGateway;
 class Device;
 class DirectSessionFactory;
+class UnifiedThreadPool;
 
 class DirectSession : public Session {
  public:
@@ -247,6 +249,13 @@ class DirectSession : public Session {
                                    ExecutorsAndKeys* executors_and_keys,
                                    RunMetadata* run_metadata);
 
+  // Runs one step of the callable with "executors_and_keys", which must
+  // stay alive until it returns.
+  ::tensorflow::Status RunCallableStep(ExecutorsAndKeys* executors_and_keys,
+                                       const std::vector<Tensor>& feed_tensors,
+                                       std::vector<Tensor>* fetch_tensors,
+                                       RunMetadata* run_metadata);
+
   ::tensorflow::Status ExtendLocked(const GraphDef& graph)
       EXCLUSIVE_LOCKS_REQUIRED(graph_def_lock_);
 
@@ -322,10 +331,19 @@ class DirectSession : public Session {
   // is owned.
   std::vector<std::pair<thread::ThreadPool*, bool>> thread_pools_;
 
+  // If not null, thread_pools_ holds only its workers, and closures for
+  // them are scheduled through it.
+  UnifiedThreadPool* unified_pool_ = nullptr;
+
   Status init_error_;  // Set to an error if construction failed.
 
   // If true, blocks until device has finished all queued operations in a step.
   bool sync_on_finish_ = true;
+
+  // If positive, one in this many untraced steps is recorded in the
+  // StepTracer and returned in RunMetadata.step_stats, from
+  // ConfigProto.Experimental.step_trace_sampling_rate.
+  int64 step_trace_sampling_period_ = 0;
   // Schedules 'c' for execution on pool.
   void SchedClosure(thread::ThreadPool* pool, std::function<void()> c);
 
@@ -345,6 +363,8 @@ class DirectSession : public Session {
   struct Callable {
     std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
     std::shared_ptr<FunctionInfo> function_info;
+    // Set if CallableOptions.batching_options enables batching.
+    std::shared_ptr<CallableBatcher> batcher;
     ~Callable();
   };
   mutex callables_lock_;
@@ -40,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/monitoring/collection_registry.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
@@ -505,6 +506,60 @@ TEST_F(DirectSessionMinusAXTest, TestPerSessionThreads) {
   delete tp;
 }
 
+// Returns the number of steps recorded by the direct_session_core_utilization
+// metric.
+int64 NumUtilizationSamples() {
+  std::unique_ptr<monitoring::CollectedMetrics> metrics =
+      monitoring::CollectionRegistry::Default()->CollectMetrics(
+          monitoring::CollectionRegistry::CollectMetricsOptions());
+  auto it = metrics->point_set_map.find(
+      "/tensorflow/core/direct_session_core_utilization");
+  if (it == metrics->point_set_map.end() || it->second->points.empty()) {
+    return 0;
+  }
+  return it->second->points[0]->histogram_value.num();
+}
+
+TEST_F(DirectSessionMinusAXTest, TestUnifiedThreadPool) {
+  Initialize({1, 2, 3, 4});
+
+  SessionOptions options;
+  options.config.mutable_experimental()->set_use_unified_thread_pool(true);
+  (*options.config.mutable_device_count())["CPU"] = 2;
+  std::unique_ptr<Session> session(NewSession(options));
+
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+
+  const int64 samples_before = NumUtilizationSamples();
+  thread::ThreadPool* tp = new thread::ThreadPool(Env::Default(), "test", 4);
+
+  // Run the graph 100 times in 4 different threads concurrently.
+  std::vector<string> output_names = {y_ + ":0"};
+  auto fn = [&session, output_names]() {
+    for (int i = 0; i < 100; ++i) {
+      std::vector<std::pair<string, Tensor>> inputs;
+      std::vector<Tensor> outputs;
+      // Run the graph
+      Status s = session->Run(inputs, output_names, {}, &outputs);
+      TF_ASSERT_OK(s);
+      ASSERT_EQ(1, outputs.size());
+      auto mat = outputs[0].matrix<float>();
+      EXPECT_FLOAT_EQ(3.0, mat(0, 0));
+    }
+  };
+
+  for (int i = 0; i < 4; ++i) {
+    tp->Schedule(fn);
+  }
+
+  // Wait for the functions to finish.
+  delete tp;
+
+  // Every step recorded the utilization of the pool.
+  EXPECT_EQ(samples_before + 4 * 100, NumUtilizationSamples());
+}
+
 TEST_F(DirectSessionMinusAXTest, TwoCreateCallsFails) {
   Initialize({1, 2, 3, 4});
   auto session = CreateSession();
@@ -593,6 +648,25 @@ TEST_F(DirectSessionMinusAXTest, RunSimpleNetworkWithOpts) {
   EXPECT_EQ(run_metadata.step_stats().dev_stats_size(), 2);
 }
 
+TEST_F(DirectSessionMinusAXTest, ReturnsSampledStepTraces) {
+  Initialize({3, 2, -1, 0});
+  SessionOptions options;
+  (*options.config.mutable_device_count())["CPU"] = 2;
+  options.config.mutable_experimental()->set_step_trace_sampling_rate(1.0);
+  std::unique_ptr<Session> session(NewSession(options));
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+
+  // Untraced steps that are sampled return their binary traces.
+  std::vector<Tensor> outputs;
+  RunMetadata run_metadata;
+  TF_ASSERT_OK(session->Run(RunOptions(), {}, {y_ + ":0"}, {y_neg_},
+                            &outputs, &run_metadata));
+  ASSERT_EQ(1, outputs.size());
+  EXPECT_FLOAT_EQ(5.0, outputs[0].matrix<float>()(0, 0));
+  EXPECT_EQ(2, run_metadata.step_stats().dev_stats_size());
+}
+
 TEST_F(DirectSessionMinusAXTest, RunSimpleNetworkWithOpts_Callable) {
   Initialize({3, 2, -1, 0});
   auto session = CreateSession();
@@ -820,6 +894,76 @@ TEST(DirectSessionTest, MultipleFeedTest_Callable) {
   EXPECT_TRUE(str_util::StrContains(s.error_message(), "fed more than once"));
 }
 
+TEST(DirectSessionTest, BatchedCallable) {
+  GraphDef def;
+  Graph g(OpRegistry::Global());
+  Tensor value(DT_FLOAT, TensorShape({1, 2}));
+  value.flat<float>().setZero();
+  Node* x = test::graph::Constant(&g, value);
+  Node* neg = test::graph::Unary(&g, "Neg", x);
+  test::graph::ToGraphDef(&g, &def);
+
+  auto session = CreateSession();
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def));
+
+  CallableOptions callable_options =
+      MakeCallableOptions({x->name()}, {neg->name() + ":0"}, {});
+  callable_options.mutable_batching_options()->set_max_batch_size(4);
+  callable_options.mutable_batching_options()->set_batch_timeout_micros(1000);
+  Session::CallableHandle handle;
+  TF_ASSERT_OK(session->MakeCallable(callable_options, &handle));
+
+  // Concurrent calls feeding one or two rows each get their own rows back.
+  thread::ThreadPool* tp = new thread::ThreadPool(Env::Default(), "test", 4);
+  for (int t = 0; t < 4; ++t) {
+    tp->Schedule([&session, handle, t]() {
+      for (int i = 0; i < 100; ++i) {
+        const float v = t * 100 + i;
+        Tensor feed(DT_FLOAT, TensorShape({1 + t % 2, 2}));
+        feed.flat<float>().setConstant(v);
+        std::vector<Tensor> outputs;
+        TF_ASSERT_OK(session->RunCallable(handle, {feed}, &outputs, nullptr));
+        ASSERT_EQ(1, outputs.size());
+        EXPECT_EQ(feed.shape(), outputs[0].shape());
+        EXPECT_EQ(-v, outputs[0].flat<float>()(0));
+        EXPECT_EQ(-v, outputs[0].flat<float>()(outputs[0].NumElements() - 1));
+      }
+    });
+  }
+  delete tp;
+
+  // Feeding and fetching through a CPU device keeps the tensors in host
+  // memory, which the batcher can concatenate and split.
+  (*callable_options.mutable_feed_devices())[x->name()] =
+      "/job:localhost/replica:0/task:0/device:CPU:0";
+  TF_EXPECT_OK(session->MakeCallable(callable_options, &handle));
+}
+
+TEST(DirectSessionTest, BatchedCallableRejectsScalarFetches) {
+  GraphDef def;
+  Graph g(OpRegistry::Global());
+  Tensor value(DT_FLOAT, TensorShape({1, 2}));
+  value.flat<float>().setZero();
+  Node* x = test::graph::Constant(&g, value);
+  Node* neg = test::graph::Unary(&g, "Neg", x);
+  Node* scalar = test::graph::Constant(&g, test::AsScalar<float>(1));
+  test::graph::ToGraphDef(&g, &def);
+
+  auto session = CreateSession();
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def));
+
+  // The scalar does not have a batch dimension to split, whatever is fed.
+  CallableOptions callable_options = MakeCallableOptions(
+      {x->name()}, {neg->name() + ":0", scalar->name() + ":0"}, {});
+  callable_options.mutable_batching_options()->set_max_batch_size(4);
+  Session::CallableHandle handle;
+  Status s = session->MakeCallable(callable_options, &handle);
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+  EXPECT_TRUE(str_util::StrContains(s.error_message(), scalar->name())) << s;
+}
+
 TEST(DirectSessionTest, TestTensorConnectionUseTwice) {
   Graph graph(OpRegistry::Global());
 
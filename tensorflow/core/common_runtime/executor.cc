@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/executor.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <memory>
@@ -24,8 +25,10 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/memory_planner.h"
 #include "tensorflow/core/common_runtime/pending_counts.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/common_runtime/step_tracer.h"
 #include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -52,6 +55,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
@@ -68,6 +72,12 @@ namespace {
 // 1-D, 0 element tensor.
 static const Tensor* const kEmptyTensor = new Tensor;
 
+auto* executor_step_allocations = monitoring::Sampler<0>::New(
+    {"/tensorflow/core/executor_step_allocations",
+     "The number of executor, frame and iteration states a step allocated "
+     "rather than reused from earlier steps."},
+    monitoring::Buckets::Exponential(1, 2, 16));
+
 bool IsInitializationOp(const Node* node) {
   return node->op_def().allows_uninitialized_input();
 }
@@ -117,6 +127,11 @@ void SetReferencedTensors(NodeExecStatsWrapper* stats,
   stats->SetReferencedTensors(tensors);
 }
 
+void SetUnforwardedOutputBytes(NodeExecStatsWrapper* stats, int64 bytes) {
+  if (!stats) return;
+  stats->SetUnforwardedOutputBytes(bytes);
+}
+
 // Sets the timeline_label field of *stats, using data from *node.
 // Returns true iff the node is a transfer node.
 bool SetTimelineLabel(const Node* node, NodeExecStatsWrapper* stats) {
@@ -130,6 +145,7 @@ bool SetTimelineLabel(const Node* node, NodeExecStatsWrapper* stats) {
 
 class ExecutorImpl;
 class GraphView;
+class IterationStatePool;
 
 struct EdgeInfo {
   int dst_id;
@@ -157,6 +173,8 @@ struct NodeItem {
   bool is_sink : 1;              // True iff IsSink(node)
   // True iff IsEnter(node) || IsExit(node) || IsNextIteration(node)
   bool is_enter_exit_or_next_iter : 1;
+  // True iff some input_last_use(i) is true.
+  bool has_last_use_inputs : 1;
 
   // Cached values of node->num_inputs() and node->num_outputs(), to
   // avoid levels of indirection.
@@ -190,6 +208,13 @@ struct NodeItem {
     return static_cast<DataType>(output_type_base()[i]);
   }
 
+  // True iff this node is the last reader of its ith input, as marked by
+  // the "_last_use_inputs" attribute.
+  bool input_last_use(int i) const {
+    DCHECK_LT(i, num_inputs);
+    return input_last_use_base()[i];
+  }
+
   // Return array of per-output allocator attributes.
   const AllocatorAttributes* output_attrs() const { return output_attr_base(); }
 
@@ -210,6 +235,7 @@ struct NodeItem {
   //   int                 forward_from[num_outputs];
   //   uint8               input_type[num_inputs];
   //   uint8               output_type[num_outputs];
+  //   bool                input_last_use[num_inputs];
 
   // Return pointer to variable length section.
   char* var() const {
@@ -239,6 +265,12 @@ struct NodeItem {
         sizeof(AllocatorAttributes) * num_outputs + sizeof(int) * num_outputs +
         sizeof(uint8) * num_inputs);
   }
+  bool* input_last_use_base() const {
+    return reinterpret_cast<bool*>(
+        var() + sizeof(EdgeInfo) * num_output_edges +
+        sizeof(AllocatorAttributes) * num_outputs + sizeof(int) * num_outputs +
+        sizeof(uint8) * num_inputs + sizeof(uint8) * num_outputs);
+  }
 
   TF_DISALLOW_COPY_AND_ASSIGN(NodeItem);
 };
@@ -279,6 +311,145 @@ class GraphView {
   TF_DISALLOW_COPY_AND_ASSIGN(GraphView);
 };
 
+// Per-node cost estimates learned from the measured run times of kernels,
+// and the critical-path priorities derived from them.
+//
+// A kernel that claims to be expensive (OpKernel::IsExpensive) starts with a
+// large estimate and is timed on every synchronous run. Every other
+// synchronous kernel starts out free and is timed on sampled steps only (see
+// SampleStep), which keeps the clock reads off the common path. Estimates
+// decay towards the measured cost, so the flag is only a starting point:
+// expensive kernels that turn out cheap get inlined, and cheap kernels that
+// turn out slow get dispatched.
+//
+// The priority of a node is the estimated length of the longest path from its
+// start to the end of the step. The nodes made ready by one completion are
+// dispatched in decreasing priority, so the critical path is not left waiting
+// behind side branches; there is no ordering across batches, the runner stays
+// FIFO. Priorities are recomputed from the estimates as steps finish.
+class KernelStats {
+ public:
+  KernelStats() {}
+
+  void Initialize(const GraphView& gview, const Graph* g) {
+    const int num_nodes = g->num_node_ids();
+    cost_estimates_.reset(new std::atomic<uint64>[num_nodes]);
+    priorities_.reset(new std::atomic<uint64>[num_nodes]);
+    for (int i = 0; i < num_nodes; ++i) {
+      const NodeItem* item = gview.node(i);
+      cost_estimates_[i] = 0;
+      if (item != nullptr && item->kernel_is_expensive) {
+        cost_estimates_[i] = kInitialCostEstimateNsec;
+      }
+      priorities_[i] = 0;
+    }
+
+    // Order the nodes topologically, ignoring the back edges of loops.
+    std::vector<int> pending(num_nodes, 0);
+    std::vector<const Node*> ready;
+    for (const Node* n : g->nodes()) {
+      for (const Edge* e : n->in_edges()) {
+        if (!IsNextIteration(e->src())) ++pending[n->id()];
+      }
+      if (pending[n->id()] == 0) ready.push_back(n);
+    }
+    topo_order_.clear();
+    while (!ready.empty()) {
+      const Node* n = ready.back();
+      ready.pop_back();
+      topo_order_.push_back(n);
+      if (IsNextIteration(n)) continue;
+      for (const Edge* e : n->out_edges()) {
+        if (--pending[e->dst()->id()] == 0) ready.push_back(e->dst());
+      }
+    }
+    UpdatePriorities();
+  }
+
+  // Returns true iff the executor should run "item" on a thread of its own
+  // rather than inline.
+  bool IsExpensive(const NodeItem& item) const {
+    return cost_estimates_[item.node->id()].load(std::memory_order_relaxed) >
+           kOpIsExpensiveThresholdNsec;
+  }
+
+  // Returns true iff the step starting now should time every synchronous
+  // kernel: the first kCostSampleWarmupSteps steps, then one step in
+  // kCostSampleInterval.
+  bool SampleStep() const {
+    const int64 step = num_steps_.load(std::memory_order_relaxed);
+    return step < kCostSampleWarmupSteps || step % kCostSampleInterval == 0;
+  }
+
+  uint64 Priority(const NodeItem& item) const {
+    return priorities_[item.node->id()].load(std::memory_order_relaxed);
+  }
+
+  // Folds a measured run time of "item" into its estimate. The first
+  // measurement of a kernel that started out free is taken as is, since
+  // sampled kernels are timed too rarely to converge from zero. Concurrent
+  // updates may drop one of them, which only slows down the convergence.
+  void UpdateCostEstimate(const NodeItem& item, uint64 elapsed_nsec) {
+    std::atomic<uint64>& estimate = cost_estimates_[item.node->id()];
+    const uint64 prev = estimate.load(std::memory_order_relaxed);
+    estimate.store(
+        prev == 0 ? elapsed_nsec
+                  : ((kCostDecay - 1) * prev + elapsed_nsec) / kCostDecay,
+        std::memory_order_relaxed);
+  }
+
+  // Called at the end of every step. Refreshes the priorities after steps
+  // 1, 2, 4, ... while the estimates settle, then every
+  // kPriorityUpdateInterval steps.
+  void StepDone() {
+    const int64 step = num_steps_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if ((step & (step - 1)) != 0 && step % kPriorityUpdateInterval != 0) {
+      return;
+    }
+    // Skip the refresh if another step is already doing it.
+    if (!mu_.try_lock()) return;
+    UpdatePriorities();
+    mu_.unlock();
+  }
+
+ private:
+  void UpdatePriorities() {
+    for (auto it = topo_order_.rbegin(); it != topo_order_.rend(); ++it) {
+      const Node* n = *it;
+      uint64 longest_tail = 0;
+      if (!IsNextIteration(n)) {
+        for (const Edge* e : n->out_edges()) {
+          longest_tail = std::max(
+              longest_tail,
+              priorities_[e->dst()->id()].load(std::memory_order_relaxed));
+        }
+      }
+      priorities_[n->id()].store(
+          cost_estimates_[n->id()].load(std::memory_order_relaxed) +
+              longest_tail,
+          std::memory_order_relaxed);
+    }
+  }
+
+  // Kernels marked expensive start out well above the threshold, so they are
+  // dispatched until measured.
+  static constexpr uint64 kInitialCostEstimateNsec = 100 * 1000 * 1000;
+  // Roughly what handing a node to another thread costs.
+  static constexpr uint64 kOpIsExpensiveThresholdNsec = 5000;
+  static constexpr uint64 kCostDecay = 10;
+  static constexpr int64 kPriorityUpdateInterval = 100;
+  static constexpr int64 kCostSampleWarmupSteps = 4;
+  static constexpr int64 kCostSampleInterval = 16;
+
+  std::unique_ptr<std::atomic<uint64>[]> cost_estimates_;
+  std::unique_ptr<std::atomic<uint64>[]> priorities_;
+  std::vector<const Node*> topo_order_;
+  std::atomic<int64> num_steps_{0};
+  mutex mu_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(KernelStats);
+};
+
 class ExecutorImpl : public Executor {
  public:
   ExecutorImpl(const LocalExecutorParams& p, std::unique_ptr<const Graph> g)
@@ -297,6 +468,12 @@ class ExecutorImpl : public Executor {
     for (auto fiter : frame_info_) {
       delete fiter.second;
     }
+    if (memory_planner_ != nullptr) {
+      memory_planner_->Unref();
+    }
+    if (tracer_ != nullptr) {
+      tracer_->UnregisterGraph(trace_graph_id_);
+    }
   }
 
   Status Initialize();
@@ -311,17 +488,17 @@ class ExecutorImpl : public Executor {
  private:
   friend class ExecutorState;
 
+  // Returns the id of graph_ in "tracer", registering it on first use.
+  int32 TraceGraphId(StepTracer* tracer) const;
+
   struct ControlFlowInfo {
     gtl::FlatSet<string> unique_frame_names;
     std::vector<string> frame_names;
   };
 
   struct FrameInfo {
-    FrameInfo()
-        : input_count(0),
-          total_inputs(0),
-          pending_counts(nullptr),
-          nodes(nullptr) {}
+    FrameInfo();
+    ~FrameInfo();
 
     // The total number of inputs to a frame.
     int input_count;
@@ -340,10 +517,9 @@ class ExecutorImpl : public Executor {
     // The nodes in a frame. Used only for debugging.
     std::vector<const Node*>* nodes;  // Owned
 
-    ~FrameInfo() {
-      delete pending_counts;
-      delete nodes;
-    }
+    // The iteration states of finished iterations of the frame, shared by
+    // all steps.
+    std::unique_ptr<IterationStatePool> iteration_pool;
   };
 
   static Status BuildControlFlowInfo(const Graph* graph,
@@ -369,6 +545,19 @@ class ExecutorImpl : public Executor {
   // Root nodes (with no in edges) that should form the initial ready queue
   std::vector<const Node*> root_nodes_;
 
+  // Cost estimates and scheduling priorities, shared by all steps. Mutable
+  // because steps update it through a const ExecutorImpl.
+  mutable KernelStats kernel_stats_;
+
+  // Plans the output buffers of each step, if
+  // params_.use_static_memory_plan is set.
+  MemoryPlanner* memory_planner_ = nullptr;
+
+  // The registration of graph_ with the tracer of traced steps.
+  mutable mutex trace_mu_;
+  mutable StepTracer* tracer_ GUARDED_BY(trace_mu_) = nullptr;
+  mutable int32 trace_graph_id_ GUARDED_BY(trace_mu_) = -1;
+
   // Mapping from frame name to static information about the frame.
   // TODO(yuanbyu): We could cache it along with the graph so to avoid
   // the overhead of constructing it for each executor instance.
@@ -416,7 +605,8 @@ size_t GraphView::NodeItemBytes(const Node* n) {
       + num_outputs * sizeof(AllocatorAttributes)  // output_attr[...]
       + num_outputs * sizeof(int)                  // forward_from[num_outputs]
       + num_inputs * sizeof(uint8)                 // input_type[num_inputs]
-      + num_outputs * sizeof(uint8);               // output_type[num_outputs]
+      + num_outputs * sizeof(uint8)                // output_type[num_outputs]
+      + num_inputs * sizeof(bool);                 // input_last_use[num_inputs]
   static constexpr size_t kItemAlignment = sizeof(NodeItem*);
   static_assert(kItemAlignment % alignof(NodeItem) == 0,
                 "NodeItem must be aligned with kItemAlignment");
@@ -500,6 +690,22 @@ char* GraphView::InitializeNode(char* ptr, const Node* n) {
     DCHECK_EQ(item->input_type(i), n->input_type(i));
   }
 
+  // Set by the grappler memory optimizer.
+  bool* input_last_use = item->input_last_use_base();
+  for (int i = 0; i < num_inputs; i++) {
+    input_last_use[i] = false;
+  }
+  item->has_last_use_inputs = false;
+  std::vector<int> last_use_inputs;
+  if (GetNodeAttr(n->attrs(), "_last_use_inputs", &last_use_inputs).ok()) {
+    for (int i : last_use_inputs) {
+      if (i >= 0 && i < num_inputs) {
+        input_last_use[i] = true;
+        item->has_last_use_inputs = true;
+      }
+    }
+  }
+
   // Check ScopedAllocatorAttrs and forward_from.  Also assign output_types.
   {
     std::vector<int> forward_input;
@@ -663,6 +869,18 @@ Status ExecutorImpl::Initialize() {
   // all nodes.
   InitializePending(graph_.get(), cf_info);
 
+  kernel_stats_.Initialize(gview_, graph_.get());
+
+  if (params_.use_static_memory_plan) {
+    std::vector<bool> in_root_frame(graph_->num_node_ids());
+    for (const Node* n : graph_->nodes()) {
+      in_root_frame[n->id()] = cf_info.frame_names[n->id()].empty();
+    }
+    memory_planner_ =
+        new MemoryPlanner(graph_.get(), in_root_frame,
+                          params_.device->GetAllocator(AllocatorAttributes()));
+  }
+
   return gview_.SetAllocAttrs(graph_.get(), params_.device);
 }
 
@@ -843,6 +1061,8 @@ class ExecutorState {
   void RunAsync(Executor::DoneCallback done);
 
  private:
+  friend class IterationStatePool;
+
   // Either a tensor pointer (pass-by-reference) or a tensor (pass-by-value).
   // TODO(yuanbyu): A better way to do "has_value"?
   struct Entry {
@@ -981,6 +1201,17 @@ class ExecutorState {
                                     dead_result);
     }
 
+    // Returns the state to that of a new iteration, dropping the inputs
+    // that an aborted step left behind.
+    void Reset(const PendingCounts* pending_counts, int total_input_tensors) {
+      for (int i = 0; i < total_input_tensors; ++i) {
+        input_tensors[i] = Entry();
+      }
+      outstanding_ops = 0;
+      outstanding_frame_count = 0;
+      counts_.CopyFrom(*pending_counts);
+    }
+
     ~IterationState() { delete[] input_tensors; }
 
    private:
@@ -988,10 +1219,12 @@ class ExecutorState {
   };
 
   struct FrameState {
-    explicit FrameState(const ExecutorImpl* impl, int parallel_iters)
+    explicit FrameState(const ExecutorImpl* impl, int parallel_iters,
+                        std::atomic<int64>* num_allocations)
         : executor(impl),
           max_parallel_iterations(parallel_iters),
-          num_outstanding_iterations(1) {}
+          num_outstanding_iterations(1),
+          step_allocations(num_allocations) {}
 
     // A new frame is created for each loop. Execution starts at iteration 0.
     // When a value at iteration 0 passes through a NextIteration node,
@@ -1077,6 +1310,10 @@ class ExecutorState {
     PendingCounts* pending_counts = nullptr;
     int total_input_tensors = 0;
     std::vector<const Node*>* nodes = nullptr;
+    IterationStatePool* iteration_pool = nullptr;
+
+    // Counts the states the step allocates. Not owned.
+    std::atomic<int64>* const step_allocations;
 
     // Lock ordering: ExecutorState.mu_ < mu;
     // during structured traversal: parent_frame->mu < mu.
@@ -1090,8 +1327,16 @@ class ExecutorState {
       total_input_tensors = finfo->total_inputs;
       num_pending_inputs = finfo->input_count;
       nodes = finfo->nodes;
+      iteration_pool = finfo->iteration_pool.get();
     }
 
+    // Returns the state of a new iteration, reusing the state of a
+    // finished one if the frame has any.
+    IterationState* NewIteration();
+
+    // Hands the state of a finished iteration back for reuse.
+    void ReleaseIteration(IterationState* state);
+
     inline IterationState* GetIteration(int64 iter)
         EXCLUSIVE_LOCKS_REQUIRED(mu) {
       size_t index = iter % iterations.size();
@@ -1162,12 +1407,7 @@ class ExecutorState {
     bool CleanupIterations(const GraphView* gview, int64 iter,
                            TaggedNodeSeq* ready) EXCLUSIVE_LOCKS_REQUIRED(mu);
 
-    ~FrameState() {
-      for (size_t i = 0; i < iterations.size(); ++i) {
-        delete iterations[i];
-        iterations[i] = nullptr;
-      }
-    }
+    ~FrameState();
   };
 
   // A tagged node: <frame*, iter, node*>.
@@ -1236,7 +1476,12 @@ class ExecutorState {
   TensorStore* tensor_store_;
   // Step-local container.
   ScopedStepContainer* step_container_;
+  // Planned output buffers for this step, or nullptr. Owned.
+  StepMemory* step_memory_;
   StepStatsCollectorInterface* const stats_collector_;
+  // Not owned. If not null, records each executed node.
+  StepTracer* const step_tracer_;
+  const int32 trace_graph_id_;
   // QUESTION: Make it a checkpoint::TensorSliceReaderCacheWrapper
   // instead of a pointer?  (avoids having to delete).
   checkpoint::TensorSliceReaderCacheWrapper* slice_reader_cache_;
@@ -1245,6 +1490,8 @@ class ExecutorState {
   CancellationManager* cancellation_manager_;
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
+  // True iff this step times every synchronous kernel for the cost estimates.
+  const bool sample_kernel_costs_;
 
   // Owned.
 
@@ -1260,6 +1507,10 @@ class ExecutorState {
 
   std::atomic_int_fast32_t num_outstanding_ops_;
 
+  // The number of states this step allocated, starting with itself and
+  // its root frame.
+  std::atomic<int64> num_state_allocations_{2};
+
   mutex mu_;
   Status status_ GUARDED_BY(mu_);
 
@@ -1303,6 +1554,25 @@ class ExecutorState {
   Status ProcessOutputs(const NodeItem& item, OpKernelContext* ctx,
                         EntryVector* outputs, NodeExecStatsWrapper* stats);
 
+  // Drops the references that keep item->kernel from computing in place:
+  // inputs that item is the last reader of and that hold the same data (the
+  // same bytes with the same shape, not merely slices of one buffer) are
+  // pointed at a single tensor.
+  void ShareLastUseInputs(const NodeItem& item, Entry* first_input,
+                          TensorValueVec* inputs);
+
+  // Returns the bytes of the outputs of item->kernel that were allocated
+  // even though an input that item is the last reader of, with the same
+  // type and size, was available. Must be called before ProcessOutputs.
+  int64 UnforwardedOutputBytes(const NodeItem& item,
+                               const TensorValueVec& inputs,
+                               OpKernelContext* ctx);
+
+  // Records the execution of item->kernel, which started at "start_nsec",
+  // in step_tracer_. Must be called before ProcessOutputs.
+  void RecordTrace(const NodeItem& item, int64 start_nsec,
+                   OpKernelContext* ctx);
+
   // After processing the outputs, propagates the outputs to their dsts.
   // Contents of *outputs are left in an indeterminate state after
   // returning from this method.
@@ -1349,6 +1619,53 @@ class ExecutorState {
   }
 };
 
+// The states of the finished iterations of one frame, kept so that later
+// iterations and steps reset them instead of allocating their input
+// entries and pending counts anew. Thread-safe.
+class IterationStatePool {
+ public:
+  typedef ExecutorState::IterationState IterationState;
+
+  IterationStatePool() {}
+
+  ~IterationStatePool() {
+    for (IterationState* state : free_) {
+      delete state;
+    }
+  }
+
+  // Returns a reset state, or nullptr if the pool is empty.
+  IterationState* Get() {
+    mutex_lock l(mu_);
+    if (free_.empty()) return nullptr;
+    IterationState* state = free_.back();
+    free_.pop_back();
+    return state;
+  }
+
+  // Takes ownership of "state", which must have been reset.
+  void Put(IterationState* state) {
+    {
+      mutex_lock l(mu_);
+      if (free_.size() < kMaxFree) {
+        free_.push_back(state);
+        return;
+      }
+    }
+    delete state;
+  }
+
+ private:
+  // Bounds the memory held after a burst of concurrent steps or of
+  // parallel iterations.
+  static constexpr size_t kMaxFree = 16;
+
+  mutex mu_;
+  std::vector<IterationState*> free_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(IterationStatePool);
+};
+
 ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
@@ -1358,30 +1675,38 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
       session_state_(args.session_state),
       tensor_store_(args.tensor_store),
       step_container_(args.step_container),
+      step_memory_(impl->memory_planner_ == nullptr
+                       ? nullptr
+                       : impl->memory_planner_->BeginStep()),
       stats_collector_(args.stats_collector),
+      step_tracer_(args.step_tracer),
+      trace_graph_id_(args.step_tracer == nullptr
+                          ? -1
+                          : impl->TraceGraphId(args.step_tracer)),
       slice_reader_cache_(new checkpoint::TensorSliceReaderCacheWrapper),
       call_frame_(args.call_frame),
       impl_(impl),
       cancellation_manager_(args.cancellation_manager),
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
+      sample_kernel_costs_(impl->kernel_stats_.SampleStep()),
       num_outstanding_ops_(0) {
   // We start the entire execution in iteration 0 of the root frame
   // so let us create the root frame and the state for iteration 0.
   // We assume root_frame_->frame_name.empty().
-  root_frame_ = new FrameState(impl_, 1);
+  root_frame_ = new FrameState(impl_, 1, &num_state_allocations_);
   root_frame_->frame_id = 0;  // must be 0
   root_frame_->InitializeFrameInfo(root_frame_->frame_name);
 
   // Initialize iteration 0.
   root_frame_->iterations.resize(root_frame_->max_parallel_iterations);
-  root_frame_->iterations[0] = new IterationState(
-      root_frame_->pending_counts, root_frame_->total_input_tensors);
+  root_frame_->iterations[0] = root_frame_->NewIteration();
 
   outstanding_frames_.insert({root_frame_->frame_name, root_frame_});
 }
 
 ExecutorState::~ExecutorState() {
+  executor_step_allocations->GetCell()->Add(num_state_allocations_);
   for (auto name_frame : outstanding_frames_) {
     delete name_frame.second;
   }
@@ -1389,6 +1714,9 @@ ExecutorState::~ExecutorState() {
     it->Unref();
   }
   delete slice_reader_cache_;
+  if (step_memory_ != nullptr) {
+    step_memory_->EndStep();
+  }
 }
 
 Status ExecutorImpl::BuildControlFlowInfo(const Graph* g,
@@ -1539,6 +1867,8 @@ struct ExecutorState::AsyncState {
   Entry* first_input;
   OpKernelContext ctx;
   NodeExecStatsWrapper* stats;
+  // When the kernel started, if the step is traced.
+  int64 trace_start_nsec = 0;
 
  private:
   OpKernelContext::Params* ParamsButClearingEigenGPUDevice(
@@ -1660,6 +1990,9 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
       params.is_input_dead = is_input_dead;
       params.output_attr_array = item.output_attrs();
       params.forward_from_array = item.forward_from();
+      params.output_allocator_array =
+          step_memory_ == nullptr ? nullptr
+                                  : step_memory_->output_allocators(id);
 
       if (item.kernel_is_async) {
         // Asynchronous computes.
@@ -1675,6 +2008,14 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
           Entry* first_input = state->first_input;     // Shorthand
 
           nodestats::SetOpEnd(stats);
+          if (step_tracer_ != nullptr) {
+            RecordTrace(*state->item, state->trace_start_nsec, &state->ctx);
+          }
+          if (stats != nullptr && state->item->has_last_use_inputs) {
+            nodestats::SetUnforwardedOutputBytes(
+                stats, UnforwardedOutputBytes(*state->item, state->saved_inputs,
+                                              &state->ctx));
+          }
           EntryVector outputs;
           Status s = ProcessOutputs(*state->item, &state->ctx, &outputs, stats);
           nodestats::SetMemory(stats, &state->ctx);
@@ -1715,13 +2056,32 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
           if (completed) Finish();
         };
         nodestats::SetOpStart(stats);
+        if (step_tracer_ != nullptr) {
+          state->trace_start_nsec = nodestats::NowInNsec();
+        }
         device->ComputeAsync(async, &state->ctx, done);
       } else {
         // Synchronous computes.
         OpKernelContext ctx(&params, item.num_outputs);
         nodestats::SetOpStart(stats);
-        device->Compute(CHECK_NOTNULL(op_kernel), &ctx);
+        const int64 trace_start_nsec =
+            step_tracer_ != nullptr ? nodestats::NowInNsec() : 0;
+        if (item.kernel_is_expensive || sample_kernel_costs_) {
+          const int64 start_nsec = nodestats::NowInNsec();
+          device->Compute(CHECK_NOTNULL(op_kernel), &ctx);
+          impl_->kernel_stats_.UpdateCostEstimate(
+              item, nodestats::NowInNsec() - start_nsec);
+        } else {
+          device->Compute(CHECK_NOTNULL(op_kernel), &ctx);
+        }
         nodestats::SetOpEnd(stats);
+        if (step_tracer_ != nullptr) {
+          RecordTrace(item, trace_start_nsec, &ctx);
+        }
+        if (stats != nullptr && item.has_last_use_inputs) {
+          nodestats::SetUnforwardedOutputBytes(
+              stats, UnforwardedOutputBytes(item, inputs, &ctx));
+        }
         s = ProcessOutputs(item, &ctx, &outputs, stats);
         if (s.ok() && impl_->device_record_tensor_accesses_) {
           // Get the list of all tensors accessed during the execution
@@ -1857,9 +2217,100 @@ Status ExecutorState::PrepareInputs(const NodeItem& item, Entry* first_input,
       }
     }
   }
+  if (item.has_last_use_inputs) {
+    ShareLastUseInputs(item, first_input, inputs);
+  }
   return Status::OK();
 }
 
+void ExecutorState::ShareLastUseInputs(const NodeItem& item,
+                                       Entry* first_input,
+                                       TensorValueVec* inputs) {
+  for (int i = 0; i < item.num_inputs; ++i) {
+    const TensorValue& inp = (*inputs)[i];
+    if (!item.input_last_use(i) || inp.tensor == nullptr || inp.is_ref() ||
+        !inp.tensor->IsInitialized()) {
+      continue;
+    }
+    for (int j = i + 1; j < item.num_inputs; ++j) {
+      TensorValue* other = &(*inputs)[j];
+      if (item.input_last_use(j) && other->tensor != nullptr &&
+          other->tensor != inp.tensor && !other->is_ref() &&
+          other->tensor->dtype() == inp.tensor->dtype() &&
+          other->tensor->shape() == inp.tensor->shape() &&
+          other->tensor->IsInitialized() &&
+          other->tensor->tensor_data().data() ==
+              inp.tensor->tensor_data().data()) {
+        other->tensor = inp.tensor;
+        (first_input + j)->ClearVal();
+      }
+    }
+  }
+}
+
+int64 ExecutorState::UnforwardedOutputBytes(const NodeItem& item,
+                                            const TensorValueVec& inputs,
+                                            OpKernelContext* ctx) {
+  gtl::InlinedVector<bool, 4> input_used(item.num_inputs, false);
+  gtl::InlinedVector<bool, 4> output_forwarded(item.num_outputs, false);
+  auto candidate = [&item, &inputs](int i) {
+    return item.input_last_use(i) && inputs[i].tensor != nullptr &&
+           !inputs[i].is_ref() && inputs[i].tensor->IsInitialized();
+  };
+  auto output = [ctx](int o) -> const Tensor* {
+    const Tensor* t = ctx->mutable_output(o);
+    if (t == nullptr || !t->IsInitialized() ||
+        IsRefType(ctx->expected_output_dtype(o))) {
+      return nullptr;
+    }
+    return t;
+  };
+  for (int o = 0; o < item.num_outputs; ++o) {
+    const Tensor* t = output(o);
+    if (t == nullptr) continue;
+    for (int i = 0; i < item.num_inputs; ++i) {
+      if (candidate(i) && t->SharesBufferWith(*inputs[i].tensor)) {
+        input_used[i] = true;
+        output_forwarded[o] = true;
+        break;
+      }
+    }
+  }
+  int64 bytes = 0;
+  for (int o = 0; o < item.num_outputs; ++o) {
+    const Tensor* t = output(o);
+    if (t == nullptr || output_forwarded[o] || t->NumElements() == 0) continue;
+    for (int i = 0; i < item.num_inputs; ++i) {
+      if (!input_used[i] && candidate(i) &&
+          inputs[i].tensor->dtype() == t->dtype() &&
+          inputs[i].tensor->NumElements() == t->NumElements()) {
+        input_used[i] = true;
+        bytes += t->TotalBytes();
+        break;
+      }
+    }
+  }
+  return bytes;
+}
+
+void ExecutorState::RecordTrace(const NodeItem& item, int64 start_nsec,
+                                OpKernelContext* ctx) {
+  StepTraceRecord record;
+  record.step_id = step_id_;
+  record.start_nanos = start_nsec;
+  record.end_nanos = nodestats::NowInNsec();
+  for (int i = 0; i < item.num_outputs; ++i) {
+    const Tensor* t = ctx->mutable_output(i);
+    if (t != nullptr && t->IsInitialized() &&
+        !IsRefType(ctx->expected_output_dtype(i))) {
+      record.output_bytes += t->TotalBytes();
+    }
+  }
+  record.graph_id = trace_graph_id_;
+  record.node_id = item.node->id();
+  step_tracer_->Record(record);
+}
+
 Status ExecutorState::ProcessOutputs(const NodeItem& item, OpKernelContext* ctx,
                                      EntryVector* outputs,
                                      NodeExecStatsWrapper* stats) {
@@ -2137,40 +2588,49 @@ void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
   if (stats_collector_) {
     scheduled_nsec = nodestats::NowInNsec();
   }
-  if (inline_ready == nullptr) {
-    // Schedule to run all the ready ops in thread pool.
-    for (auto& tagged_node : ready) {
-      runner_([=]() { Process(tagged_node, scheduled_nsec); });
-    }
-    return;
-  }
   const GraphView& gview = impl_->gview_;
-  const TaggedNode* curr_expensive_node = nullptr;
+  const KernelStats& kernel_stats = impl_->kernel_stats_;
+  // Nodes to run on a thread of their own, longest remaining path first.
+  gtl::InlinedVector<const TaggedNode*, 8> expensive;
   for (auto& tagged_node : ready) {
     const NodeItem& item = *gview.node(tagged_node.node->id());
-    if (tagged_node.is_dead || !item.kernel_is_expensive) {
+    if (inline_ready != nullptr &&
+        (tagged_node.is_dead || !kernel_stats.IsExpensive(item))) {
       // Inline this inexpensive node.
       inline_ready->push_back(tagged_node);
     } else {
-      if (curr_expensive_node) {
-        // Dispatch to another thread since there is plenty of work to
-        // do for this thread.
-        runner_(std::bind(&ExecutorState::Process, this, *curr_expensive_node,
-                          scheduled_nsec));
-      }
-      curr_expensive_node = &tagged_node;
+      expensive.push_back(&tagged_node);
     }
   }
-  if (curr_expensive_node) {
-    if (inline_ready->empty()) {
-      // Tail recursion optimization
-      inline_ready->push_back(*curr_expensive_node);
-    } else {
-      // There are inline nodes to run already. We dispatch this expensive
-      // node to other thread.
-      runner_(std::bind(&ExecutorState::Process, this, *curr_expensive_node,
+  if (expensive.size() > 1) {
+    auto priority = [&gview, &kernel_stats](const TaggedNode* t) {
+      return kernel_stats.Priority(*gview.node(t->node->id()));
+    };
+    std::stable_sort(expensive.begin(), expensive.end(),
+                     [&priority](const TaggedNode* a, const TaggedNode* b) {
+                       return priority(a) > priority(b);
+                     });
+  }
+  if (inline_ready == nullptr) {
+    // Schedule to run all the ready ops in thread pool.
+    for (const TaggedNode* tagged_node : expensive) {
+      runner_(std::bind(&ExecutorState::Process, this, *tagged_node,
                         scheduled_nsec));
     }
+    return;
+  }
+  if (expensive.empty()) return;
+  // Keep the most critical node for this thread if there is nothing else to
+  // do here, and dispatch the others to other threads.
+  size_t first_dispatched = 0;
+  if (inline_ready->empty()) {
+    // Tail recursion optimization
+    inline_ready->push_back(*expensive[0]);
+    first_dispatched = 1;
+  }
+  for (size_t i = first_dispatched; i < expensive.size(); ++i) {
+    runner_(std::bind(&ExecutorState::Process, this, *expensive[i],
+                      scheduled_nsec));
   }
 }
 
@@ -2306,6 +2766,7 @@ void ExecutorState::DumpState() {
 }
 
 void ExecutorState::Finish() {
+  impl_->kernel_stats_.StepDone();
   mu_.lock();
   auto status = status_;
   auto done_cb = std::move(done_cb_);
@@ -2348,7 +2809,9 @@ void ExecutorState::FindOrCreateChildFrame(FrameState* frame, int64 iter,
   int parallel_iters;
   s = GetNodeAttr(node->attrs(), "parallel_iterations", &parallel_iters);
   DCHECK(s.ok()) << s;
-  FrameState* temp = new FrameState(impl_, parallel_iters);
+  FrameState* temp =
+      new FrameState(impl_, parallel_iters, &num_state_allocations_);
+  ++num_state_allocations_;
   temp->frame_name = child_name;
   temp->frame_id = Hash64(child_name);
   temp->parent_frame = frame;
@@ -2358,8 +2821,7 @@ void ExecutorState::FindOrCreateChildFrame(FrameState* frame, int64 iter,
   // 'iterations' is a fixed-length circular buffer.
   temp->iterations.resize(temp->max_parallel_iterations + 1);
   // Initialize iteration 0.
-  temp->iterations[0] =
-      new IterationState(temp->pending_counts, temp->total_input_tensors);
+  temp->iterations[0] = temp->NewIteration();
 
   {
     mutex_lock executor_lock(mu_);
@@ -2615,9 +3077,7 @@ void ExecutorState::FrameState::IncrementIteration(const GraphView* gview,
   const int64 next_iter = iteration_count;
 
   // Initialize the next iteration.
-  IterationState* iter_state =
-      new IterationState(pending_counts, total_input_tensors);
-  SetIteration(next_iter, iter_state);
+  SetIteration(next_iter, NewIteration());
   num_outstanding_iterations++;
   dead_exits.clear();
 
@@ -2634,7 +3094,7 @@ bool ExecutorState::FrameState::CleanupIterations(const GraphView* gview,
   int64 curr_iter = iter;
   while (curr_iter <= iteration_count && IsIterationDone(curr_iter)) {
     // Delete the iteration curr_iter.
-    delete GetIteration(curr_iter);
+    ReleaseIteration(GetIteration(curr_iter));
     SetIteration(curr_iter, nullptr);
     --num_outstanding_iterations;
     ++curr_iter;
@@ -2648,6 +3108,54 @@ bool ExecutorState::FrameState::CleanupIterations(const GraphView* gview,
   return IsFrameDone();
 }
 
+ExecutorState::IterationState* ExecutorState::FrameState::NewIteration() {
+  IterationState* state = iteration_pool->Get();
+  if (state == nullptr) {
+    state = new IterationState(pending_counts, total_input_tensors);
+    ++*step_allocations;
+  }
+  return state;
+}
+
+void ExecutorState::FrameState::ReleaseIteration(IterationState* state) {
+  state->Reset(pending_counts, total_input_tensors);
+  iteration_pool->Put(state);
+}
+
+ExecutorState::FrameState::~FrameState() {
+  for (size_t i = 0; i < iterations.size(); ++i) {
+    if (iterations[i] != nullptr) {
+      ReleaseIteration(iterations[i]);
+      iterations[i] = nullptr;
+    }
+  }
+}
+
+ExecutorImpl::FrameInfo::FrameInfo()
+    : input_count(0),
+      total_inputs(0),
+      pending_counts(nullptr),
+      nodes(nullptr),
+      iteration_pool(new IterationStatePool) {}
+
+ExecutorImpl::FrameInfo::~FrameInfo() {
+  delete pending_counts;
+  delete nodes;
+}
+
+int32 ExecutorImpl::TraceGraphId(StepTracer* tracer) const {
+  mutex_lock l(trace_mu_);
+  if (tracer_ == nullptr) {
+    Device* device = params_.device;
+    tracer_ = tracer;
+    trace_graph_id_ = tracer->RegisterGraph(
+        device->name(), device->GetAllocator(AllocatorAttributes())->Name(),
+        *graph_);
+  }
+  DCHECK_EQ(tracer_, tracer);
+  return trace_graph_id_;
+}
+
 void ExecutorImpl::RunAsync(const Args& args, DoneCallback done) {
   (new ExecutorState(args, this))->RunAsync(std::move(done));
 }
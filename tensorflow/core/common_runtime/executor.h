@@ -29,6 +29,7 @@ limitations under the License.
 namespace tensorflow {
 
 class StepStatsCollector;
+class StepTracer;
 
 // Executor runs a graph computation.
 // Example:
@@ -84,6 +85,9 @@ class Executor {
     int64 step_id = 0;
     Rendezvous* rendezvous = nullptr;
     StepStatsCollectorInterface* stats_collector = nullptr;
+    // If not null, each executed node is recorded in "step_tracer". This is
+    // much cheaper than "stats_collector" but records less.
+    StepTracer* step_tracer = nullptr;
     CallFrameInterface* call_frame = nullptr;
     CancellationManager* cancellation_manager = nullptr;
     SessionState* session_state = nullptr;
@@ -138,6 +142,11 @@ struct LocalExecutorParams {
   // when the executor is deleted.
   std::function<Status(const NodeDef&, OpKernel**)> create_kernel;
   std::function<void(OpKernel*)> delete_kernel;
+
+  // If true, the executor sizes the outputs of its kernels during the first
+  // step and then serves them from one planned arena per step. See
+  // memory_planner.h.
+  bool use_static_memory_plan = false;
 };
 ::tensorflow::Status NewLocalExecutor(const LocalExecutorParams& params,
                                       std::unique_ptr<const Graph> graph,
@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <deque>
+#include <map>
 
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
@@ -21,15 +23,21 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/common_runtime/step_tracer.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/graph_constructor.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/monitoring/collection_registry.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/platform/tracing.h"
@@ -57,10 +65,12 @@ class ExecutorTest : public ::testing::Test {
   }
 
   // Resets executor_ with a new executor based on a graph 'gdef'.
-  void Create(std::unique_ptr<const Graph> graph) {
+  void Create(std::unique_ptr<const Graph> graph,
+              bool use_static_memory_plan = false) {
     const int version = graph->versions().producer();
     LocalExecutorParams params;
     params.device = device_;
+    params.use_static_memory_plan = use_static_memory_plan;
     params.create_kernel = [this, version](const NodeDef& ndef,
                                            OpKernel** kernel) {
       return CreateNonCachedKernel(device_, nullptr, ndef, version, kernel);
@@ -228,6 +238,367 @@ void BuildTree(int N, Graph* g) {
   test::graph::Send(g, nodes.back(), "b", BOB, 1, ALICE);
 }
 
+// Returns the number of planned outputs served from a step's arena and from
+// the device allocator, as recorded by the memory_plan_allocations metric.
+void GetPlannedAllocations(int64* arena, int64* fallback) {
+  std::unique_ptr<monitoring::CollectedMetrics> metrics =
+      monitoring::CollectionRegistry::Default()->CollectMetrics(
+          monitoring::CollectionRegistry::CollectMetricsOptions());
+  *arena = 0;
+  *fallback = 0;
+  auto it = metrics->point_set_map.find(
+      "/tensorflow/core/memory_plan_allocations");
+  if (it == metrics->point_set_map.end()) return;
+  for (const auto& point : it->second->points) {
+    ASSERT_EQ(1, point->labels.size());
+    if (point->labels[0].value == "arena") {
+      *arena = point->int64_value;
+    } else if (point->labels[0].value == "fallback") {
+      *fallback = point->int64_value;
+    }
+  }
+}
+
+TEST_F(ExecutorTest, StaticMemoryPlan) {
+  // v0 <- a
+  // v1 = v0 + v0
+  // v2 = v1 + v0
+  // ... ...
+  // v10 = v9 + v0
+  //
+  // b <- v10
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto v = in;
+  const int N = 10;
+  for (int i = 1; i <= N; ++i) {
+    v = test::graph::Add(g.get(), v, in);
+  }
+  test::graph::Send(g.get(), v, "b", BOB, 1, ALICE);
+  Create(std::move(g), /*use_static_memory_plan=*/true);
+  // The first step records the output sizes; later ones use the plan.
+  for (int step = 1; step <= 3; ++step) {
+    int64 arena_before = 0;
+    int64 fallback_before = 0;
+    GetPlannedAllocations(&arena_before, &fallback_before);
+    Rendezvous::Args args;
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args,
+                               V(step), false));
+    TF_ASSERT_OK(Run(rendez_));
+    // "out" may live in the step's arena, in which case it keeps the whole
+    // arena allocated until it goes out of scope.
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out,
+                               &is_dead));
+    EXPECT_EQ(11.0 * step, V(out));
+
+    int64 arena_after = 0;
+    int64 fallback_after = 0;
+    GetPlannedAllocations(&arena_after, &fallback_after);
+    if (step == 1) {
+      EXPECT_EQ(arena_before, arena_after);
+    } else {
+      EXPECT_LT(arena_before, arena_after);
+    }
+    EXPECT_EQ(fallback_before, fallback_after);
+  }
+}
+
+TEST_F(ExecutorTest, StepTracer) {
+  // c = a + b
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in0 = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto in1 = test::graph::Recv(g.get(), "b", "float", ALICE, 1, BOB);
+  auto tmp = test::graph::Add(g.get(), in0, in1);
+  test::graph::Send(g.get(), tmp, "c", BOB, 1, ALICE);
+  Create(std::move(g));
+  Rendezvous::Args rendez_args;
+  TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), rendez_args,
+                             V(1.0), false));
+  TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "b"), rendez_args,
+                             V(1.0), false));
+  Executor::Args args;
+  args.step_id = 12345;
+  args.rendezvous = rendez_;
+  args.step_tracer = StepTracer::Global();
+  args.runner = runner_;
+  TF_ASSERT_OK(exec_->Run(args));
+
+  StepStats step_stats;
+  StepTracer::Global()->ExportStepStats(12345, &step_stats);
+  ASSERT_EQ(1, step_stats.dev_stats_size());
+  EXPECT_EQ(device_->name(), step_stats.dev_stats(0).device());
+  std::vector<string> labels;
+  for (const NodeExecStats& ns : step_stats.dev_stats(0).node_stats()) {
+    labels.push_back(ns.timeline_label());
+    EXPECT_GE(ns.all_end_rel_nanos(), 0);
+  }
+  EXPECT_EQ(4, labels.size());
+  EXPECT_NE(labels.end(),
+            std::find(labels.begin(), labels.end(), tmp->name() + " = Add()"));
+}
+
+// A runner that queues closures and runs them one at a time, first in first
+// out, on the thread that calls RunUntil(). The order in which nodes run is
+// then the order in which the executor dispatched them.
+class FifoRunner {
+ public:
+  Executor::Args::Runner runner() {
+    return [this](std::function<void()> fn) {
+      mutex_lock l(mu_);
+      ++num_dispatched_;
+      queue_.push_back(std::move(fn));
+    };
+  }
+
+  // Runs queued closures until "done" is notified.
+  void RunUntil(Notification* done) {
+    while (!done->HasBeenNotified()) {
+      std::function<void()> fn;
+      {
+        mutex_lock l(mu_);
+        CHECK(!queue_.empty());
+        fn = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      fn();
+    }
+  }
+
+  int num_dispatched() {
+    mutex_lock l(mu_);
+    return num_dispatched_;
+  }
+
+ private:
+  mutex mu_;
+  std::deque<std::function<void()>> queue_ GUARDED_BY(mu_);
+  int num_dispatched_ GUARDED_BY(mu_) = 0;
+};
+
+TEST_F(ExecutorTest, PrioritiesAndInlining) {
+  // r = a + a
+  // c1 = r + r
+  // c2 = (r + r) + r
+  // c3 = ((r + r) + r) + r
+  //
+  // The chains are built shortest first, so that without priorities the
+  // executor would run c1's chain first.
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto root = test::graph::Add(g.get(), in, in);
+  std::vector<Node*> heads;
+  const int N = 3;
+  for (int len = 1; len <= N; ++len) {
+    auto v = test::graph::Add(g.get(), root, root);
+    heads.push_back(v);
+    for (int i = 1; i < len; ++i) {
+      v = test::graph::Add(g.get(), v, root);
+    }
+    test::graph::Send(g.get(), v, strings::StrCat("c", len), BOB, 1, ALICE);
+  }
+  Create(std::move(g));
+
+  // Runs one step and returns the number of closures dispatched to the
+  // runner. "order" receives the names of the nodes in the order they ran.
+  auto run_step = [this](std::vector<string>* order) {
+    Rendezvous::Args rendez_args;
+    TF_CHECK_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), rendez_args,
+                              V(1.0), false));
+    FifoRunner runner;
+    StepStats step_stats;
+    StepStatsCollector collector(&step_stats);
+    Executor::Args args;
+    args.rendezvous = rendez_;
+    args.stats_collector = &collector;
+    args.runner = runner.runner();
+    Notification done;
+    Status status;
+    exec_->RunAsync(args, [&done, &status](const Status& s) {
+      status = s;
+      done.Notify();
+    });
+    runner.RunUntil(&done);
+    TF_CHECK_OK(status);
+    collector.Finalize();
+    order->clear();
+    for (const NodeExecStats& ns : step_stats.dev_stats(0).node_stats()) {
+      order->push_back(ns.node_name());
+    }
+    for (int len = 1; len <= N; ++len) {
+      Tensor out = V(-1);
+      bool is_dead = false;
+      TF_CHECK_OK(rendez_->Recv(
+          Key(BOB, kIncarnation, ALICE, strings::StrCat("c", len)),
+          rendez_args, &out, &is_dead));
+      CHECK_EQ(2.0 * (len + 1), V(out));
+    }
+    return runner.num_dispatched();
+  };
+
+  // Adds start out as expensive. When r finishes, the head of the longest
+  // chain stays on the thread and the other two are dispatched, longest
+  // remaining path first.
+  std::vector<string> order;
+  const int first_dispatched = run_step(&order);
+  auto position = [&order](const Node* n) {
+    return std::find(order.begin(), order.end(), n->name()) - order.begin();
+  };
+  EXPECT_LT(position(heads[2]), position(heads[1]));
+  EXPECT_LT(position(heads[1]), position(heads[0]));
+
+  // Once the measured costs have decayed the estimates, the Adds are cheap
+  // and all three heads run inline after r instead of being dispatched.
+  int last_dispatched = first_dispatched;
+  for (int step = 0; step < 200; ++step) {
+    last_dispatched = run_step(&order);
+  }
+  EXPECT_EQ(first_dispatched - (N - 1), last_dispatched);
+}
+
+TEST_F(ExecutorTest, LastUseInputs) {
+  // t = a + a, x = t + t, y = x + x. x and y read their inputs for the last
+  // time, but only x is marked as the last reader of both of its inputs.
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto a = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto t = test::graph::Add(g.get(), a, a);
+  auto x = test::graph::Add(g.get(), t, t);
+  x->AddAttr("_last_use_inputs", std::vector<int>({0, 1}));
+  auto y = test::graph::Add(g.get(), x, x);
+  y->AddAttr("_last_use_inputs", std::vector<int>({0}));
+  test::graph::Send(g.get(), y, "y", BOB, 1, ALICE);
+  Create(std::move(g));
+  Rendezvous::Args rendez_args;
+  TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), rendez_args,
+                             V(1.0), false));
+  StepStats step_stats;
+  StepStatsCollector collector(&step_stats);
+  Executor::Args args;
+  args.rendezvous = rendez_;
+  args.stats_collector = &collector;
+  args.runner = runner_;
+  TF_ASSERT_OK(exec_->Run(args));
+  collector.Finalize();
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "y"), rendez_args,
+                             &out, &is_dead));
+  EXPECT_EQ(8.0, V(out));
+
+  // x computes into the buffer of t; y has to allocate, because the other
+  // input still holds x.
+  std::map<string, int64> unforwarded_bytes;
+  for (const NodeExecStats& ns : step_stats.dev_stats(0).node_stats()) {
+    unforwarded_bytes[ns.node_name()] =
+        ns.memory_stats().unforwarded_output_bytes();
+  }
+  EXPECT_EQ(0, unforwarded_bytes[x->name()]);
+  EXPECT_EQ(4, unforwarded_bytes[y->name()]);
+}
+
+// Builds z = s:0 + s:1, where "op" (Split or Unpack) splits a 2x16 constant
+// into its rows, with z marked as the last reader of both rows, and sends z.
+std::unique_ptr<Graph> AddOfRows(const string& op) {
+  Tensor value(DT_FLOAT, TensorShape({2, 16}));
+  for (int i = 0; i < 32; ++i) value.flat<float>()(i) = i;
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  Node* c = test::graph::Constant(g.get(), value);
+  Node* s;
+  if (op == "Split") {
+    TF_CHECK_OK(NodeBuilder("s", "Split")
+                    .Input(test::graph::Constant(g.get(), VI(0)))
+                    .Input(c)
+                    .Attr("num_split", 2)
+                    .Finalize(g.get(), &s));
+  } else {
+    TF_CHECK_OK(NodeBuilder("s", "Unpack")
+                    .Input(c)
+                    .Attr("num", 2)
+                    .Attr("axis", 0)
+                    .Finalize(g.get(), &s));
+  }
+  Node* z;
+  TF_CHECK_OK(NodeBuilder("z", "Add")
+                  .Input(s, 0)
+                  .Input(s, 1)
+                  .Attr("_last_use_inputs", std::vector<int>({0, 1}))
+                  .Finalize(g.get(), &z));
+  test::graph::Send(g.get(), z, "z", BOB, 1, ALICE);
+  return g;
+}
+
+// The rows are slices of one buffer, but they are different tensors and must
+// not be merged into one input.
+TEST_F(ExecutorTest, LastUseInputsKeepSplitOutputsApart) {
+  Create(AddOfRows("Split"));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out;
+  bool is_dead = false;
+  TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "z"),
+                             Rendezvous::Args(), &out, &is_dead));
+  Tensor expected(DT_FLOAT, TensorShape({1, 16}));
+  for (int i = 0; i < 16; ++i) expected.flat<float>()(i) = 16 + 2 * i;
+  test::ExpectTensorEqual<float>(expected, out);
+}
+
+TEST_F(ExecutorTest, LastUseInputsKeepUnpackOutputsApart) {
+  Create(AddOfRows("Unpack"));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out;
+  bool is_dead = false;
+  TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "z"),
+                             Rendezvous::Args(), &out, &is_dead));
+  Tensor expected(DT_FLOAT, TensorShape({16}));
+  for (int i = 0; i < 16; ++i) expected.flat<float>()(i) = 16 + 2 * i;
+  test::ExpectTensorEqual<float>(expected, out);
+}
+
+// Returns the number of steps and the number of states they allocated, as
+// recorded by the executor_step_allocations metric.
+void GetStepAllocations(int64* num_steps, double* num_allocations) {
+  std::unique_ptr<monitoring::CollectedMetrics> metrics =
+      monitoring::CollectionRegistry::Default()->CollectMetrics(
+          monitoring::CollectionRegistry::CollectMetricsOptions());
+  const monitoring::PointSet& point_set = *metrics->point_set_map.at(
+      "/tensorflow/core/executor_step_allocations");
+  ASSERT_EQ(1, point_set.points.size());
+  *num_steps = point_set.points[0]->histogram_value.num();
+  *num_allocations = point_set.points[0]->histogram_value.sum();
+}
+
+TEST_F(ExecutorTest, ReusesIterationStates) {
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto tmp = test::graph::Add(g.get(), in, in);
+  test::graph::Send(g.get(), tmp, "c", BOB, 1, ALICE);
+  Create(std::move(g));
+
+  std::vector<double> step_allocations;
+  for (int step = 0; step < 3; ++step) {
+    int64 steps_before = 0;
+    double allocations_before = 0;
+    GetStepAllocations(&steps_before, &allocations_before);
+    Rendezvous::Args args;
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args,
+                               V(step), false));
+    TF_ASSERT_OK(Run(rendez_));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out,
+                               &is_dead));
+    EXPECT_EQ(2.0 * step, V(out));
+    int64 steps_after = 0;
+    double allocations_after = 0;
+    GetStepAllocations(&steps_after, &allocations_after);
+    EXPECT_EQ(steps_before + 1, steps_after);
+    step_allocations.push_back(allocations_after - allocations_before);
+  }
+  // The executor and root frame states, plus the state of iteration 0 in
+  // the first step only.
+  EXPECT_EQ(std::vector<double>({3, 2, 2}), step_allocations);
+}
+
 TEST_F(ExecutorTest, RandomTree) {
   std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
   BuildTree(4096, g.get());
@@ -16,13 +16,21 @@ limitations under the License.
 #define EIGEN_USE_THREADS
 
 #include "tensorflow/core/common_runtime/local_device.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/common_runtime/eigen_thread_pool.h"
+#include "tensorflow/core/common_runtime/unified_thread_pool.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/cpu_feature_guard.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -32,29 +40,52 @@ namespace tensorflow {
 bool LocalDevice::use_global_threadpool_ = true;
 
 struct LocalDevice::EigenThreadPoolInfo {
-  explicit EigenThreadPoolInfo(const SessionOptions& options) {
+  // Unless "numa_node" is port::kNUMANoAffinity, the threads are pinned to
+  // that node and the pool gets its share of intra_op_parallelism_threads (or
+  // of the CPUs), so that the node pools together stay within the budget.
+  EigenThreadPoolInfo(const SessionOptions& options, int numa_node) {
     int32 intra_op_parallelism_threads =
         options.config.intra_op_parallelism_threads();
     if (intra_op_parallelism_threads == 0) {
       intra_op_parallelism_threads = port::NumSchedulableCPUs();
     }
+    if (numa_node != port::kNUMANoAffinity) {
+      // Assumes the CPUs are spread evenly over the nodes.
+      intra_op_parallelism_threads =
+          std::max(1, intra_op_parallelism_threads / port::NUMANumNodes());
+    }
     VLOG(1) << "Local device intra op parallelism threads: "
-            << intra_op_parallelism_threads;
+            << intra_op_parallelism_threads << " numa_node: " << numa_node;
+    ThreadOptions thread_opts;
+    thread_opts.numa_node = numa_node;
     eigen_worker_threads_.num_threads = intra_op_parallelism_threads;
     eigen_worker_threads_.workers = new thread::ThreadPool(
-        options.env, "Eigen", intra_op_parallelism_threads);
+        options.env, thread_opts,
+        numa_node == port::kNUMANoAffinity
+            ? "Eigen"
+            : strings::StrCat("numa_", numa_node, "_Eigen"),
+        intra_op_parallelism_threads);
     eigen_threadpool_wrapper_.reset(
         new EigenThreadPoolWrapper(eigen_worker_threads_.workers));
     eigen_device_.reset(new Eigen::ThreadPoolDevice(
         eigen_threadpool_wrapper_.get(), eigen_worker_threads_.num_threads));
   }
 
+  // Runs intra-op work on the workers of "pool", which it does not own.
+  explicit EigenThreadPoolInfo(UnifiedThreadPool* pool) : owns_workers_(false) {
+    eigen_worker_threads_.num_threads = pool->NumThreads();
+    eigen_worker_threads_.workers = pool->workers();
+    eigen_device_.reset(new Eigen::ThreadPoolDevice(
+        pool->eigen_pool(), eigen_worker_threads_.num_threads));
+  }
+
   ~EigenThreadPoolInfo() {
     eigen_threadpool_wrapper_.reset();
     eigen_device_.reset();
-    delete eigen_worker_threads_.workers;
+    if (owns_workers_) delete eigen_worker_threads_.workers;
   }
 
+  const bool owns_workers_ = true;
   DeviceBase::CpuWorkerThreads eigen_worker_threads_;
   std::unique_ptr<Eigen::ThreadPoolInterface> eigen_threadpool_wrapper_;
   std::unique_ptr<Eigen::ThreadPoolDevice> eigen_device_;
@@ -66,17 +97,38 @@ LocalDevice::LocalDevice(const SessionOptions& options,
   // Log info messages if TensorFlow is not compiled with instructions that
   // could speed up performance and are available on the current CPU.
   port::InfoAboutUnusedCPUFeatures();
+  int numa_node = port::kNUMANoAffinity;
+  if (UseNUMAAffinity(options) && attributes.locality().numa_node() >= 0 &&
+      attributes.locality().numa_node() < port::NUMANumNodes()) {
+    numa_node = attributes.locality().numa_node();
+  }
   LocalDevice::EigenThreadPoolInfo* tp_info;
-  if (use_global_threadpool_) {
-    // All ThreadPoolDevices in the process will use this single fixed
-    // sized threadpool for numerical computations.
-    static LocalDevice::EigenThreadPoolInfo* global_tp_info =
-        new LocalDevice::EigenThreadPoolInfo(options);
-    tp_info = global_tp_info;
+  if (options.config.experimental().use_unified_thread_pool()) {
+    // Intra-op work shares the workers of the inter-op pool, so NUMA
+    // affinity and intra_op_parallelism_threads do not apply.
+    static LocalDevice::EigenThreadPoolInfo* unified_tp_info =
+        new LocalDevice::EigenThreadPoolInfo(UnifiedComputePool(options));
+    tp_info = unified_tp_info;
+  } else if (use_global_threadpool_) {
+    // All ThreadPoolDevices in the process on the same NUMA node (or all of
+    // them, without NUMA affinity) use a single fixed sized threadpool for
+    // numerical computations. Index 0 is the pool without affinity.
+    static mutex* global_tp_mu = new mutex;
+    static std::vector<LocalDevice::EigenThreadPoolInfo*>* global_tp_info =
+        new std::vector<LocalDevice::EigenThreadPoolInfo*>;
+    mutex_lock l(*global_tp_mu);
+    const size_t index = numa_node + 1;
+    if (global_tp_info->size() <= index) global_tp_info->resize(index + 1);
+    if ((*global_tp_info)[index] == nullptr) {
+      (*global_tp_info)[index] =
+          new LocalDevice::EigenThreadPoolInfo(options, numa_node);
+    }
+    tp_info = (*global_tp_info)[index];
   } else {
     // Each LocalDevice owns a separate ThreadPoolDevice for numerical
     // computations.
-    owned_tp_info_.reset(new LocalDevice::EigenThreadPoolInfo(options));
+    owned_tp_info_.reset(
+        new LocalDevice::EigenThreadPoolInfo(options, numa_node));
     tp_info = owned_tp_info_.get();
   }
   set_tensorflow_cpu_worker_threads(&tp_info->eigen_worker_threads_);
@@ -85,4 +137,10 @@ LocalDevice::LocalDevice(const SessionOptions& options,
 
 LocalDevice::~LocalDevice() {}
 
+/* static */
+bool LocalDevice::UseNUMAAffinity(const SessionOptions& options) {
+  return options.config.experimental().use_numa_affinity() &&
+         port::NUMAEnabled();
+}
+
 }  // namespace tensorflow
@@ -38,6 +38,11 @@ class LocalDevice : public TracingDevice {
               const DeviceAttributes& attributes);
   ~LocalDevice() override;
 
+  // True if "options" ask for NUMA affinity and the machine has more than
+  // one node. Devices then bind their threads and memory to the node in
+  // their DeviceLocality.
+  static bool UseNUMAAffinity(const SessionOptions& options);
+
  private:
   static bool use_global_threadpool_;
 
@@ -0,0 +1,287 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/memory_planner.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+auto* memory_plan_allocations = monitoring::Counter<1>::New(
+    "/tensorflow/core/memory_plan_allocations",
+    "The number of planned outputs served from their step's arena ('arena') "
+    "or, when the plan missed, from the device allocator ('fallback').",
+    "result");
+
+int64 RoundUpToAlignment(int64 bytes) {
+  const int64 alignment = Allocator::kAllocatorAlignment;
+  return (bytes + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+MemoryPlanner::MemoryPlanner(const Graph* graph,
+                             const std::vector<bool>& in_root_frame,
+                             Allocator* allocator)
+    : allocator_(allocator), output_base_(graph->num_node_ids(), -1) {
+  std::vector<Node*> order;
+  GetReversePostOrder(*graph, &order);
+  std::vector<int> position(graph->num_node_ids(), 0);
+  for (size_t i = 0; i < order.size(); ++i) {
+    position[order[i]->id()] = i;
+  }
+
+  for (const Node* n : order) {
+    if (!in_root_frame[n->id()] || n->num_outputs() == 0) continue;
+    output_base_[n->id()] = num_outputs_;
+    num_outputs_ += n->num_outputs();
+    begin_.resize(num_outputs_, position[n->id()]);
+    end_.resize(num_outputs_, position[n->id()]);
+  }
+  for (const Node* n : order) {
+    const int base = output_base_[n->id()];
+    if (base < 0) continue;
+    for (const Edge* e : n->out_edges()) {
+      if (e->IsControlEdge()) continue;
+      int& end = end_[base + e->src_output()];
+      // A tensor that enters a loop is read until the loop finishes.
+      end = in_root_frame[e->dst()->id()]
+                ? std::max(end, position[e->dst()->id()])
+                : kint32max;
+    }
+  }
+
+  observed_bytes_.reset(new std::atomic<int64>[num_outputs_]);
+  for (int i = 0; i < num_outputs_; ++i) {
+    observed_bytes_[i] = 0;
+  }
+}
+
+StepMemory* MemoryPlanner::BeginStep() {
+  if (num_outputs_ == 0) return nullptr;
+  {
+    mutex_lock l(mu_);
+    if (!planned_) return new StepMemory(this, nullptr);
+  }
+  if (arena_bytes_ == 0) return nullptr;
+  void* arena =
+      allocator_->AllocateRaw(Allocator::kAllocatorAlignment, arena_bytes_);
+  if (arena == nullptr) {
+    VLOG(1) << "Could not allocate a planned arena of " << arena_bytes_
+            << " bytes; this step allocates its outputs dynamically.";
+    return nullptr;
+  }
+  return new StepMemory(this, static_cast<char*>(arena));
+}
+
+int64 MemoryPlanner::arena_bytes() const {
+  mutex_lock l(mu_);
+  return planned_ ? arena_bytes_ : 0;
+}
+
+void MemoryPlanner::RecordSize(int index, size_t num_bytes) {
+  int64 expected = 0;
+  const int64 bytes = num_bytes;
+  if (!observed_bytes_[index].compare_exchange_strong(expected, bytes) &&
+      expected != bytes) {
+    observed_bytes_[index] = -1;
+  }
+}
+
+void MemoryPlanner::BuildPlan() {
+  mutex_lock l(mu_);
+  if (planned_) return;
+
+  std::vector<int> outputs;
+  for (int i = 0; i < num_outputs_; ++i) {
+    if (observed_bytes_[i] > 0) outputs.push_back(i);
+  }
+  // Place the largest outputs first, each in the smallest buffer it fits in
+  // without overlapping the lifetime of an output already there.
+  std::sort(outputs.begin(), outputs.end(), [this](int a, int b) {
+    const int64 bytes_a = observed_bytes_[a];
+    const int64 bytes_b = observed_bytes_[b];
+    return bytes_a != bytes_b ? bytes_a > bytes_b : begin_[a] < begin_[b];
+  });
+  struct Buffer {
+    int64 bytes;
+    // The outputs using this buffer, keyed by begin_.
+    std::map<int, int> uses;
+  };
+  std::vector<Buffer> buffers;
+  for (int i : outputs) {
+    int best = -1;
+    for (size_t b = 0; b < buffers.size(); ++b) {
+      const std::map<int, int>& uses = buffers[b].uses;
+      auto next = uses.lower_bound(begin_[i]);
+      if (next != uses.end() && next->first <= end_[i]) continue;
+      if (next != uses.begin() && end_[std::prev(next)->second] >= begin_[i]) {
+        continue;
+      }
+      if (best < 0 || buffers[b].bytes < buffers[best].bytes) best = b;
+    }
+    if (best < 0) {
+      best = buffers.size();
+      buffers.push_back({RoundUpToAlignment(observed_bytes_[i]), {}});
+    }
+    buffers[best].uses[begin_[i]] = i;
+  }
+
+  offset_.assign(num_outputs_, -1);
+  planned_bytes_.assign(num_outputs_, -1);
+  prev_.assign(num_outputs_, -1);
+  int64 total_bytes = 0;
+  for (const Buffer& buffer : buffers) {
+    int prev = -1;
+    for (const auto& use : buffer.uses) {
+      const int i = use.second;
+      offset_[i] = arena_bytes_;
+      planned_bytes_[i] = observed_bytes_[i];
+      prev_[i] = prev;
+      prev = i;
+      total_bytes += RoundUpToAlignment(planned_bytes_[i]);
+    }
+    arena_bytes_ += buffer.bytes;
+  }
+  planned_ = true;
+  VLOG(1) << "Planned " << outputs.size() << " of " << num_outputs_
+          << " outputs into " << buffers.size() << " buffers: "
+          << strings::HumanReadableNumBytes(arena_bytes_) << " instead of "
+          << strings::HumanReadableNumBytes(total_bytes);
+}
+
+// Hands out the planned slice of one output. The executor passes these to
+// the output's kernel through OpKernelContext::Params.
+class StepMemory::SlotAllocator : public Allocator {
+ public:
+  string Name() override { return "step_memory"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    return step_->AllocateSlot(index_, alignment, num_bytes,
+                               AllocationAttributes());
+  }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override {
+    return step_->AllocateSlot(index_, alignment, num_bytes, allocation_attr);
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    step_->DeallocateSlot(index_, ptr);
+  }
+
+ private:
+  friend class StepMemory;
+
+  StepMemory* step_ = nullptr;
+  int index_ = 0;
+};
+
+StepMemory::StepMemory(MemoryPlanner* planner, char* arena)
+    : planner_(planner), arena_(arena) {
+  planner_->Ref();
+  const int num_outputs = planner_->num_outputs_;
+  slots_.reset(new SlotAllocator[num_outputs]);
+  allocators_.resize(num_outputs, nullptr);
+  for (int i = 0; i < num_outputs; ++i) {
+    slots_[i].step_ = this;
+    slots_[i].index_ = i;
+    if (arena_ == nullptr || planner_->offset_[i] >= 0) {
+      allocators_[i] = &slots_[i];
+    }
+  }
+  if (arena_ != nullptr) {
+    states_.reset(new std::atomic<int>[num_outputs]);
+    for (int i = 0; i < num_outputs; ++i) {
+      states_[i] = kUnused;
+    }
+  }
+}
+
+StepMemory::~StepMemory() {
+  if (arena_ != nullptr) {
+    planner_->allocator_->DeallocateRaw(arena_);
+  }
+  planner_->Unref();
+}
+
+void StepMemory::EndStep() {
+  if (arena_ == nullptr) {
+    planner_->BuildPlan();
+  }
+  Unref();
+}
+
+void* StepMemory::AllocateSlot(int index, size_t alignment, size_t num_bytes,
+                               const AllocationAttributes& allocation_attr) {
+  void* ptr = nullptr;
+  if (arena_ == nullptr) {
+    planner_->RecordSize(index, num_bytes);
+  } else if (static_cast<int64>(num_bytes) <= planner_->planned_bytes_[index] &&
+             Allocator::kAllocatorAlignment % alignment == 0 &&
+             Claim(index)) {
+    ptr = arena_ + planner_->offset_[index];
+  }
+  if (arena_ != nullptr) {
+    memory_plan_allocations->GetCell(ptr == nullptr ? "fallback" : "arena")
+        ->IncrementBy(1);
+  }
+  if (ptr == nullptr) {
+    ptr = planner_->allocator_->AllocateRaw(alignment, num_bytes,
+                                            allocation_attr);
+  }
+  if (ptr != nullptr) Ref();
+  return ptr;
+}
+
+void StepMemory::DeallocateSlot(int index, void* ptr) {
+  if (arena_ != nullptr && ptr == arena_ + planner_->offset_[index]) {
+    states_[index] = kReleased;
+  } else {
+    planner_->allocator_->DeallocateRaw(ptr);
+  }
+  Unref();
+}
+
+bool StepMemory::Claim(int index) {
+  int state = kUnused;
+  if (!states_[index].compare_exchange_strong(state, kLive)) return false;
+  // Walk back through the earlier users of the buffer. A released one was
+  // itself claimed after everything before it was done, so the walk can
+  // stop there. Ones that have not run yet give up their turn.
+  for (int prev = planner_->prev_[index]; prev >= 0;
+       prev = planner_->prev_[prev]) {
+    state = kUnused;
+    if (states_[prev].compare_exchange_strong(state, kSkipped) ||
+        state == kSkipped) {
+      continue;
+    }
+    if (state == kReleased) break;
+    states_[index] = kSkipped;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace tensorflow
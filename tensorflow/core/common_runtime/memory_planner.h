@@ -0,0 +1,153 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_MEMORY_PLANNER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+class StepMemory;
+
+// Plans the output buffers of an executor's kernels ahead of time, in the
+// spirit of TFLite's ArenaPlanner. Each step then makes one allocation for
+// an arena, and kernels receive preassigned slices of it from
+// OpKernelContext::allocate_output.
+//
+// Partition graphs get their inputs through _Arg and _Recv nodes, which carry
+// no shapes, so sizes come from the first step instead of shape inference:
+// every output that is allocated exactly once, with the same size, is
+// planned. Outputs are assigned to shared buffers so that no two outputs in
+// one buffer are live at once in the topological order of the graph.
+//
+// The plan is only a prediction. A kernel asking for more bytes than were
+// planned, a tensor that outlives its planned lifetime, or a schedule that
+// runs a producer before the previous user of its buffer is done all fall
+// back to the device allocator for that output, so planning never changes
+// results.
+//
+// Each StepMemory holds a reference to its planner, since tensors in an
+// arena may outlive the executor that planned it.
+class MemoryPlanner : public core::RefCounted {
+ public:
+  // Plans the outputs of the nodes "n" of "graph" with in_root_frame[n->id()]
+  // set; these run at most once per step. "allocator" serves the arenas and
+  // every allocation that falls back.
+  MemoryPlanner(const Graph* graph, const std::vector<bool>& in_root_frame,
+                Allocator* allocator);
+
+  // Returns the memory for a new step, or nullptr if there is nothing to
+  // plan. The caller calls StepMemory::EndStep() once the step's kernels
+  // have all run.
+  StepMemory* BeginStep();
+
+  // Bytes in each step's arena, or 0 before the plan is built.
+  int64 arena_bytes() const;
+
+ private:
+  friend class StepMemory;
+
+  ~MemoryPlanner() override {}
+
+  // Records that output "index" was allocated with "num_bytes".
+  void RecordSize(int index, size_t num_bytes);
+  // Builds the plan from the recorded sizes.
+  void BuildPlan();
+
+  Allocator* const allocator_;
+  // Index of the first output of each node, or -1 if the node is not planned.
+  std::vector<int> output_base_;
+  int num_outputs_ = 0;
+  // Lifetime of each output in the topological order: it is produced at
+  // begin_[i] and last read at end_[i].
+  std::vector<int> begin_;
+  std::vector<int> end_;
+  // Size of each output seen so far: 0 if not allocated yet, -1 if it
+  // varied or was allocated more than once.
+  std::unique_ptr<std::atomic<int64>[]> observed_bytes_;
+
+  mutable mutex mu_;
+  bool planned_ GUARDED_BY(mu_) = false;
+  // The plan; immutable once planned_ is set. Per output: the offset in the
+  // arena and the planned size, or -1, and the output that used the same
+  // buffer just before it, or -1.
+  std::vector<int64> offset_;
+  std::vector<int64> planned_bytes_;
+  std::vector<int> prev_;
+  int64 arena_bytes_ = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MemoryPlanner);
+};
+
+// The planned memory of one step. Kernels reach it through the allocators
+// returned by output_allocators(); each allocation holds a reference, so the
+// arena stays alive while any tensor in it does, even past the end of the
+// step. The arena is freed as a whole: a single fetched output that the
+// caller keeps pins all arena_bytes() of it, not just its own slice.
+class StepMemory : public core::RefCounted {
+ public:
+  // Returns the allocators for the outputs of node "id", indexed by output,
+  // or nullptr. An entry is nullptr if the output is not planned.
+  Allocator* const* output_allocators(int id) const {
+    const int base = planner_->output_base_[id];
+    return base < 0 ? nullptr : allocators_.data() + base;
+  }
+
+  // Called by the executor when the step is done.
+  void EndStep();
+
+ private:
+  friend class MemoryPlanner;
+  class SlotAllocator;
+
+  // Per-output states. A planned slice moves from kUnused to kLive when
+  // handed out and to kReleased when freed. kSkipped marks a slice that
+  // must not be handed out in this step because a later user of its buffer
+  // got there first.
+  enum SlotState { kUnused, kLive, kReleased, kSkipped };
+
+  StepMemory(MemoryPlanner* planner, char* arena);
+  ~StepMemory() override;
+
+  void* AllocateSlot(int index, size_t alignment, size_t num_bytes,
+                     const AllocationAttributes& allocation_attr);
+  void DeallocateSlot(int index, void* ptr);
+  // Takes the slice of output "index" if every earlier user of its buffer
+  // is done with it.
+  bool Claim(int index);
+
+  MemoryPlanner* const planner_;
+  // The step's arena, or nullptr while the planner is observing sizes.
+  char* const arena_;
+  std::unique_ptr<SlotAllocator[]> slots_;
+  std::vector<Allocator*> allocators_;
+  std::unique_ptr<std::atomic<int>[]> states_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StepMemory);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_MEMORY_PLANNER_H_
@@ -0,0 +1,137 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/memory_planner.h"
+
+#include <vector>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class MemoryPlannerTest : public ::testing::Test {
+ protected:
+  // Builds the chain c -> i1 -> i2 -> i3 and a planner for it.
+  MemoryPlannerTest() : graph_(OpRegistry::Global()) {
+    Tensor t(DT_FLOAT, TensorShape({}));
+    t.scalar<float>()() = 1;
+    nodes_.push_back(test::graph::Constant(&graph_, t));
+    for (int i = 0; i < 3; ++i) {
+      nodes_.push_back(test::graph::Identity(&graph_, nodes_.back()));
+    }
+    FixupSourceAndSinkEdges(&graph_);
+    planner_ = new MemoryPlanner(
+        &graph_, std::vector<bool>(graph_.num_node_ids(), true),
+        cpu_allocator());
+  }
+
+  ~MemoryPlannerTest() override { planner_->Unref(); }
+
+  Allocator* OutputAllocator(StepMemory* step, int node) {
+    Allocator* const* allocators =
+        step->output_allocators(nodes_[node]->id());
+    return allocators == nullptr ? nullptr : allocators[0];
+  }
+
+  // Runs a step that allocates and frees each output in chain order.
+  void RunStep(size_t num_bytes) {
+    StepMemory* step = planner_->BeginStep();
+    ASSERT_NE(nullptr, step);
+    void* prev = nullptr;
+    for (int i = 0; i < static_cast<int>(nodes_.size()); ++i) {
+      Allocator* a = OutputAllocator(step, i);
+      ASSERT_NE(nullptr, a);
+      void* ptr = a->AllocateRaw(Allocator::kAllocatorAlignment, num_bytes);
+      ASSERT_NE(nullptr, ptr);
+      if (prev != nullptr) OutputAllocator(step, i - 1)->DeallocateRaw(prev);
+      prev = ptr;
+    }
+    OutputAllocator(step, nodes_.size() - 1)->DeallocateRaw(prev);
+    step->EndStep();
+  }
+
+  Graph graph_;
+  std::vector<Node*> nodes_;
+  MemoryPlanner* planner_;
+};
+
+TEST_F(MemoryPlannerTest, ReusesBuffersAfterFirstStep) {
+  EXPECT_EQ(0, planner_->arena_bytes());
+  RunStep(1000);
+  // Outputs 0 and 2 share one buffer, outputs 1 and 3 another.
+  EXPECT_EQ(2 * 1024, planner_->arena_bytes());
+
+  StepMemory* step = planner_->BeginStep();
+  ASSERT_NE(nullptr, step);
+  void* p0 = OutputAllocator(step, 0)->AllocateRaw(64, 1000);
+  void* p1 = OutputAllocator(step, 1)->AllocateRaw(64, 1000);
+  OutputAllocator(step, 0)->DeallocateRaw(p0);
+  void* p2 = OutputAllocator(step, 2)->AllocateRaw(64, 1000);
+  EXPECT_EQ(p0, p2);
+  EXPECT_NE(p1, p2);
+  OutputAllocator(step, 1)->DeallocateRaw(p1);
+  OutputAllocator(step, 2)->DeallocateRaw(p2);
+  step->EndStep();
+}
+
+TEST_F(MemoryPlannerTest, FallsBackWhenBufferIsBusy) {
+  RunStep(1000);
+  StepMemory* step = planner_->BeginStep();
+  ASSERT_NE(nullptr, step);
+  // Output 0 is still alive when output 2 wants its buffer.
+  void* p0 = OutputAllocator(step, 0)->AllocateRaw(64, 1000);
+  void* p2 = OutputAllocator(step, 2)->AllocateRaw(64, 1000);
+  ASSERT_NE(nullptr, p2);
+  EXPECT_NE(p0, p2);
+  // Output 1 asks for more than was planned.
+  void* p1 = OutputAllocator(step, 1)->AllocateRaw(64, 2000);
+  ASSERT_NE(nullptr, p1);
+  EXPECT_NE(p0, p1);
+  EXPECT_NE(p2, p1);
+  step->EndStep();
+  // The tensors may outlive the step.
+  OutputAllocator(step, 0)->DeallocateRaw(p0);
+  OutputAllocator(step, 1)->DeallocateRaw(p1);
+  OutputAllocator(step, 2)->DeallocateRaw(p2);
+}
+
+TEST_F(MemoryPlannerTest, SkipsOutputsWithChangingSizes) {
+  StepMemory* step1 = planner_->BeginStep();
+  StepMemory* step2 = planner_->BeginStep();
+  for (StepMemory* step : {step1, step2}) {
+    const size_t num_bytes = step == step1 ? 100 : 200;
+    for (int i = 0; i < static_cast<int>(nodes_.size()); ++i) {
+      // Only output 3 changes size between the steps.
+      Allocator* a = OutputAllocator(step, i);
+      a->DeallocateRaw(a->AllocateRaw(64, i == 3 ? num_bytes : 100));
+    }
+  }
+  step1->EndStep();
+  step2->EndStep();
+  EXPECT_EQ(2 * 128, planner_->arena_bytes());
+
+  StepMemory* step = planner_->BeginStep();
+  EXPECT_NE(nullptr, OutputAllocator(step, 0));
+  EXPECT_EQ(nullptr, OutputAllocator(step, 3));
+  step->EndStep();
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/env_var.h"
 
@@ -76,11 +77,15 @@ VisitableAllocator* ProcessState::GetCPUAllocator(int numa_node) {
   if (!numa_enabled_) numa_node = 0;
   mutex_lock lock(mu_);
   while (cpu_allocators_.size() <= static_cast<size_t>(numa_node)) {
+    // Allocators are created in node order, so this one serves the node
+    // matching its index.
+    const int node = cpu_allocators_.size();
     bool use_bfc_allocator = false;
     // TODO(reedwm): Switch default to BGFAllocator if it's at least as fast and
-    // efficient.
-    Status status = ReadBoolFromEnvVar("TF_CPU_ALLOCATOR_USE_BFC", false,
-                                       &use_bfc_allocator);
+    // efficient. With NUMA the default is already BFC, which binds a few large
+    // regions to the node instead of one mapping per pooled buffer.
+    Status status = ReadBoolFromEnvVar("TF_CPU_ALLOCATOR_USE_BFC",
+                                       numa_enabled_, &use_bfc_allocator);
     if (!status.ok()) {
       LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
     }
@@ -95,19 +100,26 @@ VisitableAllocator* ProcessState::GetCPUAllocator(int numa_node) {
         LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
       }
       int64 cpu_mem_limit = cpu_mem_limit_in_mb * (1LL << 20);
+      bool thread_caching = true;
+      status = ReadBoolFromEnvVar("TF_CPU_BFC_THREAD_CACHING", true,
+                                  &thread_caching);
+      if (!status.ok()) {
+        LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
+      }
       allocator = new BFCAllocator(
-          new BasicCPUAllocator(numa_enabled_ ? numa_node : -1), cpu_mem_limit,
-          true /*allow_growth*/, "bfc_cpu_allocator_for_gpu" /*name*/);
+          new BasicCPUAllocator(numa_enabled_ ? node : port::kNUMANoAffinity),
+          cpu_mem_limit, true /*allow_growth*/,
+          "bfc_cpu_allocator_for_gpu" /*name*/, thread_caching);
       VLOG(2) << "Using BFCAllocator with memory limit of "
               << cpu_mem_limit_in_mb << " MB for ProcessState CPU allocator";
     } else {
       allocator = new PoolAllocator(
           100 /*pool_size_limit*/, true /*auto_resize*/,
-          new BasicCPUAllocator(numa_enabled_ ? numa_node : -1),
+          new BasicCPUAllocator(numa_enabled_ ? node : port::kNUMANoAffinity),
           new NoopRounder, "cpu_pool");
       VLOG(2) << "Using PoolAllocator for ProcessState CPU allocator "
               << "numa_enabled_=" << numa_enabled_
-              << " numa_node=" << numa_node;
+              << " numa_node=" << node;
     }
     if (LogMemory::IsEnabled()) {
       // Wrap the allocator to track allocation ids for better logging
@@ -63,8 +63,9 @@ class ProcessState {
   // If we know nothing, it's called CPU 0 with no other attributes.
   MemDesc PtrType(const void* ptr);
 
-  // Returns the one CPUAllocator used for the given numa_node.
-  // TEMPORARY: ignores numa_node.
+  // Returns the one CPUAllocator used for the given numa_node. Its memory is
+  // bound to that node once EnableNUMA() has been called; before that every
+  // node shares the allocator of node 0.
   VisitableAllocator* GetCPUAllocator(int numa_node);
 
   typedef std::unordered_map<const void*, MemDesc> MDMap;
@@ -108,6 +108,12 @@ class NodeExecStatsWrapper {
   // execution of this node.
   void SetReferencedTensors(const TensorReferenceVector& tensors);
 
+  // Records the bytes of the outputs that were allocated although they could
+  // have reused an input buffer.
+  void SetUnforwardedOutputBytes(int64 bytes) {
+    stats_->mutable_memory_stats()->set_unforwarded_output_bytes(bytes);
+  }
+
   // Sets the timeline_label field of the wrapped NodeExecStats, using data
   // from *node. Returns true iff the node is a transfer node.
   bool SetTimelineLabel(const Node* node);
@@ -0,0 +1,250 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_tracer.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/env_time.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Chrome traces are in microseconds; keeps the nanoseconds as decimals.
+string NanosToMicrosString(int64 nanos) {
+  return strings::Printf("%lld.%03lld", static_cast<long long>(nanos / 1000),
+                         static_cast<long long>(nanos % 1000));
+}
+
+}  // namespace
+
+constexpr int StepTracer::kRecordsPerThread;
+
+// A seqlock per slot: readers copy a record concurrently with its owner
+// overwriting it, and keep the copy only if the slot's sequence number shows
+// that no write overlapped. The record is held in atomic words so that the
+// racing reads are well defined.
+struct StepTracer::ThreadBuffer {
+  static constexpr int kWordsPerRecord =
+      sizeof(StepTraceRecord) / sizeof(int64);
+  static_assert(sizeof(StepTraceRecord) % sizeof(int64) == 0,
+                "StepTraceRecord must be a whole number of words");
+
+  struct Slot {
+    // 2 * (i + 1) once record i is written to this slot, and odd while a
+    // record is being written.
+    std::atomic<int64> seq{0};
+    std::atomic<int64> words[kWordsPerRecord];
+  };
+
+  int32 thread_id = 0;
+  // The number of records ever written. Only the owning thread writes.
+  std::atomic<int64> next{0};
+  Slot slots[kRecordsPerThread];
+};
+
+StepTracer* StepTracer::Global() {
+  static StepTracer* tracer = new StepTracer;
+  return tracer;
+}
+
+int32 StepTracer::RegisterGraph(const string& device, const string& allocator,
+                                const Graph& graph) {
+  GraphInfo info;
+  info.device = device;
+  info.allocator = allocator;
+  info.node_names.resize(graph.num_node_ids());
+  info.op_types.resize(graph.num_node_ids());
+  for (const Node* n : graph.nodes()) {
+    info.node_names[n->id()] = n->name();
+    info.op_types[n->id()] = n->type_string();
+  }
+  mutex_lock l(mu_);
+  const int32 graph_id = next_graph_id_++;
+  graphs_[graph_id] = std::move(info);
+  return graph_id;
+}
+
+void StepTracer::UnregisterGraph(int32 graph_id) {
+  mutex_lock l(mu_);
+  graphs_.erase(graph_id);
+}
+
+StepTracer::ThreadBuffer* StepTracer::GetThreadBuffer() {
+  static thread_local ThreadBuffer* buffer = nullptr;
+  if (buffer == nullptr) {
+    buffer = new ThreadBuffer;
+    mutex_lock l(mu_);
+    buffer->thread_id = buffers_.size();
+    buffers_.push_back(buffer);
+  }
+  return buffer;
+}
+
+void StepTracer::Record(const StepTraceRecord& record) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  const int64 n = buffer->next.load(std::memory_order_relaxed);
+  ThreadBuffer::Slot* slot = &buffer->slots[n % kRecordsPerThread];
+  StepTraceRecord stamped = record;
+  stamped.thread_id = buffer->thread_id;
+  int64 words[ThreadBuffer::kWordsPerRecord];
+  memcpy(words, &stamped, sizeof(stamped));
+  slot->seq.store(2 * n + 1, std::memory_order_relaxed);
+  // Orders the odd sequence number before the words, for readers that see
+  // any of the new words.
+  std::atomic_thread_fence(std::memory_order_release);
+  for (int i = 0; i < ThreadBuffer::kWordsPerRecord; ++i) {
+    slot->words[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot->seq.store(2 * (n + 1), std::memory_order_release);
+  buffer->next.store(n + 1, std::memory_order_release);
+}
+
+void StepTracer::CopyRecords(const ThreadBuffer& buffer,
+                             std::vector<StepTraceRecord>* records) {
+  const int64 end = buffer.next.load(std::memory_order_acquire);
+  const int64 begin = std::max<int64>(0, end - kRecordsPerThread);
+  records->reserve(records->size() + (end - begin));
+  for (int64 i = begin; i < end; ++i) {
+    const ThreadBuffer::Slot& slot = buffer.slots[i % kRecordsPerThread];
+    const int64 seq = slot.seq.load(std::memory_order_acquire);
+    // The owner has moved on and is overwriting or has overwritten record i.
+    if (seq != 2 * (i + 1)) continue;
+    int64 words[ThreadBuffer::kWordsPerRecord];
+    for (int w = 0; w < ThreadBuffer::kWordsPerRecord; ++w) {
+      words[w] = slot.words[w].load(std::memory_order_relaxed);
+    }
+    // Orders the reads of the words before the second read of the sequence
+    // number, which changes if a write overlapped them.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+    StepTraceRecord record;
+    memcpy(&record, words, sizeof(record));
+    records->push_back(record);
+  }
+}
+
+std::vector<StepTraceRecord> StepTracer::Collect(int64 step_id) const {
+  std::vector<ThreadBuffer*> buffers;
+  {
+    mutex_lock l(mu_);
+    buffers = buffers_;
+  }
+  std::vector<StepTraceRecord> records;
+  for (const ThreadBuffer* buffer : buffers) {
+    std::vector<StepTraceRecord> copied;
+    CopyRecords(*buffer, &copied);
+    for (const StepTraceRecord& record : copied) {
+      if (record.step_id == step_id) records.push_back(record);
+    }
+  }
+  std::sort(records.begin(), records.end(),
+            [](const StepTraceRecord& a, const StepTraceRecord& b) {
+              return a.start_nanos < b.start_nanos;
+            });
+  return records;
+}
+
+std::vector<int64> StepTracer::TracedSteps() const {
+  std::vector<ThreadBuffer*> buffers;
+  {
+    mutex_lock l(mu_);
+    buffers = buffers_;
+  }
+  std::set<int64> steps;
+  for (const ThreadBuffer* buffer : buffers) {
+    std::vector<StepTraceRecord> copied;
+    CopyRecords(*buffer, &copied);
+    for (const StepTraceRecord& record : copied) {
+      steps.insert(record.step_id);
+    }
+  }
+  return std::vector<int64>(steps.begin(), steps.end());
+}
+
+void StepTracer::ExportStepStats(int64 step_id, StepStats* step_stats) const {
+  const std::vector<StepTraceRecord> records = Collect(step_id);
+  mutex_lock l(mu_);
+  std::map<string, DeviceStepStats*> dev_stats;
+  for (const StepTraceRecord& record : records) {
+    auto it = graphs_.find(record.graph_id);
+    if (it == graphs_.end()) continue;
+    const GraphInfo& graph = it->second;
+    DeviceStepStats*& dss = dev_stats[graph.device];
+    if (dss == nullptr) {
+      dss = step_stats->add_dev_stats();
+      dss->set_device(graph.device);
+    }
+    NodeExecStats* ns = dss->add_node_stats();
+    const string& name = graph.node_names[record.node_id];
+    const int64 duration_nanos = record.end_nanos - record.start_nanos;
+    ns->set_node_name(name);
+    ns->set_timeline_label(
+        strings::StrCat(name, " = ", graph.op_types[record.node_id], "()"));
+    ns->set_thread_id(record.thread_id);
+    ns->set_all_start_micros(record.start_nanos / EnvTime::kMicrosToNanos);
+    ns->set_all_start_nanos(record.start_nanos);
+    ns->set_op_end_rel_micros(duration_nanos / EnvTime::kMicrosToNanos);
+    ns->set_op_end_rel_nanos(duration_nanos);
+    ns->set_all_end_rel_micros(duration_nanos / EnvTime::kMicrosToNanos);
+    ns->set_all_end_rel_nanos(duration_nanos);
+    if (record.output_bytes > 0) {
+      AllocatorMemoryUsed* memory = ns->add_memory();
+      memory->set_allocator_name(graph.allocator);
+      memory->set_total_bytes(record.output_bytes);
+      memory->set_peak_bytes(record.output_bytes);
+    }
+  }
+}
+
+string StepTracer::ExportChromeTrace(int64 step_id) const {
+  const std::vector<StepTraceRecord> records = Collect(step_id);
+  mutex_lock l(mu_);
+  // Node, op and device names need no escaping in JSON strings.
+  std::map<string, int> pids;
+  string events;
+  for (const StepTraceRecord& record : records) {
+    auto it = graphs_.find(record.graph_id);
+    if (it == graphs_.end()) continue;
+    const GraphInfo& graph = it->second;
+    auto pid = pids.insert({graph.device, pids.size()});
+    if (pid.second) {
+      strings::StrAppend(&events, events.empty() ? "" : ",\n",
+                         "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":",
+                         pid.first->second, ",\"args\":{\"name\":\"",
+                         graph.device, "\"}}");
+    }
+    strings::StrAppend(
+        &events, events.empty() ? "" : ",\n", "{\"name\":\"",
+        graph.op_types[record.node_id], "\",\"cat\":\"Op\",\"ph\":\"X\",",
+        "\"ts\":", NanosToMicrosString(record.start_nanos),
+        ",\"dur\":", NanosToMicrosString(record.end_nanos - record.start_nanos),
+        ",\"pid\":", pid.first->second, ",\"tid\":", record.thread_id,
+        ",\"args\":{\"name\":\"", graph.node_names[record.node_id],
+        "\",\"output_bytes\":", record.output_bytes, "}}");
+  }
+  return strings::StrCat("{\"traceEvents\":[\n", events, "\n]}\n");
+}
+
+}  // namespace tensorflow
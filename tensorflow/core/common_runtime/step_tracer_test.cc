@@ -0,0 +1,174 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_tracer.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class StepTracerTest : public ::testing::Test {
+ protected:
+  StepTracerTest() : graph_(OpRegistry::Global()) {
+    Tensor t(DT_FLOAT, TensorShape({}));
+    t.scalar<float>()() = 1;
+    const_ = test::graph::Constant(&graph_, t, "c");
+    identity_ = test::graph::Identity(&graph_, const_);
+    graph_id_ = tracer()->RegisterGraph("/device:CPU:0", "cpu", graph_);
+  }
+
+  ~StepTracerTest() override { tracer()->UnregisterGraph(graph_id_); }
+
+  StepTracer* tracer() { return StepTracer::Global(); }
+
+  void Record(int64 step_id, const Node* node, int64 start_nanos,
+              int64 end_nanos) {
+    StepTraceRecord record;
+    record.step_id = step_id;
+    record.start_nanos = start_nanos;
+    record.end_nanos = end_nanos;
+    record.output_bytes = 4;
+    record.graph_id = graph_id_;
+    record.node_id = node->id();
+    tracer()->Record(record);
+  }
+
+  Graph graph_;
+  Node* const_;
+  Node* identity_;
+  int32 graph_id_;
+};
+
+TEST_F(StepTracerTest, ExportsStepStats) {
+  Record(1001, const_, 2000, 3000);
+  Record(1001, identity_, 3500, 5000);
+  Record(1002, identity_, 6000, 7000);
+
+  StepStats step_stats;
+  tracer()->ExportStepStats(1001, &step_stats);
+  ASSERT_EQ(1, step_stats.dev_stats_size());
+  const DeviceStepStats& dev_stats = step_stats.dev_stats(0);
+  EXPECT_EQ("/device:CPU:0", dev_stats.device());
+  ASSERT_EQ(2, dev_stats.node_stats_size());
+  const NodeExecStats& c = dev_stats.node_stats(0);
+  EXPECT_EQ("c", c.node_name());
+  EXPECT_EQ("c = Const()", c.timeline_label());
+  EXPECT_EQ(2000, c.all_start_nanos());
+  EXPECT_EQ(1000, c.all_end_rel_nanos());
+  ASSERT_EQ(1, c.memory_size());
+  EXPECT_EQ("cpu", c.memory(0).allocator_name());
+  EXPECT_EQ(4, c.memory(0).total_bytes());
+  EXPECT_EQ(identity_->name(), dev_stats.node_stats(1).node_name());
+
+  std::vector<int64> steps = tracer()->TracedSteps();
+  EXPECT_NE(steps.end(), std::find(steps.begin(), steps.end(), 1001));
+  EXPECT_NE(steps.end(), std::find(steps.begin(), steps.end(), 1002));
+}
+
+TEST_F(StepTracerTest, ExportsChromeTrace) {
+  Record(2001, const_, 1234567, 1236567);
+  const string trace = tracer()->ExportChromeTrace(2001);
+  EXPECT_TRUE(str_util::StrContains(trace, "\"traceEvents\"")) << trace;
+  EXPECT_TRUE(str_util::StrContains(trace, "\"name\":\"Const\"")) << trace;
+  EXPECT_TRUE(str_util::StrContains(trace, "\"ts\":1234.567")) << trace;
+  EXPECT_TRUE(str_util::StrContains(trace, "\"dur\":2.000")) << trace;
+  EXPECT_TRUE(str_util::StrContains(trace, "/device:CPU:0")) << trace;
+}
+
+TEST_F(StepTracerTest, KeepsTheNewestRecords) {
+  const int kNumRecords = StepTracer::kRecordsPerThread + 10;
+  for (int i = 0; i < kNumRecords; ++i) {
+    Record(3001, const_, i, i + 1);
+  }
+  StepStats step_stats;
+  tracer()->ExportStepStats(3001, &step_stats);
+  ASSERT_EQ(1, step_stats.dev_stats_size());
+  const DeviceStepStats& dev_stats = step_stats.dev_stats(0);
+  ASSERT_EQ(StepTracer::kRecordsPerThread, dev_stats.node_stats_size());
+  EXPECT_EQ(10, dev_stats.node_stats(0).all_start_nanos());
+}
+
+TEST_F(StepTracerTest, RecordsFromManyThreads) {
+  const int kNumThreads = 8;
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), "trace", [this, t]() {
+            for (int i = 0; i < 100; ++i) {
+              Record(4001, identity_, t * 1000 + i, t * 1000 + i + 1);
+            }
+          }));
+    }
+  }
+  StepStats step_stats;
+  tracer()->ExportStepStats(4001, &step_stats);
+  ASSERT_EQ(1, step_stats.dev_stats_size());
+  EXPECT_EQ(kNumThreads * 100, step_stats.dev_stats(0).node_stats_size());
+}
+
+TEST_F(StepTracerTest, ExportsWhileRecording) {
+  // The writer wraps around its buffer many times while the reader exports.
+  // Every record the reader keeps must be one the writer wrote in full.
+  std::atomic<bool> done(false);
+  std::unique_ptr<Thread> writer(Env::Default()->StartThread(
+      ThreadOptions(), "trace", [this, &done]() {
+        for (int64 i = 1; i <= 50 * StepTracer::kRecordsPerThread; ++i) {
+          StepTraceRecord record;
+          record.step_id = 6001;
+          record.start_nanos = i;
+          record.end_nanos = 2 * i;
+          record.output_bytes = 3 * i;
+          record.graph_id = graph_id_;
+          record.node_id = const_->id();
+          tracer()->Record(record);
+        }
+        done = true;
+      }));
+  while (!done) {
+    StepStats step_stats;
+    tracer()->ExportStepStats(6001, &step_stats);
+    for (const DeviceStepStats& dev_stats : step_stats.dev_stats()) {
+      for (const NodeExecStats& ns : dev_stats.node_stats()) {
+        const int64 start = ns.all_start_nanos();
+        ASSERT_EQ(start, ns.all_end_rel_nanos());
+        ASSERT_EQ(1, ns.memory_size());
+        ASSERT_EQ(3 * start, ns.memory(0).total_bytes());
+      }
+    }
+  }
+  writer.reset();
+}
+
+TEST_F(StepTracerTest, SkipsUnregisteredGraphs) {
+  Record(5001, const_, 0, 1);
+  tracer()->UnregisterGraph(graph_id_);
+  StepStats step_stats;
+  tracer()->ExportStepStats(5001, &step_stats);
+  EXPECT_EQ(0, step_stats.dev_stats_size());
+}
+
+}  // namespace
+}  // namespace tensorflow
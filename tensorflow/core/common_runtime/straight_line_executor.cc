@@ -0,0 +1,523 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/straight_line_executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/log_memory.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/tensor_slice_reader_cache.h"
+
+namespace tensorflow {
+
+const char* const kStraightLineExecutor = "STRAIGHT_LINE";
+
+namespace {
+
+// Components are only given a thread of their own once the graph has this
+// many nodes per program; below that the hand-off costs more than it saves.
+static const int kMinNodesPerProgram = 16;
+
+// Returns OK if the straight-line executor can run "graph" on "device".
+Status CheckSupported(const Graph& graph, const Device* device) {
+  if (device->device_type() != DEVICE_CPU) {
+    return errors::Unimplemented("device type ", device->device_type());
+  }
+  for (const Node* n : graph.op_nodes()) {
+    if (n->IsControlFlow()) {
+      return errors::Unimplemented("control flow node ", n->name());
+    }
+    if (n->attrs().Find("_scoped_allocator") != nullptr) {
+      return errors::Unimplemented("scoped allocator node ", n->name());
+    }
+    for (DataType dt : n->input_types()) {
+      if (IsRefType(dt)) {
+        return errors::Unimplemented("reference input of ", n->name());
+      }
+    }
+    for (DataType dt : n->output_types()) {
+      if (IsRefType(dt)) {
+        return errors::Unimplemented("reference output of ", n->name());
+      }
+    }
+  }
+  return Status::OK();
+}
+
+int FindRoot(std::vector<int>* parent, int i) {
+  while ((*parent)[i] != i) {
+    (*parent)[i] = (*parent)[(*parent)[i]];
+    i = (*parent)[i];
+  }
+  return i;
+}
+
+class StraightLineExecutor : public Executor {
+ public:
+  StraightLineExecutor(const LocalExecutorParams& params,
+                       std::unique_ptr<const Graph> graph)
+      : params_(params), graph_(std::move(graph)) {}
+
+  ~StraightLineExecutor() override {
+    for (const Program& program : programs_) {
+      for (const KernelState& state : program.kernels) {
+        params_.delete_kernel(state.kernel);
+      }
+    }
+  }
+
+  Status Initialize();
+
+  void RunAsync(const Args& args, DoneCallback done) override;
+
+ private:
+  // A kernel and where its inputs and outputs live in its program's slots.
+  struct KernelState {
+    const Node* node = nullptr;
+    OpKernel* kernel = nullptr;
+    bool is_async = false;
+    bool is_transfer = false;
+    int input_start = 0;
+    int num_inputs = 0;
+    int num_outputs = 0;
+    // The slots fed by output i are
+    // output_targets[target_start[i]] .. output_targets[target_start[i+1]-1].
+    std::vector<int> target_start;
+    std::vector<int> output_targets;
+    // Indices in the program of the kernels with a control edge from this one.
+    std::vector<int> control_targets;
+  };
+
+  // Kernels in a valid execution order, sharing one array of input slots.
+  struct Program {
+    std::vector<KernelState> kernels;
+    int num_slots = 0;
+  };
+
+  struct RunState {
+    RunState(const Args& a, DoneCallback d, int num_programs)
+        : args(a), done(std::move(d)), pending(num_programs) {}
+
+    Args args;
+    DoneCallback done;
+    std::atomic<int> pending;
+    checkpoint::TensorSliceReaderCacheWrapper slice_reader_cache;
+    mutex mu;
+    Status status GUARDED_BY(mu);
+  };
+
+  // One program in one step. It lives until the program's last kernel is
+  // done, which is on another thread if an asynchronous kernel completes
+  // after ComputeAsync returns.
+  struct ProgramState {
+    ProgramState(const Program* p, RunState* r)
+        : program(p),
+          run(r),
+          slots(p->num_slots),
+          slot_is_dead(p->num_slots, false),
+          kernel_is_dead(p->kernels.size(), false) {}
+
+    const Program* const program;
+    RunState* const run;
+    OpKernelContext::Params params;
+    std::vector<Tensor> slots;
+    std::vector<bool> slot_is_dead;
+    // Set for the kernels with a dead control input.
+    std::vector<bool> kernel_is_dead;
+    gtl::InlinedVector<TensorValue, 4> inputs;
+    // The kernel to run next.
+    size_t next = 0;
+    // The context of the asynchronous kernel in flight.
+    std::unique_ptr<OpKernelContext> async_ctx;
+    // Counts the return of ComputeAsync and the call of its done callback;
+    // whichever comes second goes on with the program.
+    std::atomic<int> async_handoff{0};
+  };
+
+  void StartProgram(const Program* program, RunState* state) const;
+  // Runs the kernels of "ps" from ps->next on, until the program is done or
+  // an asynchronous kernel has yet to finish.
+  void RunProgram(ProgramState* ps) const;
+  // Continues the program after its asynchronous kernel finished.
+  void AsyncKernelDone(ProgramState* ps) const;
+  // Hands the outputs of the kernel ps->next to its consumers, or marks them
+  // dead, and moves on to the next kernel. "ctx" is null if the kernel was
+  // skipped.
+  Status KernelDone(bool is_dead, OpKernelContext* ctx,
+                    ProgramState* ps) const;
+  void ProgramDone(const Status& s, ProgramState* ps) const;
+
+  const LocalExecutorParams params_;
+  const std::unique_ptr<const Graph> graph_;
+  std::vector<Program> programs_;
+
+  // Default attributes and contexts, sized for the widest kernel.
+  std::vector<AllocatorAttributes> output_attrs_;
+  gtl::InlinedVector<AllocatorAttributes, 4> input_alloc_attrs_;
+  gtl::InlinedVector<DeviceContext*, 4> input_device_contexts_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StraightLineExecutor);
+};
+
+Status StraightLineExecutor::Initialize() {
+  std::vector<Node*> order;
+  GetReversePostOrder(*graph_, &order);
+
+  // Group the op nodes into weakly connected components.
+  const int num_node_ids = graph_->num_node_ids();
+  std::vector<int> parent(num_node_ids);
+  std::iota(parent.begin(), parent.end(), 0);
+  int num_nodes = 0;
+  for (const Node* n : order) {
+    if (!n->IsOp()) continue;
+    ++num_nodes;
+    for (const Edge* e : n->in_edges()) {
+      if (!e->src()->IsOp()) continue;
+      parent[FindRoot(&parent, e->src()->id())] = FindRoot(&parent, n->id());
+    }
+  }
+  std::vector<int> component_size(num_node_ids, 0);
+  for (const Node* n : order) {
+    if (n->IsOp()) ++component_size[FindRoot(&parent, n->id())];
+  }
+  std::vector<int> components;
+  for (int i = 0; i < num_node_ids; ++i) {
+    if (component_size[i] > 0) components.push_back(i);
+  }
+
+  // Spread the components over the programs, largest first.
+  int num_programs = std::min<int>(components.size(),
+                                   num_nodes / kMinNodesPerProgram);
+  const DeviceBase::CpuWorkerThreads* worker_threads =
+      params_.device->tensorflow_cpu_worker_threads();
+  if (worker_threads != nullptr) {
+    num_programs = std::min(num_programs, worker_threads->num_threads);
+  }
+  num_programs = std::max(num_programs, components.empty() ? 0 : 1);
+  std::sort(components.begin(), components.end(),
+            [&component_size](int a, int b) {
+              return component_size[a] > component_size[b];
+            });
+  std::vector<int> program_of(num_node_ids, -1);
+  std::vector<int> program_size(num_programs, 0);
+  for (int c : components) {
+    const int p =
+        std::min_element(program_size.begin(), program_size.end()) -
+        program_size.begin();
+    program_size[p] += component_size[c];
+    program_of[c] = p;
+  }
+
+  programs_.resize(num_programs);
+  std::vector<int> kernel_index(num_node_ids, -1);
+  size_t max_inputs = 0;
+  size_t max_outputs = 0;
+  for (const Node* n : order) {
+    if (!n->IsOp()) continue;
+    const int p = program_of[FindRoot(&parent, n->id())];
+    program_of[n->id()] = p;
+    Program& program = programs_[p];
+    kernel_index[n->id()] = program.kernels.size();
+    program.kernels.emplace_back();
+    KernelState& state = program.kernels.back();
+    state.node = n;
+    Status s = params_.create_kernel(n->def(), &state.kernel);
+    if (!s.ok()) {
+      state.kernel = nullptr;
+      LOG(ERROR) << "Executor failed to create kernel. " << s;
+      return s;
+    }
+    state.is_async = state.kernel->AsAsync() != nullptr;
+    state.is_transfer = IsTransferNode(n);
+    state.input_start = program.num_slots;
+    state.num_inputs = n->num_inputs();
+    state.num_outputs = n->num_outputs();
+    program.num_slots += state.num_inputs;
+    max_inputs = std::max<size_t>(max_inputs, state.num_inputs);
+    max_outputs = std::max<size_t>(max_outputs, state.num_outputs);
+  }
+
+  // Route every output to the input slots it feeds.
+  for (const Node* n : order) {
+    if (!n->IsOp()) continue;
+    Program& program = programs_[program_of[n->id()]];
+    KernelState& state = program.kernels[kernel_index[n->id()]];
+    std::vector<std::vector<int>> targets(state.num_outputs);
+    for (const Edge* e : n->out_edges()) {
+      if (!e->dst()->IsOp()) continue;
+      if (e->IsControlEdge()) {
+        state.control_targets.push_back(kernel_index[e->dst()->id()]);
+        continue;
+      }
+      const KernelState& dst =
+          program.kernels[kernel_index[e->dst()->id()]];
+      targets[e->src_output()].push_back(dst.input_start + e->dst_input());
+    }
+    state.target_start.push_back(0);
+    for (const std::vector<int>& slots : targets) {
+      state.output_targets.insert(state.output_targets.end(), slots.begin(),
+                                  slots.end());
+      state.target_start.push_back(state.output_targets.size());
+    }
+  }
+
+  output_attrs_.resize(max_outputs);
+  input_alloc_attrs_.resize(max_inputs);
+  input_device_contexts_.resize(max_inputs, nullptr);
+  return Status::OK();
+}
+
+void StraightLineExecutor::RunAsync(const Args& args, DoneCallback done) {
+  if (programs_.empty()) {
+    done(Status::OK());
+    return;
+  }
+  RunState* state = new RunState(args, std::move(done), programs_.size());
+  for (size_t i = 0; i < programs_.size(); ++i) {
+    const Program* program = &programs_[i];
+    // The last program runs on the caller's thread.
+    if (i + 1 == programs_.size()) {
+      StartProgram(program, state);
+    } else {
+      state->args.runner(
+          [this, program, state]() { StartProgram(program, state); });
+    }
+  }
+}
+
+void StraightLineExecutor::StartProgram(const Program* program,
+                                        RunState* state) const {
+  const Args& args = state->args;
+  Device* device = params_.device;
+
+  ProgramState* ps = new ProgramState(program, state);
+  OpKernelContext::Params& params = ps->params;
+  params.step_id = args.step_id;
+  params.device = device;
+  params.log_memory = LogMemory::IsEnabled();
+  params.rendezvous = args.rendezvous;
+  params.collective_executor = args.collective_executor;
+  params.session_state = args.session_state;
+  params.tensor_store = args.tensor_store;
+  params.cancellation_manager = args.cancellation_manager;
+  params.call_frame = args.call_frame;
+  params.function_library = params_.function_library;
+  params.resource_manager = device->resource_manager();
+  params.step_container = args.step_container;
+  params.slice_reader_cache = &state->slice_reader_cache;
+  params.runner = &state->args.runner;
+  params.frame_iter = FrameAndIter(0, 0);
+  params.output_attr_array = output_attrs_.data();
+  params.input_alloc_attrs = &input_alloc_attrs_;
+  params.input_device_contexts = &input_device_contexts_;
+  params.inputs = &ps->inputs;
+  RunProgram(ps);
+}
+
+void StraightLineExecutor::RunProgram(ProgramState* ps) const {
+  const std::vector<KernelState>& kernels = ps->program->kernels;
+  Device* device = params_.device;
+  Status s;
+  while (s.ok() && ps->next < kernels.size()) {
+    const KernelState& k = kernels[ps->next];
+    ps->inputs.clear();
+    bool is_input_dead = ps->kernel_is_dead[ps->next];
+    for (int i = 0; i < k.num_inputs; ++i) {
+      ps->inputs.push_back(TensorValue(&ps->slots[k.input_start + i]));
+      is_input_dead |= ps->slot_is_dead[k.input_start + i];
+    }
+
+    if (is_input_dead && !k.is_transfer) {
+      // As in the default executor, a dead input kills every output.
+      s = KernelDone(true, nullptr, ps);
+      continue;
+    }
+    ps->params.op_kernel = k.kernel;
+    ps->params.is_input_dead = is_input_dead;
+    if (!k.is_async) {
+      OpKernelContext ctx(&ps->params, k.num_outputs);
+      device->Compute(k.kernel, &ctx);
+      s = KernelDone(is_input_dead, &ctx, ps);
+      continue;
+    }
+
+    ps->async_ctx.reset(new OpKernelContext(&ps->params, k.num_outputs));
+    ps->async_handoff = 0;
+    device->ComputeAsync(k.kernel->AsAsync(), ps->async_ctx.get(),
+                         [this, ps]() {
+                           if (ps->async_handoff.fetch_add(1) == 0) return;
+                           // Go on in a closure, as the default executor
+                           // does, rather than on the thread that completed
+                           // the kernel.
+                           ps->run->args.runner(
+                               [this, ps]() { AsyncKernelDone(ps); });
+                         });
+    // The done callback continues the program if it has not run yet.
+    if (ps->async_handoff.fetch_add(1) == 0) return;
+    s = KernelDone(is_input_dead, ps->async_ctx.get(), ps);
+    ps->async_ctx.reset();
+  }
+  ProgramDone(s, ps);
+}
+
+void StraightLineExecutor::AsyncKernelDone(ProgramState* ps) const {
+  Status s = KernelDone(ps->params.is_input_dead, ps->async_ctx.get(), ps);
+  ps->async_ctx.reset();
+  if (s.ok()) {
+    RunProgram(ps);
+  } else {
+    ProgramDone(s, ps);
+  }
+}
+
+Status StraightLineExecutor::KernelDone(bool is_dead, OpKernelContext* ctx,
+                                        ProgramState* ps) const {
+  const KernelState& k = ps->program->kernels[ps->next];
+  if (ctx != nullptr && !ctx->status().ok()) {
+    return AttachDef(ctx->status(), k.kernel->def());
+  }
+
+  if (is_dead) {
+    // Like the default executor, a dead node's outputs and control edges
+    // are all dead, even for a transfer node that ran.
+    for (int t : k.output_targets) ps->slot_is_dead[t] = true;
+    for (int c : k.control_targets) ps->kernel_is_dead[c] = true;
+  } else {
+    for (int i = 0; i < k.num_outputs; ++i) {
+      const int begin = k.target_start[i];
+      const int end = k.target_start[i + 1];
+      TensorValue val = ctx->release_output(i);
+      if (val.tensor == nullptr) {
+        // Only a Recv may leave an output unset, meaning it is dead.
+        if (!IsRecv(k.node)) {
+          return errors::Internal("Missing ", i, "-th output from ",
+                                  SummarizeNode(*k.node));
+        }
+        for (int t = begin; t < end; ++t) {
+          ps->slot_is_dead[k.output_targets[t]] = true;
+        }
+        continue;
+      }
+      // Copy the tensor to every consumer but the last, which takes it
+      // so that the buffer can be forwarded.
+      for (int t = begin; t < end; ++t) {
+        Tensor* slot = &ps->slots[k.output_targets[t]];
+        if (t + 1 < end) {
+          *slot = *val.tensor;
+        } else {
+          *slot = std::move(*val.tensor);
+        }
+      }
+      delete val.tensor;
+    }
+  }
+
+  for (int i = 0; i < k.num_inputs; ++i) {
+    ps->slots[k.input_start + i] = Tensor();
+  }
+  ++ps->next;
+  return Status::OK();
+}
+
+void StraightLineExecutor::ProgramDone(const Status& s,
+                                       ProgramState* ps) const {
+  RunState* state = ps->run;
+  delete ps;
+  if (!s.ok()) {
+    mutex_lock l(state->mu);
+    if (state->status.ok()) {
+      state->status = s;
+      // Unblock the programs still running, as the default executor does.
+      const Args& args = state->args;
+      if (args.rendezvous) args.rendezvous->StartAbort(s);
+      if (args.collective_executor) args.collective_executor->StartAbort(s);
+      if (args.cancellation_manager) args.cancellation_manager->StartCancel();
+    }
+  }
+  if (state->pending.fetch_sub(1) != 1) return;
+
+  Status status;
+  {
+    mutex_lock l(state->mu);
+    status = state->status;
+  }
+  if (state->args.sync_on_finish && status.ok()) {
+    status = params_.device->Sync();
+  }
+  DoneCallback done = std::move(state->done);
+  delete state;
+  done(status);
+}
+
+class StraightLineExecutorRegistrar {
+ public:
+  StraightLineExecutorRegistrar() {
+    ExecutorFactory::Register(kStraightLineExecutor, new Factory);
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params,
+                       std::unique_ptr<const Graph> graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      Executor* ret = nullptr;
+      TF_RETURN_IF_ERROR(
+          NewStraightLineExecutor(params, std::move(graph), &ret));
+      out_executor->reset(ret);
+      return Status::OK();
+    }
+  };
+};
+static StraightLineExecutorRegistrar registrar;
+
+}  // namespace
+
+Status NewStraightLineExecutor(const LocalExecutorParams& params,
+                               std::unique_ptr<const Graph> graph,
+                               Executor** executor) {
+  Status supported = CheckSupported(*graph, params.device);
+  if (!supported.ok()) {
+    VLOG(1) << "Using the default executor instead of "
+            << kStraightLineExecutor << ": " << supported.error_message();
+    return NewLocalExecutor(params, std::move(graph), executor);
+  }
+  StraightLineExecutor* impl =
+      new StraightLineExecutor(params, std::move(graph));
+  Status s = impl->Initialize();
+  if (s.ok()) {
+    *executor = impl;
+  } else {
+    delete impl;
+  }
+  return s;
+}
+
+}  // namespace tensorflow
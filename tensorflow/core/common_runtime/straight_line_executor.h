@@ -0,0 +1,51 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STRAIGHT_LINE_EXECUTOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STRAIGHT_LINE_EXECUTOR_H_
+
+#include <memory>
+
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+
+// The executor type to set in ConfigProto.Experimental.executor_type to use
+// the straight-line executor.
+extern const char* const kStraightLineExecutor;
+
+// Creates an executor for small CPU graphs where the bookkeeping of the
+// default executor costs more than the kernels themselves.
+//
+// The graph is compiled once into straight-line programs: a topological
+// order of its kernels and, for every output, the input slots it feeds.
+// Weakly connected components of the graph are spread over up to one
+// program per CPU worker thread; each program runs on one thread without
+// per-node atomics, ready queues or closures. Kernels run in order, so the
+// executor does not overlap independent kernels within a program. An
+// asynchronous kernel that is still pending when ComputeAsync returns, such
+// as a Recv waiting for its tensor, suspends its program without blocking
+// the thread; the program goes on in a closure once the kernel is done.
+//
+// Graphs with control flow, reference-typed edges or ScopedAllocator nodes,
+// and graphs on devices other than CPU, get the default executor instead.
+// Per-node step stats are not collected.
+Status NewStraightLineExecutor(const LocalExecutorParams& params,
+                               std::unique_ptr<const Graph> graph,
+                               Executor** executor);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STRAIGHT_LINE_EXECUTOR_H_
@@ -0,0 +1,230 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/straight_line_executor.h"
+
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+namespace {
+
+#define ALICE "/job:j/replica:0/task:0/cpu:0"
+#define BOB "/job:j/replica:0/task:0/device:GPU:0"
+
+const uint64 kIncarnation = 1;
+
+class StraightLineExecutorTest : public ::testing::Test {
+ protected:
+  StraightLineExecutorTest()
+      : device_(DeviceFactory::NewDevice("CPU", {},
+                                         "/job:localhost/replica:0/task:0")) {
+    SessionOptions options;
+    thread_pool_ = ComputePool(options);
+    rendez_ = NewLocalRendezvous();
+  }
+
+  ~StraightLineExecutorTest() override {
+    CHECK(rendez_->Unref());
+    delete exec_;
+    delete device_;
+  }
+
+  void Create(std::unique_ptr<const Graph> graph) {
+    const int version = graph->versions().producer();
+    LocalExecutorParams params;
+    params.device = device_;
+    params.create_kernel = [this, version](const NodeDef& ndef,
+                                           OpKernel** kernel) {
+      return CreateNonCachedKernel(device_, nullptr, ndef, version, kernel);
+    };
+    params.delete_kernel = [](OpKernel* kernel) {
+      DeleteNonCachedKernel(kernel);
+    };
+    delete exec_;
+    TF_CHECK_OK(NewStraightLineExecutor(params, std::move(graph), &exec_));
+  }
+
+  Status Run() {
+    Executor::Args args;
+    args.rendezvous = rendez_;
+    args.runner = [this](std::function<void()> fn) {
+      thread_pool_->Schedule(fn);
+    };
+    return exec_->Run(args);
+  }
+
+  Rendezvous::ParsedKey Key(const string& sender, const string& receiver,
+                            const string& name) {
+    Rendezvous::ParsedKey result;
+    TF_CHECK_OK(Rendezvous::ParseKey(
+        Rendezvous::CreateKey(sender, kIncarnation, receiver, name,
+                              FrameAndIter(0, 0)),
+        &result));
+    return result;
+  }
+
+  void Feed(const string& name, float val) {
+    Tensor t(DT_FLOAT, TensorShape({}));
+    t.scalar<float>()() = val;
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, BOB, name), Rendezvous::Args(), t,
+                               false));
+  }
+
+  float Fetch(const string& name) {
+    Tensor out;
+    bool is_dead = false;
+    TF_CHECK_OK(rendez_->Recv(Key(BOB, ALICE, name), Rendezvous::Args(), &out,
+                              &is_dead));
+    CHECK(!is_dead);
+    return out.scalar<float>()();
+  }
+
+  thread::ThreadPool* thread_pool_ = nullptr;
+  Device* device_ = nullptr;
+  Executor* exec_ = nullptr;
+  Rendezvous* rendez_ = nullptr;
+};
+
+TEST_F(StraightLineExecutorTest, SimpleAdd) {
+  // c = a + b, with a fanned out to both inputs of a second add.
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in0 = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto in1 = test::graph::Recv(g.get(), "b", "float", ALICE, 1, BOB);
+  auto sum = test::graph::Add(g.get(), in0, in1);
+  auto twice = test::graph::Add(g.get(), sum, sum);
+  test::graph::Send(g.get(), twice, "c", BOB, 1, ALICE);
+  Create(std::move(g));
+  for (int step = 1; step <= 3; ++step) {
+    Feed("a", step);
+    Feed("b", 1.0);
+    TF_ASSERT_OK(Run());
+    EXPECT_EQ(2.0 * (step + 1), Fetch("c"));
+  }
+}
+
+TEST_F(StraightLineExecutorTest, IndependentChains) {
+  // Enough disconnected chains to be split over several programs.
+  const int kNumChains = 8;
+  const int kChainLength = 8;
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  for (int c = 0; c < kNumChains; ++c) {
+    const string in = strings::StrCat("in", c);
+    Node* v = test::graph::Recv(g.get(), in, "float", ALICE, 1, BOB);
+    for (int i = 0; i < kChainLength; ++i) {
+      v = test::graph::Add(g.get(), v, v);
+    }
+    test::graph::Send(g.get(), v, strings::StrCat("out", c), BOB, 1, ALICE);
+  }
+  Create(std::move(g));
+  for (int c = 0; c < kNumChains; ++c) {
+    Feed(strings::StrCat("in", c), c);
+  }
+  TF_ASSERT_OK(Run());
+  for (int c = 0; c < kNumChains; ++c) {
+    EXPECT_EQ(256.0 * c, Fetch(strings::StrCat("out", c)));
+  }
+}
+
+TEST_F(StraightLineExecutorTest, ReportsErrors) {
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  test::graph::Send(g.get(), test::graph::Error(g.get(), in, "oops"), "b",
+                    BOB, 1, ALICE);
+  Create(std::move(g));
+  Feed("a", 1.0);
+  Status s = Run();
+  EXPECT_TRUE(errors::IsInternal(s)) << s;
+  EXPECT_TRUE(str_util::StrContains(s.error_message(), "oops")) << s;
+}
+
+TEST_F(StraightLineExecutorTest, WaitsForAsyncKernelsWithoutBlocking) {
+  // b = a + a, where a arrives only after the step has started.
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  test::graph::Send(g.get(), test::graph::Add(g.get(), in, in), "b", BOB, 1,
+                    ALICE);
+  Create(std::move(g));
+  Executor::Args args;
+  args.rendezvous = rendez_;
+  // Runs every closure on the calling thread, so that RunAsync() would never
+  // return if the pending Recv blocked its thread.
+  args.runner = [](std::function<void()> fn) { fn(); };
+  Notification done;
+  Status status;
+  exec_->RunAsync(args, [&done, &status](const Status& s) {
+    status = s;
+    done.Notify();
+  });
+  EXPECT_FALSE(done.HasBeenNotified());
+  Feed("a", 2.0);
+  done.WaitForNotification();
+  TF_ASSERT_OK(status);
+  EXPECT_EQ(4.0, Fetch("b"));
+}
+
+TEST_F(StraightLineExecutorTest, PropagatesDeadnessAlongControlEdges) {
+  // x = Identity(a) is dead because a is, so y = Identity(b), which has a
+  // control edge from x, is dead too.
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto a = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto b = test::graph::Recv(g.get(), "b", "float", ALICE, 1, BOB);
+  auto x = test::graph::Identity(g.get(), a);
+  auto y = test::graph::Identity(g.get(), b);
+  g->AddControlEdge(x, y);
+  test::graph::Send(g.get(), y, "c", BOB, 1, ALICE);
+  Create(std::move(g));
+  TF_ASSERT_OK(rendez_->Send(Key(ALICE, BOB, "a"), Rendezvous::Args(),
+                             Tensor(DT_FLOAT, TensorShape({})),
+                             /*is_dead=*/true));
+  Feed("b", 1.0);
+  TF_ASSERT_OK(Run());
+  Tensor out;
+  bool is_dead = false;
+  TF_ASSERT_OK(rendez_->Recv(Key(BOB, ALICE, "c"), Rendezvous::Args(), &out,
+                             &is_dead));
+  EXPECT_TRUE(is_dead);
+}
+
+TEST_F(StraightLineExecutorTest, FallsBackForControlFlow) {
+  // out = Switch(a, true) goes to the default executor.
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto pred = test::graph::Recv(g.get(), "pred", "bool", ALICE, 1, BOB);
+  auto sw = test::graph::Switch(g.get(), in, pred);
+  test::graph::Send(g.get(), test::graph::Identity(g.get(), sw, 1), "b", BOB,
+                    1, ALICE);
+  Create(std::move(g));
+  Feed("a", 3.0);
+  Tensor pred_val(DT_BOOL, TensorShape({}));
+  pred_val.scalar<bool>()() = true;
+  TF_ASSERT_OK(rendez_->Send(Key(ALICE, BOB, "pred"), Rendezvous::Args(),
+                             pred_val, false));
+  TF_ASSERT_OK(Run());
+  EXPECT_EQ(3.0, Fetch("b"));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 
+#include <algorithm>
+
 #include "tensorflow/core/common_runtime/local_device.h"
+#include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/scoped_allocator.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -25,7 +28,10 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.pb_text.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/types.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session_options.h"
@@ -48,6 +54,19 @@ ThreadPoolDevice::ThreadPoolDevice(const SessionOptions& options,
                                name, DEVICE_CPU, memory_limit, locality)),
       allocator_(allocator),
       scoped_allocator_mgr_(new ScopedAllocatorMgr(name)) {
+  if (UseNUMAAffinity(options) && locality.numa_node() >= 0) {
+    // The session's inter-op threads are split evenly across the nodes.
+    const int numa_node = locality.numa_node();
+    const int32 num_threads = std::max(
+        1, NumInterOpThreadsFromSessionOptions(options) / port::NUMANumNodes());
+    ThreadOptions thread_opts;
+    thread_opts.numa_node = numa_node;
+    inter_op_pool_.reset(
+        new thread::ThreadPool(options.env, thread_opts,
+                               strings::StrCat("numa_", numa_node, "_Compute"),
+                               num_threads));
+    set_tensorflow_device_thread_pool(inter_op_pool_.get());
+  }
 #ifdef INTEL_MKL
 #ifdef _OPENMP
   const char* user_omp_threads = getenv("OMP_NUM_THREADS");
@@ -22,6 +22,11 @@ limitations under the License.
 namespace tensorflow {
 
 // CPU device implementation.
+//
+// With ConfigProto.Experimental.use_numa_affinity, a device whose
+// DeviceLocality names a NUMA node is bound to it: kernels are scheduled on
+// an inter-op pool of its own and tensors should come from a node-local
+// allocator. A numa_node of port::kNUMANoAffinity leaves the device unbound.
 class ThreadPoolDevice : public LocalDevice {
  public:
   ThreadPoolDevice(const SessionOptions& options, const string& name,
@@ -44,6 +49,8 @@ class ThreadPoolDevice : public LocalDevice {
  private:
   Allocator* allocator_;  // Not owned
   std::unique_ptr<ScopedAllocatorMgr> scoped_allocator_mgr_;
+  // Set only with NUMA affinity.
+  std::unique_ptr<thread::ThreadPool> inter_op_pool_;
 };
 
 }  // namespace tensorflow
@@ -18,7 +18,10 @@ limitations under the License.
 
 #include <vector>
 #include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/process_state.h"
+#include "tensorflow/core/common_runtime/visitable_allocator.h"
 #include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/public/session_options.h"
 
 namespace tensorflow {
@@ -28,8 +31,28 @@ class ThreadPoolDeviceFactory : public DeviceFactory {
  public:
   Status CreateDevices(const SessionOptions& options, const string& name_prefix,
                        std::vector<Device*>* devices) override {
-    // TODO(zhifengc/tucker): Figure out the number of available CPUs
-    // and/or NUMA configuration.
+    if (LocalDevice::UseNUMAAffinity(options)) {
+      // CPU:0, where the placer puts every op without a device, keeps the
+      // whole machine. CPU:1 to CPU:N are bound to nodes 0 to N-1, each
+      // allocating from memory bound to its node.
+      ProcessState::singleton()->EnableNUMA();
+      DeviceLocality unbound;
+      unbound.set_numa_node(port::kNUMANoAffinity);
+      devices->push_back(new ThreadPoolDevice(
+          options, strings::StrCat(name_prefix, "/device:CPU:0"),
+          Bytes(256 << 20), unbound, cpu_allocator()));
+      for (int node = 0; node < port::NUMANumNodes(); ++node) {
+        string name = strings::StrCat(name_prefix, "/device:CPU:", node + 1);
+        DeviceLocality locality;
+        locality.set_numa_node(node);
+        devices->push_back(new ThreadPoolDevice(
+            options, name, Bytes(256 << 20), locality,
+            ProcessState::singleton()->GetCPUAllocator(node)));
+      }
+      return Status::OK();
+    }
+
+    // TODO(zhifengc/tucker): Figure out the number of available CPUs.
     int n = 1;
     auto iter = options.config.device_count().find("CPU");
     if (iter != options.config.device_count().end()) {
@@ -0,0 +1,169 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/common_runtime/unified_thread_pool.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+class UnifiedThreadPool::EigenPool : public Eigen::ThreadPoolInterface {
+ public:
+  explicit EigenPool(UnifiedThreadPool* pool) : pool_(pool) {}
+
+  void Schedule(std::function<void()> fn) override {
+    pool_->workers_->Schedule(std::bind(
+        [this](const std::function<void()>& fn) { pool_->RunTimed(fn); },
+        std::move(fn)));
+  }
+  int NumThreads() const override { return pool_->workers_->NumThreads(); }
+  int CurrentThreadId() const override {
+    return pool_->workers_->CurrentThreadId();
+  }
+
+ private:
+  UnifiedThreadPool* const pool_;
+};
+
+// Starts the worker threads through another Env, registering each with the
+// pool before it runs its scheduling loop.
+class UnifiedThreadPool::WorkerEnv : public EnvWrapper {
+ public:
+  WorkerEnv(UnifiedThreadPool* pool, Env* env)
+      : EnvWrapper(env), pool_(pool) {}
+
+  Thread* StartThread(const ThreadOptions& thread_options, const string& name,
+                      std::function<void()> fn) override {
+    return target()->StartThread(thread_options, name, [this, fn]() {
+      pool_->RegisterWorker();
+      fn();
+    });
+  }
+
+ private:
+  UnifiedThreadPool* const pool_;
+};
+
+UnifiedThreadPool::UnifiedThreadPool(Env* env, int num_threads)
+    : env_(env),
+#if defined(__linux__)
+      use_cpu_clocks_(true),
+#else
+      use_cpu_clocks_(false),
+#endif
+      worker_env_(new WorkerEnv(this, env)),
+      workers_(
+          new thread::ThreadPool(worker_env_.get(), "Unified", num_threads)),
+      eigen_pool_(new EigenPool(this)),
+      max_running_(num_threads - 1) {
+  CHECK_GT(num_threads, 1);
+}
+
+UnifiedThreadPool::~UnifiedThreadPool() {
+  // Waits for the scheduled closures, which use the members below.
+  workers_.reset();
+}
+
+void UnifiedThreadPool::Schedule(std::function<void()> fn) {
+  {
+    mutex_lock l(mu_);
+    if (running_ >= max_running_) {
+      pending_.push_back(std::move(fn));
+      return;
+    }
+    ++running_;
+  }
+  workers_->Schedule(std::bind(
+      [this](std::function<void()>& fn) { RunInterOp(std::move(fn)); },
+      std::move(fn)));
+}
+
+void UnifiedThreadPool::RunInterOp(std::function<void()> fn) {
+  // Keeps the slot and runs the queued closures until there are none.
+  while (true) {
+    RunTimed(fn);
+    mutex_lock l(mu_);
+    if (pending_.empty()) {
+      --running_;
+      return;
+    }
+    fn = std::move(pending_.front());
+    pending_.pop_front();
+  }
+}
+
+void UnifiedThreadPool::RegisterWorker() {
+#if defined(__linux__)
+  clockid_t clock;
+  if (pthread_getcpuclockid(pthread_self(), &clock) != 0) {
+    LOG(WARNING) << "No CPU-time clock for a unified thread pool worker; "
+                 << "its busy time is not counted.";
+    return;
+  }
+  mutex_lock l(workers_mu_);
+  worker_cpu_nanos_.push_back([clock]() -> int64 {
+    timespec ts;
+    if (clock_gettime(clock, &ts) != 0) return 0;
+    return static_cast<int64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  });
+#endif
+}
+
+void UnifiedThreadPool::RunTimed(const std::function<void()>& fn) {
+  if (use_cpu_clocks_) {
+    fn();
+    return;
+  }
+  const uint64 start = env_->NowNanos();
+  fn();
+  busy_nanos_ += env_->NowNanos() - start;
+}
+
+int64 UnifiedThreadPool::busy_nanos() const {
+  if (!use_cpu_clocks_) return busy_nanos_;
+  int64 nanos = 0;
+  mutex_lock l(workers_mu_);
+  for (const auto& cpu_nanos : worker_cpu_nanos_) {
+    nanos += cpu_nanos();
+  }
+  return nanos;
+}
+
+UnifiedThreadPool* UnifiedComputePool(const SessionOptions& options) {
+  static UnifiedThreadPool* const pool = [&options]() {
+    int32 num_threads = options.config.inter_op_parallelism_threads();
+    if (num_threads == 0) num_threads = port::NumSchedulableCPUs();
+    // One worker must stay free of inter-op closures.
+    num_threads = std::max(num_threads, 2);
+    VLOG(1) << "Unified inter and intra op parallelism threads: "
+            << num_threads;
+    return new UnifiedThreadPool(options.env, num_threads);
+  }();
+  return pool;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,115 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_UNIFIED_THREAD_POOL_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_UNIFIED_THREAD_POOL_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace Eigen {
+class ThreadPoolInterface;
+}  // end namespace Eigen
+
+namespace tensorflow {
+
+// One set of workers for both levels of CPU parallelism: the closures that
+// executors schedule to run graph nodes (inter-op), and the blocks that
+// kernels hand to Eigen or Shard (intra-op).
+//
+// The workers are those of a thread::ThreadPool, which keeps a queue per
+// worker: work scheduled from a worker goes to the front of its own queue,
+// and idle workers steal from the back of the others. The blocks of a
+// parallel kernel therefore stay on the worker that runs the kernel until
+// another worker is idle, instead of waking a second pool of threads.
+//
+// A kernel waits for its blocks while holding its worker, so at most
+// NumThreads() - 1 inter-op closures run at once. Later ones are queued
+// here until one finishes, which leaves a worker to steal those blocks.
+class UnifiedThreadPool {
+ public:
+  // REQUIRES: num_threads > 1
+  UnifiedThreadPool(Env* env, int num_threads);
+  ~UnifiedThreadPool();
+
+  // Schedules an inter-op closure.
+  void Schedule(std::function<void()> fn);
+
+  // The workers, for DeviceBase::CpuWorkerThreads.
+  thread::ThreadPool* workers() const { return workers_.get(); }
+
+  // The pool to give Eigen::ThreadPoolDevice for intra-op work.
+  Eigen::ThreadPoolInterface* eigen_pool() const { return eigen_pool_.get(); }
+
+  int NumThreads() const { return workers_->NumThreads(); }
+
+  // Returns the total time, in nanoseconds, that the workers have been busy.
+  // Where threads have CPU-time clocks (Linux), this is the CPU time of the
+  // worker threads: it covers all their work, including Shard() blocks, and
+  // leaves out the time a kernel is blocked waiting for its blocks. Idle
+  // workers spin briefly before they sleep, which counts as busy.
+  // Elsewhere it is the wall time of the closures passed to Schedule() or
+  // eigen_pool().
+  int64 busy_nanos() const;
+
+ private:
+  class EigenPool;
+  class WorkerEnv;
+
+  // Called by each worker thread before it starts running closures.
+  void RegisterWorker();
+  void RunInterOp(std::function<void()> fn);
+  void RunTimed(const std::function<void()>& fn);
+
+  Env* const env_;
+  // True if busy_nanos() reads the workers' CPU-time clocks.
+  const bool use_cpu_clocks_;
+  mutable mutex workers_mu_;
+  // Return the CPU time used so far by each worker that has started.
+  std::vector<std::function<int64()>> worker_cpu_nanos_
+      GUARDED_BY(workers_mu_);
+  // Starts the threads of workers_, and must outlive them.
+  std::unique_ptr<Env> worker_env_;
+  std::unique_ptr<thread::ThreadPool> workers_;
+  std::unique_ptr<Eigen::ThreadPoolInterface> eigen_pool_;
+  std::atomic<int64> busy_nanos_{0};
+
+  const int max_running_;
+  mutex mu_;
+  int running_ GUARDED_BY(mu_) = 0;
+  std::deque<std::function<void()>> pending_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(UnifiedThreadPool);
+};
+
+// Returns the process-wide UnifiedThreadPool, creating it from "options"
+// on the first call. It has inter_op_parallelism_threads workers, or one
+// per schedulable CPU if that is 0. Caller does not take ownership.
+UnifiedThreadPool* UnifiedComputePool(const SessionOptions& options);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_UNIFIED_THREAD_POOL_H_
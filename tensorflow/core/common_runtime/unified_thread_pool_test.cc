@@ -0,0 +1,113 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/common_runtime/unified_thread_pool.h"
+
+#include <atomic>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(UnifiedThreadPoolTest, RunsAllClosures) {
+  UnifiedThreadPool pool(Env::Default(), 4);
+  const int kNumClosures = 1000;
+  std::atomic<int> count(0);
+  BlockingCounter done(kNumClosures);
+  for (int i = 0; i < kNumClosures; ++i) {
+    pool.Schedule([&count, &done]() {
+      ++count;
+      done.DecrementCount();
+    });
+  }
+  done.Wait();
+  EXPECT_EQ(kNumClosures, count);
+}
+
+TEST(UnifiedThreadPoolTest, LeavesOneWorkerForIntraOpWork) {
+  const int kNumThreads = 4;
+  UnifiedThreadPool pool(Env::Default(), kNumThreads);
+  mutex mu;
+  int running = 0;
+  int max_running = 0;
+  BlockingCounter done(4 * kNumThreads);
+  for (int i = 0; i < 4 * kNumThreads; ++i) {
+    pool.Schedule([&]() {
+      {
+        mutex_lock l(mu);
+        max_running = std::max(max_running, ++running);
+      }
+      Env::Default()->SleepForMicroseconds(1000);
+      {
+        mutex_lock l(mu);
+        --running;
+      }
+      done.DecrementCount();
+    });
+  }
+  done.Wait();
+  EXPECT_GT(max_running, 0);
+  EXPECT_LE(max_running, kNumThreads - 1);
+}
+
+TEST(UnifiedThreadPoolTest, NestedParallelFor) {
+  // Every worker that may run an inter-op closure blocks in parallelFor;
+  // the remaining one must run their blocks.
+  const int kNumThreads = 4;
+  UnifiedThreadPool pool(Env::Default(), kNumThreads);
+  Eigen::ThreadPoolDevice device(pool.eigen_pool(), pool.NumThreads());
+  const int kNumClosures = 10 * kNumThreads;
+  std::atomic<int64> sum(0);
+  BlockingCounter done(kNumClosures);
+  for (int i = 0; i < kNumClosures; ++i) {
+    pool.Schedule([&]() {
+      device.parallelFor(1000, Eigen::TensorOpCost(0, 0, 100000),
+                         [&sum](Eigen::Index first, Eigen::Index last) {
+                           sum += last - first;
+                         });
+      done.DecrementCount();
+    });
+  }
+  done.Wait();
+  EXPECT_EQ(kNumClosures * 1000, sum);
+  EXPECT_GT(pool.busy_nanos(), 0);
+}
+
+#if defined(__linux__)
+TEST(UnifiedThreadPoolTest, CountsWorkScheduledOnTheWorkers) {
+  // Shard() schedules on workers() directly; the workers' CPU clocks still
+  // count that work.
+  UnifiedThreadPool pool(Env::Default(), 2);
+  const int64 busy_before = pool.busy_nanos();
+  BlockingCounter done(1);
+  pool.workers()->Schedule([&done]() {
+    const uint64 end = Env::Default()->NowMicros() + 20000;
+    while (Env::Default()->NowMicros() < end) {
+    }
+    done.DecrementCount();
+  });
+  done.Wait();
+  EXPECT_GE(pool.busy_nanos() - busy_before, 10000000);
+}
+#endif  // defined(__linux__)
+
+}  // namespace
+}  // namespace tensorflow
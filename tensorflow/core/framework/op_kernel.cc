@@ -382,11 +382,13 @@ Tensor OpKernelContext::mutable_input(int index, bool lock_held) {
   // return a copy of the Ref acquired while holding the mutex
   if (lock_held) {
     Tensor& tensor = *((*params_->inputs)[index].tensor);
+    tensor.RecordBufferMutation();
     record_tensor_reference(tensor);
     return tensor;
   } else {
     mutex_lock l(*input_ref_mutex(index));
     Tensor& tensor = *((*params_->inputs)[index].tensor);
+    tensor.RecordBufferMutation();
     record_tensor_reference(tensor);
     return tensor;
   }
@@ -582,6 +584,7 @@ Status OpKernelContext::mutable_input(StringPiece name, Tensor* tensor,
     mutex_lock l(*input_ref_mutex(start));
     *tensor = *(*params_->inputs)[start].tensor;
   }
+  tensor->RecordBufferMutation();
   record_tensor_reference(*tensor);
   return Status::OK();
 }
@@ -674,7 +677,13 @@ Status OpKernelContext::allocate_output(StringPiece name,
 Status OpKernelContext::allocate_tensor(
     DataType type, const TensorShape& shape, Tensor* out_tensor,
     AllocatorAttributes attr, const AllocationAttributes& allocation_attr) {
-  Allocator* a = get_allocator(attr);
+  return allocate_tensor(get_allocator(attr), type, shape, out_tensor,
+                         allocation_attr);
+}
+
+Status OpKernelContext::allocate_tensor(
+    Allocator* a, DataType type, const TensorShape& shape, Tensor* out_tensor,
+    const AllocationAttributes& allocation_attr) {
   AllocationAttributes logged_attr(allocation_attr);
   logged_attr.allocation_will_be_logged = true;
   Tensor new_tensor(a, type, shape, logged_attr);
@@ -703,7 +712,15 @@ Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
   DCHECK(!IsRefType(type));
   DCHECK(mutable_output(index) == nullptr);
   Tensor* output_tensor = new Tensor();
-  Status s = allocate_tensor(type, shape, output_tensor, attr);
+  Allocator* planned = nullptr;
+  if (params_->output_allocator_array != nullptr && attr.value == 0 &&
+      attr.scope_id == 0 && !track_allocations()) {
+    planned = params_->output_allocator_array[index];
+  }
+  Status s = planned == nullptr
+                 ? allocate_tensor(type, shape, output_tensor, attr)
+                 : allocate_tensor(planned, type, shape, output_tensor,
+                                   AllocationAttributes());
   if (s.ok()) {
     outputs_[index] = TensorValue(output_tensor);
     *output = outputs_[index].tensor;
@@ -14,19 +14,40 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/framework/posit16.h"
+#include "tensorflow/core/lib/core/posit_bits.h"
 #include "tensorflow/core/lib/posit16/posit16.h"
 
 namespace tensorflow {
 
 void FloatToPosit16(const float* src, posit16* dst, int64 size) {
   for (int64 i = 0; i < size; i++) {
-    dst[i] = posit16(src[i]);
+    dst[i].value = FloatToPositBits<uint16, 16, 1>(src[i]);
   }
 }
 
+namespace {
+
+// Every posit16 bit pattern decoded to float, built once on first use. Each
+// posit16 is exactly representable as a float, so a lookup is exact.
+const float* Posit16DecodeTable() {
+  static const float* table = [] {
+    float* t = new float[1 << 16];
+    for (uint32 i = 0; i < (1u << 16); i++) {
+      posit16 p;
+      p.value = static_cast<uint16>(i);
+      t[i] = static_cast<float>(p);
+    }
+    return t;
+  }();
+  return table;
+}
+
+}  // namespace
+
 void Posit16ToFloat(const posit16* src, float* dst, int64 size) {
+  const float* table = Posit16DecodeTable();
   for (int64 i = 0; i < size; i++) {
-    dst[i] = static_cast<float>(src[i]);
+    dst[i] = table[src[i].value];
   }
 }
 
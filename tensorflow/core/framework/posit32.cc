@@ -14,13 +14,14 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/framework/posit32.h"
+#include "tensorflow/core/lib/core/posit_bits.h"
 #include "tensorflow/core/lib/posit32/posit32.h"
 
 namespace tensorflow {
 
 void FloatToPosit32(const float* src, posit32* dst, int64 size) {
   for (int64 i = 0; i < size; i++) {
-    dst[i] = posit32(src[i]);
+    dst[i].value = FloatToPositBits<uint32, 32, 2>(src[i]);
   }
 }
 
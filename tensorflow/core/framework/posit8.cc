@@ -14,19 +14,40 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/framework/posit8.h"
+#include "tensorflow/core/lib/core/posit_bits.h"
 #include "tensorflow/core/lib/posit8/posit8.h"
 
 namespace tensorflow {
 
 void FloatToPosit8(const float* src, posit8* dst, int64 size) {
   for (int64 i = 0; i < size; i++) {
-    dst[i] = posit8(src[i]);
+    dst[i].value = FloatToPositBits<uint8, 8, 0>(src[i]);
   }
 }
 
+namespace {
+
+// Every posit8 bit pattern decoded to float, built once on first use. Each
+// posit8 is exactly representable as a float, so a lookup is exact.
+const float* Posit8DecodeTable() {
+  static const float* table = [] {
+    float* t = new float[1 << 8];
+    for (uint32 i = 0; i < (1u << 8); i++) {
+      posit8 p;
+      p.value = static_cast<uint8>(i);
+      t[i] = static_cast<float>(p);
+    }
+    return t;
+  }();
+  return table;
+}
+
+}  // namespace
+
 void Posit8ToFloat(const posit8* src, float* dst, int64 size) {
+  const float* table = Posit8DecodeTable();
   for (int64 i = 0; i < size; i++) {
-    dst[i] = static_cast<float>(src[i]);
+    dst[i] = table[src[i].value];
   }
 }
 
@@ -177,6 +177,10 @@ limitations under the License.
   TF_CALL_half(m) TF_CALL_bfloat16(m) TF_CALL_float(m) TF_CALL_double(m) \
   TF_CALL_posit8(m) TF_CALL_posit16(m) TF_CALL_posit32(m)
 
+// Call "m" on all posit types.
+#define TF_CALL_POSIT_TYPES(m) \
+  TF_CALL_posit8(m) TF_CALL_posit16(m) TF_CALL_posit32(m)
+
 #define TF_CALL_REAL_NUMBER_TYPES(m) \
   TF_CALL_INTEGRAL_TYPES(m)          \
   TF_CALL_FLOAT_TYPES(m)
@@ -444,10 +444,10 @@ struct ProtoHelper<posit8> {
 template <>
 struct ProtoHelper<posit16> {
   static void Fill(const posit16* data, size_t n, TensorProto* proto) {
-    // FIXME(xman): protobuf has no uint16, find alternatives.
-    proto->mutable_uint32_val()->Reserve(n);
+    // Stored in half_val like bfloat16, which is where FromProto reads it.
+    proto->mutable_half_val()->Reserve(n);
     for (size_t i = 0; i < n; ++i) {
-      proto->mutable_uint32_val()->AddAlreadyReserved(data[i].value);
+      proto->mutable_half_val()->AddAlreadyReserved(data[i].value);
     }
   }
 };
@@ -1167,6 +1167,14 @@ bool Tensor::SharesBufferWith(const Tensor& b) const {
          buf_->root_buffer() == b.buf_->root_buffer();
 }
 
+uint64 Tensor::BufferMutationCount() const {
+  return buf_ == nullptr ? 0 : buf_->root_buffer()->mutation_count();
+}
+
+void Tensor::RecordBufferMutation() {
+  if (buf_ != nullptr) buf_->root_buffer()->RecordMutation();
+}
+
 string Tensor::DebugString() const {
   return strings::StrCat("Tensor<type: ", DataTypeString(dtype()),
                          " shape: ", shape().DebugString(),
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_TENSOR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_TENSOR_H_
 
+#include <atomic>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor_shape.h"
@@ -144,6 +146,12 @@ class Tensor {
   // True iff the two tensors use the same underlying refcounted storage
   bool SharesBufferWith(const Tensor& b) const;
 
+  // Returns how many times a kernel has taken mutable access to this tensor's
+  // underlying storage through a ref input (OpKernelContext::mutable_input).
+  // Other buffers are only written before they are shared, so a holder of a
+  // reference that sees this count unchanged knows the contents are unchanged.
+  uint64 BufferMutationCount() const;
+
   /// \brief If necessary, has this Tensor been initialized?
   ///
   /// Zero-element Tensors are always considered initialized, even if they
@@ -462,6 +470,8 @@ class Tensor {
   // Returns true if the refcount on buf_ and any possible underlying root
   // buffer is one.
   bool RefCountIsOne() const;
+  // Increments BufferMutationCount().
+  void RecordBufferMutation();
   void CheckType(DataType expected_dtype) const;
   void CheckTypeAndIsAligned(DataType expected_dtype) const;
   void CheckIsAlignedAndSingleElement() const;
@@ -564,6 +574,18 @@ class TensorBuffer : public core::RefCounted {
 
   // Whether this TensorBuffer owns the underlying memory.
   virtual bool OwnsMemory() const { return true; }
+
+  // Number of in-place writes through ref inputs; see
+  // Tensor::BufferMutationCount(). Only kept on root buffers.
+  uint64 mutation_count() const {
+    return mutation_count_.load(std::memory_order_acquire);
+  }
+  void RecordMutation() {
+    mutation_count_.fetch_add(1, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<uint64> mutation_count_{0};
 };
 
 template <typename T>
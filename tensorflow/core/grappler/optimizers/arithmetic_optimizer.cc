@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/arithmetic_optimizer.h"
 
 #include <algorithm>
+#include <cmath>
 #include <deque>
 #include <limits>
 #include <unordered_map>
@@ -224,6 +225,32 @@ bool GetElementUnexhaustive(const Tensor& t, int i, const std::set<int>& dtypes,
   }
 }
 
+// Returns the value of a Const node with a posit "dtype" in "t".
+bool GetPositConstant(const NodeDef& node, Tensor* t) {
+  if (!IsConstant(node) || !IsPositType(GetDataTypeFromAttr(node, "dtype"))) {
+    return false;
+  }
+  return t->FromProto(node.attr().at("value").tensor());
+}
+
+// If element "i" of the posit tensor "t" is +-2^k, stores k and the sign.
+bool GetPositPowerOfTwo(const Tensor& t, int i, int* exponent,
+                        bool* negative) {
+  complex128 element;
+  if (!GetElementUnexhaustive(t, i, {DT_POSIT8, DT_POSIT16, DT_POSIT32},
+                              &element)) {
+    return false;
+  }
+  // Posits decode exactly to double, and NaR decodes to NaN.
+  const double value = element.real();
+  if (value == 0 || std::isnan(value)) return false;
+  const double fraction = std::frexp(std::fabs(value), exponent);
+  if (fraction != 0.5) return false;
+  *exponent -= 1;
+  *negative = value < 0;
+  return true;
+}
+
 // Graph optimizer context extension specific to ArithmeticOptimizer.
 struct ArithmeticOptimizerContext {
   explicit ArithmeticOptimizerContext(SetVector<NodeDef*>* nodes_to_simplify)
@@ -2753,6 +2780,142 @@ class OptimizeMaxOrMinOfMonotonicStage : public ArithmeticOptimizerStage {
   }
 };
 
+// Posits are symmetric around one, so the reciprocal of a power of two is
+// always exactly representable, and powers of two are the only posits with an
+// exact reciprocal. Division by a constant made of such values is rewritten
+// into a multiplication, which ConvertPositMulToLdexpStage can then turn into
+// a rescaling:
+//   Div(x, Const(+-2^k)) => Mul(x, Const(+-2^-k))
+class ConvertPositDivToMulStage : public ArithmeticOptimizerStage {
+ public:
+  explicit ConvertPositDivToMulStage(const GraphOptimizerContext& ctx,
+                                     const ArithmeticOptimizerContext& ctx_ext)
+      : ArithmeticOptimizerStage("ConvertPositDivToMul", ctx, ctx_ext) {}
+  ~ConvertPositDivToMulStage() override = default;
+
+  bool IsSupported(const NodeDef* node) const override {
+    return (IsDiv(*node) || IsRealDiv(*node)) &&
+           IsPositType(GetDataTypeFromAttr(*node, "T"));
+  }
+
+  Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
+    NodeDef* divisor;
+    TF_RETURN_IF_ERROR(GetInputNode(node->input(1), &divisor));
+    Tensor value;
+    if (!GetPositConstant(*divisor, &value)) return Status::OK();
+
+    const string reciprocal_name =
+        OptimizedNodeName(ParseNodeScopeAndName(node->name()), "Reciprocal");
+    if (ctx().node_map->NodeExists(reciprocal_name)) return Status::OK();
+
+    Tensor reciprocal(value.dtype(), value.shape());
+    for (int i = 0; i < value.NumElements(); ++i) {
+      int exponent;
+      bool negative;
+      if (!GetPositPowerOfTwo(value, i, &exponent, &negative)) {
+        return Status::OK();
+      }
+      SetPositElement(i, std::ldexp(negative ? -1.0 : 1.0, -exponent),
+                      &reciprocal);
+    }
+
+    NodeDef* reciprocal_node = AddEmptyNode(reciprocal_name);
+    TF_RETURN_IF_ERROR(ConstantFolding::CreateNodeDef(
+        reciprocal_name, TensorValue(&reciprocal), reciprocal_node));
+    reciprocal_node->set_device(divisor->device());
+    // Keep the constant in the frame of the dividend.
+    MaybeAddControlInput(NodeName(node->input(0)), reciprocal_node,
+                         ctx().optimized_graph, ctx().node_map);
+
+    node->set_op("Mul");
+    ctx().node_map->UpdateInput(node->name(), NodeName(node->input(1)),
+                                reciprocal_name);
+    node->set_input(1, reciprocal_name);
+
+    AddToOptimizationQueue(node);
+    AddToOptimizationQueue(divisor);
+    return Status::OK();
+  }
+
+ private:
+  static void SetPositElement(int i, double value, Tensor* t) {
+    switch (t->dtype()) {
+      case DT_POSIT8:
+        t->flat<posit8>()(i) = posit8(value);
+        break;
+      case DT_POSIT16:
+        t->flat<posit16>()(i) = posit16(value);
+        break;
+      case DT_POSIT32:
+        t->flat<posit32>()(i) = posit32(value);
+        break;
+      default:
+        LOG(FATAL) << "Not a posit type: " << DataTypeString(t->dtype());
+    }
+  }
+};
+
+// Multiplying a posit by +-2^k only moves its regime and exponent fields, so
+// a multiplication by such a scalar constant is rewritten into _PositLdexp,
+// which rescales the posits without decoding them:
+//   Mul(x, Const(+-2^k)) => _PositLdexp(x, exponent=k, negate=(c < 0))
+// _PositLdexp only has a CPU kernel, as does posit Mul.
+class ConvertPositMulToLdexpStage : public ArithmeticOptimizerStage {
+ public:
+  explicit ConvertPositMulToLdexpStage(
+      const GraphOptimizerContext& ctx,
+      const ArithmeticOptimizerContext& ctx_ext)
+      : ArithmeticOptimizerStage("ConvertPositMulToLdexp", ctx, ctx_ext) {}
+  ~ConvertPositMulToLdexpStage() override = default;
+
+  bool IsSupported(const NodeDef* node) const override {
+    return IsMul(*node) && IsPositType(GetDataTypeFromAttr(*node, "T")) &&
+           IsOnCpuOrUnplaced(*node) && !IsInPreserveSet(*node);
+  }
+
+  Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
+    const auto& input_props =
+        ctx().graph_properties->GetInputProperties(node->name());
+    const auto& output_props =
+        ctx().graph_properties->GetOutputProperties(node->name());
+    if (input_props.size() != 2 || output_props.size() != 1) {
+      return Status::OK();
+    }
+    for (int c = 0; c < 2; ++c) {
+      NodeDef* scale;
+      TF_RETURN_IF_ERROR(GetInputNode(node->input(c), &scale));
+      Tensor value;
+      if (!GetPositConstant(*scale, &value) || value.NumElements() != 1) {
+        continue;
+      }
+      // The scalar must not broadcast the other operand to a new shape.
+      const int x = 1 - c;
+      if (!ShapesSymbolicallyEqual(input_props[x].shape(),
+                                   output_props[0].shape())) {
+        continue;
+      }
+      int exponent;
+      bool negative;
+      if (!GetPositPowerOfTwo(value, 0, &exponent, &negative)) continue;
+
+      node->set_op("_PositLdexp");
+      AttrValue exponent_attr;
+      exponent_attr.set_i(exponent);
+      (*node->mutable_attr())["exponent"] = exponent_attr;
+      AttrValue negate_attr;
+      negate_attr.set_b(negative);
+      (*node->mutable_attr())["negate"] = negate_attr;
+      node->set_input(0, node->input(x));
+      node->set_input(1, AsControlDependency(scale->name()));
+
+      AddToOptimizationQueue(node);
+      AddToOptimizationQueue(scale);
+      return Status::OK();
+    }
+    return Status::OK();
+  }
+};
+
 // Replace a chain of type&shape preserving unary ops with a
 // '_UnaryOpsComposition' node.
 // TODO(ezhulenev): It should be a part of remapper optimizer because it doesn't
@@ -3194,6 +3357,10 @@ Status ArithmeticOptimizer::SimplifyArithmeticOps(bool can_use_shapes) {
     pipeline.AddStage<OptimizeMaxOrMinOfMonotonicStage>(ctx, ctx_ext);
   if (options_.convert_expm1)
     pipeline.AddStage<ConvertExpm1Stage>(ctx, ctx_ext);
+  if (options_.convert_posit_div_to_mul)
+    pipeline.AddStage<ConvertPositDivToMulStage>(ctx, ctx_ext);
+  if (options_.convert_posit_mul_to_ldexp && can_use_shapes)
+    pipeline.AddStage<ConvertPositMulToLdexpStage>(ctx, ctx_ext);
   if (options_.unary_ops_composition)
     pipeline.AddStage<UnaryOpsComposition>(ctx, ctx_ext);
 
@@ -78,6 +78,8 @@ class ArithmeticOptimizer : public GraphOptimizer {
     bool convert_pow = true;
     bool convert_log1p = true;
     bool convert_expm1 = true;
+    bool convert_posit_div_to_mul = true;
+    bool convert_posit_mul_to_ldexp = true;
     bool unary_ops_composition = true;
 
     // Choose which arithmetic optimizer stages will be enabled for a given
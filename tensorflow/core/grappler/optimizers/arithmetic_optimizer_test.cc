@@ -161,6 +161,8 @@ class ArithmeticOptimizerTest : public GrapplerTest {
     options.reorder_cast_and_transpose = false;
     options.replace_mul_with_square = false;
     options.simplify_aggregation = false;
+    options.convert_posit_div_to_mul = false;
+    options.convert_posit_mul_to_ldexp = false;
     options.unary_ops_composition = false;
     optimizer->options_ = options;
   }
@@ -288,6 +290,12 @@ class ArithmeticOptimizerTest : public GrapplerTest {
     DisableAllStages(optimizer);
     optimizer->options_.unary_ops_composition = true;
   }
+
+  void EnableOnlyPositScaling(ArithmeticOptimizer* optimizer) {
+    DisableAllStages(optimizer);
+    optimizer->options_.convert_posit_div_to_mul = true;
+    optimizer->options_.convert_posit_mul_to_ldexp = true;
+  }
 };
 
 TEST_F(ArithmeticOptimizerTest, NoOp) {
@@ -3305,5 +3313,62 @@ TEST_F(ArithmeticOptimizerTest, UnaryOpsComposition) {
   test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-6);
 }
 
+TEST_F(ArithmeticOptimizerTest, PositScalingByPowersOfTwo) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto PositScalar = [&s](const string& name, float value) {
+    Tensor t(DT_POSIT16, TensorShape({}));
+    t.scalar<posit16>()() = posit16(value);
+    return ops::Const(s.WithOpName(name), Input::Initializer(t));
+  };
+  auto x_f = ops::Const(s.WithOpName("x_f"), {1.0f, -3.0f, 0.1f, 1000.0f},
+                        {2, 2});
+  auto x = ops::Cast(s.WithOpName("x"), x_f, DT_POSIT16);
+  auto four = PositScalar("four", 4.0f);
+  auto minus_half = PositScalar("minus_half", -0.5f);
+  auto three = PositScalar("three", 3.0f);
+  auto div = ops::Div(s.WithOpName("div"), x, four);
+  auto mul = ops::Mul(s.WithOpName("mul"), minus_half, x);
+  auto div3 = ops::Div(s.WithOpName("div3"), x, three);
+  auto sum = ops::AddN(s.WithOpName("sum"), {div, mul, div3});
+  auto out = ops::Cast(s.WithOpName("out"), sum, DT_FLOAT);
+
+  GrapplerItem item;
+  item.fetch = {"out"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  ASSERT_EQ(1, tensors_expected.size());
+
+  GraphDef output;
+  ArithmeticOptimizer optimizer;
+  EnableOnlyPositScaling(&optimizer);
+  OptimizeAndPrune(&optimizer, &item, &output);
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "div" || node.name() == "mul") {
+      EXPECT_EQ("_PositLdexp", node.op());
+      ASSERT_EQ(2, node.input_size());
+      EXPECT_EQ("x", node.input(0));
+      EXPECT_TRUE(IsControlInput(node.input(1)));
+      EXPECT_EQ(node.name() == "div" ? -2 : -1,
+                node.attr().at("exponent").i());
+      EXPECT_EQ(node.name() == "mul", node.attr().at("negate").b());
+      ++found;
+    } else if (node.name() == "div3") {
+      // 1/3 is not a posit, so the division stays.
+      EXPECT_EQ("Div", node.op());
+      ++found;
+    }
+  }
+  EXPECT_EQ(3, found);
+
+  auto tensors = EvaluateNodes(output, item.fetch);
+  ASSERT_EQ(1, tensors.size());
+  test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
+}
+
 }  // namespace grappler
 }  // namespace tensorflow
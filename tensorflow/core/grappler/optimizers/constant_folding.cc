@@ -23,6 +23,9 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_def.pb.h"
+#include "tensorflow/core/framework/posit16.h"
+#include "tensorflow/core/framework/posit32.h"
+#include "tensorflow/core/framework/posit8.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.h"
@@ -841,7 +844,7 @@ Status CreateConstantTensorAttrValue(DataType type, double value,
       t->add_uint32_val(static_cast<posit8>(value).value);
       break;
     case DT_POSIT16:
-      t->add_uint32_val(static_cast<posit16>(value).value);
+      t->add_half_val(static_cast<posit16>(value).value);
       break;
     case DT_POSIT32:
       t->add_uint32_val(static_cast<posit32>(value).value);
@@ -865,6 +868,63 @@ Status CreateConstantTensorAttrValue(DataType type, double value,
 
 #undef SET_TENSOR_CAL_CASE
 
+template <typename SrcT, typename DstT>
+TensorValue ConvertTensor(const Tensor& in,
+                          void (*convert)(const SrcT*, DstT*, int64)) {
+  Tensor* out = new Tensor(DataTypeToEnum<DstT>::value, in.shape());
+  convert(in.flat<SrcT>().data(), out->flat<DstT>().data(),
+          in.NumElements());
+  return TensorValue(out);
+}
+
+// Folds a Cast between float and a posit type with the bulk converters instead
+// of running the Cast kernel. Posit graphs typically cast every float weight,
+// so this is where most of their folding time goes. Returns false if the node
+// isn't such a cast, in which case it should be evaluated normally. Truncating
+// casts are left to the Cast kernel, since the converters round to nearest.
+bool EvaluatePositCast(const NodeDef& node, const TensorVector& inputs,
+                       TensorVector* output) {
+  if (!IsCast(node) || inputs.size() != 1 || node.attr().count("DstT") == 0) {
+    return false;
+  }
+  if (node.attr().count("Truncate") != 0 && node.attr().at("Truncate").b()) {
+    return false;
+  }
+  const Tensor& in = *inputs[0].tensor;
+  const DataType dst_type = node.attr().at("DstT").type();
+  if (in.dtype() == DT_FLOAT) {
+    switch (dst_type) {
+      case DT_POSIT8:
+        output->push_back(ConvertTensor(in, FloatToPosit8));
+        return true;
+      case DT_POSIT16:
+        output->push_back(ConvertTensor(in, FloatToPosit16));
+        return true;
+      case DT_POSIT32:
+        output->push_back(ConvertTensor(in, FloatToPosit32));
+        return true;
+      default:
+        return false;
+    }
+  }
+  if (dst_type == DT_FLOAT) {
+    switch (in.dtype()) {
+      case DT_POSIT8:
+        output->push_back(ConvertTensor(in, Posit8ToFloat));
+        return true;
+      case DT_POSIT16:
+        output->push_back(ConvertTensor(in, Posit16ToFloat));
+        return true;
+      case DT_POSIT32:
+        output->push_back(ConvertTensor(in, Posit32ToFloat));
+        return true;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
 DataType GetDataTypeFromNodeOrProps(const NodeDef& node,
                                     const GraphProperties& properties) {
   DataType dtype = DT_INVALID;
@@ -928,6 +988,34 @@ Status ConstantFolding::CreateNodeDef(const string& name,
   }                                                                   \
   break
 
+// Posits are stored by bit pattern, posit16 in half_val and the others in
+// uint32_val, so they are compared and copied through their "value" field
+// rather than numerically.
+#define POPULATE_POSIT_TENSOR_PROTO(tensor, t, TYPE, NAME)               \
+  {                                                                      \
+    const TYPE* val_ptr = tensor->flat<TYPE>().data();                   \
+    auto last = val_ptr->value;                                          \
+    int64 last_index = 0;                                                \
+    for (int64 i = 0; i < tensor->NumElements(); ++i) {                  \
+      auto cur = (val_ptr++)->value;                                     \
+      if (cur != last) {                                                 \
+        last = cur;                                                      \
+        last_index = i;                                                  \
+      }                                                                  \
+    }                                                                    \
+    if (last_index < kint32max) {                                        \
+      optimized = true;                                                  \
+      encoded_size = (last_index + 1) * sizeof(int);                     \
+      t->mutable_##NAME##_val()->Reserve(last_index + 1);                \
+      t->mutable_##NAME##_val()->AddNAlreadyReserved(last_index + 1);    \
+      val_ptr = tensor->flat<TYPE>().data();                             \
+      for (int64 i = 0; i <= last_index; ++i) {                          \
+        t->set_##NAME##_val(i, (val_ptr++)->value);                      \
+      }                                                                  \
+    }                                                                    \
+  }                                                                      \
+  break
+
     switch (tensor->dtype()) {
       case DT_FLOAT:
         POPULATE_TENSOR_PROTO(tensor, t, float, float);
@@ -951,6 +1039,12 @@ Status ConstantFolding::CreateNodeDef(const string& name,
         POPULATE_TENSOR_PROTO(tensor, t, uint8, int);
       case DT_BOOL:
         POPULATE_TENSOR_PROTO(tensor, t, bool, bool);
+      case DT_POSIT8:
+        POPULATE_POSIT_TENSOR_PROTO(tensor, t, posit8, uint32);
+      case DT_POSIT16:
+        POPULATE_POSIT_TENSOR_PROTO(tensor, t, posit16, half);
+      case DT_POSIT32:
+        POPULATE_POSIT_TENSOR_PROTO(tensor, t, posit32, uint32);
       default:
         /* Do nothing. */
         break;
@@ -1014,7 +1108,9 @@ Status ConstantFolding::EvaluateOneFoldable(const NodeDef& node,
     inputs.emplace_back(value);
   }
 
-  TF_RETURN_IF_ERROR(EvaluateNode(node, inputs, &output_tensors));
+  if (!EvaluatePositCast(node, inputs, &output_tensors)) {
+    TF_RETURN_IF_ERROR(EvaluateNode(node, inputs, &output_tensors));
+  }
   if (output_tensors.empty()) {
     return Status(error::INVALID_ARGUMENT, "Expected at least one output.");
   }
@@ -1689,6 +1785,17 @@ Status ConstantFolding::SimplifyNode(bool use_shape_info, NodeDef* node,
     return Status::OK();
   }
 
+  bool simplify_posit_fill_successful = false;
+  Status simplify_posit_fill_status =
+      SimplifyPositFill(*properties, use_shape_info, optimized_graph, node,
+                        &simplify_posit_fill_successful);
+  if (!simplify_posit_fill_status.ok()) {
+    return simplify_posit_fill_status;
+  } else if (simplify_posit_fill_successful) {
+    graph_modified_ = true;
+    return Status::OK();
+  }
+
   if (SimplifyPack(optimized_graph, node)) {
     graph_modified_ = true;
     return Status::OK();
@@ -2133,6 +2240,42 @@ bool ConstantFolding::SimplifySqueeze(const GraphProperties& properties,
   return false;
 }
 
+Status ConstantFolding::SimplifyPositFill(const GraphProperties& properties,
+                                          bool use_shape_info,
+                                          GraphDef* optimized_graph,
+                                          NodeDef* node, bool* success) {
+  *success = false;
+  if (!use_shape_info ||
+      !(node->op() == "ZerosLike" || node->op() == "OnesLike" ||
+        IsFill(*node)) ||
+      node->attr().count("T") == 0) {
+    return Status::OK();
+  }
+  const DataType type = node->attr().at("T").type();
+  if (type != DT_POSIT8 && type != DT_POSIT16 && type != DT_POSIT32) {
+    return Status::OK();
+  }
+  if (!properties.HasOutputProperties(node->name())) {
+    return Status::OK();
+  }
+  const TensorShapeProto& output_shape =
+      properties.GetOutputProperties(node->name())[0].shape();
+  if (!PartialTensorShape(output_shape).IsFullyDefined()) {
+    return Status::OK();
+  }
+  // The constant is stored as a single repeated value, so it stays small
+  // however large the shape is.
+  if (IsZeros(*node)) {
+    return ReplaceOperationWithConstant(0, properties, output_shape, node,
+                                        optimized_graph, success);
+  }
+  if (IsOnes(*node)) {
+    return ReplaceOperationWithConstant(1, properties, output_shape, node,
+                                        optimized_graph, success);
+  }
+  return Status::OK();
+}
+
 bool ConstantFolding::SimplifyPack(GraphDef* optimized_graph, NodeDef* node) {
   if (IsPack(*node) && NumNonControlInputs(*node) == 1 &&
       !OptimizedNodeExists(*node, "_const_axis")) {
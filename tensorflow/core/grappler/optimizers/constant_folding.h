@@ -174,6 +174,12 @@ class ConstantFolding : public GraphOptimizer {
   bool SimplifySqueeze(const GraphProperties& properties, bool use_shape_info,
                        GraphDef* optimized_graph, NodeDef* node);
 
+  // Replaces a posit ZerosLike, OnesLike or Fill of zeros or ones whose shape
+  // is fully known with the equivalent constant.
+  Status SimplifyPositFill(const GraphProperties& properties,
+                           bool use_shape_info, GraphDef* optimized_graph,
+                           NodeDef* node, bool* success);
+
   // Simplifies a Pad operation to an Identity operation if applicable.
   Status SimplifyPad(const GraphProperties& properties, bool use_shape_info,
                      GraphDef* optimized_graph, NodeDef* node, bool* success);
@@ -17,6 +17,9 @@ limitations under the License.
 #include "tensorflow/cc/ops/array_ops_internal.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/posit16.h"
+#include "tensorflow/core/framework/posit32.h"
+#include "tensorflow/core/framework/posit8.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/utils.h"
@@ -3204,6 +3207,120 @@ TEST_F(ConstantFoldingTest, FoldingPreservesDenormalFlushing) {
   test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
 }
 
+TEST_F(ConstantFoldingTest, CastToPosit) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  const std::vector<float> values = {1.0f, 0.5f, -3.0f, 1e-3f, 1e-3f, 1e-3f};
+  Output c = ops::Const(s.WithOpName("c"), values, {6});
+  Output p8 = ops::Cast(s.WithOpName("p8"), c, DT_POSIT8);
+  Output p16 = ops::Cast(s.WithOpName("p16"), c, DT_POSIT16);
+  Output p32 = ops::Cast(s.WithOpName("p32"), c, DT_POSIT32);
+
+  GrapplerItem item;
+  item.fetch = {"p8", "p16", "p32"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  ConstantFolding optimizer(nullptr /* cpu_device */);
+  GraphDef output;
+  Status status = optimizer.Optimize(nullptr, item, &output);
+  TF_EXPECT_OK(status);
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() != "p8" && node.name() != "p16" && node.name() != "p32") {
+      continue;
+    }
+    ++found;
+    EXPECT_EQ("Const", node.op());
+    const TensorProto& proto = node.attr().at("value").tensor();
+    // Trailing repeats are elided; posit16 is stored in half_val.
+    EXPECT_EQ(4, node.name() == "p16" ? proto.half_val_size()
+                                      : proto.uint32_val_size());
+    Tensor t;
+    ASSERT_TRUE(t.FromProto(proto));
+    ASSERT_EQ(6, t.NumElements());
+    for (int i = 0; i < t.NumElements(); ++i) {
+      if (node.name() == "p8") {
+        EXPECT_EQ(posit8(values[i]).value, t.flat<posit8>()(i).value);
+      } else if (node.name() == "p16") {
+        EXPECT_EQ(posit16(values[i]).value, t.flat<posit16>()(i).value);
+      } else {
+        EXPECT_EQ(posit32(values[i]).value, t.flat<posit32>()(i).value);
+      }
+    }
+  }
+  EXPECT_EQ(3, found);
+}
+
+TEST_F(ConstantFoldingTest, TruncatingCastToPositMatchesKernel) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  // Values that round up to the nearest posit16.
+  Output c = ops::Const(s.WithOpName("c"), {1.0009f, -3.0019f, 100.3f}, {3});
+  Output p16 = ops::Cast(s.WithOpName("p16"), c, DT_POSIT16,
+                         ops::Cast::Truncate(true));
+  Output f = ops::Cast(s.WithOpName("f"), p16, DT_FLOAT);
+
+  GrapplerItem item;
+  item.fetch = {"f"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  ASSERT_EQ(1, tensors_expected.size());
+
+  ConstantFolding optimizer(nullptr /* cpu_device */);
+  GraphDef output;
+  Status status = optimizer.Optimize(nullptr, item, &output);
+  TF_EXPECT_OK(status);
+
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "p16") {
+      EXPECT_EQ("Const", node.op());
+    }
+  }
+  auto tensors = EvaluateNodes(output, item.fetch);
+  ASSERT_EQ(1, tensors.size());
+  test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
+}
+
+TEST_F(ConstantFoldingTest, PositZerosAndOnesLike) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_POSIT16,
+                              ops::Placeholder::Shape(TensorShape({2, 3})));
+  Output zeros = ops::ZerosLike(s.WithOpName("zeros"), x);
+  Output ones = ops::OnesLike(s.WithOpName("ones"), x);
+  Output zeros_id = ops::Identity(s.WithOpName("zeros_id"), zeros);
+  Output ones_id = ops::Identity(s.WithOpName("ones_id"), ones);
+
+  GrapplerItem item;
+  item.fetch = {"zeros_id", "ones_id"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  ConstantFolding optimizer(nullptr /* cpu_device */);
+  GraphDef output;
+  Status status = optimizer.Optimize(nullptr, item, &output);
+  TF_EXPECT_OK(status);
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() != "zeros" && node.name() != "ones") {
+      continue;
+    }
+    ++found;
+    EXPECT_EQ("Const", node.op());
+    ASSERT_EQ(1, node.input_size());
+    EXPECT_EQ("^x", node.input(0));
+    const TensorProto& proto = node.attr().at("value").tensor();
+    EXPECT_EQ(DT_POSIT16, proto.dtype());
+    EXPECT_EQ(2, proto.tensor_shape().dim_size());
+    Tensor t;
+    ASSERT_TRUE(t.FromProto(proto));
+    ASSERT_EQ(6, t.NumElements());
+    const posit16 expected(node.name() == "zeros" ? 0.0f : 1.0f);
+    for (int i = 0; i < t.NumElements(); ++i) {
+      EXPECT_EQ(expected.value, t.flat<posit16>()(i).value);
+    }
+  }
+  EXPECT_EQ(2, found);
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
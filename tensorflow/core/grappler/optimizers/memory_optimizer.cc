@@ -49,6 +49,8 @@ const char* kRecomputeTriggerNodePrefix = "RecomputeTrigger";
 // Attribute which may be added to nodes to manually allow them to be
 // recomputed.
 const char* kRecomputeHint = "_recompute_hint";
+// Attribute listing the inputs a node is the last reader of.
+const char* kLastUseInputsAttr = "_last_use_inputs";
 
 // Ops which we wouldn't mind recomputing to save memory.
 // TODO(allenl): Replace this list with a cost model.
@@ -1297,6 +1299,90 @@ Status RelaxAllocatorConstraints(GraphDef* optimized_graph) {
   return Status::OK();
 }
 
+// Element-wise ops whose kernels compute in place into one of their inputs
+// when its buffer is not shared. Computing in place is safe for them even if
+// several of their inputs alias the same buffer.
+static bool ForwardsInputInPlace(const NodeDef& node) {
+  static const std::unordered_set<string>* binary_ops =
+      CHECK_NOTNULL((new std::unordered_set<string>{
+          "Add",
+          "AddV2",
+          "Div",
+          "Maximum",
+          "Minimum",
+          "Mul",
+          "Pow",
+          "RealDiv",
+          "ReciprocalGrad",
+          "RsqrtGrad",
+          "SigmoidGrad",
+          "SqrtGrad",
+          "SquaredDifference",
+          "Sub",
+          "TanhGrad",
+      }));
+  return binary_ops->count(node.op()) > 0 ||
+         (IsUnaryElementWise(node) && !IsValueAndOrderAndShapePreserving(node));
+}
+
+// Marks the inputs that a node is guaranteed to be the last reader of in its
+// "_last_use_inputs" attribute. The executor uses the marks to drop the
+// references that would keep the kernel from computing in place, and reports
+// the outputs that were allocated although a marked input was available.
+//
+// An input is a last use if every other node reading the same tensor is
+// itself an input of the node, and so has run before it. Tensors that
+// outlive the step (constants, variables, feeds, fetches) or that cross
+// frames or devices are never marked.
+Status AnnotateLastUses(const GrapplerItem& item, GraphDef* optimized_graph) {
+  const std::unordered_set<string> nodes_to_preserve = item.NodesToPreserve();
+  GraphView graph_view(optimized_graph);
+  for (int i = 0; i < optimized_graph->node_size(); ++i) {
+    NodeDef* node = optimized_graph->mutable_node(i);
+    node->mutable_attr()->erase(kLastUseInputsAttr);
+    if (!ForwardsInputInPlace(*node)) {
+      continue;
+    }
+    std::unordered_set<const NodeDef*> data_fanins;
+    for (int j = 0; j < node->input_size(); ++j) {
+      if (IsControlInput(node->input(j))) break;
+      const GraphView::OutputPort fanin =
+          graph_view.GetRegularFanin(GraphView::InputPort(node, j));
+      if (fanin.node != nullptr) data_fanins.insert(fanin.node);
+    }
+    std::vector<int> last_uses;
+    for (int j = 0; j < node->input_size(); ++j) {
+      if (IsControlInput(node->input(j))) break;
+      const GraphView::OutputPort fanin =
+          graph_view.GetRegularFanin(GraphView::InputPort(node, j));
+      const NodeDef* producer = fanin.node;
+      if (producer == nullptr || producer->device() != node->device() ||
+          nodes_to_preserve.count(producer->name()) > 0 ||
+          IsConstant(*producer) || IsVariable(*producer) ||
+          IsPlaceholder(*producer) || ModifiesFrameInfo(*producer)) {
+        continue;
+      }
+      bool is_last_use = true;
+      for (const GraphView::InputPort& reader : graph_view.GetFanout(fanin)) {
+        if (reader.node != node && data_fanins.count(reader.node) == 0) {
+          is_last_use = false;
+          break;
+        }
+      }
+      if (is_last_use) {
+        last_uses.push_back(j);
+      }
+    }
+    if (!last_uses.empty()) {
+      AttrValue& attr = (*node->mutable_attr())[kLastUseInputsAttr];
+      for (int j : last_uses) {
+        attr.mutable_list()->add_i(j);
+      }
+    }
+  }
+  return Status::OK();
+}
+
 Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
                                  GraphDef* optimized_graph) {
   *optimized_graph = item.graph;
@@ -1330,6 +1416,7 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   }
 
   TF_RETURN_IF_ERROR(RelaxAllocatorConstraints(&optimized_item.graph));
+  TF_RETURN_IF_ERROR(AnnotateLastUses(item, &optimized_item.graph));
 
   optimized_graph->Swap(&optimized_item.graph);
   return Status::OK();
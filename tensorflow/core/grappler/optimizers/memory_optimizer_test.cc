@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/memory_optimizer.h"
 
+#include <map>
 #include <vector>
 
 #include "tensorflow/cc/ops/standard_ops.h"
@@ -574,6 +575,95 @@ TEST_F(RelaxAllocatorConstraintsTest, AssignNodeInFanout) {
 #endif
 }
 
+class AnnotateLastUsesTest : public GrapplerTest {};
+
+TEST_F(AnnotateLastUsesTest, MarksLastReaders) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice("/cpu:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT);
+  Output c = ops::Const(s.WithOpName("c"), 2.0f, {128});
+  Output y = ops::Exp(s.WithOpName("y"), x);
+  Output z = ops::Mul(s.WithOpName("z"), y, y);
+  Output w = ops::Add(s.WithOpName("w"), z, c);
+  // z is also read by w, which runs before u.
+  Output u = ops::Sub(s.WithOpName("u"), w, z);
+  Output v = ops::MatMul(s.WithOpName("v"), u, u);
+
+  GrapplerItem item;
+  item.fetch = {"v"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  MemoryOptimizer optimizer(RewriterConfig::MANUAL);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  std::map<string, std::vector<int>> last_uses;
+  for (const NodeDef& node : output.node()) {
+    auto it = node.attr().find("_last_use_inputs");
+    if (it == node.attr().end()) continue;
+    last_uses[node.name()].assign(it->second.list().i().begin(),
+                                  it->second.list().i().end());
+  }
+  // The feed, the constant, z at w and the non-element-wise MatMul are not
+  // last uses.
+  EXPECT_EQ(0, last_uses.count("y"));
+  EXPECT_EQ(std::vector<int>({0, 1}), last_uses["z"]);
+  EXPECT_EQ(0, last_uses.count("w"));
+  EXPECT_EQ(std::vector<int>({0, 1}), last_uses["u"]);
+  EXPECT_EQ(0, last_uses.count("v"));
+}
+
+// The outputs of Split and Unpack are slices of one buffer, but each is a
+// tensor of its own, so a node reading two of them is the last reader of
+// both. The executor must not treat them as one input.
+TEST_F(AnnotateLastUsesTest, MarksSliceOutputsSeparately) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice("/cpu:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT);
+  Output y = ops::Exp(s.WithOpName("y"), x);
+  ops::Split split(s.WithOpName("split"), 0, y, 2);
+  ops::Unstack unpack(s.WithOpName("unpack"), y, 2);
+  Output a = ops::Add(s.WithOpName("a"), split[0], split[1]);
+  Output b = ops::Add(s.WithOpName("b"), unpack[0], unpack[1]);
+  Output c = ops::MatMul(s.WithOpName("c"), a, a);
+  Output d = ops::Neg(s.WithOpName("d"), b);
+
+  GrapplerItem item;
+  item.fetch = {"c", "d"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  MemoryOptimizer optimizer(RewriterConfig::MANUAL);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  std::map<string, std::vector<int>> last_uses;
+  for (const NodeDef& node : output.node()) {
+    auto it = node.attr().find("_last_use_inputs");
+    if (it == node.attr().end()) continue;
+    last_uses[node.name()].assign(it->second.list().i().begin(),
+                                  it->second.list().i().end());
+  }
+  EXPECT_EQ(std::vector<int>({0, 1}), last_uses["a"]);
+  EXPECT_EQ(std::vector<int>({0, 1}), last_uses["b"]);
+}
+
+TEST_F(AnnotateLastUsesTest, SkipsFetchedTensors) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice("/cpu:0");
+  Output x = ops::Const(s.WithOpName("x"), 2.0f, {128});
+  Output y = ops::Exp(s.WithOpName("y"), x);
+  Output z = ops::Neg(s.WithOpName("z"), y);
+
+  GrapplerItem item;
+  item.fetch = {"y", "z"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  MemoryOptimizer optimizer(RewriterConfig::MANUAL);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  for (const NodeDef& node : output.node()) {
+    EXPECT_EQ(0, node.attr().count("_last_use_inputs")) << node.name();
+  }
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 
+#include <unordered_map>
+#include <unordered_set>
+
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 #include "tensorflow/core/grappler/graph_view.h"
@@ -27,6 +31,118 @@ limitations under the License.
 namespace tensorflow {
 namespace grappler {
 
+namespace {
+
+bool HasNhwcFormat(const NodeDef& node) {
+  return node.attr().count("data_format") == 0 ||
+         node.attr().at("data_format").s() == "NHWC";
+}
+
+// Returns the only consumer of 'node' if it reads output 0 through a regular
+// input, and nullptr otherwise. Control dependencies count as consumers.
+const NodeDef* GetSoleConsumer(const GraphView& graph, const NodeDef& node) {
+  const auto fanouts =
+      graph.GetFanouts(node, /*include_controlled_nodes=*/true);
+  if (fanouts.size() != 1) return nullptr;
+  const GraphView::InputPort& consumer = *fanouts.begin();
+  if (consumer.port_id != 0) return nullptr;
+  const GraphView::OutputPort fanin = graph.GetRegularFanin(consumer);
+  if (fanin.node != &node || fanin.port_id != 0) return nullptr;
+  return consumer.node;
+}
+
+// Returns true if 'input' is produced by a constant or a variable, possibly
+// behind Identity nodes.
+bool IsWeights(const GraphView& graph, const string& input) {
+  const NodeDef* node = graph.GetNode(NodeName(input));
+  while (node != nullptr && IsIdentity(*node) && node->input_size() > 0) {
+    node = graph.GetNode(NodeName(node->input(0)));
+  }
+  return node != nullptr && (IsConstant(*node) || IsVariable(*node));
+}
+
+// Returns true if 'node' is a posit MatMul on CPU whose 'b' operand is
+// weights. The MatMul kernel keeps the decoding of such weights across calls,
+// which would only waste memory for an activation.
+bool IsPositMatMulWithWeights(const GraphView& graph, const NodeDef& node) {
+  if (node.op() != "MatMul" || node.attr().count("T") == 0 ||
+      !IsPositType(node.attr().at("T").type()) || !IsOnCpuOrUnplaced(node) ||
+      node.input_size() < 2) {
+    return false;
+  }
+  return IsWeights(graph, node.input(1));
+}
+
+// Same as IsPositMatMulWithWeights for the filter of a Conv2D.
+bool IsPositConv2DWithWeights(const GraphView& graph, const NodeDef& node) {
+  if (!IsConv2D(node) || node.attr().count("T") == 0 ||
+      !IsPositType(node.attr().at("T").type()) || !IsOnCpuOrUnplaced(node) ||
+      node.input_size() < 2) {
+    return false;
+  }
+  return IsWeights(graph, node.input(1));
+}
+
+// Builds a _PositFusedConv2D for the chain Conv2D -> BiasAdd [-> Relu|Relu6]
+// ending at 'bias_add' or its activation. The fused node takes the name of the
+// last node in the chain, so its consumers need no rewiring.
+bool FusePositConvBiasActivation(
+    const GraphView& graph, const NodeDef& bias_add,
+    const std::unordered_set<string>& nodes_to_preserve, NodeDef* fused,
+    std::vector<const NodeDef*>* absorbed) {
+  if (!IsBiasAdd(bias_add) || bias_add.attr().count("T") == 0 ||
+      !IsPositType(bias_add.attr().at("T").type()) ||
+      !HasNhwcFormat(bias_add) || !IsOnCpuOrUnplaced(bias_add)) {
+    return false;
+  }
+  const NodeDef* conv = graph.GetNode(NodeName(bias_add.input(0)));
+  if (conv == nullptr || !IsConv2D(*conv) || !HasNhwcFormat(*conv) ||
+      conv->device() != bias_add.device() ||
+      nodes_to_preserve.count(conv->name()) > 0 ||
+      GetSoleConsumer(graph, *conv) != &bias_add) {
+    return false;
+  }
+
+  const NodeDef* activation = GetSoleConsumer(graph, bias_add);
+  if (activation != nullptr &&
+      (!(IsRelu(*activation) || IsRelu6(*activation)) ||
+       activation->device() != bias_add.device() ||
+       nodes_to_preserve.count(bias_add.name()) > 0)) {
+    activation = nullptr;
+  }
+  const NodeDef& tail = activation != nullptr ? *activation : bias_add;
+
+  fused->set_name(tail.name());
+  fused->set_op("_PositFusedConv2D");
+  fused->set_device(tail.device());
+  fused->add_input(conv->input(0));
+  fused->add_input(conv->input(1));
+  fused->add_input(bias_add.input(1));
+  for (const NodeDef* node : {conv, &bias_add, activation}) {
+    if (node == nullptr) continue;
+    for (const string& input : node->input()) {
+      if (IsControlInput(input)) fused->add_input(input);
+    }
+  }
+  auto* attr = fused->mutable_attr();
+  (*attr)["T"] = bias_add.attr().at("T");
+  for (const string& name : {"strides", "padding", "dilations"}) {
+    if (conv->attr().count(name) > 0) (*attr)[name] = conv->attr().at(name);
+  }
+  (*attr)["data_format"].set_s("NHWC");
+  (*attr)["activation"].set_s(activation != nullptr ? activation->op()
+                                                     : "Identity");
+  if (IsWeights(graph, conv->input(1))) {
+    (*attr)["_grappler_filter_is_weights"].set_b(true);
+  }
+
+  absorbed->push_back(conv);
+  if (activation != nullptr) absorbed->push_back(&bias_add);
+  return true;
+}
+
+}  // namespace
+
 void AddBatchNormNodes(GraphDef* optimized_graph, const NodeDef& fused_node) {
   const string& x = fused_node.input(0);
   string scale = fused_node.input(1);
@@ -171,9 +287,49 @@ Status Remapper::Optimize(Cluster* /*cluster*/, const GrapplerItem& item,
   TF_RETURN_IF_ERROR(properties.InferStatically(false));
   GraphView graph(const_cast<GraphDef*>(&item.graph));
 
+  // Posit Conv2D + BiasAdd [+ Relu|Relu6] chains on CPU are collapsed into
+  // _PositFusedConv2D, which rounds the activation once instead of writing
+  // and re-reading it after each op. Posit MatMuls whose 'b' is a weight are
+  // marked so that the kernel caches its decoding.
+  const std::unordered_set<string> nodes_to_preserve = item.NodesToPreserve();
+  std::unordered_map<string, NodeDef> fused_convs;
+  std::unordered_set<string> absorbed_nodes;
+  for (const NodeDef& node : item.graph.node()) {
+    NodeDef fused;
+    std::vector<const NodeDef*> absorbed;
+    if (FusePositConvBiasActivation(graph, node, nodes_to_preserve, &fused,
+                                    &absorbed)) {
+      VLOG(1) << "Fusing posit convolution chain ending at " << fused.name();
+      for (const NodeDef* absorbed_node : absorbed) {
+        absorbed_nodes.insert(absorbed_node->name());
+      }
+      fused_convs[fused.name()] = std::move(fused);
+    }
+  }
+
   // During inference, most of the inputs to FusedBatchNorm are constant, and we
   // can therefore replace the op with a much cheaper set of primitives.
   for (const NodeDef& node : item.graph.node()) {
+    if (absorbed_nodes.count(node.name()) > 0) {
+      continue;
+    }
+    auto fused_conv = fused_convs.find(node.name());
+    if (fused_conv != fused_convs.end()) {
+      *optimized_graph->add_node() = fused_conv->second;
+      continue;
+    }
+    if (IsPositMatMulWithWeights(graph, node)) {
+      NodeDef* matmul = optimized_graph->add_node();
+      *matmul = node;
+      (*matmul->mutable_attr())["_grappler_b_is_weights"].set_b(true);
+      continue;
+    }
+    if (IsPositConv2DWithWeights(graph, node)) {
+      NodeDef* conv = optimized_graph->add_node();
+      *conv = node;
+      (*conv->mutable_attr())["_grappler_filter_is_weights"].set_b(true);
+      continue;
+    }
     if (node.op() == "FusedBatchNorm" || node.op() == "FusedBatchNormV2") {
       bool optimizable = (node.attr().count("T") == 0 ||
                           node.attr().at("T").type() == DT_FLOAT);
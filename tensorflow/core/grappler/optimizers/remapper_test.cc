@@ -91,5 +91,151 @@ TEST_F(RemapperTest, FusedBatchNormNCHW) {
   }
 }
 
+TEST_F(RemapperTest, FusePositConv2DBiasAddRelu) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto input_f = ops::Const(s.WithOpName("input_f"),
+                            {1.0f, 2.0f, 3.0f, 8.0f, -1.0f, 0.5f, 2.0f, 4.0f},
+                            {1, 2, 2, 2});
+  auto filter_f = ops::Const(s.WithOpName("filter_f"),
+                             {1.0f, -1.0f, 0.5f, 2.0f}, {1, 1, 2, 2});
+  auto bias_f = ops::Const(s.WithOpName("bias_f"), {0.5f, -1.0f}, {2});
+  auto input = ops::Cast(s.WithOpName("input"), input_f, DT_POSIT16);
+  auto filter = ops::Cast(s.WithOpName("filter"), filter_f, DT_POSIT16);
+  auto bias = ops::Cast(s.WithOpName("bias"), bias_f, DT_POSIT16);
+  auto conv = ops::Conv2D(s.WithOpName("conv"), input, filter, {1, 1, 1, 1},
+                          "VALID");
+  auto bias_add = ops::BiasAdd(s.WithOpName("bias_add"), conv, bias);
+  auto relu = ops::Relu(s.WithOpName("relu"), bias_add);
+  auto output = ops::Cast(s.WithOpName("output"), relu, DT_FLOAT);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"output"};
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef optimized;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &optimized));
+
+  EXPECT_EQ(item.graph.node_size() - 2, optimized.node_size());
+  int found = 0;
+  for (const NodeDef& node : optimized.node()) {
+    EXPECT_NE("conv", node.name());
+    EXPECT_NE("bias_add", node.name());
+    if (node.name() == "relu") {
+      EXPECT_EQ("_PositFusedConv2D", node.op());
+      ASSERT_EQ(3, node.input_size());
+      EXPECT_EQ("input", node.input(0));
+      EXPECT_EQ("filter", node.input(1));
+      EXPECT_EQ("bias", node.input(2));
+      EXPECT_EQ("Relu", node.attr().at("activation").s());
+      EXPECT_EQ(DT_POSIT16, node.attr().at("T").type());
+      // The filter is computed, so the kernel must not cache its decoding.
+      EXPECT_EQ(0, node.attr().count("_grappler_filter_is_weights"));
+      ++found;
+    }
+  }
+  EXPECT_EQ(1, found);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  auto tensors = EvaluateNodes(optimized, item.fetch);
+  ASSERT_EQ(1, tensors_expected.size());
+  ASSERT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-3);
+}
+
+TEST_F(RemapperTest, PositConv2DWithSharedOutputIsNotFused) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto input = ops::Cast(
+      s.WithOpName("input"),
+      ops::Const(s.WithOpName("input_f"), 1.0f, {1, 2, 2, 1}), DT_POSIT16);
+  auto filter = ops::Cast(
+      s.WithOpName("filter"),
+      ops::Const(s.WithOpName("filter_f"), 1.0f, {1, 1, 1, 1}), DT_POSIT16);
+  auto bias = ops::Cast(s.WithOpName("bias"),
+                        ops::Const(s.WithOpName("bias_f"), 1.0f, {1}),
+                        DT_POSIT16);
+  auto conv = ops::Conv2D(s.WithOpName("conv"), input, filter, {1, 1, 1, 1},
+                          "VALID");
+  auto bias_add = ops::BiasAdd(s.WithOpName("bias_add"), conv, bias);
+  auto other = ops::Relu(s.WithOpName("other"), conv);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"bias_add", "other"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef optimized;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &optimized));
+
+  EXPECT_EQ(item.graph.node_size(), optimized.node_size());
+  for (const NodeDef& node : optimized.node()) {
+    EXPECT_NE("_PositFusedConv2D", node.op());
+  }
+}
+
+TEST_F(RemapperTest, MarksPositMatMulWeights) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto x = ops::Placeholder(s.WithOpName("x"), DT_POSIT16,
+                            ops::Placeholder::Shape({2, 2}));
+  auto w = ops::Variable(s.WithOpName("w"), {2, 2}, DT_POSIT16);
+  auto w_read = ops::Identity(s.WithOpName("w_read"), w);
+  auto with_weights = ops::MatMul(s.WithOpName("with_weights"), x, w_read);
+  auto with_activation =
+      ops::MatMul(s.WithOpName("with_activation"), x, with_weights);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"with_activation"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef optimized;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &optimized));
+
+  EXPECT_EQ(item.graph.node_size(), optimized.node_size());
+  for (const NodeDef& node : optimized.node()) {
+    if (node.name() == "with_weights") {
+      ASSERT_EQ(1, node.attr().count("_grappler_b_is_weights"));
+      EXPECT_TRUE(node.attr().at("_grappler_b_is_weights").b());
+    } else {
+      EXPECT_EQ(0, node.attr().count("_grappler_b_is_weights"));
+    }
+  }
+}
+
+TEST_F(RemapperTest, MarksPositConv2DFilterWeights) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto x = ops::Placeholder(s.WithOpName("x"), DT_POSIT16,
+                            ops::Placeholder::Shape({1, 2, 2, 1}));
+  auto f = ops::Placeholder(s.WithOpName("f"), DT_POSIT16,
+                            ops::Placeholder::Shape({1, 1, 1, 1}));
+  auto w = ops::Variable(s.WithOpName("w"), {1, 1, 1, 1}, DT_POSIT16);
+  auto w_read = ops::Identity(s.WithOpName("w_read"), w);
+  auto with_weights = ops::Conv2D(s.WithOpName("with_weights"), x, w_read,
+                                  {1, 1, 1, 1}, "VALID");
+  auto with_activation = ops::Conv2D(s.WithOpName("with_activation"),
+                                     with_weights, f, {1, 1, 1, 1}, "VALID");
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"with_activation"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef optimized;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &optimized));
+
+  EXPECT_EQ(item.graph.node_size(), optimized.node_size());
+  for (const NodeDef& node : optimized.node()) {
+    if (node.name() == "with_weights") {
+      ASSERT_EQ(1, node.attr().count("_grappler_filter_is_weights"));
+      EXPECT_TRUE(node.attr().at("_grappler_filter_is_weights").b());
+    } else {
+      EXPECT_EQ(0, node.attr().count("_grappler_filter_is_weights"));
+    }
+  }
+}
+
 }  // namespace grappler
 }  // namespace tensorflow
@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/notification.h"
+#include "tensorflow/core/util/device_name_utils.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -300,6 +301,18 @@ DataType GetDataTypeFromAttr(const NodeDef& node, const string& attr_name) {
   return attr.type();
 }
 
+bool IsPositType(DataType dtype) {
+  return dtype == DT_POSIT8 || dtype == DT_POSIT16 || dtype == DT_POSIT32;
+}
+
+bool IsOnCpuOrUnplaced(const NodeDef& node) {
+  if (node.device().empty()) return true;
+  string task;
+  string device;
+  return DeviceNameUtils::SplitDeviceName(node.device(), &task, &device) &&
+         str_util::StartsWith(device, DEVICE_CPU);
+}
+
 NodeDef* GetTailOfChain(const NodeDef& source, const NodeMap& node_map,
                         bool follow_control_input,
                         const std::function<bool(const NodeDef&)>& pred_fn) {
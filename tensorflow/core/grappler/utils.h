@@ -190,6 +190,13 @@ void DedupControlInputs(NodeDef* node);
 // doesn't exist, returns DT_INVALID.
 DataType GetDataTypeFromAttr(const NodeDef& node, const string& attr_name);
 
+// True iff 'dtype' is posit8, posit16 or posit32.
+bool IsPositType(DataType dtype);
+
+// True iff 'node' is placed on a CPU or not placed yet. Posit kernels only
+// exist on CPU, so rewrites of posit nodes accept unplaced nodes as well.
+bool IsOnCpuOrUnplaced(const NodeDef& node);
+
 // Returns the last node in the simple chain starting at source and traversing
 // through the input(0) edge from each node as long as the next node satisfies
 // the predicate given in pred_fn. If no nodes satisfy the predicate, &source
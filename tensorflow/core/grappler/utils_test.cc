@@ -335,6 +335,15 @@ TEST_F(UtilsTest, NumNonControlOutputs) {
   EXPECT_EQ(1, NumNonControlDataOutputs(*add_node, node_map));
 }
 
+TEST_F(UtilsTest, IsOnCpuOrUnplaced) {
+  NodeDef node;
+  EXPECT_TRUE(IsOnCpuOrUnplaced(node));
+  node.set_device("/job:localhost/replica:0/task:0/device:CPU:0");
+  EXPECT_TRUE(IsOnCpuOrUnplaced(node));
+  node.set_device("/device:GPU:0");
+  EXPECT_FALSE(IsOnCpuOrUnplaced(node));
+}
+
 TEST_F(UtilsTest, DeleteNodes) {
   // TODO(rmlarsen): write forgtten test.
 }
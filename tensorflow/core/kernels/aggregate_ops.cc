@@ -17,6 +17,7 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <numeric>
 
 #include "tensorflow/core/kernels/aggregate_ops.h"
@@ -27,8 +28,11 @@ limitations under the License.
 #include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/framework/variant_encode_decode.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
+#include "tensorflow/core/kernels/posit_quire.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -38,6 +42,45 @@ typedef Eigen::GpuDevice GPUDevice;
 typedef Eigen::SyclDevice SYCLDevice;
 #endif  // TENSORFLOW_USE_SYCL
 
+// CPU path of AddN for posit types. Each block of output elements gets one
+// PositQuire per element; the inputs are streamed through the block one after
+// the other and every sum is rounded once at the end. The result is exact up
+// to that rounding and independent of the input order. All inputs of a block
+// are read before its outputs are written, so the output may alias an input.
+template <typename T, bool = is_posit<T>::value>
+struct PositAddN {
+  static void Compute(OpKernelContext* ctx, Tensor* output) {}
+};
+
+template <typename T>
+struct PositAddN<T, true> {
+  static void Compute(OpKernelContext* ctx, Tensor* output) {
+    const int num = ctx->num_inputs();
+    gtl::InlinedVector<const T*, 8> inputs(num);
+    for (int i = 0; i < num; ++i) {
+      inputs[i] = ctx->input(i).flat<T>().data();
+    }
+    T* out = output->flat<T>().data();
+    auto sum_block = [&inputs, num, out](int64 start, int64 limit) {
+      PositQuire<T> quires[kPositDecodeBlockSize];
+      for (int64 block = start; block < limit;
+           block += kPositDecodeBlockSize) {
+        const int64 n = std::min(kPositDecodeBlockSize, limit - block);
+        for (int64 j = 0; j < n; ++j) quires[j].Clear();
+        for (int i = 0; i < num; ++i) {
+          const T* in = inputs[i] + block;
+          for (int64 j = 0; j < n; ++j) quires[j].Add(in[j]);
+        }
+        for (int64 j = 0; j < n; ++j) out[block + j] = quires[j].ToPosit();
+      }
+    };
+    const auto& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          output->NumElements(), /*cost_per_unit=*/20 * num, sum_block);
+  }
+};
+
 template <typename Device, typename T>
 class AddNOp : public OpKernel {
  public:
@@ -74,6 +117,10 @@ class AddNOp : public OpKernel {
       input_indices[0] = reused_input;
       input_indices[reused_input] = 0;
     }
+    if (is_posit<T>::value) {
+      PositAddN<T>::Compute(ctx, output);
+      return;
+    }
     auto To = output->flat<T>();
 
 #define I(IDX) ctx->input(input_indices[IDX]).flat<T>()
@@ -112,6 +112,13 @@ REGISTER_KERNEL_BUILDER(
     Name("AvgPool").Device(DEVICE_CPU).TypeConstraint<Eigen::half>("T"),
     AvgPoolingOp<CPUDevice, Eigen::half>);
 
+#define REGISTER_POSIT_AVG_POOL(T)                               \
+  REGISTER_KERNEL_BUILDER(                                       \
+      Name("AvgPool").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      AvgPoolingOp<CPUDevice, T>);
+TF_CALL_POSIT_TYPES(REGISTER_POSIT_AVG_POOL);
+#undef REGISTER_POSIT_AVG_POOL
+
 #if GOOGLE_CUDA
 template <typename T>
 class AvgPoolingOp<GPUDevice, T> : public UnaryOp<T> {
@@ -18,13 +18,20 @@ limitations under the License.
 #define EIGEN_USE_THREADS
 
 #include "tensorflow/core/kernels/bias_op.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/numeric_op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/bounds_check.h"
+#include "tensorflow/core/kernels/posit_quire.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/util/tensor_format.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA
 #include "tensorflow/core/kernels/bias_op_gpu.h"
@@ -80,6 +87,130 @@ struct AccumulatorType<Eigen::half> {
   typedef float type;
 };
 
+// CPU paths for posit types. For posit8 and posit16, BiasAdd decodes the
+// bias once and adds it to blocks of decoded input in float, rounding each
+// sum once; the float sum is exact unless the two operands are more than
+// 2^11 apart in magnitude. float cannot hold posit32 operands, so posit32
+// uses its own correctly rounded addition instead. BiasAddGrad sums every
+// channel exactly in a PositQuire, sharded over blocks of channels, so the
+// gradient does not depend on the batch order or the number of threads.
+template <typename T, bool = is_posit<T>::value>
+struct PositBias {
+  static void Add(OpKernelContext* ctx, const Tensor& input,
+                  const Tensor& bias, TensorFormat data_format,
+                  Tensor* output) {}
+  static void Grad(OpKernelContext* ctx, const Tensor& output_backprop,
+                   TensorFormat data_format, Tensor* output) {}
+};
+
+template <typename T>
+struct PositBias<T, true> {
+  static void Add(OpKernelContext* ctx, const Tensor& input,
+                  const Tensor& bias, TensorFormat data_format,
+                  Tensor* output) {
+    int32 batch, height, width, channel;
+    GetBiasValueDims(input, data_format, &batch, &height, &width, &channel);
+    const auto& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+
+    // An NHWC row holds one element of every channel; an NCHW row is the
+    // plane of a single channel.
+    const bool nchw = data_format == FORMAT_NCHW;
+    const int64 row_size = nchw ? int64{height} * width : channel;
+    const T* in = input.flat<T>().data();
+    T* out = output->flat<T>().data();
+    if (!is_float_exact_posit<T>::value) {
+      const T* bias_data = bias.flat<T>().data();
+      auto add_rows_exact = [in, out, nchw, row_size, channel, bias_data](
+                                int64 start, int64 limit) {
+        for (int64 row = start; row < limit; ++row) {
+          const int64 offset = row * row_size;
+          if (nchw) {
+            const T plane_bias = bias_data[row % channel];
+            for (int64 j = 0; j < row_size; ++j) {
+              out[offset + j] = in[offset + j] + plane_bias;
+            }
+          } else {
+            for (int64 j = 0; j < row_size; ++j) {
+              out[offset + j] = in[offset + j] + bias_data[j];
+            }
+          }
+        }
+      };
+      Shard(worker_threads.num_threads, worker_threads.workers,
+            input.NumElements() / row_size, /*cost_per_unit=*/40 * row_size,
+            add_rows_exact);
+      return;
+    }
+
+    std::vector<float> bias_float(channel);
+    PositToFloat(bias.flat<T>().data(), bias_float.data(), channel);
+    auto add_rows = [in, out, nchw, row_size, channel, &bias_float](
+                        int64 start, int64 limit) {
+      float buf[kPositDecodeBlockSize];
+      for (int64 row = start; row < limit; ++row) {
+        const float plane_bias = nchw ? bias_float[row % channel] : 0.0f;
+        for (int64 i = 0; i < row_size; i += kPositDecodeBlockSize) {
+          const int64 n = std::min(kPositDecodeBlockSize, row_size - i);
+          const int64 offset = row * row_size + i;
+          PositToFloat(in + offset, buf, n);
+          if (nchw) {
+            for (int64 j = 0; j < n; ++j) buf[j] += plane_bias;
+          } else {
+            const float* b = bias_float.data() + i;
+            for (int64 j = 0; j < n; ++j) buf[j] += b[j];
+          }
+          FloatToPosit(buf, out + offset, n);
+        }
+      }
+    };
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          input.NumElements() / row_size, /*cost_per_unit=*/12 * row_size,
+          add_rows);
+  }
+
+  static void Grad(OpKernelContext* ctx, const Tensor& output_backprop,
+                   TensorFormat data_format, Tensor* output) {
+    int32 batch, height, width, channel;
+    GetBiasValueDims(output_backprop, data_format, &batch, &height, &width,
+                     &channel);
+    const bool nchw = data_format == FORMAT_NCHW;
+    const int64 plane_size = nchw ? int64{height} * width : 1;
+    const int64 per_channel = output_backprop.NumElements() / channel;
+    const T* in = output_backprop.flat<T>().data();
+    T* out = output->flat<T>().data();
+    auto sum_channels = [in, out, nchw, batch, channel, plane_size](
+                            int64 start, int64 limit) {
+      std::vector<PositQuire<T>> quires(limit - start);
+      if (nchw) {
+        for (int64 c = start; c < limit; ++c) {
+          PositQuire<T>& quire = quires[c - start];
+          for (int64 b = 0; b < batch; ++b) {
+            const T* plane = in + (b * channel + c) * plane_size;
+            for (int64 i = 0; i < plane_size; ++i) quire.Add(plane[i]);
+          }
+        }
+      } else {
+        // Walk the rows in order so each shard reads its channel block of
+        // every row contiguously.
+        for (int64 row = 0; row < batch; ++row) {
+          const T* values = in + row * channel;
+          for (int64 c = start; c < limit; ++c) {
+            quires[c - start].Add(values[c]);
+          }
+        }
+      }
+      for (int64 c = start; c < limit; ++c) {
+        out[c] = quires[c - start].ToPosit();
+      }
+    };
+    const auto& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, channel,
+          /*cost_per_unit=*/20 * per_channel, sum_channels);
+  }
+};
+
 }  // namespace
 
 template <typename Device, typename T>
@@ -130,6 +261,11 @@ class BiasOp : public BinaryOp<T> {
                                 {0}, 0, input.shape(), &output));
     if (input.NumElements() == 0) return;
 
+    if (is_posit<T>::value) {
+      PositBias<T>::Add(context, input, bias, data_format_, output);
+      return;
+    }
+
     // Added by intel_tf to support NCHW on CPU regardless of MKL used or not.
     if (data_format_ == FORMAT_NCHW) {
       int32 batch, height, width, channel;
@@ -243,10 +379,15 @@ class BiasGradOp : public OpKernel {
       output->template flat<T>().setZero();
     } else {
       // Added by intel_tf to support NCHW on CPU regardless of MKL used or not.
+      OP_REQUIRES(context,
+                  data_format_ != FORMAT_NCHW || output_backprop.dims() == 4,
+                  errors::InvalidArgument(
+                      "NCHW format supports only 4D input/output tensor."));
+      if (is_posit<T>::value) {
+        PositBias<T>::Grad(context, output_backprop, data_format_, output);
+        return;
+      }
       if (data_format_ == FORMAT_NCHW) {
-        OP_REQUIRES(context, output_backprop.dims() == 4,
-                    errors::InvalidArgument(
-                        "NCHW format supports only 4D input/output tensor."));
         Eigen::DSizes<int, 4> four_dims(batch, channel, height, width);
 #ifdef EIGEN_HAS_INDEX_LIST
         using idx0 = Eigen::type2index<0>;
@@ -0,0 +1,81 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/math_ops.cc.
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/posit_utils.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/util/guarded_philox_random.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+// Casts float or double to a posit type with stochastic rounding. Double
+// inputs are rounded from their own bits, so posit32 outputs keep the bits a
+// float would drop.
+template <typename SrcT, typename DstT>
+class StochasticCastOp : public OpKernel {
+ public:
+  explicit StochasticCastOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, generator_.Init(ctx));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& input = ctx->input(0);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, input.shape(), &output));
+    const int64 size = input.NumElements();
+    if (size == 0) return;
+
+    const SrcT* src = input.flat<SrcT>().data();
+    DstT* dst = output->flat<DstT>().data();
+    random::PhiloxRandom gen = generator_.ReserveSamples32(size);
+    auto work = [src, dst, gen](int64 start, int64 limit) {
+      StochasticEncodePosits(gen, start, src + start, dst + start,
+                             limit - start);
+    };
+    const auto& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, size,
+          /*cost_per_unit=*/20, work);
+  }
+
+ private:
+  GuardedPhiloxRandom generator_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StochasticCastOp);
+};
+
+#define REGISTER_CPU(SrcT, DstT)                                 \
+  REGISTER_KERNEL_BUILDER(Name("StochasticCast")                 \
+                              .Device(DEVICE_CPU)                \
+                              .TypeConstraint<SrcT>("SrcT")      \
+                              .TypeConstraint<DstT>("DstT"),     \
+                          StochasticCastOp<SrcT, DstT>);
+#define REGISTER_CPU_FROM_FLOATS(DstT) \
+  REGISTER_CPU(float, DstT);           \
+  REGISTER_CPU(double, DstT);
+
+TF_CALL_POSIT_TYPES(REGISTER_CPU_FROM_FLOATS);
+
+#undef REGISTER_CPU_FROM_FLOATS
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <vector>
+
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/node_def_builder.h"
@@ -116,6 +118,76 @@ TEST_ALL_CASTS_FROM(quint16)
 #undef TEST_ALL_CASTS_FROM
 #undef TEST_CAST
 
+class StochasticCastOpTest : public OpsTestBase {
+ protected:
+  // Casts "size" copies of "value" to posit16 with fixed seeds.
+  std::vector<float> Run(float value, int size) {
+    TF_EXPECT_OK(NodeDefBuilder("stochastic_cast", "StochasticCast")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Attr("DstT", DT_POSIT16)
+                     .Attr("seed", 17)
+                     .Attr("seed2", 42)
+                     .Finalize(node_def()));
+    TF_EXPECT_OK(InitOp());
+    inputs_.clear();
+    AddInputFromArray<float>(TensorShape({size}),
+                             std::vector<float>(size, value));
+    TF_EXPECT_OK(RunOpKernel());
+    std::vector<float> result;
+    auto output = GetOutput(0)->flat<posit16>();
+    for (int i = 0; i < size; ++i) {
+      result.push_back(static_cast<float>(output(i)));
+    }
+    return result;
+  }
+};
+
+TEST_F(StochasticCastOpTest, RoundsToNeighboursWithoutBias) {
+  // A quarter of the way from 1 to the next posit16, 1 + 2^-12.
+  const float kNext = 1.0f + 1.0f / 4096;
+  const float value = 1.0f + 0.25f / 4096;
+  const int kSize = 1 << 16;
+  std::vector<float> result = Run(value, kSize);
+  double sum = 0;
+  for (float r : result) {
+    ASSERT_TRUE(r == 1.0f || r == kNext) << r;
+    sum += r;
+  }
+  EXPECT_NEAR(value, sum / kSize, 0.01 / 4096);
+}
+
+TEST_F(StochasticCastOpTest, IsDeterministicGivenSeeds) {
+  const float value = 1.0f + 0.5f / 4096;
+  EXPECT_EQ(Run(value, 1000), Run(value, 1000));
+}
+
+TEST_F(StochasticCastOpTest, KeepsPosit32BitsFromDouble) {
+  // Posit32 values with more fraction bits than a float holds must come back
+  // unchanged from a double input.
+  std::vector<double> values;
+  std::vector<uint32> bits;
+  for (uint32 b : {0x40000001u, 0x3fffffffu, 0xbffffff3u, 0x20000005u}) {
+    posit32 p;
+    p.value = b;
+    values.push_back(static_cast<double>(p));
+    bits.push_back(b);
+  }
+  TF_EXPECT_OK(NodeDefBuilder("stochastic_cast", "StochasticCast")
+                   .Input(FakeInput(DT_DOUBLE))
+                   .Attr("DstT", DT_POSIT32)
+                   .Attr("seed", 17)
+                   .Attr("seed2", 42)
+                   .Finalize(node_def()));
+  TF_EXPECT_OK(InitOp());
+  AddInputFromArray<double>(TensorShape({static_cast<int64>(values.size())}),
+                            values);
+  TF_ASSERT_OK(RunOpKernel());
+  auto output = GetOutput(0)->flat<posit32>();
+  for (int i = 0; i < bits.size(); ++i) {
+    EXPECT_EQ(bits[i], output(i).value) << values[i];
+  }
+}
+
 // TODO(wicke): check conversions from/to bool, and bfloat16
 
 static void BM_cpu_float_int64(int iters, int num) {
@@ -532,6 +532,9 @@ TF_CALL_posit32(REGISTER_CPU_KERNELS);
 template struct LaunchConv2DBackpropFilterOp<CPUDevice, Eigen::half>;
 template struct LaunchConv2DBackpropFilterOp<CPUDevice, float>;
 template struct LaunchConv2DBackpropFilterOp<CPUDevice, double>;
+template struct LaunchConv2DBackpropFilterOp<CPUDevice, posit8>;
+template struct LaunchConv2DBackpropFilterOp<CPUDevice, posit16>;
+template struct LaunchConv2DBackpropFilterOp<CPUDevice, posit32>;
 
 // GPU definitions.
 #if GOOGLE_CUDA
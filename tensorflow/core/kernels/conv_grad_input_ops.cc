@@ -603,6 +603,9 @@ TF_CALL_posit32(REGISTER_CPU_KERNELS);
 template struct LaunchConv2DBackpropInputOp<CPUDevice, Eigen::half>;
 template struct LaunchConv2DBackpropInputOp<CPUDevice, float>;
 template struct LaunchConv2DBackpropInputOp<CPUDevice, double>;
+template struct LaunchConv2DBackpropInputOp<CPUDevice, posit8>;
+template struct LaunchConv2DBackpropInputOp<CPUDevice, posit16>;
+template struct LaunchConv2DBackpropInputOp<CPUDevice, posit32>;
 
 // GPU definitions.
 #if GOOGLE_CUDA
@@ -28,6 +28,7 @@ limitations under the License.
 #include <map>
 #include <vector>
 
+#include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/numeric_op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -38,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/conv_2d.h"
 #include "tensorflow/core/kernels/deep_conv2d.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/strings/numbers.h"
@@ -140,6 +142,41 @@ struct LaunchConv2DOp<CPUDevice, T> {
   }
 };
 
+template <typename T>
+void LaunchPositConv2DOp<T>::operator()(
+    OpKernelContext* ctx, bool use_cudnn, bool cudnn_use_autotune,
+    const Tensor& input, const Tensor& filter, int row_dilation,
+    int col_dilation, int row_stride, int col_stride, const Padding& padding,
+    Tensor* output, TensorFormat data_format) {
+  Tensor input_float, filter_float, output_float;
+  OP_REQUIRES_OK(ctx,
+                 ctx->allocate_temp(DT_FLOAT, input.shape(), &input_float));
+  const auto& attr = ctx->op_kernel().def().attr();
+  const auto filter_is_weights = attr.find("_grappler_filter_is_weights");
+  if (filter_is_weights != attr.end() && filter_is_weights->second.b()) {
+    OP_REQUIRES_OK(ctx,
+                   filter_cache_.GetDecoded<T>(ctx, filter, &filter_float));
+  } else {
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_temp(DT_FLOAT, filter.shape(), &filter_float));
+    ParallelDecodePosits(ctx, filter.flat<T>().data(),
+                         filter_float.flat<float>().data(),
+                         filter.NumElements());
+  }
+  OP_REQUIRES_OK(ctx,
+                 ctx->allocate_temp(DT_FLOAT, output->shape(), &output_float));
+  ParallelDecodePosits(ctx, input.flat<T>().data(),
+                       input_float.flat<float>().data(), input.NumElements());
+
+  LaunchConv2DOp<CPUDevice, float>()(
+      ctx, use_cudnn, cudnn_use_autotune, input_float, filter_float,
+      row_dilation, col_dilation, row_stride, col_stride, padding,
+      &output_float, data_format);
+  if (!ctx->status().ok()) return;
+  ParallelEncodePosits(ctx, output_float.flat<float>().data(),
+                       output->flat<T>().data(), output->NumElements());
+}
+
 template <typename Device, typename T>
 class LaunchDeepConvOp {
  public:
@@ -469,9 +506,9 @@ TF_CALL_posit32(REGISTER_CPU);
 template struct LaunchConv2DOp<CPUDevice, Eigen::half>;
 template struct LaunchConv2DOp<CPUDevice, float>;
 template struct LaunchConv2DOp<CPUDevice, double>;
-template struct LaunchConv2DOp<CPUDevice, posit8>;
-template struct LaunchConv2DOp<CPUDevice, posit16>;
 template struct LaunchConv2DOp<CPUDevice, posit32>;
+template struct LaunchPositConv2DOp<posit8>;
+template struct LaunchPositConv2DOp<posit16>;
 
 #if GOOGLE_CUDA
 int64 GetCudnnWorkspaceLimit(const string& envvar_in_mb,
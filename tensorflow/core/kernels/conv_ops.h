@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/kernels/posit_weight_cache.h"
 #include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/util/tensor_format.h"
 
@@ -40,6 +41,29 @@ struct LaunchConv2DOp {
                   TensorFormat data_format);
 };
 
+// Posit8 and posit16 convolutions on CPU decode their operands, run the float
+// launcher and round each output once. The decoded filter is kept across calls
+// when grappler marked it as weights (_grappler_filter_is_weights).
+// posit32 does not fit in a float and uses the generic launcher.
+template <typename T>
+struct LaunchPositConv2DOp {
+  void operator()(OpKernelContext* ctx, bool use_cudnn, bool cudnn_use_autotune,
+                  const Tensor& input, const Tensor& filter, int row_dilation,
+                  int col_dilation, int row_stride, int col_stride,
+                  const Padding& padding, Tensor* output,
+                  TensorFormat data_format);
+
+ private:
+  PositWeightCache filter_cache_;
+};
+
+template <>
+struct LaunchConv2DOp<Eigen::ThreadPoolDevice, posit8>
+    : LaunchPositConv2DOp<posit8> {};
+template <>
+struct LaunchConv2DOp<Eigen::ThreadPoolDevice, posit16>
+    : LaunchPositConv2DOp<posit16> {};
+
 #ifdef GOOGLE_CUDA
 template <typename T>
 struct LaunchConv2DOp<Eigen::GpuDevice, T> {
@@ -522,4 +522,66 @@ TEST_F(ConvOpTest, HandwrittenConv) { HandwrittenConv(); }
 
 TEST_F(ConvOpTest, AnisotropicStride) { AnisotropicStrides(); }
 
+// Posit Conv2D keeps the decoded filter between runs when grappler marked it
+// as weights, keyed on the filter's buffer. Because the cache holds a
+// reference to that buffer, a resource variable assignment copies on write,
+// and the kernel must then see a new buffer and decode it again.
+TEST_F(ConvOpTest, PositFilterReplaced) {
+  TF_EXPECT_OK(NodeDefBuilder("conv_op", "Conv2D")
+                   .Input(FakeInput(DT_POSIT16))
+                   .Input(FakeInput(DT_POSIT16))
+                   .Attr("T", DT_POSIT16)
+                   .Attr("strides", {1, 1, 1, 1})
+                   .Attr("padding", "VALID")
+                   .Attr("_grappler_filter_is_weights", true)
+                   .Finalize(node_def()));
+  TF_EXPECT_OK(InitOp());
+  AddInputFromArray<posit16>(
+      TensorShape({1, 2, 2, 1}),
+      {posit16(1.0f), posit16(2.0f), posit16(3.0f), posit16(4.0f)});
+  AddInputFromArray<posit16>(TensorShape({1, 1, 1, 1}), {posit16(2.0f)});
+
+  auto expect_output = [this](const std::vector<float>& expected) {
+    const Tensor& output = *GetOutput(0);
+    ASSERT_EQ(expected.size(), output.NumElements());
+    for (int i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(expected[i], static_cast<float>(output.flat<posit16>()(i)));
+    }
+  };
+  TF_ASSERT_OK(RunOpKernel());
+  expect_output({2, 4, 6, 8});
+  TF_ASSERT_OK(RunOpKernel());
+  expect_output({2, 4, 6, 8});
+
+  Tensor new_filter(DT_POSIT16, TensorShape({1, 1, 1, 1}));
+  new_filter.flat<posit16>()(0) = posit16(-0.5f);
+  *mutable_input(1).tensor = new_filter;
+  TF_ASSERT_OK(RunOpKernel());
+  expect_output({-0.5, -1, -1.5, -2});
+}
+
+// A filter that is not marked as weights may be an activation whose buffer is
+// reused from step to step, so it is decoded on every run.
+TEST_F(ConvOpTest, PositFilterWithoutWeightsIsNotCached) {
+  TF_EXPECT_OK(NodeDefBuilder("conv_op", "Conv2D")
+                   .Input(FakeInput(DT_POSIT16))
+                   .Input(FakeInput(DT_POSIT16))
+                   .Attr("T", DT_POSIT16)
+                   .Attr("strides", {1, 1, 1, 1})
+                   .Attr("padding", "VALID")
+                   .Finalize(node_def()));
+  TF_EXPECT_OK(InitOp());
+  AddInputFromArray<posit16>(
+      TensorShape({1, 2, 2, 1}),
+      {posit16(1.0f), posit16(2.0f), posit16(3.0f), posit16(4.0f)});
+  AddInputFromArray<posit16>(TensorShape({1, 1, 1, 1}), {posit16(2.0f)});
+
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_EQ(2.0f, static_cast<float>(GetOutput(0)->flat<posit16>()(0)));
+
+  mutable_input(1).tensor->flat<posit16>()(0) = posit16(-0.5f);
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_EQ(-0.5f, static_cast<float>(GetOutput(0)->flat<posit16>()(0)));
+}
+
 }  // namespace tensorflow
@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/conv_grad_ops.h"
 #include "tensorflow/core/kernels/depthwise_conv_op.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
@@ -456,6 +457,61 @@ struct LaunchDepthwiseConvBackpropInputOp<CPUDevice, T> {
   }
 };
 
+// Posit types have no packet type: decode 'out_backprop' and the filter to
+// float (double for posit32), run the kernel above, and round 'in_backprop'
+// once.
+template <typename T>
+struct LaunchDepthwisePositConvBackpropInputOp {
+  typedef typename PositComputeType<T>::type C;
+
+  void operator()(OpKernelContext* ctx, const DepthwiseArgs& args,
+                  const T* out_backprop, const T* depthwise_filter,
+                  T* in_backprop, TensorFormat data_format) {
+    const int64 out_backprop_size = static_cast<int64>(args.batch) *
+                                    args.out_rows * args.out_cols *
+                                    args.out_depth;
+    const int64 filter_size =
+        static_cast<int64>(args.filter_rows) * args.filter_cols * args.out_depth;
+    const int64 in_backprop_size = static_cast<int64>(args.batch) *
+                                   args.in_rows * args.in_cols * args.in_depth;
+
+    const DataType dtype = DataTypeToEnum<C>::value;
+    Tensor out_backprop_decoded, filter_decoded, in_backprop_decoded;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype,
+                                           TensorShape({out_backprop_size}),
+                                           &out_backprop_decoded));
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype, TensorShape({filter_size}),
+                                           &filter_decoded));
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype,
+                                           TensorShape({in_backprop_size}),
+                                           &in_backprop_decoded));
+    ParallelDecodePosits(ctx, out_backprop,
+                         out_backprop_decoded.flat<C>().data(),
+                         out_backprop_size);
+    DecodePosits(depthwise_filter, filter_decoded.flat<C>().data(),
+                 filter_size);
+
+    LaunchDepthwiseConvBackpropInputOp<CPUDevice, C>()(
+        ctx, args, out_backprop_decoded.flat<C>().data(),
+        filter_decoded.flat<C>().data(), in_backprop_decoded.flat<C>().data(),
+        data_format);
+    if (!ctx->status().ok()) return;
+
+    ParallelEncodePosits(ctx, in_backprop_decoded.flat<C>().data(),
+                         in_backprop, in_backprop_size);
+  }
+};
+
+template <>
+struct LaunchDepthwiseConvBackpropInputOp<CPUDevice, posit8>
+    : LaunchDepthwisePositConvBackpropInputOp<posit8> {};
+template <>
+struct LaunchDepthwiseConvBackpropInputOp<CPUDevice, posit16>
+    : LaunchDepthwisePositConvBackpropInputOp<posit16> {};
+template <>
+struct LaunchDepthwiseConvBackpropInputOp<CPUDevice, posit32>
+    : LaunchDepthwisePositConvBackpropInputOp<posit32> {};
+
 template <typename T>
 static void DepthwiseConvBackpropInputReference(const DepthwiseArgs& args,
                                                 const T* out_backprop,
@@ -516,6 +572,9 @@ static void DepthwiseConvBackpropInputReference(const DepthwiseArgs& args,
 extern template struct LaunchConv2DBackpropInputOp<CPUDevice, Eigen::half>;
 extern template struct LaunchConv2DBackpropInputOp<CPUDevice, float>;
 extern template struct LaunchConv2DBackpropInputOp<CPUDevice, double>;
+extern template struct LaunchConv2DBackpropInputOp<CPUDevice, posit8>;
+extern template struct LaunchConv2DBackpropInputOp<CPUDevice, posit16>;
+extern template struct LaunchConv2DBackpropInputOp<CPUDevice, posit32>;
 
 #if GOOGLE_CUDA
 
@@ -674,6 +733,7 @@ TF_CALL_float(REGISTER_CPU_KERNEL);
 #if !defined(PLATFORM_WINDOWS) || !defined(_DEBUG)
 TF_CALL_double(REGISTER_CPU_KERNEL);
 #endif
+TF_CALL_POSIT_TYPES(REGISTER_CPU_KERNEL);
 #undef REGISTER_CPU_KERNEL
 
 #if GOOGLE_CUDA
@@ -937,6 +997,60 @@ struct LaunchDepthwiseConvBackpropFilterOp<CPUDevice, T> {
   }
 };
 
+// As for the input gradient, the per-batch partial sums are reduced in float
+// (double for posit32) and 'filter_backprop' is rounded to the posit type once
+// at the end.
+template <typename T>
+struct LaunchDepthwisePositConvBackpropFilterOp {
+  typedef typename PositComputeType<T>::type C;
+
+  void operator()(OpKernelContext* ctx, const DepthwiseArgs& args,
+                  const T* out_backprop, const T* input, T* filter_backprop,
+                  TensorFormat data_format) {
+    const int64 out_backprop_size = static_cast<int64>(args.batch) *
+                                    args.out_rows * args.out_cols *
+                                    args.out_depth;
+    const int64 input_size = static_cast<int64>(args.batch) * args.in_rows *
+                             args.in_cols * args.in_depth;
+    const int64 filter_size =
+        static_cast<int64>(args.filter_rows) * args.filter_cols * args.out_depth;
+
+    const DataType dtype = DataTypeToEnum<C>::value;
+    Tensor out_backprop_decoded, input_decoded, filter_backprop_decoded;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype,
+                                           TensorShape({out_backprop_size}),
+                                           &out_backprop_decoded));
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype, TensorShape({input_size}),
+                                           &input_decoded));
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype, TensorShape({filter_size}),
+                                           &filter_backprop_decoded));
+    ParallelDecodePosits(ctx, out_backprop,
+                         out_backprop_decoded.flat<C>().data(),
+                         out_backprop_size);
+    ParallelDecodePosits(ctx, input, input_decoded.flat<C>().data(),
+                         input_size);
+
+    LaunchDepthwiseConvBackpropFilterOp<CPUDevice, C>()(
+        ctx, args, out_backprop_decoded.flat<C>().data(),
+        input_decoded.flat<C>().data(),
+        filter_backprop_decoded.flat<C>().data(), data_format);
+    if (!ctx->status().ok()) return;
+
+    EncodePosits(filter_backprop_decoded.flat<C>().data(), filter_backprop,
+                 filter_size);
+  }
+};
+
+template <>
+struct LaunchDepthwiseConvBackpropFilterOp<CPUDevice, posit8>
+    : LaunchDepthwisePositConvBackpropFilterOp<posit8> {};
+template <>
+struct LaunchDepthwiseConvBackpropFilterOp<CPUDevice, posit16>
+    : LaunchDepthwisePositConvBackpropFilterOp<posit16> {};
+template <>
+struct LaunchDepthwiseConvBackpropFilterOp<CPUDevice, posit32>
+    : LaunchDepthwisePositConvBackpropFilterOp<posit32> {};
+
 template <typename T>
 static void DepthwiseConvBackpropFilterReference(const DepthwiseArgs& args,
                                                  const T* out_backprop,
@@ -989,6 +1103,9 @@ static void DepthwiseConvBackpropFilterReference(const DepthwiseArgs& args,
 extern template struct LaunchConv2DBackpropFilterOp<CPUDevice, Eigen::half>;
 extern template struct LaunchConv2DBackpropFilterOp<CPUDevice, float>;
 extern template struct LaunchConv2DBackpropFilterOp<CPUDevice, double>;
+extern template struct LaunchConv2DBackpropFilterOp<CPUDevice, posit8>;
+extern template struct LaunchConv2DBackpropFilterOp<CPUDevice, posit16>;
+extern template struct LaunchConv2DBackpropFilterOp<CPUDevice, posit32>;
 
 #if GOOGLE_CUDA
 
@@ -1040,16 +1157,7 @@ class DepthwiseConv2dNativeBackpropFilterOp : public OpKernel {
     use_cudnn_ = CanUseCudnn() && std::is_same<Device, GPUDevice>::value;
     cudnn_use_autotune_ = CudnnUseAutotune();
     use_cudnn_grouped_conv_ = false;
-
-    if (std::is_same<T, Eigen::half>::value) {
-      dtype_ = DT_HALF;
-    } else if (std::is_same<T, float>::value) {
-      dtype_ = DT_FLOAT;
-    } else if (std::is_same<T, double>::value) {
-      dtype_ = DT_DOUBLE;
-    } else {
-      LOG(ERROR) << "Only half, float, and double are supported.";
-    }
+    dtype_ = DataTypeToEnum<T>::value;
   }
 
   void Compute(OpKernelContext* context) override {
@@ -1156,6 +1264,7 @@ TF_CALL_float(REGISTER_CPU_KERNEL);
 #if !defined(PLATFORM_WINDOWS) || !defined(_DEBUG)
 TF_CALL_double(REGISTER_CPU_KERNEL);
 #endif
+TF_CALL_POSIT_TYPES(REGISTER_CPU_KERNEL);
 #undef REGISTER_CPU_KERNEL
 
 #if GOOGLE_CUDA
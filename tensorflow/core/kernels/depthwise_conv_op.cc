@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/conv_ops.h"
 #include "tensorflow/core/kernels/depthwise_conv_op.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
@@ -241,10 +242,64 @@ struct LaunchDepthwiseConvOp<CPUDevice, T> {
   }
 };
 
+// Posit inputs have no packet type, so they are decoded to float (double for
+// posit32, which float can't hold exactly), run through the vectorized kernel
+// above, and rounded once on the way out.
+template <typename T>
+struct LaunchDepthwisePositConvOp {
+  typedef typename PositComputeType<T>::type C;
+
+  void operator()(OpKernelContext* ctx, const DepthwiseArgs& args,
+                  const T* input, const T* depthwise_filter, T* output,
+                  TensorFormat data_format) {
+    const int64 input_size = static_cast<int64>(args.batch) * args.in_rows *
+                             args.in_cols * args.in_depth;
+    const int64 filter_size =
+        static_cast<int64>(args.filter_rows) * args.filter_cols * args.out_depth;
+    const int64 output_size = static_cast<int64>(args.batch) * args.out_rows *
+                              args.out_cols * args.out_depth;
+
+    const DataType dtype = DataTypeToEnum<C>::value;
+    Tensor input_decoded, filter_decoded, output_decoded;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype, TensorShape({input_size}),
+                                           &input_decoded));
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype, TensorShape({filter_size}),
+                                           &filter_decoded));
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(dtype, TensorShape({output_size}),
+                                           &output_decoded));
+    ParallelDecodePosits(ctx, input, input_decoded.flat<C>().data(),
+                         input_size);
+    DecodePosits(depthwise_filter, filter_decoded.flat<C>().data(),
+                 filter_size);
+
+    LaunchDepthwiseConvOp<CPUDevice, C>()(
+        ctx, args, input_decoded.flat<C>().data(),
+        filter_decoded.flat<C>().data(), output_decoded.flat<C>().data(),
+        data_format);
+    if (!ctx->status().ok()) return;
+
+    ParallelEncodePosits(ctx, output_decoded.flat<C>().data(), output,
+                         output_size);
+  }
+};
+
+template <>
+struct LaunchDepthwiseConvOp<CPUDevice, posit8>
+    : LaunchDepthwisePositConvOp<posit8> {};
+template <>
+struct LaunchDepthwiseConvOp<CPUDevice, posit16>
+    : LaunchDepthwisePositConvOp<posit16> {};
+template <>
+struct LaunchDepthwiseConvOp<CPUDevice, posit32>
+    : LaunchDepthwisePositConvOp<posit32> {};
+
 // Extern template instantiated in conv_ops.cc.
 extern template struct LaunchConv2DOp<CPUDevice, Eigen::half>;
 extern template struct LaunchConv2DOp<CPUDevice, float>;
 extern template struct LaunchConv2DOp<CPUDevice, double>;
+extern template struct LaunchConv2DOp<CPUDevice, posit32>;
+extern template struct LaunchPositConv2DOp<posit8>;
+extern template struct LaunchPositConv2DOp<posit16>;
 
 #if GOOGLE_CUDA
 
@@ -459,6 +514,7 @@ TF_CALL_float(REGISTER_CPU_KERNEL);
 #if !defined(PLATFORM_WINDOWS) || !defined(_DEBUG)
 TF_CALL_double(REGISTER_CPU_KERNEL);
 #endif
+TF_CALL_POSIT_TYPES(REGISTER_CPU_KERNEL);
 
 #if GOOGLE_CUDA
 
@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cmath>
+
 #include "tensorflow/cc/ops/const_op.h"
 #include "tensorflow/cc/ops/image_ops.h"
 #include "tensorflow/cc/ops/nn_ops.h"
@@ -100,6 +102,124 @@ TEST_F(DepthwiseConvOpTest, DepthwiseConvHalfCpu) {
   Run<Eigen::half>(Device::CPU);
 }
 
+// Every value in the example above is exactly representable as a posit16, so
+// the decode-compute-encode path must reproduce the float result bit for bit.
+TEST_F(DepthwiseConvOpTest, DepthwiseConvPosit16Cpu) {
+  TF_EXPECT_OK(NodeDefBuilder("depthwise_conv2d", "DepthwiseConv2dNative")
+                   .Input(FakeInput(DT_POSIT16))
+                   .Input(FakeInput(DT_POSIT16))
+                   .Attr("T", DT_POSIT16)
+                   .Attr("strides", {1, 1, 1, 1})
+                   .Attr("padding", "SAME")
+                   .Finalize(node_def()));
+  TF_EXPECT_OK(InitOp());
+  auto encode = [](const std::vector<float>& values) {
+    std::vector<posit16> encoded;
+    for (float f : values) encoded.push_back(posit16(f));
+    return encoded;
+  };
+  AddInputFromArray<posit16>(
+      TensorShape({1, 3, 2, 2}),
+      encode({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}));
+  AddInputFromArray<posit16>(
+      TensorShape({3, 3, 2, 1}),
+      encode({1, 2, 7, 8, 13, 14, 3, 4, 9, 10, 15, 16, 5, 6, 11, 12, 17, 18}));
+  TF_ASSERT_OK(RunOpKernel());
+
+  const std::vector<float> expected = {228, 300, 132, 180, 482, 596,
+                                       266, 344, 372, 452, 180, 236};
+  auto output = GetOutput(0)->flat<posit16>();
+  ASSERT_EQ(expected.size(), output.size());
+  for (int i = 0; i < output.size(); ++i) {
+    EXPECT_EQ(expected[i], static_cast<float>(output(i))) << "at " << i;
+  }
+}
+
+// The gradient tests below use a 2x2 image with two channels, a 2x2 filter
+// and SAME padding. Every operand and result has the form integer + k * eps;
+// with eps = 2^-22 they are all exact posit32 values but not float values, so
+// they only come out exactly if posit32 is not computed in float.
+class DepthwiseConvGradPositTest : public OpsTestBase {
+ protected:
+  template <typename T>
+  void AddPositInput(const TensorShape& shape,
+                     const std::vector<double>& values) {
+    std::vector<T> encoded;
+    for (double v : values) encoded.push_back(T(v));
+    AddInputFromArray<T>(shape, encoded);
+  }
+
+  template <typename T>
+  void ExpectOutput(const std::vector<double>& expected) {
+    auto output = GetOutput(0)->flat<T>();
+    ASSERT_EQ(expected.size(), output.size());
+    for (int i = 0; i < output.size(); ++i) {
+      EXPECT_EQ(expected[i], static_cast<double>(output(i))) << "at " << i;
+    }
+  }
+
+  template <typename T>
+  void RunBackpropInput(double eps) {
+    const DataType dtype = DataTypeToEnum<T>::value;
+    TF_ASSERT_OK(NodeDefBuilder("depthwise_conv2d_backprop_input",
+                                "DepthwiseConv2dNativeBackpropInput")
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(dtype))
+                     .Input(FakeInput(dtype))
+                     .Attr("T", dtype)
+                     .Attr("strides", {1, 1, 1, 1})
+                     .Attr("padding", "SAME")
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    AddInputFromArray<int32>(TensorShape({4}), {1, 2, 2, 2});
+    AddPositInput<T>(TensorShape({2, 2, 2, 1}), {1, 2, 2, 1, 1, 1, 1, 1});
+    AddPositInput<T>(TensorShape({1, 2, 2, 2}),
+                     {4 + 1 * eps, 5 + 3 * eps, 6 + 5 * eps, 4 + 7 * eps,
+                      5 + 9 * eps, 6 + 11 * eps, 4 + 13 * eps, 5 + 15 * eps});
+    TF_ASSERT_OK(RunOpKernel());
+    ExpectOutput<T>({4 + 1 * eps, 10 + 6 * eps, 14 + 7 * eps, 13 + 17 * eps,
+                     9 + 10 * eps, 17 + 25 * eps, 24 + 37 * eps,
+                     25 + 51 * eps});
+  }
+
+  template <typename T>
+  void RunBackpropFilter(double eps) {
+    const DataType dtype = DataTypeToEnum<T>::value;
+    TF_ASSERT_OK(NodeDefBuilder("depthwise_conv2d_backprop_filter",
+                                "DepthwiseConv2dNativeBackpropFilter")
+                     .Input(FakeInput(dtype))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(dtype))
+                     .Attr("T", dtype)
+                     .Attr("strides", {1, 1, 1, 1})
+                     .Attr("padding", "SAME")
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    AddPositInput<T>(TensorShape({1, 2, 2, 2}),
+                     {4 + 1 * eps, 5 + 3 * eps, 6 + 5 * eps, 4 + 7 * eps,
+                      5 + 9 * eps, 6 + 11 * eps, 4 + 13 * eps, 5 + 15 * eps});
+    AddInputFromArray<int32>(TensorShape({4}), {2, 2, 2, 1});
+    AddPositInput<T>(TensorShape({1, 2, 2, 2}), {1, 2, 1, 1, 2, 1, 1, 1});
+    TF_ASSERT_OK(RunOpKernel());
+    ExpectOutput<T>({24 + 37 * eps, 25 + 39 * eps, 14 + 31 * eps,
+                     13 + 29 * eps, 9 + 22 * eps, 17 + 37 * eps, 4 + 13 * eps,
+                     10 + 30 * eps});
+  }
+};
+
+TEST_F(DepthwiseConvGradPositTest, BackpropInputPosit16) {
+  RunBackpropInput<posit16>(0);
+}
+TEST_F(DepthwiseConvGradPositTest, BackpropInputPosit32IsExact) {
+  RunBackpropInput<posit32>(std::ldexp(1.0, -22));
+}
+TEST_F(DepthwiseConvGradPositTest, BackpropFilterPosit16) {
+  RunBackpropFilter<posit16>(0);
+}
+TEST_F(DepthwiseConvGradPositTest, BackpropFilterPosit32IsExact) {
+  RunBackpropFilter<posit32>(std::ldexp(1.0, -22));
+}
+
 #ifdef GOOGLE_CUDA
 TEST_F(DepthwiseConvOpTest, DepthwiseConvFloatGpu) { Run<float>(Device::GPU); }
 TEST_F(DepthwiseConvOpTest, DepthwiseConvDoubleGpu) {
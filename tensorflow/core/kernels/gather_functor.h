@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/framework/type_traits.h"
 #include "tensorflow/core/kernels/bounds_check.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/work_sharder.h"
@@ -145,6 +146,50 @@ struct GatherFunctorCPU {
   }
 };
 
+// Gathers rows of posit "params" like GatherFunctorCPU, but decodes each row
+// straight into the float or bfloat16 output instead of copying it, so that
+// consumers of the decoded values do not need a separate Cast pass.
+template <typename T, typename OutT, typename Index>
+struct GatherDecodeFunctorCPU {
+  int64 operator()(OpKernelContext* ctx, typename TTypes<T>::ConstMatrix params,
+                   typename TTypes<Index>::ConstFlat indices,
+                   typename TTypes<OutT>::Matrix out) {
+    const int64 N = indices.size();
+    const int64 slice_elems = params.dimension(1);
+    const Index limit = static_cast<Index>(params.dimension(0));
+    const T* params_base = params.data();
+    OutT* out_base = out.data();
+    auto* worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+    mutex mu;
+    // Store the value of invalidate index for printing error information, it's
+    // a shared variable.
+    int64 result = -1;
+    auto work = [&](int64 start, int64 end) {
+      for (int64 i = start; i < end; ++i) {
+        if (i + 1 < end) {
+          const Index next = internal::SubtleMustCopy(indices(i + 1));
+          if (FastBoundsCheck(next, limit)) {
+            port::prefetch<port::PREFETCH_HINT_T0>(
+                params_base + static_cast<int64>(next) * slice_elems);
+          }
+        }
+        const Index index = internal::SubtleMustCopy(indices(i));
+        if (!FastBoundsCheck(index, limit)) {
+          mutex_lock l(mu);
+          result = i;
+          return;
+        }
+        DecodePosits(params_base + static_cast<int64>(index) * slice_elems,
+                     out_base + i * slice_elems, slice_elems);
+      }
+    };
+
+    Shard(worker_threads->num_threads, worker_threads->workers, N,
+          slice_elems * (sizeof(T) + sizeof(OutT)), work);
+    return result;
+  }
+};
+
 template <typename Device, typename T, typename Index>
 struct GatherFunctor {
   int64 operator()(OpKernelContext* ctx,
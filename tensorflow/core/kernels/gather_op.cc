@@ -148,6 +148,76 @@ TF_CALL_uint64(REGISTER_GATHER_CPU);
 
 #undef REGISTER_GATHER_CPU
 
+// Gathers rows of a posit embedding table and decodes them to OutT. This is
+// GatherV2 on axis 0 followed by Cast, without materializing the posit rows.
+template <typename T, typename OutT, typename Index>
+class GatherAndDecodeOp : public OpKernel {
+ public:
+  explicit GatherAndDecodeOp(OpKernelConstruction* c) : OpKernel(c) {}
+
+  void Compute(OpKernelContext* c) override {
+    const Tensor& params = c->input(0);
+    const Tensor& indices = c->input(1);
+    OP_REQUIRES(
+        c, TensorShapeUtils::IsVectorOrHigher(params.shape()),
+        errors::InvalidArgument("params must be at least 1 dimensional"));
+
+    // Check that we have enough index space
+    const int64 gather_dim_size = params.dim_size(0);
+    const int64 N = indices.NumElements();
+    OP_REQUIRES(
+        c, gather_dim_size <= std::numeric_limits<Index>::max(),
+        errors::InvalidArgument("params.shape[0] too large for ",
+                                DataTypeString(DataTypeToEnum<Index>::v()),
+                                " indexing: ", gather_dim_size, " > ",
+                                std::numeric_limits<Index>::max()));
+
+    // The result shape is indices.shape + params.shape[1:].
+    TensorShape result_shape = indices.shape();
+    int64 inner_size = 1;
+    for (int i = 1; i < params.dims(); i++) {
+      result_shape.AddDim(params.dim_size(i));
+      inner_size *= params.dim_size(i);
+    }
+
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(c, c->allocate_output(0, result_shape, &out));
+    if (N > 0 && inner_size > 0) {
+      auto params_flat = params.shaped<T, 2>({gather_dim_size, inner_size});
+      auto indices_flat = indices.flat<Index>();
+      auto out_flat = out->shaped<OutT, 2>({N, inner_size});
+
+      functor::GatherDecodeFunctorCPU<T, OutT, Index> functor;
+      int64 bad_i = functor(c, params_flat, indices_flat, out_flat);
+
+      OP_REQUIRES(
+          c, bad_i < 0,
+          errors::InvalidArgument(
+              "indices", SliceDebugString(indices.shape(), bad_i), " = ",
+              indices_flat(bad_i), " is not in [0, ", gather_dim_size, ")"));
+    }
+  }
+};
+
+#define REGISTER_GATHER_DECODE_FULL(type, out_type, index_type)          \
+  REGISTER_KERNEL_BUILDER(Name("GatherAndDecode")                        \
+                              .Device(DEVICE_CPU)                        \
+                              .TypeConstraint<type>("Tparams")           \
+                              .TypeConstraint<out_type>("Tout")          \
+                              .TypeConstraint<index_type>("Tindices"),   \
+                          GatherAndDecodeOp<type, out_type, index_type>)
+
+#define REGISTER_GATHER_DECODE_CPU(type)                   \
+  REGISTER_GATHER_DECODE_FULL(type, float, int32);         \
+  REGISTER_GATHER_DECODE_FULL(type, float, int64);         \
+  REGISTER_GATHER_DECODE_FULL(type, bfloat16, int32);      \
+  REGISTER_GATHER_DECODE_FULL(type, bfloat16, int64)
+
+TF_CALL_POSIT_TYPES(REGISTER_GATHER_DECODE_CPU);
+
+#undef REGISTER_GATHER_DECODE_CPU
+#undef REGISTER_GATHER_DECODE_FULL
+
 #if GOOGLE_CUDA
 
 // Registration of the GPU implementations.
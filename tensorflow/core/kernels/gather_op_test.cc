@@ -176,6 +176,70 @@ TEST_F(GatherOpTest, Error_IndexOutOfRange) {
       << s;
 }
 
+class GatherAndDecodeOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(DataType data_type, DataType out_type) {
+    TF_ASSERT_OK(NodeDefBuilder("myop", "GatherAndDecode")
+                     .Input(FakeInput(data_type))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("Tout", out_type)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  template <typename T>
+  void AddPositInput(const TensorShape& shape, const std::vector<float>& data) {
+    std::vector<T> encoded;
+    for (float f : data) encoded.push_back(T(f));
+    AddInputFromArray<T>(shape, encoded);
+  }
+};
+
+TEST_F(GatherAndDecodeOpTest, Posit16ToFloat) {
+  MakeOp(DT_POSIT16, DT_FLOAT);
+
+  // Feed and run
+  AddPositInput<posit16>(TensorShape({5, 3}), {0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+                                               10, 11, 12, 13, 14});
+  AddInputFromArray<int32>(TensorShape({2, 2}), {0, 4, 0, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Check the output.
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({2, 2, 3}));
+  test::FillValues<float>(&expected,
+                          {0, 1, 2, 12, 13, 14, 0, 1, 2, 6, 7, 8});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(GatherAndDecodeOpTest, Posit8ToBfloat16) {
+  MakeOp(DT_POSIT8, DT_BFLOAT16);
+
+  // Feed and run
+  AddPositInput<posit8>(TensorShape({4, 2}), {0, 0.5, 1, 1.5, 2, -2, 4, -4});
+  AddInputFromArray<int32>(TensorShape({3}), {3, 1, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Check the output.
+  Tensor expected(allocator(), DT_BFLOAT16, TensorShape({3, 2}));
+  test::FillValues<bfloat16>(
+      &expected, {bfloat16(4.0f), bfloat16(-4.0f), bfloat16(1.0f),
+                  bfloat16(1.5f), bfloat16(2.0f), bfloat16(-2.0f)});
+  test::ExpectTensorEqual<bfloat16>(expected, *GetOutput(0));
+}
+
+TEST_F(GatherAndDecodeOpTest, Error_IndexOutOfRange) {
+  MakeOp(DT_POSIT16, DT_FLOAT);
+
+  // Feed and run
+  AddPositInput<posit16>(TensorShape({5, 3}), {0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+                                               10, 11, 12, 13, 14});
+  AddInputFromArray<int32>(TensorShape({4}), {0, 4, 99, 2});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(
+      str_util::StrContains(s.ToString(), "indices[2] = 99 is not in [0, 5)"))
+      << s;
+}
+
 constexpr int kLookups = 2000;
 
 template <typename Index>
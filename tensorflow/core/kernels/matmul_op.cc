@@ -23,6 +23,8 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/kernels/posit_utils.h"
+#include "tensorflow/core/kernels/posit_weight_cache.h"
 #include "tensorflow/core/util/matmul_autotune.h"
 #if GOOGLE_CUDA
 #include "cuda/include/cuda.h"
@@ -435,6 +437,47 @@ struct LaunchMatMul<GPUDevice, T, true /* USE_CUBLAS */> {
 
 #endif  // GOOGLE_CUDA
 
+// Posit8 and posit16 MatMul on CPU decode both operands, multiply in float and
+// round each output once. When "b_cache" is set, "b" holds weights (grappler
+// marks x * W where W is a constant or a variable) and its decoding is kept
+// across calls. posit32 does not fit in a float and stays on the generic path.
+template <typename T, bool = is_float_exact_posit<T>::value>
+struct LaunchPositMatMul {
+  static void launch(
+      OpKernelContext* ctx, const Tensor& a, const Tensor& b,
+      const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+      PositWeightCache* b_cache, Tensor* out) {}
+};
+
+template <typename T>
+struct LaunchPositMatMul<T, true> {
+  static void launch(
+      OpKernelContext* ctx, const Tensor& a, const Tensor& b,
+      const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+      PositWeightCache* b_cache, Tensor* out) {
+    Tensor a_float, b_float, out_float;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, a.shape(), &a_float));
+    if (b_cache != nullptr) {
+      OP_REQUIRES_OK(ctx, b_cache->GetDecoded<T>(ctx, b, &b_float));
+    } else {
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, b.shape(), &b_float));
+      ParallelDecodePosits(ctx, b.flat<T>().data(),
+                           b_float.flat<float>().data(), b.NumElements());
+    }
+    OP_REQUIRES_OK(ctx,
+                   ctx->allocate_temp(DT_FLOAT, out->shape(), &out_float));
+    ParallelDecodePosits(ctx, a.flat<T>().data(), a_float.flat<float>().data(),
+                         a.NumElements());
+
+    std::vector<int64> algorithms;
+    LaunchMatMul<CPUDevice, float, false>::launch(
+        ctx, a_float, b_float, dim_pair, &algorithms,
+        /*use_aututone=*/false, &out_float);
+    ParallelEncodePosits(ctx, out_float.flat<float>().data(),
+                         out->flat<T>().data(), out->NumElements());
+  }
+};
+
 template <typename Device, typename T, bool USE_CUBLAS>
 class MatMulOp : public OpKernel {
  public:
@@ -446,6 +489,9 @@ class MatMulOp : public OpKernel {
     LaunchMatMul<Device, T, USE_CUBLAS>::GetBlasGemmAlgorithm(
         ctx, &algorithms_, &algorithms_set_already_);
     use_autotune_ = MatmulAutotuneEnable();
+    if (!ctx->GetAttr("_grappler_b_is_weights", &b_is_weights_).ok()) {
+      b_is_weights_ = false;
+    }
   }
 
   void Compute(OpKernelContext* ctx) override {
@@ -513,6 +559,12 @@ class MatMulOp : public OpKernel {
           &out_float);
       FloatToBFloat16(out_float.flat<float>().data(),
                       out->flat<bfloat16>().data(), out->NumElements());
+    } else if (is_float_exact_posit<T>::value) {
+      bool is_cpu = std::is_same<Device, CPUDevice>::value;
+      OP_REQUIRES(ctx, is_cpu,
+                  errors::Internal("posit matmul is not supported by GPU"));
+      LaunchPositMatMul<T>::launch(ctx, a, b, dim_pair,
+                                   b_is_weights_ ? &b_cache_ : nullptr, out);
     } else {
       LaunchMatMul<Device, T, USE_CUBLAS>::launch(
           ctx, a, b, dim_pair, &algorithms_, use_autotune_, out);
@@ -525,6 +577,8 @@ class MatMulOp : public OpKernel {
   bool use_autotune_;
   bool transpose_a_;
   bool transpose_b_;
+  bool b_is_weights_;
+  PositWeightCache b_cache_;
 };
 
 namespace functor {
@@ -246,14 +246,6 @@ class MaxPoolingGradOp : public OpKernel {
 
     const TensorShape& output_shape = tensor_in.shape();
 
-    Tensor tensor_out_dup;
-    OP_REQUIRES_OK(context, context->forward_input_or_allocate_temp(
-                                {1}, DataTypeToEnum<T>::v(), tensor_out.shape(),
-                                &tensor_out_dup));
-    Tensor tensor_out_arg_max;
-    OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<int64>::v(),
-                                                   tensor_out.shape(),
-                                                   &tensor_out_arg_max));
     std::vector<int32> ksize = ksize_;
     std::vector<int32> stride = stride_;
     if (context->num_inputs() == 5) {
@@ -292,6 +284,20 @@ class MaxPoolingGradOp : public OpKernel {
     OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
                                 {0}, 0, output_shape, &output));
 
+    if (is_posit<T>::value) {
+      PositPooling<T>::MaxPoolGrad(context, tensor_in, out_backprop, params,
+                                   output);
+      return;
+    }
+
+    Tensor tensor_out_dup;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_temp(
+                                {1}, DataTypeToEnum<T>::v(), tensor_out.shape(),
+                                &tensor_out_dup));
+    Tensor tensor_out_arg_max;
+    OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<int64>::v(),
+                                                   tensor_out.shape(),
+                                                   &tensor_out_arg_max));
     SpatialMaxPoolWithArgMaxHelper<CPUDevice, T>(
         context, &tensor_out_dup, &tensor_out_arg_max, output, tensor_in,
         out_backprop, params);
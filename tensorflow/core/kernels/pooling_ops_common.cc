@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/pooling_ops_common.h"
 
+#include <algorithm>
+#include <limits>
+#include <type_traits>
 #include <vector>
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -110,6 +113,185 @@ TensorShape PoolParameters::forward_output_shape() {
   }
 }
 
+namespace {
+
+// The output pixels of "params" are numbered (batch, row, col) in NHWC order.
+// Sets the input window [h_start, h_end) x [w_start, w_end) of pixel "p",
+// clipped to the input.
+void PoolWindow(const PoolParameters& params, int64 p, int64* b, int* h_start,
+                int* h_end, int* w_start, int* w_end) {
+  const int64 pw = p % params.out_width;
+  const int64 ph = (p / params.out_width) % params.out_height;
+  *b = p / (params.out_width * params.out_height);
+  const int h = static_cast<int>(ph * params.row_stride - params.pad_rows);
+  const int w = static_cast<int>(pw * params.col_stride - params.pad_cols);
+  *h_start = std::max(h, 0);
+  *h_end = std::min(h + params.window_rows, params.tensor_in_rows);
+  *w_start = std::max(w, 0);
+  *w_end = std::min(w + params.window_cols, params.tensor_in_cols);
+}
+
+// Signed integer view of the bits of posit type T.
+template <typename T>
+using PositInt = typename std::make_signed<typename PositFormat<T>::Bits>::type;
+
+}  // namespace
+
+template <typename T>
+void PositPooling<T, true>::MaxPool(OpKernelContext* context,
+                                    const Tensor& input,
+                                    const PoolParameters& params,
+                                    Tensor* output) {
+  typedef PositInt<T> Int;
+  static_assert(sizeof(Int) == sizeof(T), "posits must be bare bits");
+  const Int* in = reinterpret_cast<const Int*>(input.flat<T>().data());
+  Int* out = reinterpret_cast<Int*>(output->flat<T>().data());
+  const int depth = params.depth;
+
+  auto shard = [&params, in, out, depth](int64 start, int64 limit) {
+    for (int64 p = start; p < limit; ++p) {
+      int64 b;
+      int h_start, h_end, w_start, w_end;
+      PoolWindow(params, p, &b, &h_start, &h_end, &w_start, &w_end);
+      Int* out_pixel = out + p * depth;
+      std::fill_n(out_pixel, depth, std::numeric_limits<Int>::min());
+      for (int h = h_start; h < h_end; ++h) {
+        const int64 row = b * params.tensor_in_rows + h;
+        const Int* in_row = in + row * params.tensor_in_cols * depth;
+        for (int w = w_start; w < w_end; ++w) {
+          const Int* in_pixel = in_row + w * depth;
+          for (int d = 0; d < depth; ++d) {
+            out_pixel[d] = std::max(out_pixel[d], in_pixel[d]);
+          }
+        }
+      }
+    }
+  };
+  const DeviceBase::CpuWorkerThreads& worker_threads =
+      *(context->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers,
+        output->NumElements() / depth,
+        params.window_rows * params.window_cols * depth, shard);
+}
+
+template <typename T>
+void PositPooling<T, true>::MaxPoolGrad(OpKernelContext* context,
+                                        const Tensor& input,
+                                        const Tensor& out_backprop,
+                                        const PoolParameters& params,
+                                        Tensor* output) {
+  typedef PositInt<T> Int;
+  typedef typename PositComputeType<T>::type C;
+  const Int* in = reinterpret_cast<const Int*>(input.flat<T>().data());
+  const T* grad = out_backprop.flat<T>().data();
+  T* in_backprop = output->flat<T>().data();
+  const int depth = params.depth;
+  const int64 in_image_size =
+      static_cast<int64>(params.tensor_in_rows) * params.tensor_in_cols * depth;
+  const int64 out_image_pixels = params.out_height * params.out_width;
+
+  // Images are independent, so each shard accumulates the gradient of its
+  // images in C and rounds every input element once. An element that is the
+  // maximum of a single window gets its gradient exactly; where overlapping
+  // windows route several gradients to it, their sum is rounded to C first.
+  // Ties go to the first maximum in row-major order, as in the generic
+  // kernel. "output" may have been forwarded from "input"; an image is only
+  // written after all of it has been read.
+  auto shard = [&params, in, grad, in_backprop, depth, in_image_size,
+                out_image_pixels](int64 start, int64 limit) {
+    std::vector<C> acc(in_image_size);
+    std::vector<C> grad_buf(depth);
+    std::vector<Int> best(depth);
+    std::vector<int64> best_index(depth);
+    for (int64 b = start; b < limit; ++b) {
+      std::fill(acc.begin(), acc.end(), C(0));
+      const Int* in_image = in + b * in_image_size;
+      for (int64 p = b * out_image_pixels; p < (b + 1) * out_image_pixels;
+           ++p) {
+        int64 unused_b;
+        int h_start, h_end, w_start, w_end;
+        PoolWindow(params, p, &unused_b, &h_start, &h_end, &w_start, &w_end);
+        std::fill(best_index.begin(), best_index.end(), int64{-1});
+        for (int h = h_start; h < h_end; ++h) {
+          for (int w = w_start; w < w_end; ++w) {
+            const int64 offset =
+                (static_cast<int64>(h) * params.tensor_in_cols + w) * depth;
+            for (int d = 0; d < depth; ++d) {
+              if (best_index[d] < 0 || in_image[offset + d] > best[d]) {
+                best[d] = in_image[offset + d];
+                best_index[d] = offset + d;
+              }
+            }
+          }
+        }
+        DecodePosits(grad + p * depth, grad_buf.data(), depth);
+        for (int d = 0; d < depth; ++d) {
+          if (best_index[d] >= 0) acc[best_index[d]] += grad_buf[d];
+        }
+      }
+      EncodePosits(acc.data(), in_backprop + b * in_image_size,
+                   in_image_size);
+    }
+  };
+  const DeviceBase::CpuWorkerThreads& worker_threads =
+      *(context->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers,
+        params.tensor_in_batch,
+        in_image_size * params.window_rows * params.window_cols, shard);
+}
+
+template <typename T>
+void PositPooling<T, true>::AvgPool(OpKernelContext* context,
+                                    const Tensor& input,
+                                    const PoolParameters& params,
+                                    Tensor* output) {
+  typedef typename PositComputeType<T>::type C;
+  Tensor input_decoded;
+  OP_REQUIRES_OK(context,
+                 context->allocate_temp(DataTypeToEnum<C>::v(), input.shape(),
+                                        &input_decoded));
+  ParallelDecodePosits(context, input.flat<T>().data(),
+                       input_decoded.flat<C>().data(), input.NumElements());
+  const C* in = input_decoded.flat<C>().data();
+  T* out = output->flat<T>().data();
+  const int depth = params.depth;
+
+  // Padding is excluded from the count, as in SpatialAvgPool.
+  auto shard = [&params, in, out, depth](int64 start, int64 limit) {
+    std::vector<double> sum(depth);
+    for (int64 p = start; p < limit; ++p) {
+      int64 b;
+      int h_start, h_end, w_start, w_end;
+      PoolWindow(params, p, &b, &h_start, &h_end, &w_start, &w_end);
+      std::fill(sum.begin(), sum.end(), 0.0);
+      for (int h = h_start; h < h_end; ++h) {
+        const int64 row = b * params.tensor_in_rows + h;
+        const C* in_row = in + row * params.tensor_in_cols * depth;
+        for (int w = w_start; w < w_end; ++w) {
+          const C* in_pixel = in_row + w * depth;
+          for (int d = 0; d < depth; ++d) {
+            sum[d] += in_pixel[d];
+          }
+        }
+      }
+      const double count = (h_end - h_start) * (w_end - w_start);
+      T* out_pixel = out + p * depth;
+      for (int d = 0; d < depth; ++d) {
+        out_pixel[d] = T(sum[d] / count);
+      }
+    }
+  };
+  const DeviceBase::CpuWorkerThreads& worker_threads =
+      *(context->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers,
+        output->NumElements() / depth,
+        params.window_rows * params.window_cols * depth, shard);
+}
+
+template struct PositPooling<posit8, true>;
+template struct PositPooling<posit16, true>;
+template struct PositPooling<posit32, true>;
+
 #ifdef GOOGLE_CUDA
 
 namespace {
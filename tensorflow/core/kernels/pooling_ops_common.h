@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/avgpooling_op.h"
 #include "tensorflow/core/kernels/maxpooling_op.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/util/padding.h"
 #include "tensorflow/core/util/tensor_format.h"
 #include "tensorflow/core/util/work_sharder.h"
@@ -72,6 +73,37 @@ struct PoolParameters {
   TensorFormat data_format;
 };
 
+// CPU pooling on NHWC posit tensors; the primary template is never called.
+// Max pooling and its gradient compare the raw bits, which order the same
+// way as the values when read as signed integers (NaR sorts below every
+// real), so the inner loops over channels are plain integer max. Average
+// pooling and the max pooling gradient decode into PositComputeType<T>, so
+// posit32 goes through double and is not truncated to float. Average pooling
+// sums each window in double and rounds the mean once; the sum is exact as
+// long as the window's values lie within 2^25 (posit32) or 2^40 (posit16) of
+// each other. Defined in pooling_ops_common.cc.
+template <typename T, bool = is_posit<T>::value>
+struct PositPooling {
+  static void MaxPool(OpKernelContext* context, const Tensor& input,
+                      const PoolParameters& params, Tensor* output) {}
+  static void MaxPoolGrad(OpKernelContext* context, const Tensor& input,
+                          const Tensor& out_backprop,
+                          const PoolParameters& params, Tensor* output) {}
+  static void AvgPool(OpKernelContext* context, const Tensor& input,
+                      const PoolParameters& params, Tensor* output) {}
+};
+
+template <typename T>
+struct PositPooling<T, true> {
+  static void MaxPool(OpKernelContext* context, const Tensor& input,
+                      const PoolParameters& params, Tensor* output);
+  static void MaxPoolGrad(OpKernelContext* context, const Tensor& input,
+                          const Tensor& out_backprop,
+                          const PoolParameters& params, Tensor* output);
+  static void AvgPool(OpKernelContext* context, const Tensor& input,
+                      const PoolParameters& params, Tensor* output);
+};
+
 // An implementation of MaxPooling (forward).
 // TODO (yongtang): Remove MaxPoolingOp and use MaxPoolingV2Op,
 //     QuantizedMaxPoolingOp depends on MaxPoolingOp so keep intact for now
@@ -161,6 +193,10 @@ class MaxPoolingOp : public OpKernel {
     // Spatial MaxPooling implementation.
     //
     // TODO(vrv): Remove this once we no longer need it.
+    if (!std::is_same<Device, GPUDevice>::value && is_posit<T>::value) {
+      PositPooling<T>::MaxPool(context, tensor_in, params, output);
+      return;
+    }
     if (std::is_same<Device, GPUDevice>::value) {
       Eigen::PaddingType pt = BrainPadding2EigenPadding(padding);
       functor::SpatialMaxPooling<Device, T>()(
@@ -400,6 +436,10 @@ class MaxPoolingV2Op : public OpKernel {
     // Spatial MaxPooling implementation.
     //
     // TODO(vrv): Remove this once we no longer need it.
+    if (!std::is_same<Device, GPUDevice>::value && is_posit<T>::value) {
+      PositPooling<T>::MaxPool(context, tensor_in, params, output);
+      return;
+    }
 #ifdef GOOGLE_CUDA
     if (std::is_same<Device, GPUDevice>::value) {
       Eigen::PaddingType pt = BrainPadding2EigenPadding(padding);
@@ -512,6 +552,10 @@ template <typename Device, typename T>
 void SpatialAvgPool(OpKernelContext* context, Tensor* output,
                     const Tensor& input, const PoolParameters& params,
                     const Padding& padding) {
+  if (is_posit<T>::value) {
+    PositPooling<T>::AvgPool(context, input, params, output);
+    return;
+  }
   typedef Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>
       ConstEigenMatrixMap;
   typedef Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>
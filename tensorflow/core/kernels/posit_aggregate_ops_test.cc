@@ -0,0 +1,93 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class PositAddNOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(int num_inputs) {
+    TF_ASSERT_OK(NodeDefBuilder("add_n", "AddN")
+                     .Input(FakeInput(num_inputs, DT_POSIT16))
+                     .Attr("T", DT_POSIT16)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  void AddPositInput(const std::vector<float>& data) {
+    std::vector<posit16> encoded;
+    for (float f : data) encoded.push_back(posit16(f));
+    AddInputFromArray<posit16>(TensorShape({static_cast<int64>(data.size())}),
+                               encoded);
+  }
+
+  std::vector<float> GetPositOutput() {
+    std::vector<float> values;
+    auto output = GetOutput(0)->flat<posit16>();
+    for (int i = 0; i < output.size(); ++i) {
+      values.push_back(static_cast<float>(output(i)));
+    }
+    return values;
+  }
+};
+
+TEST_F(PositAddNOpTest, SumsElementwise) {
+  MakeOp(3);
+  AddPositInput({1, 2, -4});
+  AddPositInput({0.5, 8, 4});
+  AddPositInput({-3, 0.25, 1});
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_EQ(std::vector<float>({-1.5, 10.25, 1}), GetPositOutput());
+}
+
+TEST_F(PositAddNOpTest, RoundsOnce) {
+  // Pairwise posit16 additions would round 1024 + 0.25 back to 1024 twice
+  // and return 0; the quire keeps both quarters.
+  MakeOp(4);
+  AddPositInput({1024});
+  AddPositInput({0.25});
+  AddPositInput({0.25});
+  AddPositInput({-1024});
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_EQ(std::vector<float>({0.5}), GetPositOutput());
+}
+
+TEST_F(PositAddNOpTest, SpansSeveralBlocks) {
+  const int size = 1000;
+  MakeOp(2);
+  std::vector<float> a(size), b(size), expected(size);
+  for (int i = 0; i < size; ++i) {
+    a[i] = i;
+    b[i] = -0.5f * i;
+    expected[i] = static_cast<float>(posit16(0.5f * i));
+  }
+  AddPositInput(a);
+  AddPositInput(b);
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_EQ(expected, GetPositOutput());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,127 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class PositBiasOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(const string& op, int num_inputs, const string& data_format,
+              DataType dtype = DT_POSIT16) {
+    NodeDefBuilder builder("bias", op);
+    for (int i = 0; i < num_inputs; ++i) {
+      builder.Input(FakeInput(dtype));
+    }
+    TF_ASSERT_OK(builder.Attr("T", dtype)
+                     .Attr("data_format", data_format)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  void AddPositInput(const TensorShape& shape, const std::vector<float>& data) {
+    std::vector<posit16> encoded;
+    for (float f : data) encoded.push_back(posit16(f));
+    AddInputFromArray<posit16>(shape, encoded);
+  }
+
+  void ExpectOutput(const TensorShape& shape,
+                    const std::vector<float>& expected) {
+    const Tensor& output = *GetOutput(0);
+    EXPECT_EQ(shape, output.shape());
+    auto values = output.flat<posit16>();
+    ASSERT_EQ(expected.size(), values.size());
+    for (int i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(expected[i], static_cast<float>(values(i))) << "at " << i;
+    }
+  }
+};
+
+TEST_F(PositBiasOpTest, BiasAddNHWC) {
+  MakeOp("BiasAdd", 2, "NHWC");
+  AddPositInput(TensorShape({2, 1, 1, 3}), {1, 2, 3, 4, 5, 6});
+  AddPositInput(TensorShape({3}), {0.5, -1, 8});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectOutput(TensorShape({2, 1, 1, 3}), {1.5, 1, 11, 4.5, 4, 14});
+}
+
+TEST_F(PositBiasOpTest, BiasAddNCHW) {
+  MakeOp("BiasAdd", 2, "NCHW");
+  AddPositInput(TensorShape({1, 2, 1, 2}), {1, 2, 3, 4});
+  AddPositInput(TensorShape({2}), {0.5, -1});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectOutput(TensorShape({1, 2, 1, 2}), {1.5, 2.5, 2, 3});
+}
+
+TEST_F(PositBiasOpTest, BiasAddGradNHWC) {
+  MakeOp("BiasAddGrad", 1, "NHWC");
+  AddPositInput(TensorShape({3, 2}), {1, -2, 0.25, 4, 2, 8});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectOutput(TensorShape({2}), {3.25, 10});
+}
+
+TEST_F(PositBiasOpTest, BiasAddGradNCHW) {
+  MakeOp("BiasAddGrad", 1, "NCHW");
+  AddPositInput(TensorShape({2, 2, 1, 2}), {1, 2, 3, 4, 5, 6, 7, 8});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectOutput(TensorShape({2}), {14, 22});
+}
+
+TEST_F(PositBiasOpTest, BiasAddGradIsExact) {
+  // In a float accumulator the small gradients would be absorbed by 4096 and
+  // lost when it cancels; the quire keeps them.
+  MakeOp("BiasAddGrad", 1, "NHWC");
+  AddPositInput(TensorShape({4, 1}), {4096, 0.0001220703125, -4096,
+                                      0.0001220703125});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectOutput(TensorShape({1}), {0.000244140625});
+}
+
+TEST_F(PositBiasOpTest, BiasAddPosit32IsExact) {
+  // 1 + 2^-26 is a posit32 but not a float, so a float sum would lose the
+  // bias.
+  const double kTiny = 1.0 / (1 << 26);
+  for (const string data_format : {"NHWC", "NCHW"}) {
+    inputs_.clear();
+    MakeOp("BiasAdd", 2, data_format, DT_POSIT32);
+    AddInputFromArray<posit32>(TensorShape({1, 2, 1, 2}),
+                               {posit32(1.0), posit32(2.0), posit32(-1.0),
+                                posit32(4.0)});
+    AddInputFromArray<posit32>(TensorShape({2}),
+                               {posit32(kTiny), posit32(-kTiny)});
+    TF_ASSERT_OK(RunOpKernel());
+    const std::vector<double> expected =
+        data_format == "NHWC"
+            ? std::vector<double>{1 + kTiny, 2 - kTiny, -1 + kTiny, 4 - kTiny}
+            : std::vector<double>{1 + kTiny, 2 + kTiny, -1 - kTiny, 4 - kTiny};
+    auto values = GetOutput(0)->flat<posit32>();
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_EQ(expected[i], static_cast<double>(values(i)))
+          << data_format << " at " << i;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
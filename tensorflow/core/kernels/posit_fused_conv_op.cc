@@ -0,0 +1,254 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// CPU kernel for _PositFusedConv2D: Conv2D, BiasAdd and an optional Relu or
+// Relu6 on posit tensors, with a single rounding of the activation. The
+// remapper rewrites posit Conv2D + BiasAdd [+ Relu|Relu6] chains into it.
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/bounds_check.h"
+#include "tensorflow/core/kernels/conv_ops.h"
+#include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/kernels/posit_utils.h"
+#include "tensorflow/core/kernels/posit_weight_cache.h"
+#include "tensorflow/core/util/padding.h"
+#include "tensorflow/core/util/tensor_format.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+// Instantiated in conv_ops.cc.
+extern template struct LaunchConv2DOp<CPUDevice, float>;
+extern template struct LaunchConv2DOp<CPUDevice, double>;
+
+namespace {
+
+enum class PositFusedActivation { kIdentity, kRelu, kRelu6 };
+
+Status ParseActivation(const string& name, PositFusedActivation* activation) {
+  if (name == "Identity") {
+    *activation = PositFusedActivation::kIdentity;
+  } else if (name == "Relu") {
+    *activation = PositFusedActivation::kRelu;
+  } else if (name == "Relu6") {
+    *activation = PositFusedActivation::kRelu6;
+  } else {
+    return errors::InvalidArgument("Unsupported activation: ", name);
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+template <typename T>
+class PositFusedConv2DOp : public OpKernel {
+  // posit32 is decoded to double, which holds it exactly.
+  typedef typename PositComputeType<T>::type C;
+
+ public:
+  explicit PositFusedConv2DOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("dilations", &dilations_));
+    OP_REQUIRES_OK(context, context->GetAttr("strides", &strides_));
+    string data_format;
+    OP_REQUIRES_OK(context, context->GetAttr("data_format", &data_format));
+    OP_REQUIRES(context, FormatFromString(data_format, &data_format_),
+                errors::InvalidArgument("Invalid data format"));
+    OP_REQUIRES(context, data_format_ == FORMAT_NHWC,
+                errors::Unimplemented(
+                    "_PositFusedConv2D only supports NHWC on CPU."));
+    OP_REQUIRES(context, dilations_.size() == 4,
+                errors::InvalidArgument("Sliding window dilations field must "
+                                        "specify 4 dimensions"));
+    OP_REQUIRES(context, strides_.size() == 4,
+                errors::InvalidArgument("Sliding window strides field must "
+                                        "specify 4 dimensions"));
+    OP_REQUIRES(
+        context, strides_[0] == 1 && strides_[3] == 1,
+        errors::InvalidArgument("Current implementation does not yet support "
+                                "strides in the batch and depth dimensions."));
+    OP_REQUIRES(context, strides_[1] > 0 && strides_[2] > 0,
+                errors::InvalidArgument(
+                    "Row and column strides should be larger than 0."));
+    OP_REQUIRES(context, dilations_[0] == 1 && dilations_[3] == 1,
+                errors::InvalidArgument(
+                    "Current implementation does not yet support "
+                    "dilations in the batch and depth dimensions."));
+    OP_REQUIRES(
+        context, dilations_[1] > 0 && dilations_[2] > 0,
+        errors::InvalidArgument("Dilated rates should be larger than 0."));
+    OP_REQUIRES_OK(context, context->GetAttr("padding", &padding_));
+    string activation;
+    OP_REQUIRES_OK(context, context->GetAttr("activation", &activation));
+    OP_REQUIRES_OK(context, ParseActivation(activation, &activation_));
+    if (!context->GetAttr("_grappler_filter_is_weights", &filter_is_weights_)
+             .ok()) {
+      filter_is_weights_ = false;
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input = context->input(0);
+    const Tensor& filter = context->input(1);
+    const Tensor& bias = context->input(2);
+
+    OP_REQUIRES(context, input.dims() == 4,
+                errors::InvalidArgument("input must be 4-dimensional",
+                                        input.shape().DebugString()));
+    OP_REQUIRES(context, filter.dims() == 4,
+                errors::InvalidArgument("filter must be 4-dimensional: ",
+                                        filter.shape().DebugString()));
+    for (int i = 0; i < 3; i++) {
+      OP_REQUIRES(
+          context,
+          FastBoundsCheck(filter.dim_size(i), std::numeric_limits<int>::max()),
+          errors::InvalidArgument("filter too large"));
+    }
+    const int64 in_depth = input.dim_size(3);
+    OP_REQUIRES(context, in_depth == filter.dim_size(2),
+                errors::InvalidArgument(
+                    "input and filter must have the same depth: ", in_depth,
+                    " vs ", filter.dim_size(2)));
+    const int64 out_depth = filter.dim_size(3);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(bias.shape()),
+                errors::InvalidArgument("bias must be 1-dimensional: ",
+                                        bias.shape().DebugString()));
+    OP_REQUIRES(context, bias.dim_size(0) == out_depth,
+                errors::InvalidArgument(
+                    "bias must match the output depth: ", bias.dim_size(0),
+                    " vs ", out_depth));
+    for (int i = 0; i < 3; i++) {
+      OP_REQUIRES(
+          context,
+          FastBoundsCheck(input.dim_size(i), std::numeric_limits<int>::max()),
+          errors::InvalidArgument("input too large"));
+    }
+
+    const int batch = static_cast<int>(input.dim_size(0));
+    const int input_rows = static_cast<int>(input.dim_size(1));
+    const int input_cols = static_cast<int>(input.dim_size(2));
+    const int filter_rows = static_cast<int>(filter.dim_size(0));
+    const int filter_cols = static_cast<int>(filter.dim_size(1));
+    const int stride_rows = strides_[1];
+    const int stride_cols = strides_[2];
+    const int dilation_rows = dilations_[1];
+    const int dilation_cols = dilations_[2];
+
+    int64 out_rows = 0, out_cols = 0, pad_rows = 0, pad_cols = 0;
+    OP_REQUIRES_OK(context, GetWindowedOutputSizeV2(
+                                input_rows, filter_rows, dilation_rows,
+                                stride_rows, padding_, &out_rows, &pad_rows));
+    OP_REQUIRES_OK(context, GetWindowedOutputSizeV2(
+                                input_cols, filter_cols, dilation_cols,
+                                stride_cols, padding_, &out_cols, &pad_cols));
+    TensorShape out_shape({batch, out_rows, out_cols, out_depth});
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, out_shape, &output));
+    if (out_shape.num_elements() == 0) {
+      return;
+    }
+
+    // Decode the operands, run the float convolution, then apply bias and
+    // activation to the float accumulators before the single rounding. The
+    // decoded filter is kept across calls when it is weights.
+    const DataType dtype = DataTypeToEnum<C>::value;
+    Tensor input_decoded, filter_decoded, output_decoded;
+    OP_REQUIRES_OK(
+        context, context->allocate_temp(dtype, input.shape(), &input_decoded));
+    if (filter_is_weights_) {
+      OP_REQUIRES_OK(context, filter_cache_.GetDecoded<T, C>(context, filter,
+                                                             &filter_decoded));
+    } else {
+      OP_REQUIRES_OK(context, context->allocate_temp(dtype, filter.shape(),
+                                                     &filter_decoded));
+      ParallelDecodePosits(context, filter.flat<T>().data(),
+                           filter_decoded.flat<C>().data(),
+                           filter.NumElements());
+    }
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(dtype, out_shape, &output_decoded));
+    ParallelDecodePosits(context, input.flat<T>().data(),
+                         input_decoded.flat<C>().data(), input.NumElements());
+    std::vector<C> bias_decoded(out_depth);
+    DecodePosits(bias.flat<T>().data(), bias_decoded.data(), out_depth);
+
+    launcher_(context, /*use_cudnn=*/false, /*cudnn_use_autotune=*/false,
+              input_decoded, filter_decoded, dilation_rows, dilation_cols,
+              stride_rows, stride_cols, padding_, &output_decoded,
+              FORMAT_NHWC);
+    if (!context->status().ok()) return;
+
+    C* acc = output_decoded.flat<C>().data();
+    T* out = output->flat<T>().data();
+    const PositFusedActivation activation = activation_;
+    auto epilogue = [acc, out, out_depth, activation, &bias_decoded](
+                        int64 start, int64 limit) {
+      for (int64 pixel = start; pixel < limit; ++pixel) {
+        C* row = acc + pixel * out_depth;
+        for (int64 c = 0; c < out_depth; ++c) {
+          C v = row[c] + bias_decoded[c];
+          if (activation != PositFusedActivation::kIdentity) {
+            v = std::max(v, C(0));
+          }
+          if (activation == PositFusedActivation::kRelu6) {
+            v = std::min(v, C(6));
+          }
+          row[c] = v;
+        }
+        EncodePosits(row, out + pixel * out_depth, out_depth);
+      }
+    };
+    const auto& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          out_shape.num_elements() / out_depth,
+          /*cost_per_unit=*/12 * out_depth, epilogue);
+  }
+
+ private:
+  std::vector<int32> dilations_;
+  std::vector<int32> strides_;
+  Padding padding_;
+  TensorFormat data_format_;
+  PositFusedActivation activation_;
+  LaunchConv2DOp<CPUDevice, C> launcher_;
+  bool filter_is_weights_;
+  PositWeightCache filter_cache_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(PositFusedConv2DOp);
+};
+
+#define REGISTER_CPU(T)                                                   \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_PositFusedConv2D").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      PositFusedConv2DOp<T>);
+
+TF_CALL_POSIT_TYPES(REGISTER_CPU);
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
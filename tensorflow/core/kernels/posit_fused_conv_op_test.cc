@@ -0,0 +1,96 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class PositFusedConv2DOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(const string& activation) {
+    TF_ASSERT_OK(NodeDefBuilder("fused_conv", "_PositFusedConv2D")
+                     .Input(FakeInput(DT_POSIT16))
+                     .Input(FakeInput(DT_POSIT16))
+                     .Input(FakeInput(DT_POSIT16))
+                     .Attr("T", DT_POSIT16)
+                     .Attr("strides", {1, 1, 1, 1})
+                     .Attr("padding", "VALID")
+                     .Attr("activation", activation)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  void AddPositInput(const TensorShape& shape, const std::vector<float>& data) {
+    std::vector<posit16> encoded;
+    for (float f : data) encoded.push_back(posit16(f));
+    AddInputFromArray<posit16>(shape, encoded);
+  }
+
+  // A 1x1 convolution that copies and negates a single channel, so every
+  // intermediate value is exactly representable.
+  void RunAndCheck(const std::vector<float>& expected) {
+    AddPositInput(TensorShape({1, 2, 2, 1}), {1, 2, 3, 8});
+    AddPositInput(TensorShape({1, 1, 1, 2}), {1, -1});
+    AddPositInput(TensorShape({2}), {0.5, 1});
+    TF_ASSERT_OK(RunOpKernel());
+
+    const Tensor& output = *GetOutput(0);
+    EXPECT_EQ(TensorShape({1, 2, 2, 2}), output.shape());
+    auto values = output.flat<posit16>();
+    ASSERT_EQ(expected.size(), values.size());
+    for (int i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(expected[i], static_cast<float>(values(i))) << "at " << i;
+    }
+  }
+};
+
+TEST_F(PositFusedConv2DOpTest, Identity) {
+  MakeOp("Identity");
+  RunAndCheck({1.5, 0, 2.5, -1, 3.5, -2, 8.5, -7});
+}
+
+TEST_F(PositFusedConv2DOpTest, Relu) {
+  MakeOp("Relu");
+  RunAndCheck({1.5, 0, 2.5, 0, 3.5, 0, 8.5, 0});
+}
+
+TEST_F(PositFusedConv2DOpTest, Relu6) {
+  MakeOp("Relu6");
+  RunAndCheck({1.5, 0, 2.5, 0, 3.5, 0, 6, 0});
+}
+
+TEST_F(PositFusedConv2DOpTest, BiasSizeMismatch) {
+  MakeOp("Relu");
+  AddPositInput(TensorShape({1, 2, 2, 1}), {1, 2, 3, 8});
+  AddPositInput(TensorShape({1, 1, 1, 2}), {1, -1});
+  AddPositInput(TensorShape({3}), {0, 0, 0});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(
+      str_util::StrContains(s.ToString(), "bias must match the output depth"))
+      << s;
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,93 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// CPU kernel for _PositLdexp, which the arithmetic optimizer substitutes for
+// posit multiplications by a constant power of two. It rescales each posit in
+// the integer domain instead of decoding it to float and back.
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/posit_utils.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+template <typename T>
+class PositLdexpOp : public OpKernel {
+ public:
+  explicit PositLdexpOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("exponent", &exponent_));
+    OP_REQUIRES_OK(context, context->GetAttr("negate", &negate_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input = context->input(0);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                {0}, 0, input.shape(), &output));
+    const T* in = input.flat<T>().data();
+    T* out = output->flat<T>().data();
+    const int exponent = exponent_;
+    const bool negate = negate_;
+    auto work = [in, out, exponent, negate](int64 start, int64 limit) {
+      for (int64 i = start; i < limit; ++i) {
+        out[i].value = Scale(in[i].value, exponent, negate);
+      }
+    };
+    const auto& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          input.NumElements(), /*cost_per_unit=*/20, work);
+  }
+
+ private:
+  typedef PositFormat<T> F;
+  typedef typename F::Bits Bits;
+
+  static Bits Scale(Bits bits, int exponent, bool negate) {
+    const Bits kNaR = static_cast<Bits>(uint32{1} << (F::kNBits - 1));
+    if (bits == 0 || bits == kNaR) {
+      return bits;
+    }
+    bool negative;
+    uint32 significand;
+    int scale;
+    PositBitsToScaled<Bits, F::kNBits, F::kES>(bits, &negative, &significand,
+                                               &scale);
+    int log2_significand = 0;
+    while ((significand >> (log2_significand + 1)) != 0) ++log2_significand;
+    const uint64 man =
+        static_cast<uint64>(significand ^ (uint32{1} << log2_significand))
+        << (30 - log2_significand);
+    return ScaledToPositBits<Bits, F::kNBits, F::kES, 30>(
+        negative != negate, scale + log2_significand + exponent, man);
+  }
+
+  int exponent_;
+  bool negate_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(PositLdexpOp);
+};
+
+#define REGISTER_CPU(T)                                              \
+  REGISTER_KERNEL_BUILDER(                                           \
+      Name("_PositLdexp").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      PositLdexpOp<T>);
+
+TF_CALL_POSIT_TYPES(REGISTER_CPU);
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
@@ -0,0 +1,75 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class PositLdexpOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(int exponent, bool negate) {
+    TF_ASSERT_OK(NodeDefBuilder("ldexp", "_PositLdexp")
+                     .Input(FakeInput(DT_POSIT16))
+                     .Attr("T", DT_POSIT16)
+                     .Attr("exponent", exponent)
+                     .Attr("negate", negate)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(PositLdexpOpTest, MatchesRoundedProduct) {
+  MakeOp(3, false);
+  // Every posit16 bit pattern, scaled up into the region of fewer fraction
+  // bits, rounds like the product computed in double.
+  std::vector<posit16> input(1 << 16);
+  for (int i = 0; i < (1 << 16); ++i) input[i].value = static_cast<uint16>(i);
+  AddInputFromArray<posit16>(TensorShape({1 << 16}), input);
+  TF_ASSERT_OK(RunOpKernel());
+  auto output = GetOutput(0)->flat<posit16>();
+  for (int i = 0; i < (1 << 16); ++i) {
+    if (i == 0x8000) {
+      EXPECT_EQ(0x8000, output(i).value);
+      continue;
+    }
+    const double x = static_cast<double>(input[i]);
+    EXPECT_EQ(posit16(x * 8).value, output(i).value) << x;
+  }
+}
+
+TEST_F(PositLdexpOpTest, Negates) {
+  MakeOp(-1, true);
+  AddInputFromArray<posit16>(
+      TensorShape({4}),
+      {posit16(3.0f), posit16(-0.5f), posit16(0.0f), posit16(1024.0f)});
+  TF_ASSERT_OK(RunOpKernel());
+  auto output = GetOutput(0)->flat<posit16>();
+  EXPECT_EQ(-1.5f, static_cast<float>(output(0)));
+  EXPECT_EQ(0.25f, static_cast<float>(output(1)));
+  EXPECT_EQ(0.0f, static_cast<float>(output(2)));
+  EXPECT_EQ(-512.0f, static_cast<float>(output(3)));
+}
+
+}  // namespace
+}  // namespace tensorflow
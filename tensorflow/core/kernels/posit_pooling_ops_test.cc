@@ -0,0 +1,131 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class PositPoolingOpTest : public OpsTestBase {
+ protected:
+  void MakePoolOp(const string& op, int num_inputs, int ksize, int stride,
+                  const string& padding, DataType dtype = DT_POSIT16) {
+    NodeDefBuilder builder("pool", op);
+    for (int i = 0; i < num_inputs; ++i) {
+      builder.Input(FakeInput(dtype));
+    }
+    TF_ASSERT_OK(builder.Attr("T", dtype)
+                     .Attr("ksize", {1, ksize, ksize, 1})
+                     .Attr("strides", {1, stride, stride, 1})
+                     .Attr("padding", padding)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  void AddPositInput(const TensorShape& shape, const std::vector<float>& data) {
+    std::vector<posit16> encoded;
+    for (float f : data) encoded.push_back(posit16(f));
+    AddInputFromArray<posit16>(shape, encoded);
+  }
+
+  void ExpectOutput(const TensorShape& shape,
+                    const std::vector<float>& expected) {
+    const Tensor& output = *GetOutput(0);
+    EXPECT_EQ(shape, output.shape());
+    auto values = output.flat<posit16>();
+    ASSERT_EQ(expected.size(), values.size());
+    for (int i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(expected[i], static_cast<float>(values(i))) << "at " << i;
+    }
+  }
+
+  void AddPosit32Input(const TensorShape& shape,
+                       const std::vector<double>& data) {
+    std::vector<posit32> encoded;
+    for (double d : data) encoded.push_back(posit32(d));
+    AddInputFromArray<posit32>(shape, encoded);
+  }
+
+  void ExpectPosit32Output(const TensorShape& shape,
+                           const std::vector<double>& expected) {
+    const Tensor& output = *GetOutput(0);
+    EXPECT_EQ(shape, output.shape());
+    auto values = output.flat<posit32>();
+    ASSERT_EQ(expected.size(), values.size());
+    for (int i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(expected[i], static_cast<double>(values(i))) << "at " << i;
+    }
+  }
+};
+
+// 1 + 2^-26 is a posit32 but not a float, so it only survives pooling if
+// posit32 is decoded to double.
+const double kPosit32NotFloat = 1.0 + 1.0 / (1 << 26);
+
+TEST_F(PositPoolingOpTest, MaxPoolComparesSignedBits) {
+  MakePoolOp("MaxPool", 1, 2, 1, "VALID");
+  // Two channels, so the second one sees only negative values.
+  AddPositInput(TensorShape({1, 3, 3, 2}),
+                {1, -1, -2, -0.5, 3, -8, 0.25, -4, 5, -2, -6, -0.125, 2, -3, 0,
+                 -1, 4, -16});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectOutput(TensorShape({1, 2, 2, 2}),
+               {5, -0.5, 5, -0.125, 5, -1, 5, -0.125});
+}
+
+TEST_F(PositPoolingOpTest, AvgPoolExcludesPadding) {
+  MakePoolOp("AvgPool", 1, 2, 1, "SAME");
+  AddPositInput(TensorShape({1, 2, 2, 1}), {1, 2, 3, 4});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectOutput(TensorShape({1, 2, 2, 1}), {2.5, 3, 3.5, 4});
+}
+
+TEST_F(PositPoolingOpTest, MaxPoolGradRoutesToFirstMaximum) {
+  MakePoolOp("MaxPoolGrad", 3, 2, 1, "SAME");
+  AddPositInput(TensorShape({1, 2, 2, 1}), {1, 3, 2, 3});
+  AddPositInput(TensorShape({1, 2, 2, 1}), {3, 3, 3, 3});
+  AddPositInput(TensorShape({1, 2, 2, 1}), {1, 2, 4, 8});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectOutput(TensorShape({1, 2, 2, 1}), {0, 3, 0, 12});
+}
+
+TEST_F(PositPoolingOpTest, AvgPoolPosit32IsExact) {
+  MakePoolOp("AvgPool", 1, 2, 2, "VALID", DT_POSIT32);
+  AddPosit32Input(TensorShape({1, 2, 2, 1}),
+                  {kPosit32NotFloat, kPosit32NotFloat, kPosit32NotFloat,
+                   kPosit32NotFloat});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectPosit32Output(TensorShape({1, 1, 1, 1}), {kPosit32NotFloat});
+}
+
+TEST_F(PositPoolingOpTest, MaxPoolGradPosit32IsExact) {
+  MakePoolOp("MaxPoolGrad", 3, 2, 2, "VALID", DT_POSIT32);
+  AddPosit32Input(TensorShape({1, 2, 2, 1}), {1, 3, 2, 0});
+  AddPosit32Input(TensorShape({1, 1, 1, 1}), {3});
+  AddPosit32Input(TensorShape({1, 1, 1, 1}), {kPosit32NotFloat});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectPosit32Output(TensorShape({1, 2, 2, 1}), {0, kPosit32NotFloat, 0, 0});
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,181 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_POSIT_QUIRE_H_
+#define TENSORFLOW_CORE_KERNELS_POSIT_QUIRE_H_
+
+#include <string.h>
+
+#include "tensorflow/core/kernels/posit_utils.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// A fixed-point accumulator that sums posits of type T exactly and rounds the
+// total once. Every posit is an integer multiple of minpos no larger than
+// maxpos, so the quire covers that range plus 31 carry bits: at least 2^31
+// additions of maxpos cannot overflow it. Adding NaR makes the result NaR.
+//
+// Reductions use it instead of a float accumulator so that the result does
+// not depend on summation order or on how the work is sharded.
+template <typename T>
+class PositQuire {
+ public:
+  PositQuire() { Clear(); }
+
+  void Clear() {
+    memset(limbs_, 0, sizeof(limbs_));
+    nar_ = false;
+  }
+
+  void Add(T p) {
+    typedef typename F::Bits Bits;
+    const Bits bits = p.value;
+    if (bits == 0) {
+      return;
+    }
+    if (bits == kNaR) {
+      nar_ = true;
+      return;
+    }
+    bool negative;
+    uint32 significand;
+    int exponent;
+    PositBitsToScaled<Bits, F::kNBits, F::kES>(bits, &negative, &significand,
+                                               &exponent);
+    const int shift = exponent + kMaxScale;
+    const int limb = shift / 64;
+    const int offset = shift % 64;
+    const uint64 lo = static_cast<uint64>(significand) << offset;
+    const uint64 hi =
+        offset == 0 ? 0 : static_cast<uint64>(significand) >> (64 - offset);
+    if (negative) {
+      Subtract(limb, lo, hi);
+    } else {
+      Add(limb, lo, hi);
+    }
+  }
+
+  // Adds the contents of "other", e.g. the partial sum of another shard.
+  void Add(const PositQuire& other) {
+    nar_ |= other.nar_;
+    uint64 carry = 0;
+    for (int i = 0; i < kLimbs; ++i) {
+      const uint64 sum = limbs_[i] + other.limbs_[i];
+      const uint64 out = sum + carry;
+      carry = (sum < limbs_[i]) + (out < sum);
+      limbs_[i] = out;
+    }
+  }
+
+  // Rounds the exact sum to the nearest posit, ties to even.
+  T ToPosit() const {
+    T result;
+    if (nar_) {
+      result.value = kNaR;
+      return result;
+    }
+    uint64 magnitude[kLimbs];
+    memcpy(magnitude, limbs_, sizeof(magnitude));
+    const bool negative = (magnitude[kLimbs - 1] >> 63) != 0;
+    if (negative) {
+      uint64 carry = 1;
+      for (int i = 0; i < kLimbs; ++i) {
+        magnitude[i] = ~magnitude[i] + carry;
+        carry = carry && magnitude[i] == 0;
+      }
+    }
+    int top = kLimbs - 1;
+    while (top >= 0 && magnitude[top] == 0) {
+      --top;
+    }
+    if (top < 0) {
+      result.value = 0;
+      return result;
+    }
+    int msb = 63;
+    while ((magnitude[top] >> msb) == 0) {
+      --msb;
+    }
+    msb += top * 64;
+    // Take the kManBits bits below the leading one and fold any lower ones
+    // into the last of them, which is below every posit rounding position.
+    uint64 man = 0;
+    for (int i = 1; i <= kManBits; ++i) {
+      man = (man << 1) | Bit(magnitude, msb - i);
+    }
+    if (Sticky(magnitude, msb - kManBits)) {
+      man |= 1;
+    }
+    result.value =
+        ScaledToPositBits<typename F::Bits, F::kNBits, F::kES, kManBits>(
+            negative, msb - kMaxScale, man);
+    return result;
+  }
+
+ private:
+  typedef PositFormat<T> F;
+  static constexpr uint32 kNaR = uint32{1} << (F::kNBits - 1);
+  // Bit 0 of the quire has the weight of minpos, 2^-kMaxScale.
+  static constexpr int kMaxScale = (F::kNBits - 2) << F::kES;
+  static constexpr int kLimbs = (2 * kMaxScale + 1 + 31 + 1 + 63) / 64;
+  static constexpr int kManBits = 30;
+
+  // Bit "i" of a nonnegative quire value; zero below bit 0.
+  static uint64 Bit(const uint64* v, int i) {
+    return i < 0 ? 0 : (v[i / 64] >> (i % 64)) & 1;
+  }
+
+  // Whether any bit of "v" below bit "i" is set.
+  static bool Sticky(const uint64* v, int i) {
+    if (i <= 0) {
+      return false;
+    }
+    for (int limb = 0; limb < i / 64; ++limb) {
+      if (v[limb] != 0) return true;
+    }
+    return i % 64 != 0 && (v[i / 64] & ((uint64{1} << (i % 64)) - 1)) != 0;
+  }
+
+  void Add(int limb, uint64 lo, uint64 hi) {
+    limbs_[limb] += lo;
+    uint64 carry = limbs_[limb] < lo;
+    for (int i = limb + 1; i < kLimbs; ++i) {
+      const uint64 addend = (i == limb + 1 ? hi : 0) + carry;
+      if (addend == 0) break;
+      limbs_[i] += addend;
+      carry = limbs_[i] < addend;
+    }
+  }
+
+  void Subtract(int limb, uint64 lo, uint64 hi) {
+    uint64 borrow = limbs_[limb] < lo;
+    limbs_[limb] -= lo;
+    for (int i = limb + 1; i < kLimbs; ++i) {
+      const uint64 subtrahend = (i == limb + 1 ? hi : 0) + borrow;
+      if (subtrahend == 0) break;
+      borrow = limbs_[i] < subtrahend;
+      limbs_[i] -= subtrahend;
+    }
+  }
+
+  // Two's complement, least significant limb first.
+  uint64 limbs_[kLimbs];
+  bool nar_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_POSIT_QUIRE_H_
@@ -0,0 +1,81 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/posit_quire.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+template <typename T>
+T FromBits(uint32 bits) {
+  T p;
+  p.value = static_cast<typename PositFormat<T>::Bits>(bits);
+  return p;
+}
+
+TEST(PositQuireTest, EmptyIsZero) {
+  PositQuire<posit16> quire;
+  EXPECT_EQ(0, quire.ToPosit().value);
+}
+
+TEST(PositQuireTest, SumIsExactBeforeRounding) {
+  // 1 + minpos rounds back to 1, but the quire keeps the minpos, so it is not
+  // lost when the 1 is cancelled afterwards.
+  PositQuire<posit16> quire;
+  quire.Add(posit16(1.0f));
+  quire.Add(FromBits<posit16>(1));
+  EXPECT_EQ(posit16(1.0f).value, quire.ToPosit().value);
+  quire.Add(posit16(-1.0f));
+  EXPECT_EQ(1, quire.ToPosit().value);
+}
+
+TEST(PositQuireTest, IsIndependentOfOrder) {
+  const float values[] = {1000.0f, 0.001f, -1000.0f, 3.0f, 0.001f};
+  PositQuire<posit32> forward, backward;
+  for (int i = 0; i < 5; ++i) {
+    forward.Add(posit32(values[i]));
+    backward.Add(posit32(values[4 - i]));
+  }
+  EXPECT_EQ(forward.ToPosit().value, backward.ToPosit().value);
+  EXPECT_NEAR(3.002f, static_cast<float>(forward.ToPosit()), 1e-6f);
+}
+
+TEST(PositQuireTest, MergesPartialSums) {
+  PositQuire<posit8> total, a, b;
+  for (int i = 0; i < 10; ++i) {
+    total.Add(posit8(0.5f));
+    total.Add(posit8(-1.0f));
+    a.Add(posit8(0.5f));
+    b.Add(posit8(-1.0f));
+  }
+  a.Add(b);
+  EXPECT_EQ(total.ToPosit().value, a.ToPosit().value);
+  EXPECT_EQ(-5.0f, static_cast<float>(a.ToPosit()));
+}
+
+TEST(PositQuireTest, SaturatesAndPropagatesNaR) {
+  PositQuire<posit16> quire;
+  const posit16 maxpos = FromBits<posit16>(0x7fff);
+  quire.Add(maxpos);
+  quire.Add(maxpos);
+  EXPECT_EQ(0x7fff, quire.ToPosit().value);
+  quire.Add(FromBits<posit16>(0x8000));
+  EXPECT_EQ(0x8000, quire.ToPosit().value);
+}
+
+}  // namespace
+}  // namespace tensorflow
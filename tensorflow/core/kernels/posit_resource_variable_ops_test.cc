@@ -0,0 +1,145 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/resource_var.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class PositResourceVariableOpsTest : public OpsTestBase {
+ protected:
+  // Adds a posit16 variable holding "data" as the resource input. The
+  // resource manager keeps the variable alive for the rest of the test.
+  Var* AddVariable(const TensorShape& shape, const std::vector<float>& data) {
+    Var* var = new Var(DT_POSIT16);
+    *var->tensor() = Tensor(DT_POSIT16, shape);
+    auto values = var->tensor()->flat<posit16>();
+    for (int i = 0; i < data.size(); ++i) {
+      values(i) = posit16(data[i]);
+    }
+    var->is_initialized = true;
+    AddResourceInput("", "var", var);
+    return var;
+  }
+
+  void ExpectVariable(Var* var, const std::vector<float>& expected) {
+    auto values = var->tensor()->flat<posit16>();
+    ASSERT_EQ(expected.size(), values.size());
+    for (int i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(expected[i], static_cast<float>(values(i))) << "at " << i;
+    }
+  }
+};
+
+TEST_F(PositResourceVariableOpsTest, GatherAndDecode) {
+  TF_ASSERT_OK(NodeDefBuilder("gather", "ResourceGatherAndDecode")
+                   .Input(FakeInput(DT_RESOURCE))
+                   .Input(FakeInput(DT_INT32))
+                   .Attr("dtype", DT_POSIT16)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddVariable(TensorShape({3, 2}), {0, 1, 2, 3, 4, 5});
+  AddInputFromArray<int32>(TensorShape({2, 2}), {2, 0, 1, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({2, 2, 2}));
+  test::FillValues<float>(&expected, {4, 5, 0, 1, 2, 3, 4, 5});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(PositResourceVariableOpsTest, GatherAndDecode_IndexOutOfRange) {
+  TF_ASSERT_OK(NodeDefBuilder("gather", "ResourceGatherAndDecode")
+                   .Input(FakeInput(DT_RESOURCE))
+                   .Input(FakeInput(DT_INT32))
+                   .Attr("dtype", DT_POSIT16)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddVariable(TensorShape({3, 2}), {0, 1, 2, 3, 4, 5});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 3});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(
+      str_util::StrContains(s.ToString(), "indices[1] = 3 is not in [0, 3)"))
+      << s;
+}
+
+class PositScatterAddAndEncodeTest : public PositResourceVariableOpsTest {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("scatter", "ResourceScatterAddAndEncode")
+                     .Input(FakeInput(DT_RESOURCE))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Attr("dtype", DT_POSIT16)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(PositScatterAddAndEncodeTest, AccumulatesDuplicateIndices) {
+  MakeOp();
+  Var* var = AddVariable(TensorShape({3, 2}), {0, 1, 2, 3, 4, 5});
+  AddInputFromArray<int32>(TensorShape({3}), {0, 2, 0});
+  AddInputFromArray<float>(TensorShape({3, 2}), {1, 1, 10, 20, 2, 3});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectVariable(var, {3, 5, 2, 3, 14, 25});
+}
+
+TEST_F(PositScatterAddAndEncodeTest, ScalarUpdate) {
+  MakeOp();
+  Var* var = AddVariable(TensorShape({3, 2}), {0, 1, 2, 3, 4, 5});
+  AddInputFromArray<int32>(TensorShape({1}), {1});
+  AddInputFromArray<float>(TensorShape({}), {0.5});
+  TF_ASSERT_OK(RunOpKernel());
+  ExpectVariable(var, {0, 1, 2.5, 3.5, 4, 5});
+}
+
+TEST_F(PositScatterAddAndEncodeTest, Error_WrongUpdatesShape) {
+  MakeOp();
+  Var* var = AddVariable(TensorShape({3, 2}), {0, 1, 2, 3, 4, 5});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 1});
+  // As many elements as indices.shape + params.shape[1:], but a different
+  // shape.
+  AddInputFromArray<float>(TensorShape({4}), {1, 1, 1, 1});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(str_util::StrContains(
+      s.ToString(), "Must have updates.shape = indices.shape + params.shape[1:]"))
+      << s;
+  ExpectVariable(var, {0, 1, 2, 3, 4, 5});
+}
+
+TEST_F(PositScatterAddAndEncodeTest, Error_IndexOutOfRange) {
+  MakeOp();
+  AddVariable(TensorShape({3, 2}), {0, 1, 2, 3, 4, 5});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 5});
+  AddInputFromArray<float>(TensorShape({2, 2}), {1, 1, 1, 1});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(
+      str_util::StrContains(s.ToString(), "indices[1] = 5 is not in [0, 3)"))
+      << s;
+}
+
+}  // namespace
+}  // namespace tensorflow
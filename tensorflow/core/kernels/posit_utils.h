@@ -0,0 +1,242 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_POSIT_UTILS_H_
+#define TENSORFLOW_CORE_KERNELS_POSIT_UTILS_H_
+
+// Helpers shared by the CPU kernels that specialize on posit types. Kernels
+// decode posit operands to float in blocks, do their arithmetic there, and
+// round once when writing the result back.
+
+#include <algorithm>
+#include <type_traits>
+
+#include "tensorflow/core/framework/bfloat16.h"
+#include "tensorflow/core/framework/numeric_types.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/posit16.h"
+#include "tensorflow/core/framework/posit32.h"
+#include "tensorflow/core/framework/posit8.h"
+#include "tensorflow/core/lib/core/posit_bits.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+// Number of elements decoded at a time into stack buffers.
+static constexpr int64 kPositDecodeBlockSize = 256;
+
+// True for posit8, posit16 and posit32.
+template <typename T>
+struct is_posit : std::false_type {};
+template <>
+struct is_posit<posit8> : std::true_type {};
+template <>
+struct is_posit<posit16> : std::true_type {};
+template <>
+struct is_posit<posit32> : std::true_type {};
+
+// True for the posit types whose values are all exact floats (posit8 and
+// posit16). Kernels that compute on decoded floats use it to keep posit32 on
+// its exact path.
+template <typename T>
+struct is_float_exact_posit
+    : std::integral_constant<bool, is_posit<T>::value &&
+                                       !std::is_same<T, posit32>::value> {};
+
+// The encoding parameters of each posit type.
+template <typename T>
+struct PositFormat;
+template <>
+struct PositFormat<posit8> {
+  typedef uint8 Bits;
+  static constexpr int kNBits = 8;
+  static constexpr int kES = 0;
+};
+template <>
+struct PositFormat<posit16> {
+  typedef uint16 Bits;
+  static constexpr int kNBits = 16;
+  static constexpr int kES = 1;
+};
+template <>
+struct PositFormat<posit32> {
+  typedef uint32 Bits;
+  static constexpr int kNBits = 32;
+  static constexpr int kES = 2;
+};
+
+// Overloads of the bulk converters in framework/posit*.h, so that templated
+// kernels can call them without naming the width.
+inline void PositToFloat(const posit8* src, float* dst, int64 size) {
+  Posit8ToFloat(src, dst, size);
+}
+inline void PositToFloat(const posit16* src, float* dst, int64 size) {
+  Posit16ToFloat(src, dst, size);
+}
+inline void PositToFloat(const posit32* src, float* dst, int64 size) {
+  Posit32ToFloat(src, dst, size);
+}
+
+inline void FloatToPosit(const float* src, posit8* dst, int64 size) {
+  FloatToPosit8(src, dst, size);
+}
+inline void FloatToPosit(const float* src, posit16* dst, int64 size) {
+  FloatToPosit16(src, dst, size);
+}
+inline void FloatToPosit(const float* src, posit32* dst, int64 size) {
+  FloatToPosit32(src, dst, size);
+}
+
+// Decodes "size" posits at "src" into "dst". The bfloat16 variant rounds the
+// decoded float to nearest even, matching Cast.
+template <typename T>
+void DecodePosits(const T* src, float* dst, int64 size) {
+  PositToFloat(src, dst, size);
+}
+
+template <typename T>
+void DecodePosits(const T* src, bfloat16* dst, int64 size) {
+  float buf[kPositDecodeBlockSize];
+  for (int64 start = 0; start < size; start += kPositDecodeBlockSize) {
+    const int64 n = std::min(kPositDecodeBlockSize, size - start);
+    PositToFloat(src + start, buf, n);
+    for (int64 i = 0; i < n; ++i) {
+      dst[start + i] = bfloat16(buf[i]);
+    }
+  }
+}
+
+// Decodes to double. Every posit, including posit32, is exactly representable
+// as a double, so kernels that compute in double use this instead of the float
+// converters.
+template <typename T>
+void DecodePosits(const T* src, double* dst, int64 size) {
+  for (int64 i = 0; i < size; ++i) {
+    dst[i] = static_cast<double>(src[i]);
+  }
+}
+
+// Rounds "size" values at "src" to nearest into "dst".
+template <typename T>
+void EncodePosits(const float* src, T* dst, int64 size) {
+  FloatToPosit(src, dst, size);
+}
+
+template <typename T>
+void EncodePosits(const double* src, T* dst, int64 size) {
+  for (int64 i = 0; i < size; ++i) {
+    dst[i] = T(src[i]);
+  }
+}
+
+// The type in which kernels that reuse a float implementation compute on
+// decoded posits. posit32 carries up to 27 fraction bits, more than a float
+// holds, so it is decoded to double instead.
+template <typename T>
+struct PositComputeType {
+  typedef float type;
+};
+template <>
+struct PositComputeType<posit32> {
+  typedef double type;
+};
+
+// Rounds "size" floats or doubles at "src" stochastically into "dst". Element
+// i consumes 32 bit sample "offset + i" of "gen", so the result depends only
+// on the generator state and the element index, not on how the work is
+// sharded. Doubles keep the bits of posit32 that a float would drop.
+template <typename T>
+typename PositFormat<T>::Bits StochasticPositBits(float f, uint32 random) {
+  typedef PositFormat<T> F;
+  return FloatToPositBitsStochastic<typename F::Bits, F::kNBits, F::kES>(
+      f, random);
+}
+
+template <typename T>
+typename PositFormat<T>::Bits StochasticPositBits(double d, uint32 random) {
+  typedef PositFormat<T> F;
+  return DoubleToPositBitsStochastic<typename F::Bits, F::kNBits, F::kES>(
+      d, random);
+}
+
+template <typename T, typename C>
+void StochasticEncodePosits(random::PhiloxRandom gen, int64 offset,
+                            const C* src, T* dst, int64 size) {
+  gen.Skip(offset / random::PhiloxRandom::kResultElementCount);
+  int lane = offset % random::PhiloxRandom::kResultElementCount;
+  random::PhiloxRandom::ResultType sample = gen();
+  for (int64 i = 0; i < size; ++i) {
+    if (lane == random::PhiloxRandom::kResultElementCount) {
+      sample = gen();
+      lane = 0;
+    }
+    dst[i].value = StochasticPositBits<T>(src[i], sample[lane++]);
+  }
+}
+
+// Computes var += scale * delta over "size" posits in PositComputeType<T> and
+// rounds each result stochastically with sample i of "gen", sharded over the
+// CPU worker threads of "ctx". Shared by the stochastic assign and gradient
+// descent kernels.
+template <typename T>
+void ParallelStochasticPositAxpy(OpKernelContext* ctx, random::PhiloxRandom gen,
+                                 float scale, const T* delta, T* var,
+                                 int64 size) {
+  typedef typename PositComputeType<T>::type C;
+  auto work = [=](int64 start, int64 limit) {
+    C var_buf[kPositDecodeBlockSize];
+    C delta_buf[kPositDecodeBlockSize];
+    for (int64 b = start; b < limit; b += kPositDecodeBlockSize) {
+      const int64 n = std::min(kPositDecodeBlockSize, limit - b);
+      DecodePosits(var + b, var_buf, n);
+      DecodePosits(delta + b, delta_buf, n);
+      for (int64 i = 0; i < n; ++i) {
+        var_buf[i] += static_cast<C>(scale) * delta_buf[i];
+      }
+      StochasticEncodePosits(gen, b, var_buf, var + b, n);
+    }
+  };
+  const auto& worker_threads = *ctx->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads.num_threads, worker_threads.workers, size,
+        /*cost_per_unit=*/20, work);
+}
+
+// Like DecodePosits and EncodePosits, but sharded over the CPU worker threads
+// of "ctx". Used by kernels that convert whole operands up front.
+template <typename T, typename C>
+void ParallelDecodePosits(OpKernelContext* ctx, const T* src, C* dst,
+                          int64 size) {
+  const auto& worker_threads = *ctx->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads.num_threads, worker_threads.workers, size,
+        /*cost_per_unit=*/4, [src, dst](int64 start, int64 limit) {
+          DecodePosits(src + start, dst + start, limit - start);
+        });
+}
+
+template <typename T, typename C>
+void ParallelEncodePosits(OpKernelContext* ctx, const C* src, T* dst,
+                          int64 size) {
+  const auto& worker_threads = *ctx->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads.num_threads, worker_threads.workers, size,
+        /*cost_per_unit=*/10, [src, dst](int64 start, int64 limit) {
+          EncodePosits(src + start, dst + start, limit - start);
+        });
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_POSIT_UTILS_H_
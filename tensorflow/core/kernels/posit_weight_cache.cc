@@ -0,0 +1,81 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/posit_weight_cache.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+namespace {
+
+int64 BudgetBytes() {
+  static const int64 budget = [] {
+    int64 megabytes = 0;
+    Status s = ReadInt64FromEnvVar("TF_POSIT_WEIGHT_CACHE_MB", 256, &megabytes);
+    if (!s.ok()) {
+      LOG(ERROR) << s;
+      megabytes = 256;
+    }
+    return std::max<int64>(megabytes, 0) << 20;
+  }();
+  return budget;
+}
+
+std::atomic<int64> bytes_in_use(0);
+
+}  // namespace
+
+PositWeightCache::~PositWeightCache() {
+  mutex_lock l(mu_);
+  Clear();
+}
+
+bool PositWeightCache::Reserve(int64 bytes) {
+  const int64 budget = BudgetBytes();
+  int64 in_use = bytes_in_use.load(std::memory_order_relaxed);
+  do {
+    if (in_use + bytes > budget) return false;
+  } while (!bytes_in_use.compare_exchange_weak(in_use, in_use + bytes,
+                                               std::memory_order_relaxed));
+  return true;
+}
+
+void PositWeightCache::Release(int64 bytes) {
+  bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool PositWeightCache::Matches(const Tensor& weights,
+                               DataType decoded_type) const {
+  return decoded_.IsInitialized() && decoded_.dtype() == decoded_type &&
+         weights_.SharesBufferWith(weights) &&
+         weights_.tensor_data().data() == weights.tensor_data().data() &&
+         weights_.shape() == weights.shape() &&
+         mutation_count_ == weights.BufferMutationCount();
+}
+
+void PositWeightCache::Clear() {
+  if (reserved_bytes_ > 0) Release(reserved_bytes_);
+  weights_ = Tensor();
+  mutation_count_ = 0;
+  decoded_ = Tensor();
+  reserved_bytes_ = 0;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,119 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_POSIT_WEIGHT_CACHE_H_
+#define TENSORFLOW_CORE_KERNELS_POSIT_WEIGHT_CACHE_H_
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/posit_utils.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Keeps the decoding of a posit weight operand across Compute calls, for
+// kernels whose weights are constants or variables that change at most once
+// per step.
+//
+// The entry holds a reference to the weights' buffer and is reused only while
+// the operand is that same buffer and no kernel has taken mutable access to it
+// through a ref input since it was filled (Tensor::BufferMutationCount()).
+// Holding the reference makes resource variable updates copy the variable
+// before writing it, so every update shows up as a new buffer. Decoded buffers
+// come from the CPU allocator, and all caches in the process share a budget of
+// TF_POSIT_WEIGHT_CACHE_MB megabytes (default 256). Weights that do not fit
+// are decoded into a temporary on every call.
+class PositWeightCache {
+ public:
+  PositWeightCache() {}
+  ~PositWeightCache();
+
+  // Sets "*decoded" to a tensor of type C (float or double) holding the values
+  // of "weights", which must be of type T. The caller must not modify
+  // "*decoded".
+  template <typename T, typename C = float>
+  Status GetDecoded(OpKernelContext* ctx, const Tensor& weights,
+                    Tensor* decoded);
+
+ private:
+  // Charges or returns "bytes" against the process-wide budget.
+  static bool Reserve(int64 bytes);
+  static void Release(int64 bytes);
+
+  bool Matches(const Tensor& weights, DataType decoded_type) const
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void Clear() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  mutex mu_;
+  Tensor weights_ GUARDED_BY(mu_);
+  uint64 mutation_count_ GUARDED_BY(mu_) = 0;
+  Tensor decoded_ GUARDED_BY(mu_);
+  int64 reserved_bytes_ GUARDED_BY(mu_) = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(PositWeightCache);
+};
+
+template <typename T, typename C>
+Status PositWeightCache::GetDecoded(OpKernelContext* ctx,
+                                    const Tensor& weights, Tensor* decoded) {
+  const DataType decoded_type = DataTypeToEnum<C>::value;
+  // Read before decoding: a ref update that races with the decode bumps the
+  // count, so the next call decodes again.
+  const uint64 mutation_count = weights.BufferMutationCount();
+  {
+    mutex_lock l(mu_);
+    if (Matches(weights, decoded_type)) {
+      *decoded = decoded_;
+      return Status::OK();
+    }
+    Clear();
+  }
+
+  const int64 bytes = weights.NumElements() * sizeof(C);
+  Tensor fresh;
+  bool cached = false;
+  if (Reserve(bytes)) {
+    fresh = Tensor(cpu_allocator(), decoded_type, weights.shape());
+    cached = fresh.IsInitialized();
+    if (!cached) Release(bytes);
+  }
+  if (!cached) {
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_temp(decoded_type, weights.shape(), &fresh));
+  }
+  ParallelDecodePosits(ctx, weights.flat<T>().data(), fresh.flat<C>().data(),
+                       weights.NumElements());
+
+  if (cached) {
+    mutex_lock l(mu_);
+    Clear();
+    weights_ = weights;
+    mutation_count_ = mutation_count;
+    decoded_ = fresh;
+    reserved_bytes_ = bytes;
+  }
+  *decoded = fresh;
+  return Status::OK();
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_POSIT_WEIGHT_CACHE_H_
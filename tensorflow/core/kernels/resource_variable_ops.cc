@@ -60,14 +60,18 @@ limitations under the License.
 #include "tensorflow/core/kernels/bounds_check.h"
 #include "tensorflow/core/kernels/dense_update_functor.h"
 #include "tensorflow/core/kernels/gather_functor.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/kernels/scatter_functor.h"
 #include "tensorflow/core/kernels/training_op_helpers.h"
 #include "tensorflow/core/kernels/variable_ops.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/guarded_philox_random.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -407,6 +411,65 @@ TF_CALL_int64(REGISTER_GPU_KERNELS);
 #undef REGISTER_GPU_KERNELS
 #endif  // GOOGLE_CUDA
 
+// Adds or subtracts "value" into a posit variable in float and rounds each
+// sum stochastically, so that updates smaller than the posit spacing still
+// move the variable in expectation.
+template <typename T, DenseUpdateType Op>
+class StochasticAssignUpdateVariableOp : public OpKernel {
+ public:
+  explicit StochasticAssignUpdateVariableOp(OpKernelConstruction* c)
+      : OpKernel(c) {
+    OP_REQUIRES_OK(c, generator_.Init(c));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    Var* variable = nullptr;
+    OP_REQUIRES_OK(context, LookupResource(context, HandleFromInput(context, 0),
+                                           &variable));
+    core::ScopedUnref s(variable);
+
+    const Tensor& value = context->input(1);
+    mutex_lock ml(*variable->mu());
+    Tensor* var_tensor = variable->tensor();
+    OP_REQUIRES(context, var_tensor->dtype() == DataTypeToEnum<T>::v(),
+                errors::InvalidArgument(
+                    "Trying to update a variable of type ",
+                    DataTypeString(var_tensor->dtype()), " as ",
+                    DataTypeString(DataTypeToEnum<T>::v())));
+    OP_REQUIRES(context, var_tensor->shape().IsSameSize(value.shape()),
+                errors::InvalidArgument(
+                    "Cannot update variable with shape ",
+                    var_tensor->shape().DebugString(),
+                    " using a Tensor with shape ",
+                    value.shape().DebugString(), ", shapes must be equal."));
+    OP_REQUIRES_OK(context,
+                   PrepareToUpdateVariable<CPUDevice, T>(context, var_tensor));
+
+    const int64 size = value.NumElements();
+    if (size == 0) return;
+    ParallelStochasticPositAxpy(context, generator_.ReserveSamples32(size),
+                                Op == ADD ? 1.0f : -1.0f,
+                                value.flat<T>().data(),
+                                var_tensor->flat<T>().data(), size);
+  }
+
+ private:
+  GuardedPhiloxRandom generator_;
+};
+
+#define REGISTER_KERNELS(type)                                         \
+  REGISTER_KERNEL_BUILDER(Name("StochasticAssignAddVariableOp")         \
+                              .Device(DEVICE_CPU)                       \
+                              .TypeConstraint<type>("dtype"),           \
+                          StochasticAssignUpdateVariableOp<type, ADD>); \
+  REGISTER_KERNEL_BUILDER(Name("StochasticAssignSubVariableOp")         \
+                              .Device(DEVICE_CPU)                       \
+                              .TypeConstraint<type>("dtype"),           \
+                          StochasticAssignUpdateVariableOp<type, SUB>);
+
+TF_CALL_POSIT_TYPES(REGISTER_KERNELS);
+#undef REGISTER_KERNELS
+
 class VarIsInitializedOp : public OpKernel {
  public:
   explicit VarIsInitializedOp(OpKernelConstruction* c) : OpKernel(c) {}
@@ -554,6 +617,86 @@ REGISTER_KERNEL_BUILDER(Name("ResourceGather")
 #undef REGISTER_GATHER_ALL_INDICES
 #undef REGISTER_GATHER_FULL
 
+// Like ResourceGather, but decodes the gathered rows of a posit variable to
+// OutT while copying them out of the variable.
+template <typename T, typename OutT, typename Index>
+class ResourceGatherAndDecodeOp : public OpKernel {
+ public:
+  explicit ResourceGatherAndDecodeOp(OpKernelConstruction* c) : OpKernel(c) {}
+
+  void Compute(OpKernelContext* c) override {
+    Var* v = nullptr;
+    OP_REQUIRES_OK(c, LookupResource(c, HandleFromInput(c, 0), &v));
+    core::ScopedUnref su(v);
+    // See ResourceGatherOp for why the lock is held for the whole gather.
+    tf_shared_lock ml(*v->mu());
+    const Tensor& params = *v->tensor();
+    const Tensor& indices = c->input(1);
+    OP_REQUIRES(
+        c, TensorShapeUtils::IsVectorOrHigher(params.shape()),
+        errors::InvalidArgument("params must be at least 1 dimensional"));
+    OP_REQUIRES(c, params.dtype() == DataTypeToEnum<T>::v(),
+                errors::InvalidArgument(
+                    "Trying to gather from a variable of type ",
+                    DataTypeString(params.dtype()), " as ",
+                    DataTypeString(DataTypeToEnum<T>::v())));
+
+    // Check that we have enough index space
+    const int64 N = indices.NumElements();
+    OP_REQUIRES(
+        c, params.dim_size(0) <= std::numeric_limits<Index>::max(),
+        errors::InvalidArgument("params.shape[0] too large for ",
+                                DataTypeString(DataTypeToEnum<Index>::v()),
+                                " indexing: ", params.dim_size(0), " > ",
+                                std::numeric_limits<Index>::max()));
+
+    // The result shape is indices.shape + params.shape[1:].
+    TensorShape result_shape = indices.shape();
+    int64 inner_size = 1;
+    for (int i = 1; i < params.dims(); i++) {
+      result_shape.AddDim(params.dim_size(i));
+      inner_size *= params.dim_size(i);
+    }
+
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(c, c->allocate_output(0, result_shape, &out));
+    if (N > 0 && inner_size > 0) {
+      auto params_flat = params.shaped<T, 2>({params.dim_size(0), inner_size});
+      auto indices_flat = indices.flat<Index>();
+      auto out_flat = out->shaped<OutT, 2>({N, inner_size});
+
+      functor::GatherDecodeFunctorCPU<T, OutT, Index> functor;
+      int64 bad_i = functor(c, params_flat, indices_flat, out_flat);
+
+      OP_REQUIRES(
+          c, bad_i < 0,
+          errors::InvalidArgument(
+              "indices", SliceDebugString(indices.shape(), bad_i), " = ",
+              indices_flat(bad_i), " is not in [0, ", params.dim_size(0), ")"));
+    }
+  }
+};
+
+#define REGISTER_GATHER_DECODE_FULL(type, out_type, index_type)        \
+  REGISTER_KERNEL_BUILDER(Name("ResourceGatherAndDecode")              \
+                              .Device(DEVICE_CPU)                      \
+                              .HostMemory("resource")                  \
+                              .TypeConstraint<type>("dtype")           \
+                              .TypeConstraint<out_type>("Tout")        \
+                              .TypeConstraint<index_type>("Tindices"), \
+                          ResourceGatherAndDecodeOp<type, out_type, index_type>)
+
+#define REGISTER_GATHER_DECODE_CPU(type)              \
+  REGISTER_GATHER_DECODE_FULL(type, float, int32);    \
+  REGISTER_GATHER_DECODE_FULL(type, float, int64);    \
+  REGISTER_GATHER_DECODE_FULL(type, bfloat16, int32); \
+  REGISTER_GATHER_DECODE_FULL(type, bfloat16, int64)
+
+TF_CALL_POSIT_TYPES(REGISTER_GATHER_DECODE_CPU);
+
+#undef REGISTER_GATHER_DECODE_CPU
+#undef REGISTER_GATHER_DECODE_FULL
+
 template <typename Device, typename T, typename Index, scatter_op::UpdateOp op>
 class ResourceScatterUpdateOp : public OpKernel {
  public:
@@ -703,6 +846,108 @@ REGISTER_KERNEL_BUILDER(Name("ResourceScatterUpdate")
 
 #endif  // GOOGLE_CUDA
 
+// Adds float or bfloat16 "updates" into rows of a posit variable. Each row is
+// decoded, accumulated in float and encoded again, so every touched element is
+// rounded once instead of once for the Cast and once for the posit add.
+template <typename T, typename UpdT, typename Index>
+class ResourceScatterAddAndEncodeOp : public OpKernel {
+ public:
+  explicit ResourceScatterAddAndEncodeOp(OpKernelConstruction* c)
+      : OpKernel(c) {}
+
+  void Compute(OpKernelContext* c) override {
+    Var* v = nullptr;
+    OP_REQUIRES_OK(c, LookupResource(c, HandleFromInput(c, 0), &v));
+    core::ScopedUnref unref_v(v);
+    mutex_lock ml(*v->mu());
+    Tensor* params = v->tensor();
+    OP_REQUIRES(c, params->dtype() == DataTypeToEnum<T>::v(),
+                errors::InvalidArgument(
+                    "Trying to update a variable of type ",
+                    DataTypeString(params->dtype()), " as ",
+                    DataTypeString(DataTypeToEnum<T>::v())));
+    OP_REQUIRES(
+        c, TensorShapeUtils::IsVectorOrHigher(params->shape()),
+        errors::InvalidArgument("params must be at least 1 dimensional"));
+    OP_REQUIRES_OK(c, PrepareToUpdateVariable<CPUDevice, T>(c, params));
+    const Tensor& indices = c->input(1);
+    const Tensor& updates = c->input(2);
+
+    // Check that we have enough index space
+    const int64 N = indices.NumElements();
+    OP_REQUIRES(
+        c, params->dim_size(0) <= std::numeric_limits<Index>::max(),
+        errors::InvalidArgument("params.shape[0] too large for ",
+                                DataTypeString(DataTypeToEnum<Index>::v()),
+                                " indexing: ", params->dim_size(0), " > ",
+                                std::numeric_limits<Index>::max()));
+    // updates must be a scalar or have shape indices.shape + params.shape[1:].
+    const bool scalar_update = TensorShapeUtils::IsScalar(updates.shape());
+    TensorShape expected_updates_shape = indices.shape();
+    for (int i = 1; i < params->dims(); i++) {
+      expected_updates_shape.AddDim(params->dim_size(i));
+    }
+    OP_REQUIRES(c, scalar_update || updates.shape() == expected_updates_shape,
+                errors::InvalidArgument(
+                    "Must have updates.shape = indices.shape + "
+                    "params.shape[1:] or updates.shape = [], got ",
+                    "updates.shape ", updates.shape().DebugString(),
+                    ", indices.shape ", indices.shape().DebugString(),
+                    ", params.shape ", params->shape().DebugString()));
+    if (N == 0) return;
+
+    auto indices_flat = indices.flat<Index>();
+    auto params_flat = params->flat_outer_dims<T>();
+    const int64 slice_elems = params_flat.dimension(1);
+    const UpdT* updates_base = updates.flat<UpdT>().data();
+    const Index limit = static_cast<Index>(params_flat.dimension(0));
+
+    // Duplicate indices must accumulate in order, so rows are updated
+    // serially, as in ScatterFunctor on CPU.
+    float buf[kPositDecodeBlockSize];
+    for (int64 i = 0; i < N; ++i) {
+      const Index index = internal::SubtleMustCopy(indices_flat(i));
+      OP_REQUIRES(c, FastBoundsCheck(index, limit),
+                  errors::InvalidArgument(
+                      "indices", SliceDebugString(indices.shape(), i), " = ",
+                      index, " is not in [0, ", params->dim_size(0), ")"));
+      T* row = &params_flat(index, 0);
+      const UpdT* update = scalar_update ? updates_base
+                                         : updates_base + i * slice_elems;
+      for (int64 start = 0; start < slice_elems;
+           start += kPositDecodeBlockSize) {
+        const int64 n = std::min(kPositDecodeBlockSize, slice_elems - start);
+        PositToFloat(row + start, buf, n);
+        for (int64 j = 0; j < n; ++j) {
+          buf[j] += static_cast<float>(
+              scalar_update ? update[0] : update[start + j]);
+        }
+        FloatToPosit(buf, row + start, n);
+      }
+    }
+  }
+};
+
+#define REGISTER_SCATTER_ENCODE_FULL(type, update_type, index_type)       \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("ResourceScatterAddAndEncode")                                 \
+          .Device(DEVICE_CPU)                                             \
+          .HostMemory("resource")                                         \
+          .TypeConstraint<type>("dtype")                                  \
+          .TypeConstraint<update_type>("Tupdates")                        \
+          .TypeConstraint<index_type>("Tindices"),                        \
+      ResourceScatterAddAndEncodeOp<type, update_type, index_type>)
+
+#define REGISTER_SCATTER_ENCODE_CPU(type)                \
+  REGISTER_SCATTER_ENCODE_FULL(type, float, int32);      \
+  REGISTER_SCATTER_ENCODE_FULL(type, float, int64);      \
+  REGISTER_SCATTER_ENCODE_FULL(type, bfloat16, int32);   \
+  REGISTER_SCATTER_ENCODE_FULL(type, bfloat16, int64)
+
+TF_CALL_POSIT_TYPES(REGISTER_SCATTER_ENCODE_CPU);
+
+#undef REGISTER_SCATTER_ENCODE_CPU
+#undef REGISTER_SCATTER_ENCODE_FULL
 #undef REGISTER_SCATTER_ARITHMETIC
 #undef REGISTER_SCATTER_ARITHMETIC_CPU
 #undef REGISTER_SCATTER_MINMAX
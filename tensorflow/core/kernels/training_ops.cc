@@ -21,13 +21,18 @@ limitations under the License.
 #include "tensorflow/core/lib/posit32/posit32.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/kernels/bounds_check.h"
+#include "tensorflow/core/kernels/posit_utils.h"
 #include "tensorflow/core/kernels/training_op_helpers.h"
 #include "tensorflow/core/kernels/training_ops.h"
 #include "tensorflow/core/kernels/variable_ops.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/util/guarded_philox_random.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #ifdef TENSORFLOW_USE_SYCL
 #include "tensorflow/core/common_runtime/sycl/sycl_util.h"
@@ -2822,6 +2827,544 @@ REGISTER_KERNELS(GPU, double);
 #undef REGISTER_CPU_KERNELS
 #undef REGISTER_KERNELS
 
+// Per-element updates shared by the *WithMaster and *Stochastic posit
+// kernels, which differ only in where the weight lives and how the results
+// are rounded back to posits. C is the type the update is computed in. Each
+// updates the optimizer state in place and returns the weight decrement.
+template <typename C>
+struct PositMomentumUpdate {
+  C lr;
+  C momentum;
+  bool use_nesterov;
+
+  C operator()(C g, C* accum) const {
+    const C a = *accum * momentum + g;
+    *accum = a;
+    return use_nesterov ? g * lr + a * momentum * lr : a * lr;
+  }
+};
+
+template <typename C>
+struct PositAdamUpdate {
+  C alpha;  // lr * sqrt(1 - beta2_power) / (1 - beta1_power)
+  C beta1;
+  C beta2;
+  C epsilon;
+  bool use_nesterov;
+
+  C operator()(C g, C* m, C* v) const {
+    const C m_i = *m + (g - *m) * (C(1) - beta1);
+    const C v_i = *v + (g * g - *v) * (C(1) - beta2);
+    *m = m_i;
+    *v = v_i;
+    const C step = use_nesterov ? g * (C(1) - beta1) + beta1 * m_i : m_i;
+    return step * alpha / (std::sqrt(v_i) + epsilon);
+  }
+};
+
+// Kernels for the *WithMaster variants of the optimizers. The variable and
+// the optimizer state are posits, and the update is applied to a master copy
+// of the variable in M (float or double), so that updates smaller than the
+// posit spacing of the weights are not lost. Posit operands are decoded into M
+// a block at a time and written back once per step; with a double master the
+// decode is exact for every posit width.
+template <typename T, typename M>
+class ApplyMomentumWithMasterOp : public OpKernel {
+ public:
+  explicit ApplyMomentumWithMasterOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    auto locks = MaybeLockVariableInputMutexesInOrder(ctx, use_exclusive_lock_,
+                                                      {0, 1, 2});
+
+    Tensor var;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 0, use_exclusive_lock_, false, &var));
+    Tensor master;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, M>(
+                            ctx, 1, use_exclusive_lock_, false, &master));
+    Tensor accum;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 2, use_exclusive_lock_, false, &accum));
+    OP_REQUIRES(
+        ctx, var.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(0)));
+    OP_REQUIRES(
+        ctx, master.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(1)));
+    OP_REQUIRES(
+        ctx, accum.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(2)));
+
+    const Tensor& lr = ctx->input(3);
+    const Tensor& grad = ctx->input(4);
+    const Tensor& momentum = ctx->input(5);
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
+                errors::InvalidArgument("lr is not a scalar: ",
+                                        lr.shape().DebugString()));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(momentum.shape()),
+                errors::InvalidArgument("momentum is not a scalar: ",
+                                        momentum.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(master.shape()),
+        errors::InvalidArgument("var and master do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                master.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(accum.shape()),
+        errors::InvalidArgument("var and accum do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                accum.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(grad.shape()),
+        errors::InvalidArgument("var and grad do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                grad.shape().DebugString()));
+
+    const PositMomentumUpdate<M> update{
+        lr.scalar<M>()(), momentum.scalar<M>()(), use_nesterov_};
+    T* var_data = var.flat<T>().data();
+    M* master_data = master.flat<M>().data();
+    T* accum_data = accum.flat<T>().data();
+    const T* grad_data = grad.flat<T>().data();
+
+    auto work = [=](int64 start, int64 limit) {
+      M accum_buf[kPositDecodeBlockSize];
+      M grad_buf[kPositDecodeBlockSize];
+      for (int64 b = start; b < limit; b += kPositDecodeBlockSize) {
+        const int64 n = std::min(kPositDecodeBlockSize, limit - b);
+        DecodePosits(accum_data + b, accum_buf, n);
+        DecodePosits(grad_data + b, grad_buf, n);
+        for (int64 i = 0; i < n; ++i) {
+          M& w = master_data[b + i];
+          w -= update(grad_buf[i], &accum_buf[i]);
+          // grad_buf is dead from here on; reuse it for the new weights.
+          grad_buf[i] = w;
+        }
+        EncodePosits(accum_buf, accum_data + b, n);
+        EncodePosits(grad_buf, var_data + b, n);
+      }
+    };
+    const auto& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          var.NumElements(), 20, work);
+  }
+
+ private:
+  bool use_exclusive_lock_;
+  bool use_nesterov_;
+};
+
+template <typename T, typename M>
+class ApplyAdamWithMasterOp : public OpKernel {
+ public:
+  explicit ApplyAdamWithMasterOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    auto locks = MaybeLockVariableInputMutexesInOrder(ctx, use_exclusive_lock_,
+                                                      {0, 1, 2, 3});
+
+    Tensor var;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 0, use_exclusive_lock_, false, &var));
+    Tensor master;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, M>(
+                            ctx, 1, use_exclusive_lock_, false, &master));
+    Tensor m;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 2, use_exclusive_lock_, false, &m));
+    Tensor v;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 3, use_exclusive_lock_, false, &v));
+    OP_REQUIRES(
+        ctx, var.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(0)));
+    OP_REQUIRES(
+        ctx, master.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(1)));
+    OP_REQUIRES(
+        ctx, m.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(2)));
+    OP_REQUIRES(
+        ctx, v.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(3)));
+
+    static const char* const kScalarNames[] = {
+        "beta1_power", "beta2_power", "lr", "beta1", "beta2", "epsilon"};
+    M scalars[6];
+    for (int i = 0; i < 6; ++i) {
+      const Tensor& t = ctx->input(4 + i);
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(t.shape()),
+                  errors::InvalidArgument(kScalarNames[i], " is not a scalar: ",
+                                          t.shape().DebugString()));
+      scalars[i] = t.scalar<M>()();
+    }
+    const M beta1_power = scalars[0];
+    const M beta2_power = scalars[1];
+    const M lr = scalars[2];
+    const M beta1 = scalars[3];
+    const M beta2 = scalars[4];
+    const M epsilon = scalars[5];
+
+    const Tensor& grad = ctx->input(10);
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(master.shape()),
+        errors::InvalidArgument("var and master do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                master.shape().DebugString()));
+    OP_REQUIRES(ctx, var.shape().IsSameSize(m.shape()),
+                errors::InvalidArgument("var and m do not have the same shape",
+                                        var.shape().DebugString(), " ",
+                                        m.shape().DebugString()));
+    OP_REQUIRES(ctx, var.shape().IsSameSize(v.shape()),
+                errors::InvalidArgument("var and v do not have the same shape",
+                                        var.shape().DebugString(), " ",
+                                        v.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(grad.shape()),
+        errors::InvalidArgument("var and grad do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                grad.shape().DebugString()));
+
+    const PositAdamUpdate<M> update{
+        lr * std::sqrt(M(1) - beta2_power) / (M(1) - beta1_power), beta1,
+        beta2, epsilon, use_nesterov_};
+    T* var_data = var.flat<T>().data();
+    M* master_data = master.flat<M>().data();
+    T* m_data = m.flat<T>().data();
+    T* v_data = v.flat<T>().data();
+    const T* grad_data = grad.flat<T>().data();
+
+    auto work = [=](int64 start, int64 limit) {
+      M m_buf[kPositDecodeBlockSize];
+      M v_buf[kPositDecodeBlockSize];
+      M grad_buf[kPositDecodeBlockSize];
+      for (int64 b = start; b < limit; b += kPositDecodeBlockSize) {
+        const int64 n = std::min(kPositDecodeBlockSize, limit - b);
+        DecodePosits(m_data + b, m_buf, n);
+        DecodePosits(v_data + b, v_buf, n);
+        DecodePosits(grad_data + b, grad_buf, n);
+        for (int64 i = 0; i < n; ++i) {
+          M& w = master_data[b + i];
+          w -= update(grad_buf[i], &m_buf[i], &v_buf[i]);
+          // grad_buf is dead from here on; reuse it for the new weights.
+          grad_buf[i] = w;
+        }
+        EncodePosits(m_buf, m_data + b, n);
+        EncodePosits(v_buf, v_data + b, n);
+        EncodePosits(grad_buf, var_data + b, n);
+      }
+    };
+    const auto& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          var.NumElements(), 40, work);
+  }
+
+ private:
+  bool use_exclusive_lock_;
+  bool use_nesterov_;
+};
+
+#define REGISTER_KERNELS(T, M)                                    \
+  REGISTER_KERNEL_BUILDER(Name("ResourceApplyMomentumWithMaster") \
+                              .Device(DEVICE_CPU)                 \
+                              .TypeConstraint<T>("T")             \
+                              .TypeConstraint<M>("master_dtype"), \
+                          ApplyMomentumWithMasterOp<T, M>);       \
+  REGISTER_KERNEL_BUILDER(Name("ResourceApplyAdamWithMaster")     \
+                              .Device(DEVICE_CPU)                 \
+                              .TypeConstraint<T>("T")             \
+                              .TypeConstraint<M>("master_dtype"), \
+                          ApplyAdamWithMasterOp<T, M>);
+#define REGISTER_CPU_KERNELS(T) \
+  REGISTER_KERNELS(T, float);   \
+  REGISTER_KERNELS(T, double);
+
+TF_CALL_POSIT_TYPES(REGISTER_CPU_KERNELS);
+
+#undef REGISTER_CPU_KERNELS
+#undef REGISTER_KERNELS
+
+// Kernels for the *Stochastic variants of the optimizers. Variable and
+// optimizer state are posits with no master copy; each step decodes them to
+// PositComputeType<T> (double for posit32, float otherwise), applies the same
+// update as the *WithMaster kernels and rounds every result stochastically,
+// so that updates below the posit spacing are kept in expectation. Element i
+// of the k-th output uses 32 bit sample k * size + i of the kernel's Philox
+// stream, which makes a step reproducible for given seeds regardless of
+// sharding.
+template <typename T>
+class ApplyGradientDescentStochasticOp : public OpKernel {
+ public:
+  explicit ApplyGradientDescentStochasticOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, generator_.Init(ctx));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    auto locks =
+        MaybeLockVariableInputMutexesInOrder(ctx, use_exclusive_lock_, {0});
+    Tensor var;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 0, use_exclusive_lock_, false, &var));
+    OP_REQUIRES(
+        ctx, var.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(0)));
+    const Tensor& alpha = ctx->input(1);
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(alpha.shape()),
+                errors::InvalidArgument("alpha is not a scalar: ",
+                                        alpha.shape().DebugString()));
+    const Tensor& delta = ctx->input(2);
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(delta.shape()),
+        errors::InvalidArgument("var and delta do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                delta.shape().DebugString()));
+
+    const int64 size = var.NumElements();
+    if (size == 0) return;
+    ParallelStochasticPositAxpy(ctx, generator_.ReserveSamples32(size),
+                                -alpha.scalar<float>()(),
+                                delta.flat<T>().data(), var.flat<T>().data(),
+                                size);
+  }
+
+ private:
+  bool use_exclusive_lock_;
+  GuardedPhiloxRandom generator_;
+};
+
+template <typename T>
+class ApplyMomentumStochasticOp : public OpKernel {
+ public:
+  explicit ApplyMomentumStochasticOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+    OP_REQUIRES_OK(ctx, generator_.Init(ctx));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    auto locks =
+        MaybeLockVariableInputMutexesInOrder(ctx, use_exclusive_lock_, {0, 1});
+
+    Tensor var;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 0, use_exclusive_lock_, false, &var));
+    Tensor accum;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 1, use_exclusive_lock_, false, &accum));
+    OP_REQUIRES(
+        ctx, var.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(0)));
+    OP_REQUIRES(
+        ctx, accum.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(1)));
+
+    const Tensor& lr = ctx->input(2);
+    const Tensor& grad = ctx->input(3);
+    const Tensor& momentum = ctx->input(4);
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
+                errors::InvalidArgument("lr is not a scalar: ",
+                                        lr.shape().DebugString()));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(momentum.shape()),
+                errors::InvalidArgument("momentum is not a scalar: ",
+                                        momentum.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(accum.shape()),
+        errors::InvalidArgument("var and accum do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                accum.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(grad.shape()),
+        errors::InvalidArgument("var and grad do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                grad.shape().DebugString()));
+
+    const int64 size = var.NumElements();
+    if (size == 0) return;
+    typedef typename PositComputeType<T>::type C;
+    const PositMomentumUpdate<C> update{
+        lr.scalar<float>()(), momentum.scalar<float>()(), use_nesterov_};
+    T* var_data = var.flat<T>().data();
+    T* accum_data = accum.flat<T>().data();
+    const T* grad_data = grad.flat<T>().data();
+    random::PhiloxRandom gen = generator_.ReserveSamples32(2 * size);
+
+    auto work = [=](int64 start, int64 limit) {
+      C var_buf[kPositDecodeBlockSize];
+      C accum_buf[kPositDecodeBlockSize];
+      C grad_buf[kPositDecodeBlockSize];
+      for (int64 b = start; b < limit; b += kPositDecodeBlockSize) {
+        const int64 n = std::min(kPositDecodeBlockSize, limit - b);
+        DecodePosits(var_data + b, var_buf, n);
+        DecodePosits(accum_data + b, accum_buf, n);
+        DecodePosits(grad_data + b, grad_buf, n);
+        for (int64 i = 0; i < n; ++i) {
+          var_buf[i] -= update(grad_buf[i], &accum_buf[i]);
+        }
+        StochasticEncodePosits(gen, b, accum_buf, accum_data + b, n);
+        StochasticEncodePosits(gen, size + b, var_buf, var_data + b, n);
+      }
+    };
+    const auto& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, size, 40, work);
+  }
+
+ private:
+  bool use_exclusive_lock_;
+  bool use_nesterov_;
+  GuardedPhiloxRandom generator_;
+};
+
+template <typename T>
+class ApplyAdamStochasticOp : public OpKernel {
+ public:
+  explicit ApplyAdamStochasticOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+    OP_REQUIRES_OK(ctx, generator_.Init(ctx));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    auto locks = MaybeLockVariableInputMutexesInOrder(ctx, use_exclusive_lock_,
+                                                      {0, 1, 2});
+
+    Tensor var;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 0, use_exclusive_lock_, false, &var));
+    Tensor m;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 1, use_exclusive_lock_, false, &m));
+    Tensor v;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 2, use_exclusive_lock_, false, &v));
+    OP_REQUIRES(
+        ctx, var.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(0)));
+    OP_REQUIRES(
+        ctx, m.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(1)));
+    OP_REQUIRES(
+        ctx, v.IsInitialized(),
+        errors::FailedPrecondition(
+            "Attempting to use uninitialized variables: ", requested_input(2)));
+
+    static const char* const kScalarNames[] = {
+        "beta1_power", "beta2_power", "lr", "beta1", "beta2", "epsilon"};
+    float scalars[6];
+    for (int i = 0; i < 6; ++i) {
+      const Tensor& t = ctx->input(3 + i);
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(t.shape()),
+                  errors::InvalidArgument(kScalarNames[i], " is not a scalar: ",
+                                          t.shape().DebugString()));
+      scalars[i] = t.scalar<float>()();
+    }
+    const float beta1_power = scalars[0];
+    const float beta2_power = scalars[1];
+    const float lr = scalars[2];
+    const float beta1 = scalars[3];
+    const float beta2 = scalars[4];
+    const float epsilon = scalars[5];
+
+    const Tensor& grad = ctx->input(9);
+    OP_REQUIRES(ctx, var.shape().IsSameSize(m.shape()),
+                errors::InvalidArgument("var and m do not have the same shape",
+                                        var.shape().DebugString(), " ",
+                                        m.shape().DebugString()));
+    OP_REQUIRES(ctx, var.shape().IsSameSize(v.shape()),
+                errors::InvalidArgument("var and v do not have the same shape",
+                                        var.shape().DebugString(), " ",
+                                        v.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(grad.shape()),
+        errors::InvalidArgument("var and grad do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                grad.shape().DebugString()));
+
+    const int64 size = var.NumElements();
+    if (size == 0) return;
+    typedef typename PositComputeType<T>::type C;
+    const PositAdamUpdate<C> update{
+        lr * std::sqrt(1 - beta2_power) / (1 - beta1_power), beta1, beta2,
+        epsilon, use_nesterov_};
+    T* var_data = var.flat<T>().data();
+    T* m_data = m.flat<T>().data();
+    T* v_data = v.flat<T>().data();
+    const T* grad_data = grad.flat<T>().data();
+    random::PhiloxRandom gen = generator_.ReserveSamples32(3 * size);
+
+    auto work = [=](int64 start, int64 limit) {
+      C var_buf[kPositDecodeBlockSize];
+      C m_buf[kPositDecodeBlockSize];
+      C v_buf[kPositDecodeBlockSize];
+      C grad_buf[kPositDecodeBlockSize];
+      for (int64 b = start; b < limit; b += kPositDecodeBlockSize) {
+        const int64 n = std::min(kPositDecodeBlockSize, limit - b);
+        DecodePosits(var_data + b, var_buf, n);
+        DecodePosits(m_data + b, m_buf, n);
+        DecodePosits(v_data + b, v_buf, n);
+        DecodePosits(grad_data + b, grad_buf, n);
+        for (int64 i = 0; i < n; ++i) {
+          var_buf[i] -= update(grad_buf[i], &m_buf[i], &v_buf[i]);
+        }
+        StochasticEncodePosits(gen, b, m_buf, m_data + b, n);
+        StochasticEncodePosits(gen, size + b, v_buf, v_data + b, n);
+        StochasticEncodePosits(gen, 2 * size + b, var_buf, var_data + b, n);
+      }
+    };
+    const auto& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, size, 60, work);
+  }
+
+ private:
+  bool use_exclusive_lock_;
+  bool use_nesterov_;
+  GuardedPhiloxRandom generator_;
+};
+
+#define REGISTER_CPU_KERNELS(T)                                          \
+  REGISTER_KERNEL_BUILDER(Name("ResourceApplyGradientDescentStochastic") \
+                              .Device(DEVICE_CPU)                        \
+                              .TypeConstraint<T>("T"),                   \
+                          ApplyGradientDescentStochasticOp<T>);          \
+  REGISTER_KERNEL_BUILDER(Name("ResourceApplyMomentumStochastic")        \
+                              .Device(DEVICE_CPU)                        \
+                              .TypeConstraint<T>("T"),                   \
+                          ApplyMomentumStochasticOp<T>);                 \
+  REGISTER_KERNEL_BUILDER(Name("ResourceApplyAdamStochastic")            \
+                              .Device(DEVICE_CPU)                        \
+                              .TypeConstraint<T>("T"),                   \
+                          ApplyAdamStochasticOp<T>);
+
+TF_CALL_POSIT_TYPES(REGISTER_CPU_KERNELS);
+
+#undef REGISTER_CPU_KERNELS
+
 template <typename Device, typename T>
 class ApplyAdaMaxOp : public OpKernel {
  public:
@@ -0,0 +1,259 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_CORE_POSIT_BITS_H_
+#define TENSORFLOW_CORE_LIB_CORE_POSIT_BITS_H_
+
+// Integer-only encoders for the posit formats in lib/posit*. They produce the
+// same bits as the SoftPosit conversions without going through double, and are
+// usable from device code.
+
+#include <string.h>
+
+#include "tensorflow/core/platform/types.h"
+
+#if defined(__CUDACC__)
+#define POSIT_DEVICE_INLINE __host__ __device__ inline
+#else
+#define POSIT_DEVICE_INLINE inline
+#endif
+
+namespace tensorflow {
+
+// Encodes m * 2^-kFracBits, where 0 <= m < 2^kFracBits, as the bits of a posit
+// with kNBits bits and kES exponent bits.
+template <typename UInt, int kNBits, int kES, int kFracBits>
+POSIT_DEVICE_INLINE UInt FixedPointToPositBits(uint32 m) {
+  // Posits are formatted as follows (MSB first):
+  //    sign(1) regime(variable) exponent(kES) fraction(remaining bits)
+  // For 0 < m * 2^-kFracBits < 1 the regime is a run of zeros terminated by
+  // a one. Callers choose kFracBits so that the fraction field always has room
+  // for the bits of m below its leading one; the encoding is therefore exact
+  // and the values keep the uniform spacing 2^-kFracBits.
+  if (m == 0) {
+    return 0;
+  }
+  int log2_m = 0;
+  for (int shift = 16; shift > 0; shift >>= 1) {
+    if ((m >> (log2_m + shift)) != 0) {
+      log2_m += shift;
+    }
+  }
+  const int scale = log2_m - kFracBits;  // Always negative.
+  // Floor division of scale by 2^kES.
+  const int regime = -((-scale + (1 << kES) - 1) >> kES);
+  const uint32 exponent = static_cast<uint32>(scale - regime * (1 << kES));
+  // Position of the bit terminating the regime.
+  const int terminator = kNBits - 2 + regime;
+  const int fraction_bits = terminator - kES;
+  uint32 bits = uint32{1} << terminator;
+  bits |= exponent << fraction_bits;
+  bits |= (m ^ (uint32{1} << log2_m)) << (fraction_bits - log2_m);
+  return static_cast<UInt>(bits);
+}
+
+namespace posit_bits_internal {
+
+// Rounds (-1)^negative * (1 + man * 2^-kManBits) * 2^scale to the bits of a
+// posit. kManBits may be at most 30 so that the laid out bit string fits in 64
+// bits. If "stochastic" is false "random" is ignored and ties round to even.
+template <typename UInt, int kNBits, int kES, int kManBits>
+POSIT_DEVICE_INLINE UInt RoundToPositBits(bool negative, int scale, uint64 man,
+                                          bool stochastic, uint32 random) {
+  static_assert(kManBits <= 30, "mantissa too wide for a 64 bit body");
+  const UInt kNaR = static_cast<UInt>(uint32{1} << (kNBits - 1));
+  const UInt kMaxPos = static_cast<UInt>(kNaR - 1);
+  const UInt kMinPos = 1;
+  const int kMaxScale = (kNBits - 2) << kES;
+
+  UInt magnitude;
+  if (scale < -kMaxScale) {
+    // Posits never round a nonzero value to zero.
+    magnitude = kMinPos;
+  } else if (scale >= kMaxScale) {
+    // Nor do they round a real value to NaR.
+    magnitude = kMaxPos;
+  } else {
+    // Floor division of scale by 2^kES.
+    const int regime =
+        scale >= 0 ? (scale >> kES) : -((-scale + (1 << kES) - 1) >> kES);
+    const uint64 exponent = static_cast<uint64>(scale - regime * (1 << kES));
+    // Lay out regime, exponent and mantissa in one bit string, then round it
+    // to the kNBits - 1 bits following the sign.
+    uint64 body;
+    int length;
+    if (regime >= 0) {
+      body = ((uint64{1} << (regime + 1)) - 1) << 1;
+      length = regime + 2;
+    } else {
+      body = 1;
+      length = 1 - regime;
+    }
+    body = (((body << kES) | exponent) << kManBits) | man;
+    length += kES + kManBits;
+    const int shift = length - (kNBits - 1);
+    if (shift <= 0) {
+      magnitude = static_cast<UInt>(body << -shift);
+    } else {
+      uint64 kept = body >> shift;
+      const uint64 rest = body & ((uint64{1} << shift) - 1);
+      if (stochastic) {
+        // Round up with probability rest / 2^shift: compare the dropped bits
+        // against a uniform threshold of the same width.
+        const uint64 threshold =
+            shift <= 32 ? (random & ((uint64{1} << shift) - 1))
+                        : static_cast<uint64>(random) << (shift - 32);
+        if (rest > threshold) {
+          ++kept;
+        }
+      } else {
+        const uint64 half = uint64{1} << (shift - 1);
+        if (rest > half || (rest == half && (kept & 1))) {
+          ++kept;
+        }
+      }
+      if (kept == 0) {
+        kept = kMinPos;
+      } else if (kept > kMaxPos) {
+        kept = kMaxPos;
+      }
+      magnitude = static_cast<UInt>(kept);
+    }
+  }
+  // Negative posits are the two's complement of their magnitude.
+  return negative ? static_cast<UInt>(~magnitude + 1) : magnitude;
+}
+
+// Shared by FloatToPositBits and FloatToPositBitsStochastic.
+template <typename UInt, int kNBits, int kES>
+POSIT_DEVICE_INLINE UInt FloatToPositBitsImpl(float f, bool stochastic,
+                                              uint32 random) {
+  uint32 bits;
+  memcpy(&bits, &f, sizeof(bits));
+  const bool negative = (bits >> 31) != 0;
+  const uint32 biased_exp = (bits >> 23) & 0xffu;
+  const uint32 man = bits & 0x7fffffu;
+  if (biased_exp == 0xffu) {
+    return static_cast<UInt>(uint32{1} << (kNBits - 1));  // Infs and NaNs.
+  }
+  if (biased_exp == 0) {
+    // Zero, or a subnormal below every posit's minpos.
+    return man == 0 ? 0
+                    : RoundToPositBits<UInt, kNBits, kES, 23>(
+                          negative, -(1 << 30), 0, false, 0);
+  }
+  return RoundToPositBits<UInt, kNBits, kES, 23>(
+      negative, static_cast<int>(biased_exp) - 127, man, stochastic, random);
+}
+
+}  // namespace posit_bits_internal
+
+// Rounds a float to the bits of the nearest posit with kNBits bits and kES
+// exponent bits. Ties round to even; nonzero values never round to zero and
+// finite values never round to NaR.
+template <typename UInt, int kNBits, int kES>
+POSIT_DEVICE_INLINE UInt FloatToPositBits(float f) {
+  return posit_bits_internal::FloatToPositBitsImpl<UInt, kNBits, kES>(
+      f, /*stochastic=*/false, 0);
+}
+
+// Like FloatToPositBits, but rounds the magnitude of f away from zero with
+// probability proportional to its distance from the posit below it, using
+// "random" as a uniformly distributed 32 bit sample. The result is unbiased
+// between the two neighbouring posits, so small updates accumulate in
+// expectation instead of being rounded away. Saturation is as in
+// FloatToPositBits.
+template <typename UInt, int kNBits, int kES>
+POSIT_DEVICE_INLINE UInt FloatToPositBitsStochastic(float f, uint32 random) {
+  return posit_bits_internal::FloatToPositBitsImpl<UInt, kNBits, kES>(
+      f, /*stochastic=*/true, random);
+}
+
+// Like FloatToPositBitsStochastic for doubles, which hold every posit up to 32
+// bits exactly. The mantissa is truncated to 30 bits before rounding; that
+// lowers the magnitude by less than 2^-30 of itself, an eighth of the finest
+// posit32 spacing, where a float would already be off by eight spacings.
+template <typename UInt, int kNBits, int kES>
+POSIT_DEVICE_INLINE UInt DoubleToPositBitsStochastic(double d, uint32 random) {
+  uint64 bits;
+  memcpy(&bits, &d, sizeof(bits));
+  const bool negative = (bits >> 63) != 0;
+  const uint32 biased_exp = static_cast<uint32>((bits >> 52) & 0x7ffu);
+  const uint64 man = bits & ((uint64{1} << 52) - 1);
+  if (biased_exp == 0x7ffu) {
+    return static_cast<UInt>(uint32{1} << (kNBits - 1));  // Infs and NaNs.
+  }
+  if (biased_exp == 0) {
+    // Zero, or a subnormal below every posit's minpos.
+    return man == 0 ? 0
+                    : posit_bits_internal::RoundToPositBits<UInt, kNBits, kES,
+                                                            30>(
+                          negative, -(1 << 30), 0, false, 0);
+  }
+  return posit_bits_internal::RoundToPositBits<UInt, kNBits, kES, 30>(
+      negative, static_cast<int>(biased_exp) - 1023, man >> 22,
+      /*stochastic=*/true, random);
+}
+
+// Rounds (-1)^negative * (1 + man * 2^-kManBits) * 2^scale, where
+// kManBits <= 30, to the bits of the nearest posit with ties to even. Wide
+// accumulators use it to round their exact sum once; callers with more
+// mantissa bits fold the dropped ones into the lowest kept bit.
+template <typename UInt, int kNBits, int kES, int kManBits>
+POSIT_DEVICE_INLINE UInt ScaledToPositBits(bool negative, int scale,
+                                           uint64 man) {
+  return posit_bits_internal::RoundToPositBits<UInt, kNBits, kES, kManBits>(
+      negative, scale, man, /*stochastic=*/false, 0);
+}
+
+// Splits the bits of a posit that is neither zero nor NaR into sign and an
+// integer significand and exponent, so that the posit equals
+// (-1)^*negative * *significand * 2^*exponent with *significand < 2^kNBits.
+// The exponent is never below -((kNBits - 2) << kES), the scale of minpos.
+template <typename UInt, int kNBits, int kES>
+POSIT_DEVICE_INLINE void PositBitsToScaled(UInt bits, bool* negative,
+                                           uint32* significand,
+                                           int* exponent) {
+  const uint32 kMask =
+      kNBits == 32 ? ~uint32{0} : (uint32{1} << kNBits) - 1;
+  uint32 v = static_cast<uint32>(bits) & kMask;
+  *negative = ((v >> (kNBits - 1)) & 1) != 0;
+  if (*negative) {
+    v = (~v + 1) & kMask;
+  }
+  // The regime is the run of identical bits after the sign.
+  int i = kNBits - 2;
+  const uint32 run_bit = (v >> i) & 1;
+  int run = 0;
+  while (i >= 0 && ((v >> i) & 1) == run_bit) {
+    ++run;
+    --i;
+  }
+  const int regime = run_bit ? run - 1 : -run;
+  // Skip the terminating bit; exponent bits cut off by the end of the posit
+  // are zero.
+  int remaining = i > 0 ? i : 0;
+  const int es_bits = remaining < kES ? remaining : kES;
+  remaining -= es_bits;
+  const int exp = static_cast<int>((v >> remaining) & ((1u << es_bits) - 1))
+                  << (kES - es_bits);
+  const uint32 frac = v & ((uint32{1} << remaining) - 1);
+  *significand = (uint32{1} << remaining) | frac;
+  *exponent = regime * (1 << kES) + exp - remaining;
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_CORE_POSIT_BITS_H_
@@ -0,0 +1,158 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/core/posit_bits.h"
+
+#include <cmath>
+#include <initializer_list>
+
+#include "tensorflow/core/lib/posit16/posit16.h"
+#include "tensorflow/core/lib/posit32/posit32.h"
+#include "tensorflow/core/lib/posit8/posit8.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(PositBitsTest, FloatToPositBitsMatchesConversion) {
+  // Walk float bit patterns with a stride that covers every exponent.
+  for (uint64 bits = 0; bits <= 0xffffffffu; bits += 65537) {
+    const uint32 b = static_cast<uint32>(bits);
+    float f;
+    memcpy(&f, &b, sizeof(f));
+    if (std::isnan(f)) continue;
+    ASSERT_EQ((FloatToPositBits<uint8, 8, 0>(f)), posit8(f).value) << f;
+    ASSERT_EQ((FloatToPositBits<uint16, 16, 1>(f)), posit16(f).value) << f;
+    ASSERT_EQ((FloatToPositBits<uint32, 32, 2>(f)), posit32(f).value) << f;
+  }
+}
+
+TEST(PositBitsTest, FloatToPositBitsSaturates) {
+  EXPECT_EQ(0x7FFFU, (FloatToPositBits<uint16, 16, 1>(1e30f)));
+  EXPECT_EQ(0x8001U, (FloatToPositBits<uint16, 16, 1>(-1e30f)));
+  EXPECT_EQ(0x0001U, (FloatToPositBits<uint16, 16, 1>(1e-30f)));
+  EXPECT_EQ(0x0000U, (FloatToPositBits<uint16, 16, 1>(0.0f)));
+  EXPECT_EQ(0x8000U, (FloatToPositBits<uint16, 16, 1>(INFINITY)));
+}
+
+TEST(PositBitsTest, FixedPointToPositBitsIsExact) {
+  for (uint32 m = 0; m < (1u << 12); ++m) {
+    posit16 p;
+    p.value = FixedPointToPositBits<uint16, 16, 1, 12>(m);
+    ASSERT_EQ(static_cast<double>(p), m / 4096.0) << m;
+  }
+}
+
+TEST(PositBitsTest, FloatToPositBitsStochasticIsExactOnPosits) {
+  for (uint32 bits = 0; bits <= 0xffffu; ++bits) {
+    if (bits == 0x8000u) continue;  // NaR
+    posit16 p;
+    p.value = static_cast<uint16>(bits);
+    const float f = static_cast<float>(p);
+    for (uint32 random : {0u, 0x12345678u, 0xffffffffu}) {
+      ASSERT_EQ(bits, (FloatToPositBitsStochastic<uint16, 16, 1>(f, random)))
+          << f << " " << random;
+    }
+  }
+}
+
+TEST(PositBitsTest, FloatToPositBitsStochasticIsUnbiased) {
+  // A quarter of the way from 1 to the next posit16, 1 + 2^-12. An odd
+  // multiplier walks the low bits of "random" through every value evenly,
+  // so exactly a quarter of the samples round up.
+  const float f = 1.0f + 0.25f / 4096;
+  const uint16 below = posit16(1.0f).value;
+  for (float sign : {1.0f, -1.0f}) {
+    int ups = 0;
+    for (uint32 i = 0; i < (1u << 16); ++i) {
+      const uint16 bits =
+          FloatToPositBitsStochastic<uint16, 16, 1>(sign * f, i * 0x9E3779B9u);
+      const uint16 magnitude =
+          sign > 0 ? bits : static_cast<uint16>(~bits + 1);
+      ASSERT_TRUE(magnitude == below || magnitude == below + 1) << magnitude;
+      ups += magnitude != below;
+    }
+    EXPECT_EQ(1 << 14, ups);
+  }
+}
+
+TEST(PositBitsTest, FloatToPositBitsStochasticSaturates) {
+  EXPECT_EQ(0x7FFFU,
+            (FloatToPositBitsStochastic<uint16, 16, 1>(1e30f, 0xffffffffu)));
+  EXPECT_EQ(0x0001U, (FloatToPositBitsStochastic<uint16, 16, 1>(1e-30f, 0)));
+  EXPECT_EQ(0x8000U, (FloatToPositBitsStochastic<uint16, 16, 1>(NAN, 0)));
+}
+
+TEST(PositBitsTest, DoubleToPositBitsStochasticRoundTripsPosit32) {
+  // Every posit32 is a double, so it must encode back to itself whatever the
+  // random sample. Most of them are not floats.
+  for (uint64 bits = 0; bits <= 0xffffffffu; bits += 0x10001u) {
+    if (bits == 0x80000000u) continue;  // NaR
+    posit32 p;
+    p.value = static_cast<uint32>(bits);
+    const double d = static_cast<double>(p);
+    for (uint32 random : {0u, 0x12345678u, 0xffffffffu}) {
+      ASSERT_EQ(bits, (DoubleToPositBitsStochastic<uint32, 32, 2>(d, random)))
+          << d << " " << random;
+    }
+  }
+}
+
+TEST(PositBitsTest, DoubleToPositBitsStochasticIsUnbiased) {
+  // A quarter of the way from 1 to the next posit32, 1 + 2^-27, which a float
+  // cannot tell from 1.
+  const double d = 1.0 + 0.25 / (1 << 27);
+  const uint32 below = posit32(1.0f).value;
+  for (double sign : {1.0, -1.0}) {
+    int ups = 0;
+    for (uint32 i = 0; i < (1u << 16); ++i) {
+      const uint32 bits =
+          DoubleToPositBitsStochastic<uint32, 32, 2>(sign * d, i * 0x9E3779B9u);
+      const uint32 magnitude = sign > 0 ? bits : ~bits + 1;
+      ASSERT_TRUE(magnitude == below || magnitude == below + 1) << magnitude;
+      ups += magnitude != below;
+    }
+    EXPECT_EQ(1 << 14, ups);
+  }
+}
+
+TEST(PositBitsTest, PositBitsToScaledRoundTrips) {
+  for (uint32 bits = 1; bits <= 0xffffu; ++bits) {
+    if (bits == 0x8000u) continue;  // NaR
+    posit16 p;
+    p.value = static_cast<uint16>(bits);
+    bool negative;
+    uint32 significand;
+    int exponent;
+    PositBitsToScaled<uint16, 16, 1>(p.value, &negative, &significand,
+                                     &exponent);
+    ASSERT_GE(exponent, -28) << bits;
+    ASSERT_EQ(static_cast<double>(p),
+              (negative ? -1 : 1) * std::ldexp(significand, exponent))
+        << bits;
+    // Normalize to a leading one and re-encode.
+    int log2_significand = 0;
+    while ((significand >> (log2_significand + 1)) != 0) ++log2_significand;
+    const uint64 man = static_cast<uint64>(significand ^
+                                           (1u << log2_significand))
+                       << (30 - log2_significand);
+    ASSERT_EQ(bits, (ScaledToPositBits<uint16, 16, 1, 30>(
+                        negative, exponent + log2_significand, man)))
+        << bits;
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -27,6 +27,7 @@ limitations under the License.
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/lib/bfloat16/bfloat16.h"
+#include "tensorflow/core/lib/core/posit_bits.h"
 #include "tensorflow/core/lib/posit8/posit8.h"
 #include "tensorflow/core/lib/posit16/posit16.h"
 #include "tensorflow/core/lib/posit32/posit32.h"
@@ -130,7 +131,8 @@ template <class Generator>
 class UniformDistribution<Generator, posit8> {
  public:
   // The number of elements that will be returned.
-  static const int kResultElementCount = Generator::kResultElementCount*2; // Assume each sample is at least uint16.
+  // Each sample is at least 16 bits wide, which is enough for two posit8s.
+  static const int kResultElementCount = Generator::kResultElementCount * 2;
   // Cost of generation of a single element (in cycles).
   static const int kElementCost = 3;
   // Indicate that this distribution may take variable number of samples
@@ -143,9 +145,9 @@ class UniformDistribution<Generator, posit8> {
   ResultType operator()(Generator* gen) {
     typename Generator::ResultType sample = (*gen)();
     ResultType result;
-    for (int i = 0; i < kResultElementCount; i+=2) {
-      result[i  ] = Uint8ToPosit8( sample[i]       & 0x00FFU);
-      result[i+1] = Uint8ToPosit8((sample[i] >> 8) & 0x00FFU);
+    for (int i = 0; i < kResultElementCount; i += 2) {
+      result[i] = Uint8ToPosit8(sample[i / 2] & 0x00FFU);
+      result[i + 1] = Uint8ToPosit8((sample[i / 2] >> 8) & 0x00FFU);
     }
     return result;
   }
@@ -484,8 +486,8 @@ class NormalDistribution<Generator, posit8> {
       float f[2];
       // Box-Muller transform requires processing 2 elements at a time.
       BoxMullerFloat(sample[i], sample[i + 1], &f[0], &f[1]);
-      result[i] = posit8(f[0]);
-      result[i + 1] = posit8(f[1]);
+      result[i].value = FloatToPositBits<uint8, 8, 0>(f[0]);
+      result[i + 1].value = FloatToPositBits<uint8, 8, 0>(f[1]);
     }
     return result;
   }
@@ -514,8 +516,8 @@ class NormalDistribution<Generator, posit16> {
       float f[2];
       // Box-Muller transform requires processing 2 elements at a time.
       BoxMullerFloat(sample[i], sample[i + 1], &f[0], &f[1]);
-      result[i] = posit16(f[0]);
-      result[i + 1] = posit16(f[1]);
+      result[i].value = FloatToPositBits<uint16, 16, 1>(f[0]);
+      result[i + 1].value = FloatToPositBits<uint16, 16, 1>(f[1]);
     }
     return result;
   }
@@ -544,8 +546,8 @@ class NormalDistribution<Generator, posit32> {
       float f[2];
       // Box-Muller transform requires processing 2 elements at a time.
       BoxMullerFloat(sample[i], sample[i + 1], &f[0], &f[1]);
-      result[i] = posit32(f[0]);
-      result[i + 1] = posit32(f[1]);
+      result[i].value = FloatToPositBits<uint32, 32, 2>(f[0]);
+      result[i + 1].value = FloatToPositBits<uint32, 32, 2>(f[1]);
     }
     return result;
   }
@@ -734,7 +736,7 @@ class TruncatedNormalDistribution<SingleSampleGenerator, posit8> {
 
       for (int i = 0; i < 2; ++i) {
         if (Eigen::numext::abs(f[i]) < kTruncateValue) {
-          results[index++] = posit8(f[i]);
+          results[index++].value = FloatToPositBits<uint8, 8, 0>(f[i]);
           if (index >= kResultElementCount) {
             return results;
           }
@@ -776,7 +778,7 @@ class TruncatedNormalDistribution<SingleSampleGenerator, posit16> {
 
       for (int i = 0; i < 2; ++i) {
         if (Eigen::numext::abs(f[i]) < kTruncateValue) {
-          results[index++] = posit16(f[i]);
+          results[index++].value = FloatToPositBits<uint16, 16, 1>(f[i]);
           if (index >= kResultElementCount) {
             return results;
           }
@@ -818,7 +820,7 @@ class TruncatedNormalDistribution<SingleSampleGenerator, posit32> {
 
       for (int i = 0; i < 2; ++i) {
         if (Eigen::numext::abs(f[i]) < kTruncateValue) {
-          results[index++] = posit32(f[i]);
+          results[index++].value = FloatToPositBits<uint32, 32, 2>(f[i]);
           if (index >= kResultElementCount) {
             return results;
           }
@@ -1002,30 +1004,27 @@ PHILOX_DEVICE_INLINE bfloat16 Uint16ToGfloat16(uint16 x) {
   return result - bfloat16(1.0);
 }
 
+// Helper function to convert an 8-bit integer to a posit8 between [0..1).
 PHILOX_DEVICE_INLINE posit8 Uint8ToPosit8(uint8 x) {
-  posit8 one;
-  one.value = posit8::ONE_VALUE;
+  // 5 random bits: the fraction width of posit8 in [0.5..1).
   posit8 result;
-  result.value = (x & 0x1FU) | 0x40U;
-  result -= one;
+  result.value = FixedPointToPositBits<uint8, 8, 0, 5>(x & 0x1FU);
   return result;
 }
 
+// Helper function to convert a 16-bit integer to a posit16 between [0..1).
 PHILOX_DEVICE_INLINE posit16 Uint16ToPosit16(uint16 x) {
-  posit16 one;
-  one.value = posit16::ONE_VALUE;
+  // 12 random bits: the fraction width of posit16 in [0.5..1).
   posit16 result;
-  result.value = (x & 0x0FFFU) | 0x4000U;
-  result -= one;
+  result.value = FixedPointToPositBits<uint16, 16, 1, 12>(x & 0x0FFFU);
   return result;
 }
 
+// Helper function to convert a 32-bit integer to a posit32 between [0..1).
 PHILOX_DEVICE_INLINE posit32 Uint32ToPosit32(uint32 x) {
-  posit32 one;
-  one.value = posit32::ONE_VALUE;
+  // 27 random bits: the fraction width of posit32 in [0.5..1).
   posit32 result;
-  result.value = (x & 0x07FFFFFFU) | 0x40000000U;
-  result -= one;
+  result.value = FixedPointToPositBits<uint32, 32, 2, 27>(x & 0x07FFFFFFU);
   return result;
 }
 
@@ -272,6 +272,13 @@ TEST(PhiloxRandomTest, RandomParametersBfloat16MomentsTest) {
                                         bfloat16(kZLimitBfloat16));
 }
 
+TEST(PhiloxRandomTest, UniformPosit16IsExact) {
+  for (uint32 x = 0; x <= 0xffffu; ++x) {
+    const posit16 p = Uint16ToPosit16(static_cast<uint16>(x));
+    ASSERT_EQ(static_cast<double>(p), (x & 0x0fffu) / 4096.0) << x;
+  }
+}
+
 TEST(PhiloxRandomTest, UniformFloatMomentsTest) {
   const std::vector<int> strides = {0, 1, 4, 17};
   UniformMomentsTest<float>(1 << 20, 40, strides, kZLimit);
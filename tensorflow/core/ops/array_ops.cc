@@ -1159,6 +1159,26 @@ REGISTER_OP("GatherV2")
       return Status::OK();
     });
 
+// --------------------------------------------------------------------------
+REGISTER_OP("GatherAndDecode")
+    .Input("params: Tparams")
+    .Input("indices: Tindices")
+    .Output("output: Tout")
+    .Attr("Tparams: {posit8, posit16, posit32}")
+    .Attr("Tindices: {int32,int64}")
+    .Attr("Tout: {float, bfloat16} = DT_FLOAT")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(0), 1, &unused));
+      ShapeHandle params_subshape;
+      TF_RETURN_IF_ERROR(c->Subshape(c->input(0), 1, &params_subshape));
+      ShapeHandle indices_shape = c->input(1);
+      ShapeHandle out;
+      TF_RETURN_IF_ERROR(c->Concatenate(indices_shape, params_subshape, &out));
+      c->set_output(0, out);
+      return Status::OK();
+    });
+
 // --------------------------------------------------------------------------
 REGISTER_OP("GatherNd")
     .Input("params: Tparams")
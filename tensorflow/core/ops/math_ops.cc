@@ -132,6 +132,16 @@ Cast x of type SrcT to y of DstT.
 _HostCast requires its input and produces its output in host memory.
 )doc");
 
+REGISTER_OP("StochasticCast")
+    .Input("x: SrcT")
+    .Output("y: DstT")
+    .Attr("SrcT: {float, double}")
+    .Attr("DstT: {posit8, posit16, posit32}")
+    .Attr("seed: int = 0")
+    .Attr("seed2: int = 0")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::UnchangedShape);
+
 // --------------------------------------------------------------------------
 
 REGISTER_OP("Abs")
@@ -264,6 +274,22 @@ REGISTER_OP("_UnaryOpsComposition")
 expected to create these operators.
 )doc");
 
+REGISTER_OP("_PositLdexp")
+    .Input("x: T")
+    .Output("y: T")
+    .Attr("T: {posit8, posit16, posit32}")
+    .Attr("exponent: int")
+    .Attr("negate: bool = false")
+    .SetShapeFn(shape_inference::UnchangedShape)
+    .Doc(R"doc(
+Computes `x * 2^exponent`, negated if `negate` is set, by adjusting the regime
+and exponent fields of each posit. The result is the correctly rounded product
+and zero and NaR are unchanged.
+
+*NOTE*: Do not invoke this operator directly in Python. The arithmetic
+optimizer rewrites posit multiplications by powers of two into it.
+)doc");
+
 #undef UNARY
 #undef UNARY_REAL
 #undef UNARY_COMPLEX
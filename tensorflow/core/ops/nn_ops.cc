@@ -274,6 +274,27 @@ REGISTER_OP("Conv2D")
     .Attr("dilations: list(int) = [1, 1, 1, 1]")
     .SetShapeFn(shape_inference::Conv2DShape);
 
+REGISTER_OP("_PositFusedConv2D")
+    .Input("input: T")
+    .Input("filter: T")
+    .Input("bias: T")
+    .Output("output: T")
+    .Attr("T: {posit8, posit16, posit32}")
+    .Attr("strides: list(int)")
+    .Attr(GetPaddingAttrString())
+    .Attr(GetConvnetDataFormatAttrString())
+    .Attr("dilations: list(int) = [1, 1, 1, 1]")
+    .Attr("activation: {'Identity', 'Relu', 'Relu6'} = 'Identity'")
+    .SetShapeFn(shape_inference::Conv2DShape)
+    .Doc(R"doc(
+Conv2D followed by BiasAdd and an optional Relu or Relu6 on posit tensors.
+The bias and activation are applied before the output is rounded, so the
+result is rounded once instead of once per op.
+
+NOTE Do not invoke this operator directly in Python. Graph rewrite pass is
+expected to create these operators.
+)doc");
+
 REGISTER_OP("Conv2DBackpropInput")
     .Input("input_sizes: int32")
     .Input("filter: T")
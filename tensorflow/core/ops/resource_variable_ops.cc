@@ -136,6 +136,22 @@ REGISTER_OP("AssignSubVariableOp")
     .Attr("dtype: type")
     .SetShapeFn(CreateAssignShapeFn);
 
+REGISTER_OP("StochasticAssignAddVariableOp")
+    .Input("resource: resource")
+    .Input("value: dtype")
+    .Attr("dtype: {posit8, posit16, posit32}")
+    .Attr("seed: int = 0")
+    .Attr("seed2: int = 0")
+    .SetShapeFn(CreateAssignShapeFn);
+
+REGISTER_OP("StochasticAssignSubVariableOp")
+    .Input("resource: resource")
+    .Input("value: dtype")
+    .Attr("dtype: {posit8, posit16, posit32}")
+    .Attr("seed: int = 0")
+    .Attr("seed2: int = 0")
+    .SetShapeFn(CreateAssignShapeFn);
+
 REGISTER_OP("VarIsInitializedOp")
     .Input("resource: resource")
     .Output("is_initialized: bool")
@@ -184,6 +200,31 @@ REGISTER_OP("ResourceGather")
       return Status::OK();
     });
 
+REGISTER_OP("ResourceGatherAndDecode")
+    .Input("resource: resource")
+    .Input("indices: Tindices")
+    .Output("output: Tout")
+    .Attr("dtype: {posit8, posit16, posit32}")
+    .Attr("Tindices: {int32,int64}")
+    .Attr("Tout: {float, bfloat16} = DT_FLOAT")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeAndType handle_shape_and_type;
+      TF_RETURN_IF_ERROR(
+          ValidateVariableResourceHandle(c, &handle_shape_and_type));
+
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(
+          c->WithRankAtLeast(handle_shape_and_type.shape, 1, &unused));
+      ShapeHandle params_subshape;
+      TF_RETURN_IF_ERROR(
+          c->Subshape(handle_shape_and_type.shape, 1, &params_subshape));
+      ShapeHandle indices_shape = c->input(1);
+      ShapeHandle out;
+      TF_RETURN_IF_ERROR(c->Concatenate(indices_shape, params_subshape, &out));
+      c->set_output(0, out);
+      return Status::OK();
+    });
+
 namespace {
 
 Status ResourceScatterUpdateShape(InferenceContext* c) {
@@ -214,6 +255,15 @@ REGISTER_OP("ResourceScatterAdd")
     .Attr("Tindices: {int32, int64}")
     .SetShapeFn(ResourceScatterUpdateShape);
 
+REGISTER_OP("ResourceScatterAddAndEncode")
+    .Input("resource: resource")
+    .Input("indices: Tindices")
+    .Input("updates: Tupdates")
+    .Attr("dtype: {posit8, posit16, posit32}")
+    .Attr("Tupdates: {float, bfloat16} = DT_FLOAT")
+    .Attr("Tindices: {int32, int64}")
+    .SetShapeFn(ResourceScatterUpdateShape);
+
 REGISTER_OP("ResourceScatterSub")
     .Input("resource: resource")
     .Input("indices: Tindices")
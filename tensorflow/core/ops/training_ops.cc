@@ -84,6 +84,16 @@ REGISTER_OP("ResourceApplyGradientDescent")
     .Attr("use_locking: bool = false")
     .SetShapeFn(ApplyGradientDescentShapeFn);
 
+REGISTER_OP("ResourceApplyGradientDescentStochastic")
+    .Input("var: resource")
+    .Input("alpha: float")
+    .Input("delta: T")
+    .Attr("T: {posit8, posit16, posit32}")
+    .Attr("use_locking: bool = false")
+    .Attr("seed: int = 0")
+    .Attr("seed2: int = 0")
+    .SetShapeFn(ApplyGradientDescentShapeFn);
+
 static Status ApplyProximalGradientDescentShapeFn(InferenceContext* c,
                                                   bool sparse) {
   ShapeHandle unused;
@@ -685,6 +695,47 @@ REGISTER_OP("ResourceSparseApplyMomentum")
       return ApplyMomentumShapeFn(c, true /* sparse */);
     });
 
+// Shape function for the *WithMaster variants, which take a master copy of
+// var as their second input and are otherwise laid out like the plain op.
+static Status ApplyMomentumWithMasterShapeFn(InferenceContext* c) {
+  ShapeHandle unused;
+  ShapeHandle s = ShapeOrHandleShape(c, 0);                       // var
+  TF_RETURN_IF_ERROR(c->Merge(s, ShapeOrHandleShape(c, 1), &s));  // master
+  TF_RETURN_IF_ERROR(c->Merge(s, ShapeOrHandleShape(c, 2), &s));  // accum
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(3), 0, &unused));       // lr
+  TF_RETURN_IF_ERROR(c->Merge(s, c->input(4), &s));               // grad
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(5), 0, &unused));       // momentum
+  return Status::OK();
+}
+
+REGISTER_OP("ResourceApplyMomentumWithMaster")
+    .Input("var: resource")
+    .Input("master: resource")
+    .Input("accum: resource")
+    .Input("lr: master_dtype")
+    .Input("grad: T")
+    .Input("momentum: master_dtype")
+    .Attr("T: {posit8, posit16, posit32}")
+    .Attr("master_dtype: {float, double} = DT_FLOAT")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .SetShapeFn(ApplyMomentumWithMasterShapeFn);
+
+REGISTER_OP("ResourceApplyMomentumStochastic")
+    .Input("var: resource")
+    .Input("accum: resource")
+    .Input("lr: float")
+    .Input("grad: T")
+    .Input("momentum: float")
+    .Attr("T: {posit8, posit16, posit32}")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .Attr("seed: int = 0")
+    .Attr("seed2: int = 0")
+    .SetShapeFn([](InferenceContext* c) {
+      return ApplyMomentumShapeFn(c, false /* sparse */);
+    });
+
 static Status ApplyAdamShapeFn(InferenceContext* c, bool sparse) {
   ShapeHandle unused;
   ShapeHandle s = ShapeOrHandleShape(c, 0);                       // var
@@ -741,6 +792,58 @@ REGISTER_OP("ResourceApplyAdam")
       return ApplyAdamShapeFn(c, false /* sparse */);
     });
 
+static Status ApplyAdamWithMasterShapeFn(InferenceContext* c) {
+  ShapeHandle unused;
+  ShapeHandle s = ShapeOrHandleShape(c, 0);                       // var
+  TF_RETURN_IF_ERROR(c->Merge(s, ShapeOrHandleShape(c, 1), &s));  // master
+  TF_RETURN_IF_ERROR(c->Merge(s, ShapeOrHandleShape(c, 2), &s));  // m
+  TF_RETURN_IF_ERROR(c->Merge(s, ShapeOrHandleShape(c, 3), &s));  // v
+  for (int i = 4; i < 10; ++i) {
+    // beta1_power, beta2_power, lr, beta1, beta2, epsilon
+    TF_RETURN_IF_ERROR(c->WithRank(c->input(i), 0, &unused));
+  }
+  TF_RETURN_IF_ERROR(c->Merge(s, c->input(10), &s));  // grad
+  return Status::OK();
+}
+
+REGISTER_OP("ResourceApplyAdamWithMaster")
+    .Input("var: resource")
+    .Input("master: resource")
+    .Input("m: resource")
+    .Input("v: resource")
+    .Input("beta1_power: master_dtype")
+    .Input("beta2_power: master_dtype")
+    .Input("lr: master_dtype")
+    .Input("beta1: master_dtype")
+    .Input("beta2: master_dtype")
+    .Input("epsilon: master_dtype")
+    .Input("grad: T")
+    .Attr("T: {posit8, posit16, posit32}")
+    .Attr("master_dtype: {float, double} = DT_FLOAT")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .SetShapeFn(ApplyAdamWithMasterShapeFn);
+
+REGISTER_OP("ResourceApplyAdamStochastic")
+    .Input("var: resource")
+    .Input("m: resource")
+    .Input("v: resource")
+    .Input("beta1_power: float")
+    .Input("beta2_power: float")
+    .Input("lr: float")
+    .Input("beta1: float")
+    .Input("beta2: float")
+    .Input("epsilon: float")
+    .Input("grad: T")
+    .Attr("T: {posit8, posit16, posit32}")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .Attr("seed: int = 0")
+    .Attr("seed2: int = 0")
+    .SetShapeFn([](InferenceContext* c) {
+      return ApplyAdamShapeFn(c, false /* sparse */);
+    });
+
 static Status ApplyAdaMaxShapeFn(InferenceContext* c, bool sparse) {
   ShapeHandle unused;
   ShapeHandle s = ShapeOrHandleShape(c, 0);                       // var
@@ -42,6 +42,32 @@ TEST(Numa, Malloc) {
   }
 }
 
+TEST(Numa, MallocHonoursLargeAlignment) {
+  if (port::NUMAEnabled()) {
+    const int kAlignment = 1 << 21;
+    int num_nodes = port::NUMANumNodes();
+    for (int request_node = 0; request_node < num_nodes; ++request_node) {
+      void* ptr = port::NUMAMalloc(request_node, 8, kAlignment);
+      ASSERT_NE(ptr, nullptr);
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % kAlignment);
+      *(reinterpret_cast<int*>(ptr)) = 0;
+      EXPECT_EQ(request_node, port::NUMAGetMemAffinity(ptr));
+      port::NUMAFree(ptr, 8);
+    }
+  }
+}
+
+TEST(Numa, MallocReusesFreedMemory) {
+  if (port::NUMAEnabled()) {
+    void* first = port::NUMAMalloc(0, 100, 64);
+    ASSERT_NE(first, nullptr);
+    port::NUMAFree(first, 100);
+    void* second = port::NUMAMalloc(0, 100, 64);
+    EXPECT_EQ(first, second);
+    port::NUMAFree(second, 100);
+  }
+}
+
 TEST(Numa, SetNodeAffinity) {
   // NOTE(tucker): This test is not reliable when executed under tap because
   // the virtual machine may not have access to all of the availble NUMA
@@ -57,5 +83,14 @@ TEST(Numa, SetNodeAffinity) {
   }
 }
 
+TEST(Numa, ClearNodeAffinity) {
+  if (port::NUMAEnabled()) {
+    port::NUMASetThreadNodeAffinity(port::NUMANumNodes() - 1);
+    EXPECT_EQ(port::NUMANumNodes() - 1, port::NUMAGetThreadNodeAffinity());
+  }
+  port::NUMASetThreadNodeAffinity(port::kNUMANoAffinity);
+  EXPECT_EQ(port::kNUMANoAffinity, port::NUMAGetThreadNodeAffinity());
+}
+
 }  // namespace internal
 }  // namespace tensorflow
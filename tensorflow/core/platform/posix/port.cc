@@ -27,8 +27,16 @@ limitations under the License.
 #include "tensorflow/core/platform/types.h"
 
 #if defined(__linux__) && !defined(__ANDROID__)
+#include <errno.h>
+#include <linux/mempolicy.h>
 #include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include <sys/sysinfo.h>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #endif
 #include <stdio.h>
 #include <stdlib.h>
@@ -78,6 +86,197 @@ int NumHyperthreadsPerCore() {
   return (ht_per_core > 0) ? ht_per_core : 1;
 }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+namespace {
+
+// Parses a sysfs list such as "0-3,8-11" into its members. Returns false if
+// the text is malformed.
+bool ParseSysfsList(const char* text, std::vector<int>* members) {
+  members->clear();
+  const char* p = text;
+  while (*p != '\0' && *p != '\n') {
+    char* end;
+    const long first = strtol(p, &end, 10);
+    if (end == p || first < 0) return false;
+    long last = first;
+    p = end;
+    if (*p == '-') {
+      ++p;
+      last = strtol(p, &end, 10);
+      if (end == p || last < first) return false;
+      p = end;
+    }
+    for (long i = first; i <= last; ++i) members->push_back(i);
+    if (*p == ',') ++p;
+  }
+  return true;
+}
+
+bool ReadSysfsList(const char* path, std::vector<int>* members) {
+  FILE* f = fopen(path, "r");
+  if (f == nullptr) return false;
+  char buf[4096];
+  const bool ok = fgets(buf, sizeof(buf), f) != nullptr;
+  fclose(f);
+  return ok && ParseSysfsList(buf, members);
+}
+
+// The NUMA nodes of the machine, as reported by sysfs. Index i of the port
+// API refers to the i-th online node, which is kernel node node_ids[i].
+struct NUMATopology {
+  std::vector<int> node_ids;
+  std::vector<cpu_set_t> node_cpus;
+  // The affinity of the process at startup, restored by
+  // NUMASetThreadNodeAffinity(kNUMANoAffinity).
+  cpu_set_t process_cpus;
+
+  NUMATopology() {
+    CPU_ZERO(&process_cpus);
+    if (sched_getaffinity(0, sizeof(process_cpus), &process_cpus) != 0) {
+      return;
+    }
+    std::vector<int> online;
+    if (!ReadSysfsList("/sys/devices/system/node/online", &online)) return;
+    for (int node : online) {
+      char path[64];
+      snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+               node);
+      std::vector<int> cpus;
+      if (!ReadSysfsList(path, &cpus)) continue;
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &process_cpus)) {
+          CPU_SET(cpu, &set);
+        }
+      }
+      // Memory-only nodes, and nodes this process may not run on, cannot
+      // host threads.
+      if (CPU_COUNT(&set) == 0) continue;
+      node_ids.push_back(node);
+      node_cpus.push_back(set);
+    }
+  }
+};
+
+const NUMATopology& GetNUMATopology() {
+  static const NUMATopology* topology = new NUMATopology;
+  return *topology;
+}
+
+thread_local int thread_numa_node = kNUMANoAffinity;
+
+// Fills "mask" with a nodemask selecting only kernel node "node_id" and
+// returns the maxnode argument expected by mbind and set_mempolicy.
+unsigned long MakeNodeMask(int node_id, std::vector<unsigned long>* mask) {
+  const int kBitsPerLong = 8 * sizeof(unsigned long);
+  mask->assign(node_id / kBitsPerLong + 1, 0);
+  (*mask)[node_id / kBitsPerLong] = 1UL << (node_id % kBitsPerLong);
+  return mask->size() * kBitsPerLong + 1;
+}
+
+size_t PageSize() {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+size_t PageRoundUp(size_t size) {
+  return (size + PageSize() - 1) / PageSize() * PageSize();
+}
+
+// Mappings released by NUMAFree are kept, still bound to their node, and
+// handed out again for requests of the same length, so that allocators that
+// free and reallocate buffers of a few sizes do not pay for mmap, mbind and
+// munmap on every call. At most kMaxCachedBytesPerNode stay cached per node.
+constexpr size_t kMaxCachedBytesPerNode = 64 << 20;
+
+struct NUMAMappingCache {
+  std::mutex mu;
+  // Node of every mapping handed out by NUMAMalloc.
+  std::unordered_map<void*, int> live_nodes;
+  // Per node, free mappings by length.
+  std::vector<std::unordered_map<size_t, std::vector<void*>>> free_mappings;
+  std::vector<size_t> cached_bytes;
+};
+
+NUMAMappingCache& GetNUMAMappingCache() {
+  static NUMAMappingCache* cache = [] {
+    NUMAMappingCache* c = new NUMAMappingCache;
+    const size_t num_nodes = GetNUMATopology().node_ids.size();
+    c->free_mappings.resize(num_nodes);
+    c->cached_bytes.resize(num_nodes, 0);
+    return c;
+  }();
+  return *cache;
+}
+
+// Maps "length" bytes, a multiple of the page size, at an address aligned to
+// "alignment" and binds them to port node "node". Alignments above the page
+// size are met by over-mapping and unmapping the unaligned head and tail.
+void* MapOnNode(int node, size_t length, size_t alignment) {
+  const size_t slack = alignment > PageSize() ? alignment - PageSize() : 0;
+  void* mapped = mmap(nullptr, length + slack, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) return nullptr;
+  char* base = static_cast<char*>(mapped);
+  char* ptr = base;
+  if (slack > 0) {
+    ptr = reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(base) + alignment - 1) &
+        ~(static_cast<uintptr_t>(alignment) - 1));
+    if (ptr > base) munmap(base, ptr - base);
+    char* const end = base + length + slack;
+    if (ptr + length < end) munmap(ptr + length, end - (ptr + length));
+  }
+  std::vector<unsigned long> mask;
+  const unsigned long maxnode =
+      MakeNodeMask(GetNUMATopology().node_ids[node], &mask);
+  if (syscall(SYS_mbind, ptr, length, MPOL_BIND, mask.data(), maxnode, 0) !=
+      0) {
+    LOG(WARNING) << "mbind to NUMA node " << node
+                 << " failed: " << strerror(errno);
+  }
+  return ptr;
+}
+
+}  // namespace
+
+bool NUMAEnabled() { return NUMANumNodes() > 1; }
+
+int NUMANumNodes() {
+  return std::max<int>(1, GetNUMATopology().node_ids.size());
+}
+
+void NUMASetThreadNodeAffinity(int node) {
+  if (!NUMAEnabled()) return;
+  const NUMATopology& topology = GetNUMATopology();
+  if (node == kNUMANoAffinity) {
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &topology.process_cpus) != 0) {
+      LOG(WARNING) << "sched_setaffinity failed: " << strerror(errno);
+      return;
+    }
+    syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+  } else {
+    if (node < 0 || node >= static_cast<int>(topology.node_ids.size())) {
+      LOG(ERROR) << "NUMASetThreadNodeAffinity: invalid node " << node;
+      return;
+    }
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &topology.node_cpus[node]) !=
+        0) {
+      LOG(WARNING) << "sched_setaffinity failed: " << strerror(errno);
+      return;
+    }
+    // Prefer, but do not require, local pages for the thread's own
+    // allocations.
+    std::vector<unsigned long> mask;
+    const unsigned long maxnode = MakeNodeMask(topology.node_ids[node], &mask);
+    syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask.data(), maxnode);
+  }
+  thread_numa_node = node;
+}
+
+int NUMAGetThreadNodeAffinity() { return thread_numa_node; }
+#else
 bool NUMAEnabled() {
   // Not yet implemented: coming soon.
   return false;
@@ -90,6 +289,7 @@ void NUMASetThreadNodeAffinity(int node) {}
 int NUMAGetThreadNodeAffinity() {
   return kNUMANoAffinity;
 }
+#endif  // defined(__linux__) && !defined(__ANDROID__)
 
 void* AlignedMalloc(size_t size, int minimum_alignment) {
 #if defined(__ANDROID__)
@@ -140,6 +340,76 @@ void Free(void* ptr) {
 #endif
 }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+// Node-local memory comes from mmap, so that no page has been touched before
+// the binding takes effect, or from a mapping NUMAFree kept for reuse.
+void* NUMAMalloc(int node, size_t size, int minimum_alignment) {
+  if (!NUMAEnabled()) return AlignedMalloc(size, minimum_alignment);
+  CHECK_GE(node, 0);
+  CHECK_LT(node, static_cast<int>(GetNUMATopology().node_ids.size()));
+  const size_t length = PageRoundUp(std::max<size_t>(size, 1));
+  const size_t alignment = std::max(minimum_alignment, 1);
+  NUMAMappingCache& cache = GetNUMAMappingCache();
+  {
+    std::lock_guard<std::mutex> l(cache.mu);
+    auto it = cache.free_mappings[node].find(length);
+    if (it != cache.free_mappings[node].end()) {
+      std::vector<void*>& mappings = it->second;
+      for (size_t i = mappings.size(); i-- > 0;) {
+        if (reinterpret_cast<uintptr_t>(mappings[i]) % alignment == 0) {
+          void* ptr = mappings[i];
+          mappings[i] = mappings.back();
+          mappings.pop_back();
+          cache.cached_bytes[node] -= length;
+          cache.live_nodes[ptr] = node;
+          return ptr;
+        }
+      }
+    }
+  }
+  void* ptr = MapOnNode(node, length, alignment);
+  if (ptr != nullptr) {
+    std::lock_guard<std::mutex> l(cache.mu);
+    cache.live_nodes[ptr] = node;
+  }
+  return ptr;
+}
+
+void NUMAFree(void* ptr, size_t size) {
+  if (!NUMAEnabled()) {
+    Free(ptr);
+    return;
+  }
+  if (ptr == nullptr) return;
+  const size_t length = PageRoundUp(std::max<size_t>(size, 1));
+  NUMAMappingCache& cache = GetNUMAMappingCache();
+  std::lock_guard<std::mutex> l(cache.mu);
+  auto it = cache.live_nodes.find(ptr);
+  CHECK(it != cache.live_nodes.end()) << "NUMAFree of unknown pointer " << ptr;
+  const int node = it->second;
+  cache.live_nodes.erase(it);
+  if (cache.cached_bytes[node] + length <= kMaxCachedBytesPerNode) {
+    cache.free_mappings[node][length].push_back(ptr);
+    cache.cached_bytes[node] += length;
+  } else {
+    munmap(ptr, length);
+  }
+}
+
+int NUMAGetMemAffinity(const void* addr) {
+  if (!NUMAEnabled()) return kNUMANoAffinity;
+  int node_id = -1;
+  if (syscall(SYS_get_mempolicy, &node_id, nullptr, 0, addr,
+              MPOL_F_NODE | MPOL_F_ADDR) != 0) {
+    return kNUMANoAffinity;
+  }
+  const std::vector<int>& node_ids = GetNUMATopology().node_ids;
+  for (int i = 0; i < static_cast<int>(node_ids.size()); ++i) {
+    if (node_ids[i] == node_id) return i;
+  }
+  return kNUMANoAffinity;
+}
+#else
 void* NUMAMalloc(int node, size_t size, int minimum_alignment) {
   return AlignedMalloc(size, minimum_alignment);
 }
@@ -149,6 +419,7 @@ void NUMAFree(void* ptr, size_t size) { Free(ptr); }
 int NUMAGetMemAffinity(const void* addr) {
   return kNUMANoAffinity;
 }
+#endif  // defined(__linux__) && !defined(__ANDROID__)
 
 void MallocExtension_ReleaseToSystem(std::size_t num_bytes) {
   // No-op.
@@ -29,6 +29,7 @@ import numpy as np
 from tensorflow.core.protobuf import config_pb2
 from tensorflow.python import pywrap_tensorflow as tf_session
 from tensorflow.python.framework import device
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import error_interpolation
 from tensorflow.python.framework import errors
 from tensorflow.python.framework import ops
@@ -130,6 +131,12 @@ _REGISTERED_EXPANSIONS = [
 
 # pylint: enable=g-long-lambda
 
+# Feeds of these types accept float32 and float64 arrays as-is; see _run().
+# Only the feeds of run() and of callables that delegate to it are encoded
+# this way: the callables of _make_callable_from_options() and eager
+# execution still need posit arrays, and posit fetches are not decoded.
+_POSIT_DTYPES = frozenset([dtypes.posit8, dtypes.posit16, dtypes.posit32])
+
 
 def _convert_to_numpy_obj(numpy_dtype, obj):
   """Explicitly convert obj based on numpy type except for string type."""
@@ -506,6 +513,12 @@ class _FetchHandler(object):
           value = self._feed_handles[self._fetches[i]].eval()
         else:
           value = self._feeds.get(self._fetches[i])
+          if (value is not None and
+              self._fetches[i].dtype.base_dtype in _POSIT_DTYPES):
+            # Float arrays fed to posit tensors are only encoded in C++, so
+            # encode the fed value here when it is fetched back.
+            value = np.asarray(
+                value, dtype=self._fetches[i].dtype.as_numpy_dtype)
         if value is None:
           value = tensor_values[j]
           j += 1
@@ -1075,6 +1088,12 @@ class BaseSession(SessionInterface):
           if is_tensor_handle_feed:
             np_val = subfeed_val.to_numpy_array()
             feed_handles[subfeed_t] = subfeed_val
+          elif (subfeed_t.dtype.base_dtype in _POSIT_DTYPES and
+                isinstance(subfeed_val, np.ndarray) and
+                subfeed_val.dtype in (np.float32, np.float64)):
+            # Float arrays fed to posit tensors are encoded in C++ when the
+            # feed is converted, which is much faster than a numpy cast.
+            np_val = subfeed_val
           else:
             np_val = np.asarray(subfeed_val, dtype=subfeed_dtype)
 
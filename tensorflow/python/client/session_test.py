@@ -1345,6 +1345,24 @@ class SessionTest(test_util.TensorFlowTestCase):
           self.assertAllEqual(np_array, out_v)
           self.assertAllEqual(np_array, feed_v)
 
+  def testFeedFloatArraysToPositTensors(self):
+    with session.Session() as sess:
+      values = [[0.5, -2.0], [3.0, 1024.0]]
+      for dtype in [dtypes.posit8, dtypes.posit16, dtypes.posit32]:
+        feed_t = array_ops.placeholder(dtype=dtype, shape=[2, 2])
+        out_t = math_ops.cast(feed_t, dtypes.float32)
+        expected = np.array(values).astype(dtype.as_numpy_dtype).astype(
+            np.float32)
+        for np_dtype in [np.float32, np.float64]:
+          np_array = np.array(values, dtype=np_dtype)
+          self.assertAllEqual(expected,
+                              sess.run(out_t, feed_dict={feed_t: np_array}))
+          # Callables with a feed list convert their feeds like run().
+          runner = sess.make_callable(out_t, [feed_t])
+          self.assertAllEqual(expected, runner(np_array))
+          fetched = sess.run(feed_t, feed_dict={feed_t: np_array})
+          self.assertEqual(dtype.as_numpy_dtype, fetched.dtype)
+
   def testMakeCallableOnTensorWithRunOptions(self):
     with session.Session() as sess:
       a = constant_op.constant(42.0)
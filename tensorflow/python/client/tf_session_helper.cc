@@ -385,9 +385,11 @@ void TF_SessionRun_wrapper_helper(TF_Session* session, const char* handle,
   // queued or assigned to a variable).
   TF_TensorVector input_vals;
   std::vector<Safe_TF_TensorPtr> input_vals_safe;
-  for (PyObject* ndarray : input_ndarrays) {
+  for (size_t i = 0; i < input_ndarrays.size(); ++i) {
     input_vals_safe.emplace_back(make_safe(static_cast<TF_Tensor*>(nullptr)));
-    s = PyArrayToTF_Tensor(ndarray, &input_vals_safe.back());
+    s = PyArrayToTF_TensorOfType(input_ndarrays[i],
+                                 TF_OperationOutputType(inputs[i]),
+                                 &input_vals_safe.back());
     if (!s.ok()) {
       Set_TF_Status_from_Status(out_status, s);
       return;
@@ -19,6 +19,8 @@ from __future__ import print_function
 
 import numpy as np
 
+from tensorflow.core.protobuf import config_pb2
+from tensorflow.core.protobuf import rewriter_config_pb2
 from tensorflow.python.framework import dtypes as dtypes_lib
 from tensorflow.python.framework import ops
 from tensorflow.python.framework import test_util
@@ -56,6 +58,33 @@ class AccumulateNV2Test(test_util.TensorFlowTestCase):
       acc = math_ops.accumulate_n([x0, x0], shape=[None])
       self.assertAllEqual([2, 4], acc.eval(feed_dict={x0: [1, 2]}))
 
+  def testPositLowersToExactAddN(self):
+    # For posits the AccumulateNV2 placeholder is rewritten into a single AddN,
+    # which sums exactly. The AssignAdd chain used for other types would round
+    # 4096 + 2^-12 back to 4096 and lose one of the small terms.
+    values = [4096.0, 2.**-12, -4096.0, 2.**-12]
+    config = config_pb2.ConfigProto(
+        graph_options=config_pb2.GraphOptions(
+            rewrite_options=rewriter_config_pb2.RewriterConfig(
+                disable_meta_optimizer=True)))
+    with self.test_session(config=config) as sess:
+      feeds = [array_ops.placeholder(dtypes_lib.float32, [1]) for _ in values]
+      acc = math_ops.accumulate_n(
+          [math_ops.cast(x, dtypes_lib.posit16) for x in feeds], name="acc")
+      run_metadata = config_pb2.RunMetadata()
+      result = sess.run(
+          math_ops.cast(acc, dtypes_lib.float32),
+          feed_dict={x: [v] for x, v in zip(feeds, values)},
+          options=config_pb2.RunOptions(output_partition_graphs=True),
+          run_metadata=run_metadata)
+    self.assertAllEqual([2.**-11], result)
+    node_ops = {node.name: node.op
+                for graph in run_metadata.partition_graphs
+                for node in graph.node}
+    self.assertEqual("AddN", node_ops["acc"])
+    self.assertNotIn("TemporaryVariable", node_ops.values())
+    self.assertNotIn("AssignAdd", node_ops.values())
+
   def testGrad(self):
     np.random.seed(42)
     for num_inputs in range(1, 10):
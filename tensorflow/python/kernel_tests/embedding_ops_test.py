@@ -36,6 +36,7 @@ from tensorflow.python.ops import init_ops
 from tensorflow.python.ops import linalg_ops
 from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import partitioned_variables
+from tensorflow.python.ops import resource_variable_ops
 from tensorflow.python.ops import state_ops
 from tensorflow.python.ops import variable_scope
 from tensorflow.python.ops import variables
@@ -610,6 +611,41 @@ class EmbeddingLookupTest(test.TestCase):
               transform_fn=transform).eval()
           self.assertAllEqual(simple, sharded)
 
+  def testPositTableKeepsDtype(self):
+    with self.test_session():
+      table = math_ops.cast(
+          constant_op.constant([[0., 1.], [2., 3.], [4., 5.]]), dtypes.posit16)
+      embedding = embedding_ops.embedding_lookup(table, [2, 0])
+      self.assertEqual(dtypes.posit16, embedding.dtype)
+      self.assertAllEqual([[4., 5.], [0., 1.]],
+                          math_ops.cast(embedding, dtypes.float32).eval())
+
+  def testPositTableIsDecoded(self):
+    with self.test_session():
+      table = math_ops.cast(
+          constant_op.constant([[0., 1.], [2., 3.], [4., 5.]]), dtypes.posit16)
+      embedding = embedding_ops.embedding_lookup(
+          table, [2, 0], decode_posits=True)
+      self.assertEqual(dtypes.float32, embedding.dtype)
+      self.assertIn("GatherAndDecode",
+                    [op.type for op in ops.get_default_graph().get_operations()])
+      self.assertAllEqual([[4., 5.], [0., 1.]], embedding.eval())
+
+  def testShardedPositResourceVariableIsDecoded(self):
+    with self.test_session():
+      shards = [
+          resource_variable_ops.ResourceVariable(
+              math_ops.cast(constant_op.constant(values), dtypes.posit16))
+          for values in ([[0., 1.], [4., 5.]], [[2., 3.]])
+      ]
+      variables.global_variables_initializer().run()
+      embedding = embedding_ops.embedding_lookup(
+          shards, [2, 1, 0], decode_posits=True)
+      self.assertEqual(dtypes.float32, embedding.dtype)
+      self.assertIn("ResourceGatherAndDecode",
+                    [op.type for op in ops.get_default_graph().get_operations()])
+      self.assertAllEqual([[4., 5.], [2., 3.], [0., 1.]], embedding.eval())
+
 
 class EmbeddingLookupSparseTest(test.TestCase):
 
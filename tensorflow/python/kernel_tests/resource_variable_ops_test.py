@@ -225,6 +225,40 @@ class ResourceVariableOpsTest(test_util.TensorFlowTestCase):
         resource_variable_ops.read_variable_op(handle, dtype=dtypes.int32))
     self.assertEqual(read, 2)
 
+  def _stochasticAssign(self, assign_fn, seed2=42):
+    # Applies assign_fn with a delta of 2^-14 to 2^14 posit16 ones.
+    size = 1 << 14
+    with self.test_session(graph=ops.Graph()):
+      var = resource_variable_ops.ResourceVariable(
+          [1.0] * size, dtype=dtypes.posit16)
+      delta = math_ops.cast(
+          constant_op.constant(2.**-14, shape=[size]), dtypes.posit16)
+      var.initializer.run()
+      assign_fn(var.handle, delta, seed=17, seed2=seed2).run()
+      return math_ops.cast(var, dtypes.float32).eval()
+
+  def testStochasticAssignAddRoundsWithoutBias(self):
+    # 1 + 2^-14 is a quarter of the way from 1 to the next posit16, 1 + 2^-12.
+    result = self._stochasticAssign(
+        resource_variable_ops.stochastic_assign_add_variable_op)
+    self.assertEqual({1.0, 1.0 + 2.**-12}, set(result))
+    self.assertNear(1.0 + 2.**-14, np.mean(result), 2.**-17)
+
+  def testStochasticAssignSubRoundsWithoutBias(self):
+    # 1 - 2^-14 is half way from 1 to the previous posit16, 1 - 2^-13.
+    result = self._stochasticAssign(
+        resource_variable_ops.stochastic_assign_sub_variable_op)
+    self.assertEqual({1.0 - 2.**-13, 1.0}, set(result))
+    self.assertNear(1.0 - 2.**-14, np.mean(result), 2.**-17)
+
+  def testStochasticAssignIsDeterministicGivenSeeds(self):
+    assign = resource_variable_ops.stochastic_assign_add_variable_op
+    self.assertAllEqual(self._stochasticAssign(assign),
+                        self._stochasticAssign(assign))
+    self.assertNotEqual(
+        list(self._stochasticAssign(assign)),
+        list(self._stochasticAssign(assign, seed2=43)))
+
   @test_util.run_in_graph_and_eager_modes
   def testScatterAdd(self):
     handle = resource_variable_ops.var_handle_op(
@@ -17,6 +17,9 @@ limitations under the License.
 
 #include <cstring>
 
+#include "tensorflow/core/framework/posit16.h"
+#include "tensorflow/core/framework/posit32.h"
+#include "tensorflow/core/framework/posit8.h"
 #include "tensorflow/core/lib/core/coding.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
@@ -362,6 +365,47 @@ inline void FastMemcpy(void* dst, const void* src, size_t size) {
   // clang-format on
 }
 
+bool IsPositDataType(TF_DataType dtype) {
+  return dtype == TF_POSIT8 || dtype == TF_POSIT16 || dtype == TF_POSIT32;
+}
+
+// Encodes the float32 or float64 values of `array` into `dst`, a buffer of
+// `nelems` posits of type `dtype`.
+void EncodePyArrayAsPosits(PyArrayObject* array, TF_DataType dtype,
+                           int64 nelems, void* dst) {
+  if (PyArray_TYPE(array) == NPY_FLOAT32) {
+    const float* src = reinterpret_cast<const float*>(PyArray_DATA(array));
+    switch (dtype) {
+      case TF_POSIT8:
+        FloatToPosit8(src, reinterpret_cast<posit8*>(dst), nelems);
+        break;
+      case TF_POSIT16:
+        FloatToPosit16(src, reinterpret_cast<posit16*>(dst), nelems);
+        break;
+      default:
+        FloatToPosit32(src, reinterpret_cast<posit32*>(dst), nelems);
+        break;
+    }
+    return;
+  }
+  // Round doubles directly rather than through float, to avoid rounding
+  // twice.
+  const double* src = reinterpret_cast<const double*>(PyArray_DATA(array));
+  for (int64 i = 0; i < nelems; ++i) {
+    switch (dtype) {
+      case TF_POSIT8:
+        reinterpret_cast<posit8*>(dst)[i] = posit8(src[i]);
+        break;
+      case TF_POSIT16:
+        reinterpret_cast<posit16*>(dst)[i] = posit16(src[i]);
+        break;
+      default:
+        reinterpret_cast<posit32*>(dst)[i] = posit32(src[i]);
+        break;
+    }
+  }
+}
+
 }  // namespace
 
 // Converts the given TF_Tensor to a numpy ndarray.
@@ -472,6 +516,44 @@ Status PyArrayToTF_Tensor(PyObject* ndarray, Safe_TF_TensorPtr* out_tensor) {
   return Status::OK();
 }
 
+Status PyArrayToTF_TensorOfType(PyObject* ndarray, TF_DataType dtype,
+                                Safe_TF_TensorPtr* out_tensor) {
+  DCHECK(out_tensor != nullptr);
+  if (!IsPositDataType(dtype)) {
+    return PyArrayToTF_Tensor(ndarray, out_tensor);
+  }
+
+  Safe_PyObjectPtr array_safe(make_safe(
+      PyArray_FromAny(ndarray, nullptr, 0, 0, NPY_ARRAY_CARRAY_RO, nullptr)));
+  if (!array_safe) return errors::InvalidArgument("Not a ndarray.");
+  PyArrayObject* array = reinterpret_cast<PyArrayObject*>(array_safe.get());
+  const int pyarray_type = PyArray_TYPE(array);
+  if (pyarray_type != NPY_FLOAT32 && pyarray_type != NPY_FLOAT64) {
+    // Posit arrays are aliased without a copy; anything else is rejected
+    // downstream with the usual type mismatch error.
+    return PyArrayToTF_Tensor(ndarray, out_tensor);
+  }
+
+  tensorflow::int64 nelems = 1;
+  gtl::InlinedVector<int64_t, 4> dims;
+  for (int i = 0; i < PyArray_NDIM(array); ++i) {
+    dims.push_back(PyArray_SHAPE(array)[i]);
+    nelems *= dims[i];
+  }
+  TF_Tensor* tensor = TF_AllocateTensor(dtype, dims.data(), dims.size(),
+                                        nelems * TF_DataTypeSize(dtype));
+  if (tensor == nullptr) {
+    return errors::Internal("Could not allocate a posit tensor for the feed");
+  }
+  *out_tensor = make_safe(tensor);
+  // The conversion only touches memory owned by `array` and `tensor`, which
+  // are both kept alive here.
+  Py_BEGIN_ALLOW_THREADS;
+  EncodePyArrayAsPosits(array, dtype, nelems, TF_TensorData(tensor));
+  Py_END_ALLOW_THREADS;
+  return Status::OK();
+}
+
 Status TF_TensorToTensor(const TF_Tensor* src, Tensor* dst);
 TF_Tensor* TF_TensorFromTensor(const tensorflow::Tensor& src,
                                TF_Status* status);
@@ -36,6 +36,12 @@ Status TF_TensorToPyArray(Safe_TF_TensorPtr tensor, PyObject** out_ndarray);
 // `out_tensor` must be non-null. Caller retains ownership of `ndarray`.
 Status PyArrayToTF_Tensor(PyObject* ndarray, Safe_TF_TensorPtr* out_tensor);
 
+// Like PyArrayToTF_Tensor, but converts for a feed of type `dtype`. Float32
+// and float64 arrays fed where a posit tensor is expected are encoded by the
+// bulk converters in C++, instead of requiring a per-element numpy cast.
+Status PyArrayToTF_TensorOfType(PyObject* ndarray, TF_DataType dtype,
+                                Safe_TF_TensorPtr* out_tensor);
+
 // Creates a tensor in 'ret' from the input Ndarray.
 Status NdarrayToTensor(PyObject* obj, Tensor* ret);
 
@@ -410,6 +410,26 @@ def _GatherGrad(op, grad):
   return [ops.IndexedSlices(values, indices, params_shape), None]
 
 
+@ops.RegisterGradient("GatherAndDecode")
+def _GatherAndDecodeGrad(op, grad):
+  """Gradient for GatherAndDecode op."""
+  # The gradient flows back to the posit params, so it is encoded in their
+  # dtype; otherwise this is the same as the Gather gradient.
+  params = op.inputs[0]
+  with ops.colocate_with(params):
+    params_shape = array_ops.shape(params, out_type=ops.dtypes.int64)
+    params_shape = math_ops.to_int32(params_shape)
+
+  # Build appropriately shaped IndexedSlices
+  indices = op.inputs[1]
+  size = array_ops.expand_dims(array_ops.size(indices), 0)
+  values_shape = array_ops.concat([size, params_shape[1:]], 0)
+  values = math_ops.cast(
+      array_ops.reshape(grad, values_shape), op.get_attr("Tparams"))
+  indices = array_ops.reshape(indices, size)
+  return [ops.IndexedSlices(values, indices, params_shape), None]
+
+
 @ops.RegisterGradient("GatherV2")
 def _GatherV2Grad(op, grad):
   """Gradient for GatherV2 op."""
@@ -19,6 +19,7 @@ from __future__ import print_function
 
 from six.moves import xrange  # pylint: disable=redefined-builtin
 
+from tensorflow.python.eager import tape
 from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
@@ -29,6 +30,8 @@ from tensorflow.python.ops import clip_ops
 # Imports gradient definitions.
 from tensorflow.python.ops import data_flow_grad  # pylint: disable=unused-import
 from tensorflow.python.ops import data_flow_ops
+from tensorflow.python.ops import gen_array_ops
+from tensorflow.python.ops import gen_resource_variable_ops
 from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import resource_variable_ops
 from tensorflow.python.ops import sparse_ops
@@ -37,6 +40,28 @@ from tensorflow.python.platform import tf_logging as logging
 from tensorflow.python.util.tf_export import tf_export
 
 
+_POSIT_DTYPES = frozenset([dtypes.posit8, dtypes.posit16, dtypes.posit32])
+
+
+def _gather(params, ids, name=None, decode_posits=False):
+  """Gathers `ids` from `params`, optionally decoding posit tables to float32.
+
+  With `decode_posits`, posit tables are gathered with the fused decoding ops,
+  which decode each row while copying it rather than casting the gathered rows
+  afterwards. Otherwise rows keep the dtype of `params`.
+  """
+  if not decode_posits or params.dtype.base_dtype not in _POSIT_DTYPES:
+    return array_ops.gather(params, ids, name=name)
+  if isinstance(params, resource_variable_ops.ResourceVariable):
+    with ops.name_scope("Gather" if name is None else name) as name:
+      if params.trainable:
+        tape.watch_variable(params)
+      value = gen_resource_variable_ops.resource_gather_and_decode(
+          params.handle, ids, dtype=params.dtype.base_dtype, name=name)
+    return array_ops.identity(value)
+  return gen_array_ops.gather_and_decode(params, ids, name=name)
+
+
 def _clip(params, ids, max_norm):
   """Helper function for _embedding_lookup_and_transform.
 
@@ -86,7 +111,8 @@ def _embedding_lookup_and_transform(params,
                                     partition_strategy="mod",
                                     name=None,
                                     max_norm=None,
-                                    transform_fn=None):
+                                    transform_fn=None,
+                                    decode_posits=False):
   """Helper function for embedding_lookup and _compute_sampled_logits.
 
   This function is a generalization of embedding_lookup that optionally
@@ -108,6 +134,7 @@ def _embedding_lookup_and_transform(params,
     transform_fn: An optional function to apply to each retrieved embedding.
       If max_norm is provided, transform_fn is applied to the norm-limited
       embeddings.
+    decode_posits: See embedding_lookup.
 
   Returns:
     See embedding_lookup for details.
@@ -130,7 +157,8 @@ def _embedding_lookup_and_transform(params,
     ids = ops.convert_to_tensor(ids, name="ids")
     if np == 1 and (not transform_fn or ids.get_shape().ndims == 1):
       with ops.colocate_with(params[0]):
-        result = _clip(array_ops.gather(params[0], ids, name=name),
+        result = _clip(_gather(params[0], ids, name=name,
+                               decode_posits=decode_posits),
                        ids, max_norm)
         if transform_fn:
           result = transform_fn(result)
@@ -198,7 +226,7 @@ def _embedding_lookup_and_transform(params,
       for p in xrange(np):
         pids = gather_ids[p]
         with ops.colocate_with(params[p]):
-          result = array_ops.gather(params[p], pids)
+          result = _gather(params[p], pids, decode_posits=decode_posits)
           if transform_fn:
             # If transform_fn is provided, the clip_by_norm precedes
             # the transform and hence must be co-located. See below
@@ -251,7 +279,8 @@ def embedding_lookup(
     partition_strategy="mod",
     name=None,
     validate_indices=True,  # pylint: disable=unused-argument
-    max_norm=None):
+    max_norm=None,
+    decode_posits=False):
   """Looks up `ids` in a list of embedding tensors.
 
   This function is used to perform parallel lookups on the list of
@@ -297,9 +326,12 @@ def embedding_lookup(
       include raising an error.
     max_norm: If not `None`, each embedding is clipped if its l2-norm is
       larger than this value.
+    decode_posits: If `True` and `params` are posits, decode the rows to
+      `float32` as they are gathered instead of returning posits.
 
   Returns:
-    A `Tensor` with the same type as the tensors in `params`.
+    A `Tensor` with the same type as the tensors in `params`, or `float32` if
+    they are posits and `decode_posits` is `True`.
 
   Raises:
     ValueError: If `params` is empty.
@@ -310,7 +342,8 @@ def embedding_lookup(
       partition_strategy=partition_strategy,
       name=name,
       max_norm=max_norm,
-      transform_fn=None)
+      transform_fn=None,
+      decode_posits=decode_posits)
 
 
 @tf_export("nn.embedding_lookup_sparse")
@@ -1491,6 +1491,21 @@ def _GatherGrad(op, grad):
   return (ops.IndexedSlices(values, indices, params_shape), None)
 
 
+@ops.RegisterGradient("ResourceGatherAndDecode")
+def _GatherAndDecodeGrad(op, grad):
+  """Gradient for gather-and-decode op."""
+  # Same as the ResourceGather gradient, encoded in the variable's dtype.
+  handle = op.inputs[0]
+  indices = op.inputs[1]
+  params_shape = gen_resource_variable_ops.variable_shape(handle)
+  size = array_ops.expand_dims(array_ops.size(indices), 0)
+  values_shape = array_ops.concat([size, params_shape[1:]], 0)
+  values = math_ops.cast(
+      array_ops.reshape(grad, values_shape), op.get_attr("dtype"))
+  indices = array_ops.reshape(indices, size)
+  return (ops.IndexedSlices(values, indices, params_shape), None)
+
+
 def _to_proto_fn(v, export_scope=None):
   """Converts Variable and ResourceVariable to VariableDef for collections."""
   return v.to_proto(export_scope=export_scope)
@@ -18,7 +18,9 @@ from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
+from tensorflow.python.ops import gen_resource_variable_ops
 from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import resource_variable_ops
 from tensorflow.python.training import optimizer
@@ -66,6 +68,13 @@ class GradientDescentOptimizer(optimizer.Optimizer):
         grad, use_locking=self._use_locking)
 
   def _resource_apply_sparse_duplicate_indices(self, grad, handle, indices):
+    if handle.dtype.base_dtype in (dtypes.posit8, dtypes.posit16,
+                                   dtypes.posit32):
+      # Scale in float and round each touched element once, when it is added.
+      delta = -math_ops.cast(grad, dtypes.float32) * math_ops.cast(
+          self._learning_rate_tensor, dtypes.float32)
+      return gen_resource_variable_ops.resource_scatter_add_and_encode(
+          handle.handle, indices, delta, dtype=handle.dtype.base_dtype)
     return resource_variable_ops.resource_scatter_add(
         handle.handle, indices, -grad * self._learning_rate)
 
@@ -162,6 +162,25 @@ class GradientDescentOptimizerTest(test.TestCase):
             [[1.0 - np_grad * 4.0, 2.0 - np_grad * 5.0]], var0.eval())
         self.assertAllCloseAccordingToType([3.0 - np_grad], var1.eval())
 
+  def testMinimizeSparsePositResourceVariable(self):
+    with self.test_session():
+      var0 = resource_variable_ops.ResourceVariable(
+          math_ops.cast([[1.0, 2.0], [7.0, 8.0]], dtypes.posit16))
+      x = constant_op.constant([[4.0], [5.0]])
+      pred = math_ops.matmul(
+          embedding_ops.embedding_lookup([var0], [0], decode_posits=True), x)
+      loss = pred * pred
+      sgd_op = gradient_descent.GradientDescentOptimizer(0.5).minimize(loss)
+      self.assertIn("ResourceScatterAddAndEncode",
+                    [op.type for op in ops.get_default_graph().get_operations()])
+      variables.global_variables_initializer().run()
+      sgd_op.run()
+      # Only the looked up row moves, by lr * 2 * pred * x.
+      np_grad = 2 * (1.0 * 4.0 + 2.0 * 5.0)
+      self.assertAllEqual(
+          [[1.0 - 0.5 * np_grad * 4.0, 2.0 - 0.5 * np_grad * 5.0], [7.0, 8.0]],
+          math_ops.cast(var0, dtypes.float32).eval())
+
   def testTensorLearningRate(self):
     for dtype in [dtypes.half, dtypes.float32, dtypes.float64]:
       with self.test_session():
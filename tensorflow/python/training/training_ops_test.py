@@ -24,9 +24,11 @@ import numpy as np
 
 from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import ops
 from tensorflow.python.framework.test_util import TensorFlowTestCase
+from tensorflow.python.ops import math_ops
 # Import resource_variable_ops for the variables-to-tensor implicit conversion.
-from tensorflow.python.ops import resource_variable_ops  # pylint: disable=unused-import
+from tensorflow.python.ops import resource_variable_ops
 from tensorflow.python.ops import variables
 from tensorflow.python.platform import googletest
 from tensorflow.python.training import training_ops
@@ -295,6 +297,60 @@ class TrainingOpsTest(TensorFlowTestCase):
     param_t = param - alpha_t * m_t / (np.sqrt(v_t) + epsilon)
     return param_t, m_t, v_t
 
+  def _applyStochastic(self, apply_fn, seed2=42):
+    """Runs one step of apply_fn on 2^14 posit16 weights at 1.
+
+    apply_fn(var, grad, slot, seed, seed2) gets the weights, a gradient of 0.5
+    in posit16 and a function that makes zero posit16 slots, and must move the
+    weights by 2^-14, half the posit16 spacing just below 1. Returns the new
+    weights as floats.
+    """
+    size = 1 << 14
+    with self.test_session(graph=ops.Graph()):
+      def slot():
+        return resource_variable_ops.ResourceVariable(
+            [0.0] * size, dtype=dtypes.posit16)
+
+      var = resource_variable_ops.ResourceVariable(
+          [1.0] * size, dtype=dtypes.posit16)
+      grad = math_ops.cast(
+          constant_op.constant(0.5, shape=[size]), dtypes.posit16)
+      update = apply_fn(var, grad, slot, 17, seed2)
+      variables.global_variables_initializer().run()
+      update.run()
+      return math_ops.cast(var, dtypes.float32).eval()
+
+  def _testStochasticStep(self, apply_fn):
+    result = self._applyStochastic(apply_fn)
+    # Round to nearest would leave every weight at 1; stochastic rounding
+    # moves half of them down a step, so the mean follows the float update.
+    self.assertEqual({1.0 - 2.**-13, 1.0}, set(result))
+    self.assertNear(1.0 - 2.**-14, np.mean(result), 2.**-17)
+    self.assertAllEqual(result, self._applyStochastic(apply_fn))
+    self.assertNotEqual(
+        list(result), list(self._applyStochastic(apply_fn, seed2=43)))
+
+  def testApplyGradientDescentStochastic(self):
+    def apply_fn(var, grad, unused_slot, seed, seed2):
+      return training_ops.resource_apply_gradient_descent_stochastic(
+          var.handle, 2.**-13, grad, seed=seed, seed2=seed2)
+    self._testStochasticStep(apply_fn)
+
+  def testApplyMomentumStochastic(self):
+    def apply_fn(var, grad, slot, seed, seed2):
+      return training_ops.resource_apply_momentum_stochastic(
+          var.handle, slot().handle, 2.**-13, grad, 0.9, seed=seed,
+          seed2=seed2)
+    self._testStochasticStep(apply_fn)
+
+  def testApplyAdamStochastic(self):
+    # On the first step Adam moves each weight by about lr.
+    def apply_fn(var, grad, slot, seed, seed2):
+      return training_ops.resource_apply_adam_stochastic(
+          var.handle, slot().handle, slot().handle, 0.9, 0.999, 2.**-14, 0.9,
+          0.999, 1e-8, grad, seed=seed, seed2=seed2)
+    self._testStochasticStep(apply_fn)
+
 
 if __name__ == '__main__':
   googletest.main()